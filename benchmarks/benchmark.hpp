@@ -0,0 +1,46 @@
+#ifndef BLUETOE_BENCHMARKS_BENCHMARK_HPP
+#define BLUETOE_BENCHMARKS_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace benchmark {
+
+    // the results of all benchmarked calls end up here
+    static volatile unsigned sink;
+
+    /*
+     * calls f( i ) for i in [0, iterations) and returns the average duration of a single call in nanoseconds
+     *
+     * f has to return a value, which is accumulated to keep the optimizer from removing the call.
+     */
+    template < class F >
+    double nanoseconds_per_call( std::size_t iterations, F f )
+    {
+        unsigned accu = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for ( std::size_t i = 0; i != iterations; ++i )
+            accu += static_cast< unsigned >( f( i ) );
+
+        const auto end = std::chrono::steady_clock::now();
+
+        sink = accu;
+
+        return std::chrono::duration< double, std::nano >( end - start ).count() / iterations;
+    }
+
+    inline void report( const char* name, double nanoseconds )
+    {
+        std::printf( "%-50s %10.2f ns\n", name, nanoseconds );
+    }
+
+    inline void report_microseconds( const char* name, double nanoseconds )
+    {
+        std::printf( "%-50s %10.3f us\n", name, nanoseconds / 1000.0 );
+    }
+}
+
+#endif
@@ -0,0 +1,45 @@
+#include <bluetoe/channel_map.hpp>
+
+#include "benchmark.hpp"
+
+/*
+ * Compares the table lookup of the Channel Selection Algorithm #1 with the per event calculation
+ * of the Channel Selection Algorithm #2.
+ */
+namespace {
+    constexpr std::size_t   iterations              = 10000000;
+    constexpr std::uint32_t access_address          = 0x8E89BED6;
+
+    const std::uint8_t all_channels_map[]           = { 0xff, 0xff, 0xff, 0xff, 0x1f };
+    const std::uint8_t nine_channels_map[]          = { 0x00, 0x06, 0xE0, 0x00, 0x1E };
+
+    void algorithm_1( const char* name, const std::uint8_t* map )
+    {
+        bluetoe::link_layer::channel_map channels;
+        channels.reset( map, 7 );
+
+        benchmark::report( name, benchmark::nanoseconds_per_call( iterations, [&channels]( std::size_t i ) {
+            return channels.data_channel( i % bluetoe::link_layer::channel_map::max_number_of_data_channels );
+        } ) );
+    }
+
+    void algorithm_2( const char* name, const std::uint8_t* map )
+    {
+        bluetoe::link_layer::channel_map channels;
+        channels.reset_algorithm_2( map, access_address );
+
+        benchmark::report( name, benchmark::nanoseconds_per_call( iterations, [&channels]( std::size_t i ) {
+            return channels.data_channel(
+                i % bluetoe::link_layer::channel_map::max_number_of_data_channels,
+                static_cast< std::uint16_t >( i ) );
+        } ) );
+    }
+}
+
+int main()
+{
+    algorithm_1( "CSA #1, all channels", all_channels_map );
+    algorithm_1( "CSA #1, 9 channels", nine_channels_map );
+    algorithm_2( "CSA #2, all channels", all_channels_map );
+    algorithm_2( "CSA #2, 9 channels", nine_channels_map );
+}
@@ -0,0 +1,133 @@
+#include <bluetoe/server.hpp>
+
+#include "benchmark.hpp"
+
+/*
+ * Measures the costs of GATT primary service discovery by a client, that discovers the services
+ * in small steps, with servers of different size.
+ */
+namespace {
+    constexpr std::size_t iterations = 100000;
+    constexpr std::size_t mtu_size   = 23;
+
+    template < std::uint16_t N >
+    using numbered_service = bluetoe::service<
+        bluetoe::service_uuid16< 0x1000 + N >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid16< 0x2000 + N >,
+            bluetoe::fixed_uint8_value< N & 0xff >
+        >
+    >;
+
+    using small_server = bluetoe::server<
+        numbered_service< 0 >
+    >;
+
+    using large_server = bluetoe::server<
+        numbered_service< 0 >,  numbered_service< 1 >,  numbered_service< 2 >,  numbered_service< 3 >,
+        numbered_service< 4 >,  numbered_service< 5 >,  numbered_service< 6 >,  numbered_service< 7 >,
+        numbered_service< 8 >,  numbered_service< 9 >,  numbered_service< 10 >, numbered_service< 11 >,
+        numbered_service< 12 >, numbered_service< 13 >, numbered_service< 14 >, numbered_service< 15 >,
+        numbered_service< 16 >, numbered_service< 17 >, numbered_service< 18 >, numbered_service< 19 >,
+        numbered_service< 20 >, numbered_service< 21 >, numbered_service< 22 >, numbered_service< 23 >,
+        numbered_service< 24 >, numbered_service< 25 >, numbered_service< 26 >, numbered_service< 27 >,
+        numbered_service< 28 >, numbered_service< 29 >, numbered_service< 30 >, numbered_service< 31 >,
+        numbered_service< 32 >, numbered_service< 33 >, numbered_service< 34 >, numbered_service< 35 >,
+        numbered_service< 36 >, numbered_service< 37 >, numbered_service< 38 >, numbered_service< 39 >
+    >;
+
+    template < class Server >
+    struct client
+    {
+        client()
+            : connection( mtu_size )
+        {
+            connection.client_mtu( mtu_size );
+        }
+
+        std::size_t request( const std::uint8_t* input, std::size_t size )
+        {
+            std::size_t out_size = sizeof( output );
+            server.l2cap_input( input, size, output, out_size, connection );
+
+            return out_size;
+        }
+
+        // Read By Group Type requests until the server responds with an error; returns the number of requests
+        unsigned discover_all_primary_services()
+        {
+            std::uint16_t starting_handle = 1;
+            unsigned      requests        = 0;
+
+            for ( ;; )
+            {
+                const std::uint8_t read_by_group[] = {
+                    0x10,
+                    static_cast< std::uint8_t >( starting_handle ), static_cast< std::uint8_t >( starting_handle >> 8 ),
+                    0xff, 0xff,
+                    0x00, 0x28
+                };
+
+                const std::size_t size = request( read_by_group, sizeof( read_by_group ) );
+                ++requests;
+
+                if ( output[ 0 ] != 0x11 )
+                    return requests;
+
+                // the end group handle of the last attribute data
+                const std::uint8_t* const last = &output[ size - output[ 1 ] ];
+                starting_handle = static_cast< std::uint16_t >( ( last[ 2 ] | ( last[ 3 ] << 8 ) ) + 1 );
+
+                if ( starting_handle == 0 )
+                    return requests;
+            }
+        }
+
+        // Find By Type Value for the last service, starting with the given handle
+        unsigned find_last_service( std::uint16_t starting_handle )
+        {
+            const std::uint8_t find_by_type_value[] = {
+                0x06,
+                static_cast< std::uint8_t >( starting_handle ), static_cast< std::uint8_t >( starting_handle >> 8 ),
+                0xff, 0xff,
+                0x00, 0x28,
+                0x27, 0x10
+            };
+
+            request( find_by_type_value, sizeof( find_by_type_value ) );
+
+            return output[ 0 ];
+        }
+
+        Server                              server;
+        typename Server::connection_data    connection;
+        std::uint8_t                        output[ mtu_size ];
+    };
+
+    template < class Server >
+    void discovery( const char* name )
+    {
+        client< Server > c;
+
+        benchmark::report( name, benchmark::nanoseconds_per_call( iterations, [&c]( std::size_t ) {
+            return c.discover_all_primary_services();
+        } ) );
+    }
+
+    void find_by_type_value( const char* name, std::uint16_t starting_handle )
+    {
+        client< large_server > c;
+
+        benchmark::report( name, benchmark::nanoseconds_per_call( iterations, [&c, starting_handle]( std::size_t ) {
+            return c.find_last_service( starting_handle );
+        } ) );
+    }
+}
+
+int main()
+{
+    discovery< small_server >( "Primary Service Discovery, 1 service" );
+    discovery< large_server >( "Primary Service Discovery, 40 services" );
+    find_by_type_value( "Find By Type Value, 40 services, from handle 1", 1 );
+    find_by_type_value( "Find By Type Value, 40 services, from last service", 39 * 3 + 1 );
+}
@@ -0,0 +1,83 @@
+#include <bluetoe/software_encryption.hpp>
+
+#include "benchmark.hpp"
+
+#include <vector>
+
+/*
+ * Costs of the software link layer encryption: a single AES-128 block, the setup of a session and
+ * encrypting and decrypting data channel PDUs with the shortest and the longest payload.
+ */
+namespace {
+    constexpr std::size_t iterations = 200000;
+
+    struct radio : bluetoe::link_layer::software_encryption< radio >
+    {
+        bluetoe::details::uint128_t create_srand()
+        {
+            return bluetoe::details::uint128_t{{ 0x79, 0x68, 0x57, 0x46, 0x35, 0x24, 0x13, 0x02, 0xbe, 0xba, 0xaf, 0xde }};
+        }
+    };
+
+    const bluetoe::details::uint128_t long_term_key = {{
+        0xbf, 0x01, 0xfb, 0x9d, 0x4e, 0xf3, 0xbc, 0x36, 0xd8, 0x74, 0xf5, 0x39, 0x41, 0x38, 0x68, 0x4c
+    }};
+
+    void aes_block()
+    {
+        const bluetoe::details::aes128 cipher( long_term_key.data() );
+        std::uint8_t block[ bluetoe::details::aes128::block_size ] = { 0 };
+
+        benchmark::report( "AES-128 block", benchmark::nanoseconds_per_call( iterations, [&cipher, &block]( std::size_t ) {
+            cipher.encrypt( block, block );
+            return block[ 0 ];
+        } ) );
+    }
+
+    void session_setup()
+    {
+        radio r;
+
+        benchmark::report_microseconds( "session setup (LL_ENC_REQ)", benchmark::nanoseconds_per_call( iterations, [&r]( std::size_t i ) {
+            return r.setup_encryption( long_term_key, i, 0xBADCAB24 ).second;
+        } ) );
+    }
+
+    void encrypt_pdu( const char* name, std::size_t size )
+    {
+        radio r;
+        r.setup_encryption( long_term_key, 0xACBDCEDFE0F10213, 0xBADCAB24 );
+        r.start_transmit_encrypted();
+
+        std::vector< std::uint8_t > pdu( size + radio::mic_size );
+
+        benchmark::report_microseconds( name, benchmark::nanoseconds_per_call( iterations, [&r, &pdu, size]( std::size_t ) {
+            r.encrypt_transmitted_pdu( 0x02, pdu.data(), size );
+            return pdu[ size ];
+        } ) );
+    }
+
+    void decrypt_pdu( const char* name, std::size_t size )
+    {
+        radio r;
+        r.setup_encryption( long_term_key, 0xACBDCEDFE0F10213, 0xBADCAB24 );
+        r.start_receive_encrypted();
+
+        std::vector< std::uint8_t > pdu( size + radio::mic_size );
+
+        // the MIC does not match, which takes the same time as a successful decryption and keeps the packet counter
+        benchmark::report_microseconds( name, benchmark::nanoseconds_per_call( iterations, [&r, &pdu]( std::size_t ) {
+            return r.decrypt_received_pdu( 0x02, pdu.data(), pdu.size() );
+        } ) );
+    }
+}
+
+int main()
+{
+    aes_block();
+    session_setup();
+    encrypt_pdu( "encrypt 27 byte PDU", 27 );
+    decrypt_pdu( "decrypt 27 byte PDU", 27 );
+    encrypt_pdu( "encrypt 251 byte PDU", 251 );
+    decrypt_pdu( "decrypt 251 byte PDU", 251 );
+}
@@ -0,0 +1,429 @@
+#include <bluetoe/server.hpp>
+#include <bluetoe/link_layer.hpp>
+
+#include "test_radio.hpp"
+#include "benchmark.hpp"
+
+// the test tools report failed checks through Boost.Test
+#define BOOST_TEST_NO_MAIN
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+/*
+ * Drives complete link layers with a GATT server over the simulated radio of the tests through scripted
+ * workloads and reports, for every workload:
+ * - application bytes per second of simulated air time (connection events * connection interval)
+ * - connection events per operation
+ * - host nanoseconds per link layer PDU (received and transmitted), including the costs of the simulation
+ *
+ * The simulated master sends at most one ATT request per connection event and sends the next request
+ * in the connection event after the response was received.
+ */
+namespace {
+    using pdu_t = std::vector< std::uint8_t >;
+
+    const std::initializer_list< std::uint8_t > connection_request = {
+        0xc5, 0x22,                         // header
+        0x3c, 0x1c, 0x62, 0x92, 0xf0, 0x48, // InitA: 48:f0:92:62:1c:3c (random)
+        0x47, 0x11, 0x08, 0x15, 0x0f, 0xc0, // AdvA:  c0:0f:15:08:11:47 (random)
+        0x5a, 0xb3, 0x9a, 0xaf,             // Access Address
+        0x08, 0x81, 0xf6,                   // CRC Init
+        0x03,                               // transmit window size
+        0x0b, 0x00,                         // window offset
+        0x18, 0x00,                         // interval (30ms)
+        0x00, 0x00,                         // slave latency
+        0x48, 0x00,                         // connection timeout (720ms)
+        0xff, 0xff, 0xff, 0xff, 0x1f,       // used channel map
+        0xaa                                // hop increment and sleep clock accuracy (10 and 50ppm)
+    };
+
+    constexpr std::size_t   att_mtu             = 23;
+    constexpr std::uint16_t large_value_handle  = 0x0003;
+
+    std::uint8_t large_value[ 512 ];
+    std::uint8_t value_a[ 20 ];
+    std::uint8_t value_b[ 20 ];
+    std::uint8_t value_c[ 20 ];
+    std::uint8_t value_d[ 20 ];
+
+    template < std::uint16_t UUID, std::uint8_t (*Value)[ 20 ] >
+    using notified_characteristic = bluetoe::characteristic<
+        bluetoe::characteristic_uuid16< UUID >,
+        bluetoe::bind_characteristic_value< std::uint8_t[ 20 ], Value >,
+        bluetoe::notify
+    >;
+
+    // handles: 0x0003 large value, 0x0006, 0x0009, 0x000C and 0x000F CCCDs of the notified values
+    using benchmark_server = bluetoe::server<
+        bluetoe::shared_write_queue< ( sizeof( large_value ) + 17 ) / 18 * 7 + sizeof( large_value ) >,
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::bind_characteristic_value< decltype( large_value ), &large_value >
+            >,
+            notified_characteristic< 0x0002, &value_a >,
+            notified_characteristic< 0x0003, &value_b >,
+            notified_characteristic< 0x0004, &value_c >,
+            notified_characteristic< 0x0005, &value_d >
+        >
+    >;
+
+    void require( bool condition, const char* message )
+    {
+        if ( !condition )
+        {
+            std::fprintf( stderr, "benchmark failed: %s\n", message );
+            std::exit( 1 );
+        }
+    }
+
+    template < typename ... Options >
+    class simulation : public bluetoe::link_layer::link_layer<
+        benchmark_server, test::radio, bluetoe::link_layer::buffer_sizes< 200, 200 >, Options... >
+    {
+    public:
+        simulation()
+            : last_sequence_number_( -1 )
+            , simulated_events_( 0 )
+            , pdus_( 0 )
+        {
+            this->respond_to( 37, connection_request );
+            connection_event();
+
+            require( simulated_events_ == 1, "no connection established" );
+        }
+
+        /*
+         * simulates one connection event, in which the master transmits the given ATT PDUs, and
+         * returns the ATT PDUs that where transmitted by the link layer.
+         */
+        std::vector< pdu_t > connection_event( const std::vector< pdu_t >& requests = std::vector< pdu_t >() )
+        {
+            this->add_connection_event_respond( test::connection_event_response(
+                std::function< test::pdu_list_t () >( [this, requests]() -> test::pdu_list_t
+                {
+                    // let run() return after this connection event
+                    this->wake_up();
+
+                    test::pdu_list_t result;
+
+                    for ( const auto& request : requests )
+                        result.push_back( l2cap_pdu( request ) );
+
+                    return result;
+                } ) ) );
+
+            this->run( server );
+
+            std::vector< pdu_t > result;
+            const auto& events = this->connection_events();
+
+            // the last connection event is scheduled, but not simulated jet
+            for ( ; simulated_events_ + 1 < events.size(); ++simulated_events_ )
+            {
+                const auto& event = events[ simulated_events_ ];
+
+                pdus_ += event.received_data.size() + event.transmitted_data.size();
+
+                for ( const auto& pdu : event.transmitted_data )
+                    add_att_pdu( pdu.data, result );
+            }
+
+            return result;
+        }
+
+        /*
+         * sends the request in a connection event and waits for the response
+         */
+        pdu_t transaction( const pdu_t& request )
+        {
+            std::vector< pdu_t > responses = connection_event( { request } );
+
+            while ( responses.empty() )
+                responses = connection_event();
+
+            require( responses.size() == 1, "unexpected ATT PDU" );
+
+            return responses.front();
+        }
+
+        std::size_t events() const
+        {
+            return simulated_events_;
+        }
+
+        std::size_t pdus() const
+        {
+            return pdus_;
+        }
+
+        std::uint32_t connection_interval_usec() const
+        {
+            return this->connection_events().back().connection_interval.usec();
+        }
+
+        benchmark_server server;
+
+    private:
+        static test::pdu_t l2cap_pdu( const pdu_t& att )
+        {
+            require( att.size() + 4 <= 27, "ATT request does not fit into a single LL PDU" );
+
+            pdu_t pdu = {
+                0x02, static_cast< std::uint8_t >( att.size() + 4 ),
+                static_cast< std::uint8_t >( att.size() ), static_cast< std::uint8_t >( att.size() >> 8 ),
+                0x04, 0x00 };
+
+            pdu.insert( pdu.end(), att.begin(), att.end() );
+
+            return test::pdu_t( pdu );
+        }
+
+        void add_att_pdu( const pdu_t& pdu, std::vector< pdu_t >& output )
+        {
+            static constexpr std::uint8_t sn_flag = 0x08;
+
+            // retransmissions and empty PDUs do not count
+            const int  sequence_number = pdu[ 0 ] & sn_flag;
+            const bool retransmission  = sequence_number == last_sequence_number_;
+            last_sequence_number_      = sequence_number;
+
+            if ( retransmission || pdu[ 1 ] == 0 || ( pdu[ 0 ] & 0x03 ) != 0x02 )
+                return;
+
+            require( pdu.size() >= 6 && pdu[ 4 ] == 0x04 && pdu[ 5 ] == 0x00, "unexpected L2CAP channel" );
+            require( static_cast< std::size_t >( pdu[ 2 ] | ( pdu[ 3 ] << 8 ) ) == pdu.size() - 6, "fragmented L2CAP SDU" );
+
+            output.push_back( pdu_t( pdu.begin() + 6, pdu.end() ) );
+        }
+
+        int         last_sequence_number_;
+        std::size_t simulated_events_;
+        std::size_t pdus_;
+    };
+
+    struct workload_result
+    {
+        std::size_t operations;
+        std::size_t bytes;
+    };
+
+    template < class Simulation, class Workload >
+    void measure( const char* name, Simulation& simulation, Workload workload )
+    {
+        const std::size_t events = simulation.events();
+        const std::size_t pdus   = simulation.pdus();
+
+        const auto start = std::chrono::steady_clock::now();
+        const workload_result result = workload( simulation );
+        const auto end   = std::chrono::steady_clock::now();
+
+        const double nanoseconds = std::chrono::duration< double, std::nano >( end - start ).count();
+        const double air_time    = static_cast< double >( simulation.events() - events ) * simulation.connection_interval_usec() / 1e6;
+
+        std::printf( "%-50s %10.1f B/s %8.2f events/op %10.1f ns/PDU\n",
+            name,
+            result.bytes / air_time,
+            static_cast< double >( simulation.events() - events ) / result.operations,
+            nanoseconds / ( simulation.pdus() - pdus ) );
+    }
+
+    template < class Simulation >
+    void subscribe( Simulation& simulation )
+    {
+        for ( const std::uint8_t cccd : { 0x06, 0x09, 0x0C, 0x0F } )
+            require( simulation.transaction( { 0x12, cccd, 0x00, 0x01, 0x00 } ) == pdu_t{ 0x13 }, "subscription failed" );
+    }
+
+    /*
+     * the application notifies all 4 characteristics in every connection event
+     */
+    template < class Simulation >
+    workload_result notification_streaming( Simulation& simulation, std::size_t notifications )
+    {
+        workload_result result = { 0, 0 };
+
+        while ( result.operations < notifications )
+        {
+            simulation.server.notify( value_a );
+            simulation.server.notify( value_b );
+            simulation.server.notify( value_c );
+            simulation.server.notify( value_d );
+
+            for ( const auto& att : simulation.connection_event() )
+            {
+                require( att[ 0 ] == 0x1B, "notification expected" );
+
+                ++result.operations;
+                result.bytes += att.size() - 3;
+            }
+        }
+
+        return result;
+    }
+
+    /*
+     * reads the 512 byte value with Read Request and Read Blob Requests
+     */
+    template < class Simulation >
+    workload_result long_reads( Simulation& simulation, std::size_t reads )
+    {
+        workload_result result = { reads, 0 };
+
+        for ( ; reads; --reads )
+        {
+            pdu_t response = simulation.transaction( { 0x0A, large_value_handle, 0x00 } );
+
+            for ( std::size_t offset = 0; ; )
+            {
+                require( response[ 0 ] == 0x0B || response[ 0 ] == 0x0D, "read response expected" );
+
+                const std::size_t size = response.size() - 1;
+                result.bytes += size;
+                offset       += size;
+
+                if ( size < att_mtu - 1 )
+                    break;
+
+                response = simulation.transaction( {
+                    0x0C, large_value_handle, 0x00, static_cast< std::uint8_t >( offset ), static_cast< std::uint8_t >( offset >> 8 ) } );
+            }
+        }
+
+        return result;
+    }
+
+    /*
+     * writes the 512 byte value with Prepare Write Requests and an Execute Write Request
+     */
+    template < class Simulation >
+    workload_result prepared_writes( Simulation& simulation, std::size_t writes )
+    {
+        static constexpr std::size_t chunk_size = att_mtu - 5;
+
+        workload_result result = { writes, 0 };
+
+        for ( ; writes; --writes )
+        {
+            for ( std::size_t offset = 0; offset < sizeof( large_value ); offset += chunk_size )
+            {
+                const std::size_t size = std::min( chunk_size, sizeof( large_value ) - offset );
+
+                pdu_t request = {
+                    0x16, large_value_handle, 0x00, static_cast< std::uint8_t >( offset ), static_cast< std::uint8_t >( offset >> 8 ) };
+                request.insert( request.end(), size, static_cast< std::uint8_t >( writes ) );
+
+                require( simulation.transaction( request )[ 0 ] == 0x17, "prepare write response expected" );
+                result.bytes += size;
+            }
+
+            require( simulation.transaction( { 0x18, 0x01 } ) == pdu_t{ 0x19 }, "execute write response expected" );
+        }
+
+        return result;
+    }
+
+    /*
+     * discovers all primary services, all characteristics and all descriptors
+     */
+    template < class Simulation >
+    workload_result discovery( Simulation& simulation, std::size_t discoveries )
+    {
+        workload_result result = { discoveries, 0 };
+
+        // returns the next starting handle from a response, or 0, if the procedure is done
+        const auto discover = [&simulation, &result]( std::uint8_t opcode, std::uint16_t attribute_type, std::size_t next_handle_offset )
+        {
+            for ( std::uint16_t starting_handle = 1; starting_handle != 0; )
+            {
+                pdu_t request = {
+                    opcode,
+                    static_cast< std::uint8_t >( starting_handle ), static_cast< std::uint8_t >( starting_handle >> 8 ),
+                    0xff, 0xff };
+
+                if ( attribute_type )
+                {
+                    request.push_back( static_cast< std::uint8_t >( attribute_type ) );
+                    request.push_back( static_cast< std::uint8_t >( attribute_type >> 8 ) );
+                }
+
+                const pdu_t response = simulation.transaction( request );
+                result.bytes += response.size();
+
+                if ( response[ 0 ] == 0x01 )
+                    return;
+
+                require( response[ 0 ] == opcode + 1, "discovery response expected" );
+
+                // Find Information Response: format instead of length
+                const std::size_t entry_size = opcode == 0x04
+                    ? ( response[ 1 ] == 0x01 ? 4 : 18 )
+                    : response[ 1 ];
+
+                const std::uint8_t* last = &response[ response.size() - entry_size ];
+                starting_handle = static_cast< std::uint16_t >( ( last[ next_handle_offset ] | ( last[ next_handle_offset + 1 ] << 8 ) ) + 1 );
+            }
+        };
+
+        for ( ; discoveries; --discoveries )
+        {
+            discover( 0x10, 0x2800, 2 );
+            discover( 0x08, 0x2803, 0 );
+            discover( 0x04, 0x0000, 0 );
+        }
+
+        return result;
+    }
+}
+
+int main()
+{
+    {
+        simulation<> sim;
+        subscribe( sim );
+
+        measure( "notification streaming, 1 per event", sim, []( simulation<>& s ) {
+            return notification_streaming( s, 1000 );
+        } );
+    }
+
+    {
+        using multiple_notifications = simulation< bluetoe::link_layer::multiple_notifications_per_event<> >;
+
+        multiple_notifications sim;
+        subscribe( sim );
+
+        measure( "notification streaming, all per event", sim, []( multiple_notifications& s ) {
+            return notification_streaming( s, 1000 );
+        } );
+    }
+
+    {
+        simulation<> sim;
+
+        measure( "long reads, 512 bytes", sim, []( simulation<>& s ) {
+            return long_reads( s, 20 );
+        } );
+    }
+
+    {
+        simulation<> sim;
+
+        measure( "prepared writes, 512 bytes", sim, []( simulation<>& s ) {
+            return prepared_writes( s, 20 );
+        } );
+    }
+
+    {
+        simulation<> sim;
+
+        measure( "discovery, services/characteristics/descriptors", sim, []( simulation<>& s ) {
+            return discovery( s, 20 );
+        } );
+    }
+}
@@ -0,0 +1,56 @@
+#include <bluetoe/notification_queue.hpp>
+
+#include "benchmark.hpp"
+
+/*
+ * Costs of queueing and dequeueing a notification, depending on the number of
+ * characteristics with notifications enabled, with an otherwise empty queue and with
+ * a queue that contains every 16th characteristic.
+ */
+namespace {
+    constexpr std::size_t iterations = 10000000;
+
+    struct empty_mixin {};
+
+    template < int Size >
+    using queue = bluetoe::link_layer::notification_queue< std::tuple< std::integral_constant< int, Size > >, empty_mixin >;
+
+    template < int Size >
+    void single_entry( const char* name )
+    {
+        queue< Size > q;
+        std::size_t   index = 0;
+
+        benchmark::report( name, benchmark::nanoseconds_per_call( iterations, [&q, &index]( std::size_t ) {
+            // worst case: the queued characteristic is the one in front of the last dequeued
+            index = ( index + Size - 1 ) % Size;
+            q.queue_notification( index );
+            return q.dequeue_indication_or_confirmation().second;
+        } ) );
+    }
+
+    template < int Size >
+    void sparse_entries( const char* name )
+    {
+        queue< Size > q;
+
+        for ( std::size_t i = 0; i < Size; i += 16 )
+            q.queue_notification( i );
+
+        benchmark::report( name, benchmark::nanoseconds_per_call( iterations, [&q]( std::size_t ) {
+            const auto entry = q.dequeue_indication_or_confirmation();
+            q.queue_notification( entry.second );
+
+            return entry.second;
+        } ) );
+    }
+}
+
+int main()
+{
+    single_entry< 8 >( "single entry, 8 characteristics" );
+    single_entry< 64 >( "single entry, 64 characteristics" );
+    single_entry< 256 >( "single entry, 256 characteristics" );
+    sparse_entries< 64 >( "every 16th queued, 64 characteristics" );
+    sparse_entries< 256 >( "every 16th queued, 256 characteristics" );
+}
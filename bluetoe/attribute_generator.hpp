@@ -33,6 +33,8 @@ namespace details {
             assert( !"should not happen" );
             return attribute();
         }
+
+        using attribute_generators = std::tuple<>;
     };
 
     template < typename ... Attributes, typename ... CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server, typename ... Options >
@@ -44,6 +46,12 @@ namespace details {
         }
 
         static const attribute attributes[ sizeof ...(Attributes) ];
+
+        /*
+         * the list of generate_attribute<> types, that generate the attributes in the very same order
+         */
+        using attribute_generators = std::tuple<
+            generate_attribute< Attributes, std::tuple< CCCDIndices... >, ClientCharacteristicIndex, Service, Server, Options... >... >;
     };
 
     template < typename ... Attributes, typename ... CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server, typename ... Options >
@@ -92,6 +100,16 @@ namespace details {
                 OptionsList
             >::attribute_at( index );
         }
+
+        template < std::size_t ClientCharacteristicIndex, typename Service, typename Server >
+        using attribute_generators = typename generate_attribute_list<
+                attribute_generation_parameters,
+                CCCDIndices,
+                ClientCharacteristicIndex,
+                Service,
+                Server,
+                OptionsList
+            >::attribute_generators;
     };
 
 }
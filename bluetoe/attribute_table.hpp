@@ -0,0 +1,104 @@
+#ifndef BLUETOE_ATTRIBUTE_TABLE_HPP
+#define BLUETOE_ATTRIBUTE_TABLE_HPP
+
+#include <bluetoe/attribute.hpp>
+#include <bluetoe/meta_types.hpp>
+#include <cstddef>
+#include <cassert>
+#include <tuple>
+
+namespace bluetoe {
+
+    namespace details {
+        struct attribute_table_meta_type {};
+    }
+
+    /**
+     * @brief generates one flat table of all attributes of a server at compile time
+     *
+     * By default, the server looks up an attribute by its handle by walking the list of
+     * services and characteristics recursively, until the attribute with the requested handle
+     * is found. The resulting code is small, but the costs of every lookup grows with the number of
+     * characteristics in a server.
+     *
+     * With this option given to the server, all attributes (an UUID and a pointer to an access function)
+     * are placed in a single, constant array, that can be placed in flash memory. Finding an attribute by
+     * its handle becomes an indexed load from that array. Procedures that iterate over a range of
+     * handles (Find Information, Read By Type) become simple scans over that array.
+     *
+     * The array requires a constant amount of 2 pointers (including padding) per attribute of read only memory.
+     *
+     * @sa server
+     *
+     * example:
+     * @code
+    typedef bluetoe::server<
+        bluetoe::flat_attribute_table,
+    ...
+    > large_server;
+     * @endcode
+     */
+    struct flat_attribute_table {
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::attribute_table_meta_type,
+            details::valid_server_option_meta_type {};
+
+        template < typename Services, typename Server, typename CCCDIndices >
+        static details::attribute attribute_at( std::size_t index );
+        /** @endcond */
+    };
+
+    namespace details {
+
+        /*
+         * default: find the attribute by walking the list of services and characteristics
+         */
+        struct recursive_attribute_table {
+            struct meta_type :
+                attribute_table_meta_type,
+                valid_server_option_meta_type {};
+
+            template < typename Services, typename Server, typename CCCDIndices >
+            static attribute attribute_at( std::size_t index )
+            {
+                return attribute_from_service_list< Services, Server, CCCDIndices >::attribute_at( index );
+            }
+        };
+
+        /*
+         * a static array of all attributes, generated by the given list of generate_attribute<> instances
+         */
+        template < typename Generators >
+        struct flat_attribute_table_impl;
+
+        template < typename ... Generators >
+        struct flat_attribute_table_impl< std::tuple< Generators... > >
+        {
+            static constexpr std::size_t size = sizeof...( Generators );
+
+            static const attribute attributes[ sizeof...( Generators ) ];
+        };
+
+        template < typename ... Generators >
+        const attribute flat_attribute_table_impl< std::tuple< Generators... > >::attributes[ sizeof...( Generators ) ] =
+        {
+            Generators::attr...
+        };
+    }
+
+    /** @cond HIDDEN_SYMBOLS */
+    template < typename Services, typename Server, typename CCCDIndices >
+    details::attribute flat_attribute_table::attribute_at( std::size_t index )
+    {
+        using table = details::flat_attribute_table_impl<
+            typename details::attribute_generators_from_service_list< Services, Server, CCCDIndices >::type >;
+
+        assert( index < table::size );
+
+        return table::attributes[ index ];
+    }
+    /** @endcond */
+}
+
+#endif
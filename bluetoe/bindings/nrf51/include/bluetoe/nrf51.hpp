@@ -79,6 +79,14 @@ namespace bluetoe
 
             static constexpr bool hardware_supports_encryption = false;
 
+            static constexpr bool hardware_supports_slave_latency = true;
+
+            bool reschedule_connection_event(
+                unsigned                                    channel,
+                bluetoe::link_layer::delta_time             start_receive,
+                bluetoe::link_layer::delta_time             end_receive,
+                bluetoe::link_layer::delta_time             connection_interval );
+
             void increment_receive_packet_counter()
             {
             }
@@ -97,6 +105,12 @@ namespace bluetoe
 
             void configure_encryption( bool receive, bool transmit );
 
+            enum class receive_error : std::uint8_t {
+                none,
+                crc,
+                mic
+            };
+
         private:
             friend void ::RADIO_IRQHandler(void);
             friend void ::TIMER0_IRQHandler(void);
@@ -143,6 +157,10 @@ namespace bluetoe
             bool                            receive_encrypted_;
             bool                            transmit_encrypted_;
             std::uint32_t                   encrypted_area_;
+
+        protected:
+            // reason of the last connection event timeout, set by the radio ISR and evaluated with the timeout() callback
+            volatile receive_error          receive_error_;
         };
 
         class scheduled_radio_base_with_encryption_base : public scheduled_radio_base
@@ -302,6 +320,16 @@ namespace bluetoe
 
             void timeout() override
             {
+                // the statistics hooks of the buffer are empty, if the link layer does not collect connection statistics
+                if ( this->receive_error_ == Base::receive_error::crc )
+                {
+                    buffer::crc_error();
+                }
+                else if ( this->receive_error_ == Base::receive_error::mic )
+                {
+                    buffer::mic_error();
+                }
+
                 static_cast< CallBack* >( this )->timeout();
             }
 
@@ -40,6 +40,16 @@ namespace nrf51_details {
     static constexpr unsigned           us_radio_rx_startup_time            = 138;
     static constexpr unsigned           us_radio_tx_startup_time            = 140;
     static constexpr unsigned           connect_request_size                = 36;
+    static constexpr unsigned           us_reschedule_margin                = 100;
+    static constexpr unsigned           us_per_octet                        = 8;
+    static constexpr std::size_t        crc_size                            = 3;
+
+    // the radio is disabled, when the timer reaches CC[ 1 ]. So the receiver has to stay on after the end of the receive window,
+    // until the largest PDU, that fits into the receive buffer and started at the end of the window, is received completely.
+    static std::uint32_t us_receive_window_extension( std::size_t receive_size )
+    {
+        return us_from_packet_start_to_address_end + ( receive_size + encryption_mic_size + crc_size ) * us_per_octet;
+    }
 
 #   if defined BLUETOE_NRF51_RADIO_DEBUG
         static constexpr int debug_pin_end_crypt     = 20;
@@ -248,6 +258,7 @@ namespace nrf51_details {
         , receive_encrypted_( false )
         , transmit_encrypted_( false )
         , encrypted_area_( encrypted_area )
+        , receive_error_( receive_error::none )
     {
         // start high freuquence clock source if not done yet
         if ( !NRF_CLOCK->EVENTS_HFCLKSTARTED )
@@ -595,13 +606,41 @@ namespace nrf51_details {
         nrf_radio->INTENSET    = RADIO_INTENSET_DISABLED_Msk;
 
         nrf_timer->CC[ 0 ] = start_receive.usec() + anchor_offset_.usec() - us_radio_rx_startup_time;
-        nrf_timer->CC[ 1 ] = end_receive.usec() + anchor_offset_.usec() + 1000; // TODO: 1000: must depend on transmit size.
+        nrf_timer->CC[ 1 ] = end_receive.usec() + anchor_offset_.usec() + us_receive_window_extension( receive_buffer_.size );
 
         nrf_timer->TASKS_CAPTURE[ 3 ] = 1;
 
         return link_layer::delta_time::usec( nrf_timer->CC[ 0 ] - nrf_timer->CC[ 3 ] );
     }
 
+    bool scheduled_radio_base::reschedule_connection_event(
+        unsigned                        channel,
+        bluetoe::link_layer::delta_time start_receive,
+        bluetoe::link_layer::delta_time end_receive,
+        bluetoe::link_layer::delta_time )
+    {
+        lock_guard lock;
+
+        // the receiver was already started by the timer
+        if ( state_ != state::evt_wait_connect || nrf_timer->EVENTS_COMPARE[ 0 ] )
+            return false;
+
+        const std::uint32_t start = start_receive.usec() + anchor_offset_.usec() - us_radio_rx_startup_time;
+
+        nrf_timer->TASKS_CAPTURE[ 3 ] = 1;
+
+        if ( nrf_timer->CC[ 3 ] + us_reschedule_margin >= start )
+            return false;
+
+        NRF_RADIO->FREQUENCY   = frequency_from_channel( channel );
+        NRF_RADIO->DATAWHITEIV = channel & 0x3F;
+
+        nrf_timer->CC[ 0 ] = start;
+        nrf_timer->CC[ 1 ] = end_receive.usec() + anchor_offset_.usec() + us_receive_window_extension( receive_buffer_.size );
+
+        return true;
+    }
+
     void scheduled_radio_base::evt_radio_interrupt()
     {
         assert( nrf_radio->EVENTS_DISABLED );
@@ -681,6 +720,12 @@ namespace nrf51_details {
             }
             else
             {
+                receive_error_ = crc_error
+                    ? receive_error::crc
+                    : mic_error
+                        ? receive_error::mic
+                        : receive_error::none;
+
                 nrf_ccm->OUTPTR  = 0;
                 nrf_ccm->INPTR   = 0;
                 nrf_radio->PACKETPTR = 0;
@@ -5,6 +5,7 @@
 #include <bluetoe/attribute.hpp>
 #include <bluetoe/codes.hpp>
 #include <bluetoe/meta_types.hpp>
+#include <bluetoe/notification_fifo.hpp>
 #include <type_traits>
 #include <climits>
 
@@ -192,6 +193,36 @@ namespace bluetoe {
         /** @endcond */
     };
 
+    /**
+     * @brief allows the value of a characteristic to be transmitted directly from the bound memory
+     *
+     * By default, the value of a characteristic is copied into the response to a Read or Read Blob request,
+     * when the request is handled. With this option, the link layer copies the value of a
+     * bluetoe::bind_characteristic_value directly from the bound object into the link layer PDUs. For large
+     * values, that have to be segmented into several link layer PDUs, this saves an intermediate copy of the whole
+     * ATT response. Bound values of const type are always transmitted without copy.
+     *
+     * The value is read, when the PDUs are filled. So the application must not change the value, while a
+     * response to a read request might still be pending, otherwise the client might receive a mix of the old and
+     * the new value.
+     *
+     * Example:
+     * @code
+        std::uint8_t calibration[ 200 ];
+
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0xD0B10674, 0x6DDD, 0x4B59, 0x89CA, 0xA009B78C956B >,
+            bluetoe::bind_characteristic_value< decltype( calibration ), &calibration >,
+            bluetoe::zero_copy_read >
+     * @endcode
+     * @sa bind_characteristic_value
+     */
+    struct zero_copy_read {
+        /** @cond HIDDEN_SYMBOLS */
+        using meta_type = details::valid_characteristic_option_meta_type;
+        /** @endcond */
+    };
+
     namespace details {
         template < bool RequiresEncryption >
         struct encryption_requirements;
@@ -237,6 +268,10 @@ namespace bluetoe {
             static constexpr bool has_write_without_response = details::has_option< write_without_response, Options... >::value;
             static constexpr bool has_notification = details::has_option< notify, Options... >::value;
             static constexpr bool has_indication   = details::has_option< indicate, Options... >::value;
+            static constexpr bool has_zero_copy_read = has_read_access
+                && ( std::is_const< T >::value || details::has_option< zero_copy_read, Options... >::value );
+
+            using notification_samples = details::bound_value_notification_fifo< T, Ptr, Options... >;
 
             template < class Server, std::size_t ClientCharacteristicIndex, bool RequiresEncryption >
             static details::attribute_access_result characteristic_value_access( details::attribute_access_arguments& args, std::uint16_t )
@@ -254,6 +289,10 @@ namespace bluetoe {
                 {
                     return characteristic_value_write_access( args, std::integral_constant< bool, has_write_access >() );
                 }
+                else if ( args.type == details::attribute_access_type::read_reference )
+                {
+                    return characteristic_value_reference_access( args, std::integral_constant< bool, has_zero_copy_read >() );
+                }
 
                 return details::attribute_access_result::write_not_permitted;
             }
@@ -277,6 +316,24 @@ namespace bluetoe {
                 return details::attribute_access_result::read_not_permitted;
             }
 
+            static details::attribute_access_result characteristic_value_reference_access( details::attribute_access_arguments& args, const std::true_type& )
+            {
+                if ( args.buffer_offset > sizeof( T ) )
+                    return details::attribute_access_result::invalid_offset;
+
+                const std::uint8_t* const ptr = static_cast< const std::uint8_t* >( static_cast< const void* >( Ptr ) );
+
+                args.buffer      = const_cast< std::uint8_t* >( ptr + args.buffer_offset );
+                args.buffer_size = sizeof( T ) - args.buffer_offset;
+
+                return details::attribute_access_result::success;
+            }
+
+            static constexpr details::attribute_access_result characteristic_value_reference_access( details::attribute_access_arguments&, const std::false_type& )
+            {
+                return details::attribute_access_result::request_not_supported;
+            }
+
             static details::attribute_access_result characteristic_value_write_access( details::attribute_access_arguments& args, const std::true_type& )
             {
                 if ( args.buffer_offset > sizeof( T ) )
@@ -0,0 +1,88 @@
+#ifndef BLUETOE_ENHANCED_ATT_HPP
+#define BLUETOE_ENHANCED_ATT_HPP
+
+#include <bluetoe/meta_types.hpp>
+#include <bluetoe/codes.hpp>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace bluetoe {
+
+    namespace details {
+        struct enhanced_att_meta_type {};
+
+        /*
+         * the minimum ATT_MTU of an enhanced ATT bearer
+         */
+        static constexpr std::uint16_t enhanced_att_minimum_mtu = 64;
+    }
+
+    /**
+     * @brief accept up to Bearers Enhanced ATT (EATT) bearers in addition to the unenhanced ATT bearer
+     *
+     * An enhanced ATT bearer is an L2CAP Enhanced Credit Based Flow Control channel (SPSM 0x0027), that is opened by
+     * the GATT client. A client can open (and reconfigure) several bearers with a single request. Bearers are only
+     * accepted on an encrypted link. Every bearer has its own ATT_MTU and its own outstanding request and indication. So a request that
+     * is answered late (see error_codes::pending), or an indication that is not confirmed yet, only blocks the
+     * bearer it was sent on, while other bearers keep working. Indications are sent on all bearers that do
+     * not wait for a confirmation.
+     *
+     * MTU is the ATT_MTU of the server on every enhanced bearer. The link layer statically allocates a receive
+     * and a transmit buffer of MTU octets per bearer. The ATT_MTU of an enhanced bearer is defined by the L2CAP
+     * connection and can not be changed by an ATT Exchange MTU Request.
+     *
+     * The server has to support GATT caching (see gatt_caching), where the support for EATT is announced in the
+     * Server Supported Features characteristic. The link layer has to support encryption and an L2CAP payload of at
+     * least 64 octets (see link_layer::max_mtu_size).
+     *
+     * Example:
+     * @code
+    using gatt = bluetoe::server<
+        ...
+        bluetoe::gatt_caching,
+        bluetoe::enhanced_att< 2 >
+    >;
+     * @endcode
+     *
+     * @sa server
+     * @sa gatt_caching
+     * @sa l2cap::credit_based_channel
+     */
+    template < std::size_t Bearers, std::uint16_t MTU = details::enhanced_att_minimum_mtu >
+    struct enhanced_att
+    {
+        static_assert( Bearers > 0, "at least one enhanced ATT bearer is required" );
+        static_assert( MTU >= details::enhanced_att_minimum_mtu, "the minimum ATT_MTU of an enhanced ATT bearer is 64" );
+
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr std::size_t    bearers = Bearers;
+        static constexpr std::uint16_t  mtu     = MTU;
+
+        struct meta_type :
+            details::enhanced_att_meta_type,
+            details::valid_server_option_meta_type {};
+        /** @endcond */
+    };
+
+    /**
+     * @brief only the unenhanced ATT bearer on the fixed ATT channel is supported
+     *
+     * This is the default.
+     *
+     * @sa enhanced_att
+     */
+    struct no_enhanced_att
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr std::size_t    bearers = 0;
+        static constexpr std::uint16_t  mtu     = details::default_att_mtu_size;
+
+        struct meta_type :
+            details::enhanced_att_meta_type,
+            details::valid_server_option_meta_type {};
+        /** @endcond */
+    };
+}
+
+#endif
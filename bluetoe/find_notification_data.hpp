@@ -51,28 +51,6 @@ namespace details {
             >::type;
         };
 
-        struct attribute_at
-        {
-            constexpr attribute_at( std::uint16_t& r, std::size_t i )
-                : result( r )
-                , index( i )
-            {}
-
-            template< typename O >
-            void each()
-            {
-                if ( index == 0 )
-                {
-                    result = O::first_attribute_handle + 1;
-                }
-
-                --index;
-            }
-
-            std::uint16_t&  result;
-            std::size_t     index;
-        };
-
         template < typename A, typename B >
         struct order_by_prio
         {
@@ -118,6 +96,63 @@ namespace details {
             using type = std::integral_constant< std::size_t, Characteristic::cccd_position >;
         };
 
+        /*
+         * table of the characteristic value handles, indexed by the notification index
+         */
+        template < typename Characteristics >
+        struct notification_value_handles;
+
+        template <>
+        struct notification_value_handles< std::tuple<> >
+        {
+            static std::uint16_t handle( std::size_t )
+            {
+                return 0;
+            }
+        };
+
+        template < typename ... Characteristics >
+        struct notification_value_handles< std::tuple< Characteristics... > >
+        {
+            static constexpr std::uint16_t handles[ sizeof...( Characteristics ) ] = {
+                static_cast< std::uint16_t >( Characteristics::first_attribute_handle + 1 )...
+            };
+
+            static std::uint16_t handle( std::size_t index )
+            {
+                return index < sizeof...( Characteristics ) ? handles[ index ] : 0;
+            }
+        };
+
+        template < typename ... Characteristics >
+        constexpr std::uint16_t notification_value_handles< std::tuple< Characteristics... > >::handles[ sizeof...( Characteristics ) ];
+
+        /*
+         * compares the address of the notified value with the bound values in order and stops at the first match.
+         * If the address is known at the point of call, the compiler is able to fold the whole search.
+         */
+        template < typename Characteristics >
+        struct find_notification_data_by_value;
+
+        template <>
+        struct find_notification_data_by_value< std::tuple<> >
+        {
+            static notification_data find( const void* )
+            {
+                return notification_data();
+            }
+        };
+
+        template < typename Characteristic, typename ... Characteristics >
+        struct find_notification_data_by_value< std::tuple< Characteristic, Characteristics... > >
+        {
+            static notification_data find( const void* value )
+            {
+                return Characteristic::characteristic_t::value_type::is_this( value )
+                    ? notification_data( Characteristic::first_attribute_handle + 1, Characteristic::cccd_handle )
+                    : find_notification_data_by_value< std::tuple< Characteristics... > >::find( value );
+            }
+        };
     }
 
     template <
@@ -158,40 +193,16 @@ namespace details {
 
         static notification_data find_notification_data_by_index( std::size_t index )
         {
-            std::uint16_t attribute = 0;
-            for_< characteristics_sorted_by_priority >::each( impl::attribute_at( attribute, index ) );
+            const std::uint16_t attribute = impl::notification_value_handles< characteristics_sorted_by_priority >::handle( index );
 
-            return notification_data( attribute, index );
+            return attribute == 0
+                ? notification_data()
+                : notification_data( attribute, index );
         }
 
-        struct attribute_value
-        {
-            constexpr attribute_value( notification_data& r, const void* v )
-                : result( r )
-                , index( 0 )
-                , value( v )
-            {}
-
-            template< typename O >
-            void each()
-            {
-                if ( O::characteristic_t::value_type::is_this( value ) )
-                    result = notification_data( O::first_attribute_handle + 1, index );
-
-                ++index;
-            }
-
-            notification_data&  result;
-            std::size_t         index;
-            const void*         value;
-        };
-
         static notification_data find_notification_data( const void* value )
         {
-            notification_data result;
-            for_< characteristics_only_with_cccd >::each( attribute_value( result, value ) );
-
-            return result;
+            return impl::find_notification_data_by_value< characteristics_with_cccd_handle >::find( value );
         }
 
         using cccd_indices = typename transform_list< characteristics_with_cccd_handle, impl::select_cccd_position >::type;
@@ -0,0 +1,372 @@
+#ifndef BLUETOE_GATT_CACHING_HPP
+#define BLUETOE_GATT_CACHING_HPP
+
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <bluetoe/service.hpp>
+#include <bluetoe/characteristic_value.hpp>
+#include <bluetoe/aes.hpp>
+#include <bluetoe/bits.hpp>
+
+namespace bluetoe {
+
+    namespace details {
+        struct gatt_caching_meta_type {};
+
+        /*
+         * Bits of the Client Supported Features characteristic value
+         */
+        enum class client_supported_features : std::uint8_t {
+            robust_caching                      = 0x01,
+            enhanced_att_bearer                 = 0x02,
+            multiple_handle_value_notifications = 0x04
+        };
+
+        constexpr std::uint8_t bits( client_supported_features c )
+        {
+            return static_cast< std::uint8_t >( c );
+        }
+
+        /*
+         * Bits of the Server Supported Features characteristic value
+         */
+        enum class server_supported_features : std::uint8_t {
+            enhanced_att_bearer                 = 0x01
+        };
+
+        constexpr std::uint8_t bits( server_supported_features s )
+        {
+            return static_cast< std::uint8_t >( s );
+        }
+
+        /*
+         * The Database Hash of a server, calculated once from the attribute table of the server
+         */
+        template < class Server >
+        struct database_hash
+        {
+            static constexpr std::size_t size = aes_cmac::mac_size;
+
+            static const std::uint8_t* value();
+            static void calculate();
+
+            static bool         calculated;
+            static std::uint8_t hash[ size ];
+        };
+
+        template < class Server >
+        bool database_hash< Server >::calculated = false;
+
+        template < class Server >
+        std::uint8_t database_hash< Server >::hash[ size ];
+
+        template < class Server >
+        const std::uint8_t* database_hash< Server >::value()
+        {
+            if ( !calculated )
+                calculate();
+
+            return &hash[ 0 ];
+        }
+
+        template < class Server >
+        void database_hash< Server >::calculate()
+        {
+            // handle and type, followed by the largest declaration: a characteristic declaration with 128 bit UUID
+            static constexpr std::size_t max_entry_size = 2 + 2 + 1 + 2 + 16;
+            static constexpr std::size_t number_of_attributes = sum_by< typename Server::services, sum_by_attributes >::value;
+
+            const std::uint8_t key[ aes128::block_size ] = { 0 };
+            aes_cmac mac( key );
+
+            for ( std::size_t index = 0; index != number_of_attributes; ++index )
+            {
+                const attribute attr = Server::attribute_at( index );
+
+                // declarations are hashed with handle, type and value, descriptors that belong to the GATT profile without value
+                const bool with_value =
+                       attr.uuid == bits( gatt_uuids::primary_service )
+                    || attr.uuid == bits( gatt_uuids::secondary_service )
+                    || attr.uuid == bits( gatt_uuids::include )
+                    || attr.uuid == bits( gatt_uuids::characteristic )
+                    || attr.uuid == bits( gatt_uuids::characteristic_extended_properties );
+
+                const bool without_value =
+                       attr.uuid == bits( gatt_uuids::characteristic_user_description )
+                    || attr.uuid == bits( gatt_uuids::client_characteristic_configuration )
+                    || attr.uuid == bits( gatt_uuids::server_characteristic_configuration )
+                    || attr.uuid == bits( gatt_uuids::characteristic_presentation_format )
+                    || attr.uuid == bits( gatt_uuids::characteristic_aggregate_format );
+
+                if ( !with_value && !without_value )
+                    continue;
+
+                const std::uint16_t handle = static_cast< std::uint16_t >( index + 1 );
+
+                std::uint8_t  entry[ max_entry_size ];
+                std::uint8_t* end = write_16bit_uuid( write_handle( &entry[ 0 ], handle ), attr.uuid );
+
+                if ( with_value )
+                {
+                    auto read = attribute_access_arguments::read( end, std::end( entry ), 0,
+                        client_characteristic_configuration(), connection_security_attributes(), nullptr );
+
+                    if ( attr.access( read, handle ) == attribute_access_result::success )
+                        end += read.buffer_size;
+                }
+
+                mac.update( &entry[ 0 ], static_cast< std::size_t >( end - &entry[ 0 ] ) );
+            }
+
+            std::uint8_t result[ size ];
+            mac.finish( result );
+
+            // AES-CMAC yields the most significant octet first, the characteristic value is little endian
+            std::reverse_copy( std::begin( result ), std::end( result ), std::begin( hash ) );
+            calculated = true;
+        }
+
+        /*
+         * Value of the Database Hash characteristic
+         */
+        struct database_hash_value
+        {
+            template < typename ... Options >
+            class value_impl
+            {
+            public:
+                static constexpr bool has_read_access  = true;
+                static constexpr bool has_write_access = false;
+                static constexpr bool has_write_without_response = false;
+                static constexpr bool has_notification = false;
+                static constexpr bool has_indication   = false;
+
+                template < class Server, std::size_t ClientCharacteristicIndex, bool RequiresEncryption >
+                static attribute_access_result characteristic_value_access( attribute_access_arguments& args, std::uint16_t )
+                {
+                    const auto security_result = encryption_requirements< RequiresEncryption >::check( args.connection_security );
+
+                    if ( security_result != attribute_access_result::success )
+                        return security_result;
+
+                    return attribute_value_read_only_access( args, database_hash< Server >::value(), database_hash< Server >::size );
+                }
+
+                static constexpr bool is_this( const void* )
+                {
+                    return false;
+                }
+            };
+
+            struct meta_type :
+                characteristic_value_meta_type,
+                characteristic_value_declaration_parameter,
+                valid_characteristic_option_meta_type {};
+        };
+
+        /*
+         * Value of the Client Supported Features characteristic
+         *
+         * The value has to be stored per connection. It is stored in two additional client characteristic
+         * configurations, behind the configurations of all Client Characteristic Configuration descriptors.
+         */
+        struct client_supported_features_value
+        {
+            static constexpr std::size_t number_of_client_configs = 2;
+
+            // the features, stored for the connection, behind the first FirstConfig configurations
+            template < std::size_t FirstConfig >
+            static std::uint8_t features( const client_characteristic_configuration& config )
+            {
+                return static_cast< std::uint8_t >( config.flags( FirstConfig ) | ( config.flags( FirstConfig + 1 ) << 2 ) );
+            }
+
+            template < typename ... Options >
+            class value_impl
+            {
+            public:
+                static constexpr bool has_read_access  = true;
+                static constexpr bool has_write_access = true;
+                static constexpr bool has_write_without_response = false;
+                static constexpr bool has_notification = false;
+                static constexpr bool has_indication   = false;
+
+                template < class Server, std::size_t ClientCharacteristicIndex, bool RequiresEncryption >
+                static attribute_access_result characteristic_value_access( attribute_access_arguments& args, std::uint16_t )
+                {
+                    const auto security_result = encryption_requirements< RequiresEncryption >::check( args.connection_security );
+
+                    if ( security_result != attribute_access_result::success )
+                        return security_result;
+
+                    static constexpr std::size_t first_config = Server::number_of_client_configs;
+
+                    const std::uint8_t features = client_supported_features_value::features< first_config >( args.client_config );
+
+                    if ( args.type == attribute_access_type::read || args.type == attribute_access_type::compare_value )
+                        return attribute_value_read_access( args, &features, sizeof( features ) );
+
+                    // the value is stored per connection and can not be referenced
+                    if ( args.type != attribute_access_type::write )
+                        return attribute_access_result::request_not_supported;
+
+                    if ( args.buffer_offset != 0 )
+                        return attribute_access_result::attribute_not_long;
+
+                    if ( args.buffer_size != sizeof( features ) )
+                        return attribute_access_result::invalid_attribute_value_length;
+
+                    // bits that are not supported are ignored, supported bits can not be cleared by the client
+                    const std::uint8_t new_features = args.buffer[ 0 ] & supported_features< Server >();
+
+                    if ( features & ~new_features )
+                        return static_cast< attribute_access_result >( bits( att_error_codes::value_not_allowed ) );
+
+                    args.client_config.flags( first_config, new_features & 0x03 );
+                    args.client_config.flags( first_config + 1, new_features >> 2 );
+
+                    return attribute_access_result::success;
+                }
+
+                static constexpr bool is_this( const void* )
+                {
+                    return false;
+                }
+
+            private:
+                // robust caching is always supported, as the database never changes
+                template < class Server >
+                static constexpr std::uint8_t supported_features()
+                {
+                    return static_cast< std::uint8_t >(
+                        bits( client_supported_features::robust_caching )
+                      | ( Server::number_of_enhanced_att_bearers != 0
+                            ? bits( client_supported_features::enhanced_att_bearer ) : 0 )
+                      | ( Server::multiple_handle_value_notifications_enabled
+                            ? bits( client_supported_features::multiple_handle_value_notifications ) : 0 ) );
+                }
+            };
+
+            struct meta_type :
+                characteristic_value_meta_type,
+                characteristic_value_declaration_parameter,
+                valid_characteristic_option_meta_type {};
+        };
+    }
+
+    /**
+     * @brief Used as a parameter to a server, to define that the GATT server will _not_ support GATT caching.
+     *
+     * This is the default.
+     *
+     * @sa server
+     * @sa gatt_caching
+     */
+    struct no_gatt_caching {
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::gatt_caching_meta_type,
+            details::valid_server_option_meta_type {};
+
+        static constexpr std::size_t number_of_client_configs = 0;
+
+        template < typename Services, bool EnhancedATT = false >
+        struct add_service {
+            typedef Services type;
+        };
+
+        template < class Server >
+        static void calculate_database_hash()
+        {
+        }
+
+        template < class Server >
+        static bool client_supports( const details::client_characteristic_configuration&, details::client_supported_features )
+        {
+            return false;
+        }
+        /** @endcond */
+    };
+
+    /**
+     * @brief Used as a parameter to a server, to add a Generic Attribute service, that supports GATT caching.
+     *
+     * The Generic Attribute service is added behind all other services of the server and contains a
+     * Client Supported Features and a Database Hash characteristic. If the server supports enhanced ATT bearers
+     * (see enhanced_att), a Server Supported Features characteristic announces the support for EATT to the client.
+     * A client that supports GATT caching, can
+     * read the Database Hash after reconnecting and can skip the service discovery, if the hash did not change.
+     *
+     * As the attribute table of a bluetoe::server is fixed at compile time, there is no need for a Service Changed
+     * characteristic. The Database Hash (AES-CMAC over the attribute table, as defined by the Core Specification)
+     * is calculated once, when the first server instance is constructed. A client can set the features,
+     * it supports, in the Client Supported Features characteristic for the current connection. Only features,
+     * that are supported by the server (see enhanced_att and multiple_handle_value_notifications) are stored.
+     * Once set, a feature can not be cleared by the client.
+     *
+     * @sa server
+     * @sa no_gatt_caching
+     */
+    struct gatt_caching {
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::gatt_caching_meta_type,
+            details::valid_server_option_meta_type {};
+
+        static constexpr std::size_t number_of_client_configs = details::client_supported_features_value::number_of_client_configs;
+
+        using gatt_service =
+            service<
+                service_uuid16< 0x1801 >,
+                characteristic<
+                    characteristic_uuid16< 0x2B29 >,
+                    details::client_supported_features_value
+                >,
+                characteristic<
+                    characteristic_uuid16< 0x2B2A >,
+                    details::database_hash_value
+                >
+            >;
+
+        using gatt_service_with_server_features =
+            service<
+                service_uuid16< 0x1801 >,
+                characteristic<
+                    characteristic_uuid16< 0x2B29 >,
+                    details::client_supported_features_value
+                >,
+                characteristic<
+                    characteristic_uuid16< 0x2B2A >,
+                    details::database_hash_value
+                >,
+                characteristic<
+                    characteristic_uuid16< 0x2B3A >,
+                    fixed_uint8_value< details::bits( details::server_supported_features::enhanced_att_bearer ) >
+                >
+            >;
+
+        template < typename Services, bool EnhancedATT = false >
+        struct add_service {
+            typedef typename details::add_type< Services,
+                typename std::conditional< EnhancedATT, gatt_service_with_server_features, gatt_service >::type >::type type;
+        };
+
+        template < class Server >
+        static void calculate_database_hash()
+        {
+            details::database_hash< Server >::value();
+        }
+
+        // true, if the client announced support for the feature by writing to the Client Supported Features characteristic
+        template < class Server >
+        static bool client_supports( const details::client_characteristic_configuration& config, details::client_supported_features feature )
+        {
+            return details::client_supported_features_value::features< Server::number_of_client_configs >( config ) & details::bits( feature );
+        }
+        /** @endcond */
+    };
+}
+
+#endif
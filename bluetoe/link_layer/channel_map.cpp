@@ -1,11 +1,15 @@
 #include <bluetoe/channel_map.hpp>
 #include <cassert>
+#include <algorithm>
 
 namespace bluetoe {
 namespace link_layer {
 
     channel_map::channel_map()
         : hop_( 0 )
+        , used_channels_count_( 0 )
+        , channel_identifier_( 0 )
+        , algorithm_2_( false )
     {
     }
 
@@ -37,7 +41,8 @@ namespace link_layer {
         if ( hop < 5 || hop > 16 )
             return false;
 
-        hop_ = hop;
+        hop_         = hop;
+        algorithm_2_ = false;
 
         std::uint8_t   used_channels[ max_number_of_data_channels ];
         const unsigned used_channels_count = build_used_channel_map( map, used_channels );
@@ -62,17 +67,100 @@ namespace link_layer {
         return true;
     }
 
+    bool channel_map::reset_algorithm_2( const std::uint8_t* map, std::uint32_t access_address )
+    {
+        channel_identifier_ = static_cast< std::uint16_t >( ( access_address >> 16 ) ^ access_address );
+
+        return reset_used_channels( map );
+    }
+
+    bool channel_map::reset_used_channels( const std::uint8_t* map )
+    {
+        assert( map );
+
+        std::uint8_t   used_channels[ max_number_of_data_channels ];
+        const unsigned used_channels_count = build_used_channel_map( map, used_channels );
+
+        if ( used_channels_count < 2 )
+            return false;
+
+        std::copy( &used_channels[ 0 ], &used_channels[ used_channels_count ], &map_[ 0 ] );
+        std::copy( &map[ 0 ], &map[ map_size ], &used_channels_[ 0 ] );
+        used_channels_[ map_size - 1 ] &= 0x1f;
+
+        used_channels_count_ = used_channels_count;
+        algorithm_2_         = true;
+
+        return true;
+    }
+
     bool channel_map::reset( const std::uint8_t* map )
     {
-        return reset( map, hop_ );
+        return algorithm_2_
+            ? reset_used_channels( map )
+            : reset( map, hop_ );
     }
 
     unsigned channel_map::data_channel( unsigned index ) const
     {
         assert( index < max_number_of_data_channels );
+        assert( !algorithm_2_ );
         return map_[ index ];
     }
 
+    unsigned channel_map::data_channel( unsigned index, std::uint16_t event_counter ) const
+    {
+        return algorithm_2_
+            ? algorithm_2_channel( event_counter )
+            : data_channel( index );
+    }
+
+    bool channel_map::algorithm_2() const
+    {
+        return algorithm_2_;
+    }
+
+    // bit reversal of every single octet
+    static std::uint16_t perm( std::uint16_t value )
+    {
+        static const std::uint8_t reversed_nibbles[ 16 ] = {
+            0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe,
+            0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf
+        };
+
+        return static_cast< std::uint16_t >(
+            ( reversed_nibbles[ value & 0xf ] << 4 )
+          | reversed_nibbles[ ( value >> 4 ) & 0xf ]
+          | ( reversed_nibbles[ ( value >> 8 ) & 0xf ] << 12 )
+          | ( reversed_nibbles[ ( value >> 12 ) & 0xf ] << 8 ) );
+    }
+
+    // multiply, add, modulo
+    static std::uint16_t mam( std::uint16_t a, std::uint16_t b )
+    {
+        return static_cast< std::uint16_t >( 17 * a + b );
+    }
+
+    unsigned channel_map::algorithm_2_channel( std::uint16_t event_counter ) const
+    {
+        std::uint16_t prn_e = event_counter ^ channel_identifier_;
+
+        prn_e = mam( perm( prn_e ), channel_identifier_ );
+        prn_e = mam( perm( prn_e ), channel_identifier_ );
+        prn_e = mam( perm( prn_e ), channel_identifier_ );
+
+        prn_e ^= channel_identifier_;
+
+        const unsigned unmapped_channel = prn_e % max_number_of_data_channels;
+
+        if ( in_map( used_channels_, unmapped_channel ) )
+            return unmapped_channel;
+
+        const unsigned remapping_index = ( used_channels_count_ * prn_e ) >> 16;
+
+        return map_[ remapping_index ];
+    }
+
 
 }
 }
@@ -37,6 +37,7 @@ namespace link_layer {
         struct advertising_type_base {
             static constexpr std::uint8_t   header_txaddr_field         = 0x40;
             static constexpr std::uint8_t   header_rxaddr_field         = 0x80;
+            static constexpr std::uint8_t   header_chsel_field          = 0x20;
             static constexpr std::size_t    advertising_pdu_header_size = 2;
             static constexpr std::uint8_t   adv_ind_pdu_type_code       = 0;
             static constexpr std::uint8_t   adv_direct_ind_pdu_type_code= 1;
@@ -177,6 +178,9 @@ namespace link_layer {
                 if ( addr.is_random() )
                     header |= header_txaddr_field;
 
+                if ( LinkLayer::channel_selection_algorithm_2_supported )
+                    header |= header_chsel_field;
+
                 const std::size_t size =
                     address_length
                   + link_layer().fill_l2cap_advertising_data( &body[ address_length ], max_advertising_data_size );
@@ -241,6 +245,9 @@ namespace link_layer {
             {
                 using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
 
+                // prevent assert() in layout_t::body
+                adv_response_size_ = layout_t::data_channel_pdu_memory_size( 0 );
+
                 adv_response_size_ = fill_empty_advertising_response_data< layout_t >(
                     link_layer().local_address(), advertising_response_buffer() );
             }
@@ -367,6 +374,9 @@ namespace link_layer {
                 if ( addr.is_random() )
                     header |= header_txaddr_field;
 
+                if ( LinkLayer::channel_selection_algorithm_2_supported )
+                    header |= header_chsel_field;
+
                 if ( addr_.is_random() )
                     header |= header_rxaddr_field;
 
@@ -482,9 +492,11 @@ namespace link_layer {
             {
                 using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
 
-                fill_advertising_response_data();
                 const device_address& addr = link_layer().local_address();
 
+                // prevent assert() in layout_t::body
+                adv_size_ = address_length;
+
                 std::uint16_t header = adv_scan_ind_pdu_type_code;
                 std::uint8_t* body   = layout_t::body( advertising_buffer() ).first;
 
@@ -501,6 +513,7 @@ namespace link_layer {
                 layout_t::header( advertising_buffer(), header );
                 std::copy( addr.begin(), addr.end(), body );
 
+                fill_advertising_response_data();
                 return advertising_buffer();
             }
 
@@ -545,6 +558,9 @@ namespace link_layer {
             {
                 using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
 
+                // prevent assert() in layout_t::body
+                adv_response_size_ = layout_t::data_channel_pdu_memory_size( 0 );
+
                 adv_response_size_ = fill_empty_advertising_response_data< layout_t >(
                     link_layer().local_address(), advertising_response_buffer() );
             }
@@ -1058,7 +1074,10 @@ namespace link_layer {
 
             void handle_adv_timeout()
             {
-                const read_buffer advertising_data = this->get_advertising_data();
+                // the radio does not use the advertising PDU between two advertising events
+                const read_buffer advertising_data = static_cast< LinkLayer& >( *this ).advertising_data_changed()
+                    ? this->fill_advertising_data()
+                    : this->get_advertising_data();
                 const read_buffer response_data    = this->get_advertising_response_data();
 
                 if ( !advertising_data.empty() && this->continued_advertising_events() )
@@ -1271,7 +1290,10 @@ namespace link_layer {
 
             void handle_adv_timeout()
             {
-                const read_buffer advertising_data = this->get_advertising_data( selected_ );
+                // the radio does not use the advertising PDU between two advertising events
+                const read_buffer advertising_data = static_cast< LinkLayer& >( *this ).advertising_data_changed()
+                    ? this->fill_advertising_data( selected_ )
+                    : this->get_advertising_data( selected_ );
                 const read_buffer response_data    = this->get_advertising_response_data( selected_ );
 
                 if ( !advertising_data.empty() && this->continued_advertising_events() )
@@ -2,6 +2,7 @@
 #define BLUETOE_LINK_LAYER_CHANNEL_MAP_HPP
 
 #include <cstdint>
+#include <cstddef>
 
 namespace bluetoe {
 namespace link_layer {
@@ -15,7 +16,7 @@ namespace link_layer {
         channel_map();
 
         /**
-         * @brief sets a new list of used channels and a new hop value.
+         * @brief sets a new list of used channels and a new hop value and selects the Channel Selection Algorithm #1.
          *
          * The function returns true, if the given parameters are valid.
          * A valid map contains at least 2 channel.
@@ -24,9 +25,17 @@ namespace link_layer {
         bool reset( const std::uint8_t* map, const unsigned hop );
 
         /**
-         * @brief sets a new list of used channels and keeps the old hop value.
+         * @brief sets a new list of used channels and selects the Channel Selection Algorithm #2.
          *
-         * @pre reset( const std::uint8_t* map, const unsigned hop ) must have been called before, to have an old hop value
+         * The channel identifier is derived from the access address of the connection.
+         * The function returns true, if the given map contains at least 2 channel.
+         */
+        bool reset_algorithm_2( const std::uint8_t* map, std::uint32_t access_address );
+
+        /**
+         * @brief sets a new list of used channels and keeps the old hop value or channel identifier.
+         *
+         * @pre reset( const std::uint8_t* map, const unsigned hop ) or reset_algorithm_2() must have been called before
          */
         bool reset( const std::uint8_t* map );
 
@@ -34,18 +43,44 @@ namespace link_layer {
          * the BLE channel hop sequence is 37 entries long, after 37 hops, the sequence starts again.
          * This function returns the entries in this sequence. The channel for the first entry is given
          * by calling the function with index = 0, the last entry with index = max_number_of_data_channels -1
+         *
+         * @pre the Channel Selection Algorithm #1 is selected
          */
         unsigned data_channel( unsigned index ) const;
 
+        /**
+         * @brief returns the channel for a connection event
+         *
+         * With the Channel Selection Algorithm #1, the result is data_channel( index ). With the Channel
+         * Selection Algorithm #2, the channel is calculated from the connection event counter.
+         */
+        unsigned data_channel( unsigned index, std::uint16_t event_counter ) const;
+
+        /**
+         * @brief returns true, if the Channel Selection Algorithm #2 is selected
+         */
+        bool algorithm_2() const;
+
         /**
          * the number of channels, used as data channel.
          */
         static constexpr unsigned max_number_of_data_channels = 37;
     private:
         unsigned build_used_channel_map( const std::uint8_t* map, std::uint8_t* used ) const;
+        bool reset_used_channels( const std::uint8_t* map );
+        unsigned algorithm_2_channel( std::uint16_t event_counter ) const;
+
+        static constexpr std::size_t map_size = ( max_number_of_data_channels + 7 ) / 8;
+
+        // algorithm #1: the hop sequence; algorithm #2: the list of used channels
+        std::uint8_t  map_[ max_number_of_data_channels ];
+        std::uint8_t  hop_;
 
-        std::uint8_t map_[ max_number_of_data_channels ];
-        std::uint8_t hop_;
+        // algorithm #2 only
+        std::uint8_t  used_channels_[ map_size ];
+        std::uint8_t  used_channels_count_;
+        std::uint16_t channel_identifier_;
+        bool          algorithm_2_;
     };
 }
 }
@@ -0,0 +1,248 @@
+#ifndef BLUETOE_LINK_LAYER_CONNECTION_STATISTICS_HPP
+#define BLUETOE_LINK_LAYER_CONNECTION_STATISTICS_HPP
+
+#include "ll_meta_types.hpp"
+#include <bluetoe/meta_tools.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace bluetoe {
+namespace link_layer {
+
+    namespace details {
+        struct connection_statistics_meta_type {};
+    }
+
+    /**
+     * @brief counters of a single connection, collected by connection_statistics
+     *
+     * ProcessingTimeBuckets is the number of entries in the histogram of the time, the CPU spends in
+     * processing a connection event.
+     */
+    template < std::size_t ProcessingTimeBuckets >
+    struct connection_counters
+    {
+        /**
+         * @brief number of connection events, in which a PDU was received from the master
+         */
+        std::uint32_t events;
+
+        /**
+         * @brief number of connection events, in which no PDU with payload was received or acknowledged
+         */
+        std::uint32_t empty_events;
+
+        /**
+         * @brief number of connection events, in which no PDU was received from the master
+         */
+        std::uint32_t timeouts;
+
+        /**
+         * @brief number of received PDUs with payload (not counting resent PDUs)
+         */
+        std::uint32_t received_pdus;
+
+        /**
+         * @brief number of transmitted PDUs with payload, that where acknowledged by the master
+         */
+        std::uint32_t transmitted_pdus;
+
+        /**
+         * @brief number of PDUs, that the master did not acknowledge and that have to be transmitted again
+         */
+        std::uint32_t retransmissions;
+
+        /**
+         * @brief number of PDUs, that where received with CRC error (as reported by the scheduled radio)
+         */
+        std::uint32_t crc_errors;
+
+        /**
+         * @brief number of PDUs, that failed the message integrity check (as reported by the scheduled radio)
+         */
+        std::uint32_t mic_failures;
+
+        /**
+         * @brief histogram of the time spend in processing a connection event
+         *
+         * Entry n counts the events that took n * CyclesPerBucket till ( n + 1 ) * CyclesPerBucket - 1 cycles.
+         * The last entry counts all events, that took longer.
+         */
+        std::uint32_t processing_time[ ProcessingTimeBuckets ];
+    };
+
+    /**
+     * @brief link layer option to collect statistics about the current connection
+     *
+     * The statistics are reset, when a new connection is established and stay available after the connection
+     * was closed. They can be read by link_layer::connection_statistics().
+     *
+     * CycleCounter is a class with a static function, that returns a free running counter (like the DWT
+     * cycle counter of a Cortex-M):
+     *
+     * @code
+     * struct cycle_counter {
+     *     static std::uint32_t cycles();
+     * };
+     * @endcode
+     *
+     * The link layer measures the time spend in processing the received PDUs and preparing the next connection
+     * event and sorts the result into a histogram with ProcessingTimeBuckets entries of CyclesPerBucket cycles.
+     *
+     * CRC errors and MIC failures are counted, when the scheduled radio reports them to the ll_data_pdu_buffer.
+     *
+     * Without this option, no statistics are collected and no memory or CPU time is used.
+     *
+     * @sa no_connection_statistics
+     */
+    template < class CycleCounter, std::uint32_t CyclesPerBucket, std::size_t ProcessingTimeBuckets = 8 >
+    struct connection_statistics
+    {
+        static_assert( CyclesPerBucket > 0, "CyclesPerBucket must not be 0" );
+        static_assert( ProcessingTimeBuckets > 0, "at least one histogram bucket is required" );
+
+        /**
+         * @brief type of the collected statistics
+         */
+        using counters = connection_counters< ProcessingTimeBuckets >;
+
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::connection_statistics_meta_type,
+            details::valid_link_layer_option_meta_type {};
+
+        class impl
+        {
+        public:
+            static constexpr bool collects_connection_statistics = true;
+
+            impl()
+            {
+                reset_connection_statistics();
+            }
+
+            /**
+             * @brief statistics of the current, or last connection
+             */
+            const counters& connection_statistics() const
+            {
+                return counters_;
+            }
+
+            void reset_connection_statistics()
+            {
+                counters_       = counters();
+                last_activity_  = 0;
+            }
+
+            std::uint32_t statistics_start_processing() const
+            {
+                return CycleCounter::cycles();
+            }
+
+            void statistics_connection_event( std::uint32_t start_of_processing )
+            {
+                const std::uint32_t duration = CycleCounter::cycles() - start_of_processing;
+                const std::size_t   bucket   = std::min< std::uint32_t >( duration / CyclesPerBucket, ProcessingTimeBuckets - 1 );
+
+                ++counters_.events;
+                ++counters_.processing_time[ bucket ];
+
+                const std::uint32_t activity = counters_.received_pdus + counters_.transmitted_pdus;
+
+                if ( activity == last_activity_ )
+                    ++counters_.empty_events;
+
+                last_activity_ = activity;
+            }
+
+            void statistics_timeout()
+            {
+                ++counters_.timeouts;
+            }
+
+            void statistics_pdu_received()
+            {
+                ++counters_.received_pdus;
+            }
+
+            void statistics_pdu_acknowledged()
+            {
+                ++counters_.transmitted_pdus;
+            }
+
+            void statistics_pdu_retransmitted()
+            {
+                ++counters_.retransmissions;
+            }
+
+            void statistics_crc_error()
+            {
+                ++counters_.crc_errors;
+            }
+
+            void statistics_mic_failure()
+            {
+                ++counters_.mic_failures;
+            }
+
+        private:
+            counters        counters_;
+            std::uint32_t   last_activity_;
+        };
+        /** @endcond */
+    };
+
+    /**
+     * @brief link layer option to not collect connection statistics
+     *
+     * This is the default.
+     *
+     * @sa connection_statistics
+     */
+    struct no_connection_statistics
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::connection_statistics_meta_type,
+            details::valid_link_layer_option_meta_type {};
+
+        class impl
+        {
+        public:
+            static constexpr bool collects_connection_statistics = false;
+
+            void reset_connection_statistics() {}
+
+            std::uint32_t statistics_start_processing() const
+            {
+                return 0;
+            }
+
+            void statistics_connection_event( std::uint32_t ) {}
+            void statistics_timeout() {}
+            void statistics_pdu_received() {}
+            void statistics_pdu_acknowledged() {}
+            void statistics_pdu_retransmitted() {}
+            void statistics_crc_error() {}
+            void statistics_mic_failure() {}
+        };
+        /** @endcond */
+    };
+
+    namespace details {
+        template < typename ... Options >
+        struct connection_statistics_impl
+        {
+            using type = typename ::bluetoe::details::find_by_meta_type<
+                connection_statistics_meta_type,
+                Options...,
+                no_connection_statistics >::type::impl;
+        };
+    }
+}
+}
+
+#endif
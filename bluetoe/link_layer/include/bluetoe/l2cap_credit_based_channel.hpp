@@ -0,0 +1,510 @@
+#ifndef BLUETOE_LINK_LAYER_L2CAP_CREDIT_BASED_CHANNEL_HPP
+#define BLUETOE_LINK_LAYER_L2CAP_CREDIT_BASED_CHANNEL_HPP
+
+#include <bluetoe/attribute.hpp>
+#include <bluetoe/codes.hpp>
+#include <bluetoe/bits.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <tuple>
+
+namespace bluetoe {
+
+namespace details {
+    struct credit_based_channel_meta_type {};
+}
+
+namespace l2cap {
+
+    template < typename ... Options >
+    class signaling_channel;
+
+    /** @cond HIDDEN_SYMBOLS */
+    /*
+     * state of a single LE or Enhanced Credit Based Flow Control channel; all SPSM and MTU specific parts are
+     * runtime parameters, so that the implementation is not instanciated per channel.
+     */
+    class credit_based_channel_base
+    {
+    public:
+        /**
+         * @brief returns true, if a remote device is connected to this channel
+         */
+        bool connected() const
+        {
+            return connected_;
+        }
+
+        /**
+         * @brief hands a buffer to the channel, to receive the next SDU into
+         *
+         * The buffer has to be at least as large as the MTU of the channel. The remote device gets credits to
+         * transmit into the buffer, only while the application provided a buffer. The received data is copied
+         * from the link layer directly into the buffer. A completely received SDU is released, by providing
+         * the next buffer.
+         *
+         * @return false, if the buffer is too small, or if an SDU is currently received into the last buffer.
+         */
+        bool receive( std::uint8_t* buffer, std::size_t size )
+        {
+            if ( size < mtu_ || rx_state_ == rx_receiving )
+                return false;
+
+            rx_buffer_ = buffer;
+            rx_state_  = rx_waiting;
+
+            grant_first_frame_credit();
+
+            return true;
+        }
+
+        /**
+         * @brief returns true and the size of the received SDU, if an SDU was completely received into the last
+         *        provided buffer.
+         */
+        bool sdu_received( std::size_t& size ) const
+        {
+            size = rx_size_;
+
+            return rx_state_ == rx_complete;
+        }
+
+        /**
+         * @brief queues an SDU for transmission
+         *
+         * The SDU is not copied and the application has to keep it unchanged, until transmitting() returns false.
+         *
+         * @return false, if the channel is not connected, the last SDU is still transmitted or the SDU is larger than
+         *         the MTU of the remote device.
+         */
+        bool transmit( const std::uint8_t* sdu, std::size_t size )
+        {
+            if ( !connected_ || tx_state_ != tx_idle || size > remote_mtu_ )
+                return false;
+
+            tx_sdu_   = sdu;
+            tx_size_  = size;
+            tx_sent_  = 0;
+            tx_state_ = tx_segmenting;
+
+            return true;
+        }
+
+        /**
+         * @brief returns true, while the link layer still refers to the last SDU, passed to transmit()
+         */
+        bool transmitting() const
+        {
+            return tx_state_ != tx_idle;
+        }
+
+        /**
+         * @brief the largest SDU, the remote device is able to receive
+         * @pre connected()
+         */
+        std::uint16_t remote_mtu() const
+        {
+            return remote_mtu_;
+        }
+
+    protected:
+        /*
+         * le_credit_based: the channel can be opened with an LE Credit Based Connection Request; every channel with
+         * an MTU of at least 64 can be opened with an Enhanced Credit Based Connection Request.
+         * requires_encryption: the channel can only be opened on an encrypted link
+         */
+        credit_based_channel_base( std::uint16_t spsm, std::uint16_t mtu, bool le_credit_based, bool requires_encryption )
+            : spsm_( spsm )
+            , mtu_( mtu )
+            , le_credit_based_( le_credit_based )
+            , requires_encryption_( requires_encryption )
+            , mps_( details::default_att_mtu_size )
+            , rx_buffer_( nullptr )
+            , rx_size_( 0 )
+            , rx_received_( 0 )
+            , rx_state_( rx_no_buffer )
+            , tx_sdu_( nullptr )
+            , tx_size_( 0 )
+            , tx_sent_( 0 )
+        {
+            reset( details::default_att_mtu_size );
+        }
+
+    private:
+        template < typename ... Options >
+        friend class signaling_channel;
+
+        enum : std::uint16_t {
+            connection_successful           = 0x0000,
+            spsm_not_supported              = 0x0002,
+            no_resources_available          = 0x0004,
+            insufficient_encryption         = 0x0008,
+            invalid_source_cid              = 0x0009,
+            source_cid_already_allocated    = 0x000A,
+            unacceptable_parameters         = 0x000B
+        };
+
+        enum : std::uint16_t {
+            reconfiguration_successful      = 0x0000,
+            mtu_reduction_not_allowed       = 0x0001,
+            mps_reduction_not_allowed       = 0x0002,
+            invalid_destination_cid         = 0x0003,
+            unacceptable_reconfiguration    = 0x0004
+        };
+
+        // the minimum MTU and MPS of a channel, that is opened with an Enhanced Credit Based Connection Request
+        static constexpr std::uint16_t  enhanced_minimum_mtu = 64;
+
+        static constexpr std::uint16_t  first_dynamic_cid   = 0x0040;
+        static constexpr std::uint16_t  last_dynamic_cid    = 0x007F;
+        static constexpr std::size_t    sdu_length_size     = 2;
+
+        // closes the channel; mps is the largest L2CAP payload, that the link layer can receive
+        void reset( std::uint16_t mps )
+        {
+            connected_      = false;
+            enhanced_       = false;
+            disconnect_     = false;
+            mps_            = mps;
+            remote_cid_     = 0;
+            remote_mtu_     = 0;
+            remote_mps_     = 0;
+            rx_credits_     = 0;
+            rx_grant_       = 0;
+            tx_credits_     = 0;
+            tx_state_       = tx_idle;
+
+            if ( rx_state_ == rx_receiving )
+                rx_state_ = rx_waiting;
+        }
+
+        // true, if the channel can be opened with an Enhanced Credit Based Connection Request
+        bool enhanced_credit_based() const
+        {
+            return mtu_ >= enhanced_minimum_mtu && mps_ >= enhanced_minimum_mtu;
+        }
+
+        std::uint16_t connect( std::uint16_t remote_cid, std::uint16_t mtu, std::uint16_t mps, std::uint16_t credits, bool enhanced )
+        {
+            if ( connected_ )
+                return no_resources_available;
+
+            const std::uint16_t minimum = enhanced ? enhanced_minimum_mtu : details::default_att_mtu_size;
+
+            if ( mtu < minimum || mps < minimum )
+                return unacceptable_parameters;
+
+            connected_  = true;
+            enhanced_   = enhanced;
+            remote_cid_ = remote_cid;
+            remote_mtu_ = mtu;
+            remote_mps_ = mps;
+            tx_credits_ = credits;
+
+            grant_first_frame_credit();
+
+            return connection_successful;
+        }
+
+        void disconnected()
+        {
+            reset( mps_ );
+        }
+
+        // new MTU and MPS of the remote device, from a Credit Based Reconfigure Request
+        void reconfigure( std::uint16_t mtu, std::uint16_t mps )
+        {
+            remote_mtu_ = mtu;
+            remote_mps_ = mps;
+        }
+
+        void add_credits( std::uint16_t credits )
+        {
+            tx_credits_ = static_cast< std::uint16_t >( std::min< unsigned >( tx_credits_ + credits, 0xffff ) );
+        }
+
+        // returns the credits, that have to be granted to the remote device
+        std::uint16_t take_credits_to_grant()
+        {
+            return take_credits_to_grant( rx_grant_ );
+        }
+
+        // returns up to max credits; the rest is granted later
+        std::uint16_t take_credits_to_grant( std::uint16_t max )
+        {
+            const std::uint16_t result = std::min( rx_grant_, max );
+            rx_grant_ = static_cast< std::uint16_t >( rx_grant_ - result );
+
+            return result;
+        }
+
+        // the credits, that are not granted to the remote device yet
+        std::uint16_t credits_to_grant() const
+        {
+            return rx_grant_;
+        }
+
+        // a received K-frame; returns false, if the remote device violated the protocol
+        bool input( const std::uint8_t* frame, std::size_t size )
+        {
+            if ( !connected_ || rx_credits_ == 0 || size > mps_ )
+                return false;
+
+            --rx_credits_;
+
+            if ( rx_state_ == rx_waiting )
+            {
+                if ( size < sdu_length_size )
+                    return false;
+
+                rx_size_     = ::bluetoe::details::read_16bit( frame );
+                rx_received_ = 0;
+                rx_state_    = rx_receiving;
+
+                frame += sdu_length_size;
+                size  -= sdu_length_size;
+
+                if ( rx_size_ > mtu_ )
+                    return false;
+            }
+            else if ( rx_state_ != rx_receiving )
+            {
+                return false;
+            }
+
+            if ( rx_received_ + size > rx_size_ )
+                return false;
+
+            std::copy( frame, frame + size, rx_buffer_ + rx_received_ );
+            rx_received_ += size;
+
+            if ( rx_received_ == rx_size_ )
+            {
+                rx_state_ = rx_complete;
+            }
+            else
+            {
+                // credits for the rest of the SDU, assuming K-frames of MPS size. If the remote device sends smaller
+                // frames, it will get more credits later, but it never holds credits for the next SDU, that
+                // could not be stored.
+                const std::size_t frames_needed = ( rx_size_ - rx_received_ + mps_ - 1 ) / mps_;
+
+                if ( frames_needed > rx_credits_ )
+                    grant( static_cast< std::uint16_t >( frames_needed - rx_credits_ ) );
+            }
+
+            return true;
+        }
+
+        // the next K-frame to transmit. output contains the SDU length of the first K-frame, the SDU itself is
+        // passed by reference.
+        void output( std::uint8_t* output, std::size_t& out_size, ::bluetoe::details::output_reference& reference )
+        {
+            // the link layer calls output() only, after the last K-frame was completely copied to the link layer
+            if ( tx_state_ == tx_flushing )
+                tx_state_ = tx_idle;
+
+            if ( tx_state_ != tx_segmenting || tx_credits_ == 0 )
+            {
+                out_size = 0;
+                return;
+            }
+
+            const std::size_t max_frame = std::min< std::size_t >( remote_mps_, out_size );
+            std::size_t       header    = 0;
+
+            if ( tx_sent_ == 0 )
+            {
+                ::bluetoe::details::write_16bit( output, static_cast< std::uint16_t >( tx_size_ ) );
+                header = sdu_length_size;
+            }
+
+            const std::size_t chunk = std::min( max_frame - header, tx_size_ - tx_sent_ );
+
+            reference = ::bluetoe::details::output_reference( tx_sdu_ + tx_sent_, chunk );
+            out_size  = header;
+
+            tx_sent_ += chunk;
+            --tx_credits_;
+
+            if ( tx_sent_ == tx_size_ )
+                tx_state_ = tx_flushing;
+        }
+
+        void grant( std::uint16_t credits )
+        {
+            rx_credits_ = static_cast< std::uint16_t >( rx_credits_ + credits );
+            rx_grant_   = static_cast< std::uint16_t >( rx_grant_ + credits );
+        }
+
+        void grant_first_frame_credit()
+        {
+            if ( connected_ && rx_state_ == rx_waiting && rx_credits_ == 0 )
+                grant( 1 );
+        }
+
+        const std::uint16_t spsm_;
+        const std::uint16_t mtu_;
+        const bool          le_credit_based_;
+        const bool          requires_encryption_;
+        std::uint16_t       mps_;
+
+        bool                connected_;
+        // opened with an Enhanced Credit Based Connection Request
+        bool                enhanced_;
+        // the channel has to be disconnected, because of a protocol violation by the remote device
+        bool                disconnect_;
+        std::uint16_t       remote_cid_;
+        std::uint16_t       remote_mtu_;
+        std::uint16_t       remote_mps_;
+
+        std::uint8_t*       rx_buffer_;
+        std::size_t         rx_size_;
+        std::size_t         rx_received_;
+        // credits, the remote device has, and credits, that are not send to the remote device yet
+        std::uint16_t       rx_credits_;
+        std::uint16_t       rx_grant_;
+
+        enum {
+            rx_no_buffer,
+            rx_waiting,
+            rx_receiving,
+            rx_complete
+        }                   rx_state_;
+
+        const std::uint8_t* tx_sdu_;
+        std::size_t         tx_size_;
+        std::size_t         tx_sent_;
+        std::uint16_t       tx_credits_;
+
+        enum {
+            tx_idle,
+            tx_segmenting,
+            tx_flushing
+        }                   tx_state_;
+    };
+    /** @endcond */
+
+    /**
+     * @brief an L2CAP LE Credit Based Flow Control channel
+     *
+     * The channel accepts a connection from the remote device for the simplified protocol/service
+     * multiplexer SPSM (0x0080 - 0x00FF for dynamically assigned SPSMs). A channel with an MTU of at least 64
+     * can also be opened with Enhanced Credit Based Flow Control, where a remote device opens up to 5 channels
+     * of the same SPSM with a single request. The channel transports SDUs of up to
+     * MTU octets in both directions. Unlike ATT, there is no request / response scheme and the data rate is
+     * only limited by the number of credits and by the link layer.
+     *
+     * A channel is a statically allocated object, that is bound to the bluetoe::l2cap::signaling_channel with
+     * bluetoe::l2cap::bind_channel. All functions of the channel have to be called from the same context, that
+     * calls bluetoe::link_layer::link_layer::run().
+     *
+     * SDUs are received directly into buffers provided by the application (receive()), without an intermediate
+     * copy. The remote device gets credits only, when the application provided a buffer. This way, a slow
+     * application slows down the remote device, instead of losing data. SDUs to be transmitted are copied
+     * directly from the application buffer into the link layer PDUs.
+     *
+     * Example:
+     * @code
+    bluetoe::l2cap::credit_based_channel< 0x0080, 512 > log_channel;
+
+    std::uint8_t buffer[ 512 ];
+
+    using link_layer = bluetoe::nrf51<
+        gatt,
+        bluetoe::l2cap::signaling_channel<
+            bluetoe::l2cap::bind_channel< decltype( log_channel ), log_channel >
+        >
+    >;
+
+    int main()
+    {
+        log_channel.receive( buffer, sizeof( buffer ) );
+
+        for ( ;; )
+        {
+            gatt_link_layer.run( gatt );
+
+            std::size_t size;
+            if ( log_channel.sdu_received( size ) )
+            {
+                process_log_command( buffer, size );
+                log_channel.receive( buffer, sizeof( buffer ) );
+            }
+        }
+    }
+     * @endcode
+     *
+     * @sa bind_channel
+     * @sa signaling_channel
+     */
+    template < std::uint16_t SPSM, std::uint16_t MTU >
+    class credit_based_channel : public credit_based_channel_base
+    {
+    public:
+        static_assert( MTU >= details::default_att_mtu_size, "the minimum MTU of a credit based channel is 23" );
+
+        /**
+         * @brief a channel is closed by default
+         */
+        credit_based_channel()
+            : credit_based_channel_base( SPSM, MTU, true, false )
+        {
+        }
+    };
+
+    /**
+     * @brief binds a credit_based_channel instance to a signaling_channel
+     *
+     * The local channel identifiers are assigned in the order, in which the channels are bound, starting
+     * with 0x0040.
+     *
+     * @sa credit_based_channel
+     */
+    template < typename Channel, Channel& Obj >
+    struct bind_channel
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        static credit_based_channel_base& channel()
+        {
+            return Obj;
+        }
+
+        typedef ::bluetoe::details::credit_based_channel_meta_type meta_type;
+        /** @endcond */
+    };
+
+    /** @cond HIDDEN_SYMBOLS */
+    template < typename Channels >
+    struct credit_based_channels;
+
+    template <>
+    struct credit_based_channels< std::tuple<> >
+    {
+        static constexpr std::size_t size = 0;
+
+        static credit_based_channel_base* channel( std::size_t )
+        {
+            return nullptr;
+        }
+    };
+
+    template < typename ... Bindings >
+    struct credit_based_channels< std::tuple< Bindings... > >
+    {
+        static constexpr std::size_t size = sizeof...( Bindings );
+
+        static credit_based_channel_base* channel( std::size_t index )
+        {
+            static credit_based_channel_base* const channels[ size ] = { &Bindings::channel()... };
+
+            return index < size ? channels[ index ] : nullptr;
+        }
+    };
+    /** @endcond */
+}
+}
+
+#endif
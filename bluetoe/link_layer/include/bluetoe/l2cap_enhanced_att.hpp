@@ -0,0 +1,120 @@
+#ifndef BLUETOE_LINK_LAYER_L2CAP_ENHANCED_ATT_HPP
+#define BLUETOE_LINK_LAYER_L2CAP_ENHANCED_ATT_HPP
+
+#include "l2cap_credit_based_channel.hpp"
+#include "l2cap_signaling_channel.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace bluetoe {
+namespace l2cap {
+
+    /** @cond HIDDEN_SYMBOLS */
+    static constexpr std::uint16_t enhanced_att_spsm = 0x0027;
+
+    /*
+     * credit based channel of an enhanced ATT bearer, with the buffers for one request and one response. An enhanced
+     * ATT bearer can only be opened with Enhanced Credit Based Flow Control and only on an encrypted link.
+     */
+    template < std::uint16_t MTU >
+    class enhanced_att_channel : public credit_based_channel_base
+    {
+    public:
+        static constexpr std::uint16_t mtu = MTU;
+
+        // the receive buffer is available right from the start, so that the first credit is granted with the connection
+        enhanced_att_channel()
+            : credit_based_channel_base( enhanced_att_spsm, MTU, false, true )
+            , bearer_open( false )
+        {
+            this->receive( receive_buffer, MTU );
+        }
+
+        std::uint8_t    receive_buffer[ MTU ];
+        std::uint8_t    transmit_buffer[ MTU ];
+
+        // set by the link layer, when the ATT bearer state was initialized for the connected channel
+        bool            bearer_open;
+    };
+
+    /*
+     * statically allocated channels of all enhanced ATT bearers
+     */
+    template < std::size_t Bearers, std::uint16_t MTU >
+    struct enhanced_att_channels
+    {
+        static constexpr std::size_t size = Bearers;
+
+        static enhanced_att_channel< MTU >& channel( std::size_t index )
+        {
+            return channels_[ index ];
+        }
+
+        template < std::size_t Index >
+        struct binding
+        {
+            static credit_based_channel_base& channel()
+            {
+                return channels_[ Index ];
+            }
+
+            typedef ::bluetoe::details::credit_based_channel_meta_type meta_type;
+        };
+
+    private:
+        static enhanced_att_channel< MTU > channels_[ Bearers ];
+    };
+
+    template < std::size_t Bearers, std::uint16_t MTU >
+    enhanced_att_channel< MTU > enhanced_att_channels< Bearers, MTU >::channels_[ Bearers ];
+
+    template < std::uint16_t MTU >
+    struct enhanced_att_channels< 0, MTU >
+    {
+        static constexpr std::size_t size = 0;
+
+        static enhanced_att_channel< MTU >& channel( std::size_t );
+    };
+
+    /*
+     * adds the channel bindings to the given signaling channel; without signaling channel, a signaling
+     * channel is added.
+     */
+    template < class SignalingChannel, typename ... Bindings >
+    struct signaling_channel_with_bindings;
+
+    template < typename ... Options, typename ... Bindings >
+    struct signaling_channel_with_bindings< signaling_channel< Options... >, Bindings... >
+    {
+        using type = signaling_channel< Options..., Bindings... >;
+    };
+
+    template < typename ... Bindings >
+    struct signaling_channel_with_bindings< no_signaling_channel, Bindings... >
+    {
+        using type = signaling_channel< Bindings... >;
+    };
+
+    /*
+     * signaling channel, that accepts the channels of all enhanced ATT bearers, in addition to the channels of
+     * the application
+     */
+    template < class SignalingChannel, class Channels, std::size_t Remaining = Channels::size, typename ... Bindings >
+    struct signaling_channel_with_enhanced_att
+        : signaling_channel_with_enhanced_att< SignalingChannel, Channels, Remaining - 1,
+            typename Channels::template binding< Remaining - 1 >, Bindings... >
+    {
+    };
+
+    template < class SignalingChannel, class Channels, typename ... Bindings >
+    struct signaling_channel_with_enhanced_att< SignalingChannel, Channels, 0, Bindings... >
+        : signaling_channel_with_bindings< SignalingChannel, Bindings... >
+    {
+    };
+
+    /** @endcond */
+}
+}
+
+#endif
@@ -4,6 +4,8 @@
 #include <cstdlib>
 #include <cstdint>
 #include "ll_meta_types.hpp"
+#include "l2cap_credit_based_channel.hpp"
+#include <bluetoe/meta_tools.hpp>
 
 namespace bluetoe {
 
@@ -16,7 +18,11 @@ namespace l2cap {
     /**
      * @brief very basic l2cap signaling channel implementation
      *
-     * Currently the implementation allows just for sending connection parameter update requests.
+     * The implementation allows for sending connection parameter update requests and for accepting
+     * LE and Enhanced Credit Based Flow Control channels from the remote device. The channels are passed as
+     * bluetoe::l2cap::bind_channel options.
+     *
+     * @sa credit_based_channel
      */
     template < typename ... Options >
     class signaling_channel
@@ -26,14 +32,40 @@ namespace l2cap {
 
         /**
          * @brief input from the l2cap layer
+         *
+         * encrypted denotes, whether the link is currently encrypted. Channels that require encryption are refused
+         * on an unencrypted link.
          */
-        void signaling_channel_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size );
+        void signaling_channel_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, bool encrypted );
 
         /**
          * @brief output to the l2cap layer
          */
         void signaling_channel_output( std::uint8_t* output, std::size_t& out_size );
 
+        /**
+         * @brief input to the dynamic channel with the given channel identifier
+         *
+         * Returns false, if the channel identifier does not belong to a credit based channel.
+         */
+        bool channel_input( std::uint16_t channel_id, const std::uint8_t* input, std::size_t in_size );
+
+        /**
+         * @brief next K-frame of a credit based channel
+         *
+         * The K-frame consists of out_size octets in output, followed by the referenced data and has to be sent to
+         * the remote channel identifier channel_id. If there is nothing to transmit, out_size and reference are empty.
+         */
+        void channel_output( std::uint8_t* output, std::size_t& out_size, std::uint16_t& channel_id, bluetoe::details::output_reference& reference );
+
+        /**
+         * @brief closes all credit based channels
+         *
+         * To be called, when a connection is established or closed. mps is the largest L2CAP payload, that
+         * the link layer is able to receive.
+         */
+        void reset_channels( std::uint16_t mps );
+
         /**
          * @brief queues a connection parameter update request.
          *
@@ -48,11 +80,38 @@ namespace l2cap {
             bluetoe::link_layer::details::valid_link_layer_option_meta_type {};
         /** @endcond */
     private:
+        using channels = credit_based_channels<
+            typename bluetoe::details::find_all_by_meta_type< bluetoe::details::credit_based_channel_meta_type, Options... >::type >;
+
         void reject_command( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size );
+        void credit_based_connection_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size );
+        void enhanced_connection_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, bool encrypted );
+        std::uint16_t enhanced_connect( std::uint16_t spsm, std::uint16_t remote_cid, std::uint16_t mtu, std::uint16_t mps, std::uint16_t credits, std::uint16_t& local_cid );
+        void reconfigure_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size );
+        void flow_control_credit( const std::uint8_t* input, std::size_t in_size );
+        void disconnection_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size );
+        void channel_command_output( std::uint8_t* output, std::size_t& out_size );
+
+        credit_based_channel_base* channel_by_id( std::uint16_t channel_id ) const;
+        credit_based_channel_base* channel_by_remote_id( std::uint16_t remote_cid ) const;
+        std::uint8_t next_command_identifier();
 
         static constexpr std::uint8_t command_reject_code                       = 0x01;
+        static constexpr std::uint8_t disconnection_request_code                = 0x06;
+        static constexpr std::uint8_t disconnection_response_code               = 0x07;
         static constexpr std::uint8_t connection_parameter_update_request_code  = 0x12;
         static constexpr std::uint8_t connection_parameter_update_response_code = 0x13;
+        static constexpr std::uint8_t credit_based_connection_request_code      = 0x14;
+        static constexpr std::uint8_t credit_based_connection_response_code     = 0x15;
+        static constexpr std::uint8_t flow_control_credit_code                  = 0x16;
+        static constexpr std::uint8_t enhanced_connection_request_code          = 0x17;
+        static constexpr std::uint8_t enhanced_connection_response_code         = 0x18;
+        static constexpr std::uint8_t reconfigure_request_code                  = 0x19;
+        static constexpr std::uint8_t reconfigure_response_code                 = 0x1A;
+
+        static constexpr std::size_t  command_header_size                       = 4;
+        // number of channels, that can be opened or reconfigured with a single request
+        static constexpr std::size_t  max_enhanced_channels                     = 5;
 
         std::uint16_t interval_min_;
         std::uint16_t interval_max_;
@@ -67,6 +126,12 @@ namespace l2cap {
 
         static constexpr std::uint8_t   invalid_identifier = 0x00;
         std::uint8_t identifier_;
+
+        // identifier for commands without response
+        std::uint8_t command_identifier_;
+
+        // index of the channel, that is asked first for output, so that a busy channel can not starve the others
+        std::size_t next_output_channel_;
     };
 
     /**
@@ -78,7 +143,7 @@ namespace l2cap {
         /**
          * @copydoc signaling_channel::signaling_channel_input
          */
-        void signaling_channel_input( const std::uint8_t*, std::size_t, std::uint8_t*, std::size_t& out_size )
+        void signaling_channel_input( const std::uint8_t*, std::size_t, std::uint8_t*, std::size_t& out_size, bool )
         {
             out_size = 0;
         }
@@ -99,6 +164,29 @@ namespace l2cap {
             return false;
         }
 
+        /**
+         * @copydoc signaling_channel::channel_input
+         */
+        bool channel_input( std::uint16_t, const std::uint8_t*, std::size_t )
+        {
+            return false;
+        }
+
+        /**
+         * @copydoc signaling_channel::channel_output
+         */
+        void channel_output( std::uint8_t*, std::size_t& out_size, std::uint16_t&, bluetoe::details::output_reference& )
+        {
+            out_size = 0;
+        }
+
+        /**
+         * @copydoc signaling_channel::reset_channels
+         */
+        void reset_channels( std::uint16_t )
+        {
+        }
+
         /** @cond HIDDEN_SYMBOLS */
         typedef bluetoe::details::signaling_channel_meta_type meta_type;
         /** @endcond */
@@ -108,11 +196,13 @@ namespace l2cap {
     signaling_channel< Options... >::signaling_channel()
         : pending_status_( idle )
         , identifier_( 0x01 )
+        , command_identifier_( 0x80 )
+        , next_output_channel_( 0 )
     {
     }
 
     template < typename ... Options >
-    void signaling_channel< Options... >::signaling_channel_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size )
+    void signaling_channel< Options... >::signaling_channel_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, bool encrypted )
     {
         const std::uint8_t code = in_size > 0 ? input[ 0 ] : 0;
 
@@ -126,6 +216,32 @@ namespace l2cap {
 
             out_size = 0;
         }
+        else if ( code == credit_based_connection_request_code )
+        {
+            credit_based_connection_request( input, in_size, output, out_size );
+        }
+        else if ( code == enhanced_connection_request_code )
+        {
+            enhanced_connection_request( input, in_size, output, out_size, encrypted );
+        }
+        else if ( code == reconfigure_request_code )
+        {
+            reconfigure_request( input, in_size, output, out_size );
+        }
+        else if ( code == flow_control_credit_code )
+        {
+            flow_control_credit( input, in_size );
+            out_size = 0;
+        }
+        else if ( code == disconnection_request_code )
+        {
+            disconnection_request( input, in_size, output, out_size );
+        }
+        else if ( code == disconnection_response_code )
+        {
+            // response to a disconnection of a channel, that was already closed locally
+            out_size = 0;
+        }
         else
         {
             reject_command( input, in_size, output, out_size );
@@ -158,7 +274,7 @@ namespace l2cap {
         }
         else
         {
-            out_size = 0;
+            channel_command_output( output, out_size );
         }
     }
 
@@ -179,6 +295,439 @@ namespace l2cap {
         return false;
     }
 
+    template < typename ... Options >
+    bool signaling_channel< Options... >::channel_input( std::uint16_t channel_id, const std::uint8_t* input, std::size_t in_size )
+    {
+        credit_based_channel_base* const channel = channel_by_id( channel_id );
+
+        if ( channel == nullptr )
+            return false;
+
+        if ( channel->connected() && !channel->disconnect_ && !channel->input( input, in_size ) )
+            channel->disconnect_ = true;
+
+        return true;
+    }
+
+    template < typename ... Options >
+    void signaling_channel< Options... >::channel_output( std::uint8_t* output, std::size_t& out_size, std::uint16_t& channel_id, bluetoe::details::output_reference& reference )
+    {
+        const std::size_t max_size = out_size;
+
+        for ( std::size_t count = 0, index = next_output_channel_; count != channels::size; ++count )
+        {
+            credit_based_channel_base& channel = *channels::channel( index );
+
+            index = index + 1 == channels::size ? 0 : index + 1;
+
+            if ( !channel.connected() || channel.disconnect_ )
+                continue;
+
+            out_size  = max_size;
+            reference = bluetoe::details::output_reference();
+
+            channel.output( output, out_size, reference );
+
+            if ( out_size != 0 || !reference.empty() )
+            {
+                next_output_channel_ = index;
+
+                // K-frames are addressed to the channel endpoint of the remote device
+                channel_id = channel.remote_cid_;
+                return;
+            }
+        }
+
+        out_size = 0;
+    }
+
+    template < typename ... Options >
+    void signaling_channel< Options... >::reset_channels( std::uint16_t mps )
+    {
+        for ( std::size_t index = 0; index != channels::size; ++index )
+            channels::channel( index )->reset( mps );
+
+        next_output_channel_ = 0;
+    }
+
+    template < typename ... Options >
+    void signaling_channel< Options... >::credit_based_connection_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size )
+    {
+        static constexpr std::size_t request_size  = command_header_size + 10;
+        static constexpr std::size_t response_size = command_header_size + 10;
+        assert( out_size >= response_size );
+
+        out_size = 0;
+
+        if ( in_size != request_size || input[ 1 ] == invalid_identifier )
+            return;
+
+        using bluetoe::details::read_16bit;
+        using bluetoe::details::write_16bit;
+
+        const std::uint16_t spsm        = read_16bit( &input[ 4 ] );
+        const std::uint16_t remote_cid  = read_16bit( &input[ 6 ] );
+        const std::uint16_t mtu         = read_16bit( &input[ 8 ] );
+        const std::uint16_t mps         = read_16bit( &input[ 10 ] );
+        const std::uint16_t credits     = read_16bit( &input[ 12 ] );
+
+        std::uint16_t               result      = credit_based_channel_base::spsm_not_supported;
+        std::uint16_t               local_cid   = 0;
+        credit_based_channel_base*  channel     = nullptr;
+
+        for ( std::size_t index = 0; index != channels::size; ++index )
+        {
+            credit_based_channel_base* const candidate = channels::channel( index );
+
+            if ( candidate->connected() && candidate->remote_cid_ == remote_cid )
+            {
+                result = credit_based_channel_base::source_cid_already_allocated;
+                channel = nullptr;
+                break;
+            }
+
+            // several channels can be bound to the same SPSM; prefer the first one, that is not connected yet
+            if ( candidate->spsm_ == spsm && candidate->le_credit_based_ && ( channel == nullptr || ( channel->connected() && !candidate->connected() ) ) )
+            {
+                channel   = candidate;
+                local_cid = static_cast< std::uint16_t >( credit_based_channel_base::first_dynamic_cid + index );
+            }
+        }
+
+        if ( channel )
+        {
+            result = remote_cid < credit_based_channel_base::first_dynamic_cid || remote_cid > credit_based_channel_base::last_dynamic_cid
+                ? static_cast< std::uint16_t >( credit_based_channel_base::invalid_source_cid )
+                : channel->connect( remote_cid, mtu, mps, credits, false );
+        }
+
+        const bool connected = result == credit_based_channel_base::connection_successful;
+
+        out_size = response_size;
+        output[ 0 ] = credit_based_connection_response_code;
+        output[ 1 ] = input[ 1 ];
+        write_16bit( &output[ 2 ], response_size - command_header_size );
+        write_16bit( &output[ 4 ], connected ? local_cid : 0 );
+        write_16bit( &output[ 6 ], connected ? channel->mtu_ : 0 );
+        write_16bit( &output[ 8 ], connected ? channel->mps_ : 0 );
+        write_16bit( &output[ 10 ], connected ? channel->take_credits_to_grant() : 0 );
+        write_16bit( &output[ 12 ], result );
+    }
+
+    template < typename ... Options >
+    void signaling_channel< Options... >::enhanced_connection_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, bool encrypted )
+    {
+        static constexpr std::size_t request_header_size  = command_header_size + 8;
+        static constexpr std::size_t response_header_size = command_header_size + 8;
+        assert( out_size >= response_header_size + 2 * max_enhanced_channels );
+
+        const std::size_t number_of_cids = in_size > request_header_size ? ( in_size - request_header_size ) / 2 : 0;
+
+        if ( number_of_cids == 0 || number_of_cids > max_enhanced_channels || in_size != request_header_size + 2 * number_of_cids )
+        {
+            reject_command( input, in_size, output, out_size );
+            return;
+        }
+
+        out_size = 0;
+
+        if ( input[ 1 ] == invalid_identifier )
+            return;
+
+        using bluetoe::details::read_16bit;
+        using bluetoe::details::write_16bit;
+
+        const std::uint16_t spsm        = read_16bit( &input[ 4 ] );
+        const std::uint16_t mtu         = read_16bit( &input[ 6 ] );
+        const std::uint16_t mps         = read_16bit( &input[ 8 ] );
+        const std::uint16_t credits     = read_16bit( &input[ 10 ] );
+
+        std::uint16_t               result          = credit_based_channel_base::connection_successful;
+        credit_based_channel_base*  spsm_channel    = nullptr;
+
+        for ( std::size_t index = 0; index != channels::size && spsm_channel == nullptr; ++index )
+        {
+            if ( channels::channel( index )->spsm_ == spsm && channels::channel( index )->enhanced_credit_based() )
+                spsm_channel = channels::channel( index );
+        }
+
+        if ( spsm_channel == nullptr )
+        {
+            result = credit_based_channel_base::spsm_not_supported;
+        }
+        else if ( mtu < credit_based_channel_base::enhanced_minimum_mtu || mps < credit_based_channel_base::enhanced_minimum_mtu )
+        {
+            result = credit_based_channel_base::unacceptable_parameters;
+        }
+        else if ( spsm_channel->requires_encryption_ && !encrypted )
+        {
+            result = credit_based_channel_base::insufficient_encryption;
+        }
+
+        // if the request as a whole is acceptable, the result is the reason, why the first refused channel was
+        // not opened
+        const bool refused = result != credit_based_channel_base::connection_successful;
+
+        // all channels are opened with the same MTU and initial credits, so the smallest values of all opened
+        // channels are announced and missing credits are granted later.
+        std::uint16_t   local_mtu   = 0xffff;
+        std::uint16_t   initial     = 0xffff;
+        std::size_t     opened      = 0;
+
+        for ( std::size_t cid = 0; cid != number_of_cids; ++cid )
+        {
+            std::uint16_t local_cid = 0;
+
+            if ( !refused )
+            {
+                const std::uint16_t channel_result = enhanced_connect(
+                    spsm, read_16bit( &input[ request_header_size + 2 * cid ] ), mtu, mps, credits, local_cid );
+
+                if ( channel_result != credit_based_channel_base::connection_successful )
+                {
+                    if ( result == credit_based_channel_base::connection_successful )
+                        result = channel_result;
+                }
+                else
+                {
+                    credit_based_channel_base& channel = *channel_by_id( local_cid );
+
+                    local_mtu = std::min( local_mtu, channel.mtu_ );
+                    initial   = std::min( initial, channel.credits_to_grant() );
+                    ++opened;
+                }
+            }
+
+            write_16bit( &output[ response_header_size + 2 * cid ], local_cid );
+        }
+
+        for ( std::size_t cid = 0; cid != number_of_cids; ++cid )
+        {
+            if ( credit_based_channel_base* const channel = channel_by_id( read_16bit( &output[ response_header_size + 2 * cid ] ) ) )
+                channel->take_credits_to_grant( initial );
+        }
+
+        out_size = response_header_size + 2 * number_of_cids;
+        output[ 0 ] = enhanced_connection_response_code;
+        output[ 1 ] = input[ 1 ];
+        write_16bit( &output[ 2 ], static_cast< std::uint16_t >( out_size - command_header_size ) );
+        write_16bit( &output[ 4 ], opened ? local_mtu : 0 );
+        write_16bit( &output[ 6 ], opened ? spsm_channel->mps_ : 0 );
+        write_16bit( &output[ 8 ], opened ? initial : 0 );
+        write_16bit( &output[ 10 ], result );
+    }
+
+    template < typename ... Options >
+    std::uint16_t signaling_channel< Options... >::enhanced_connect( std::uint16_t spsm, std::uint16_t remote_cid, std::uint16_t mtu, std::uint16_t mps, std::uint16_t credits, std::uint16_t& local_cid )
+    {
+        if ( remote_cid < credit_based_channel_base::first_dynamic_cid || remote_cid > credit_based_channel_base::last_dynamic_cid )
+            return credit_based_channel_base::invalid_source_cid;
+
+        if ( channel_by_remote_id( remote_cid ) )
+            return credit_based_channel_base::source_cid_already_allocated;
+
+        for ( std::size_t index = 0; index != channels::size; ++index )
+        {
+            credit_based_channel_base& channel = *channels::channel( index );
+
+            if ( channel.spsm_ == spsm && channel.enhanced_credit_based() && !channel.connected() )
+            {
+                const std::uint16_t result = channel.connect( remote_cid, mtu, mps, credits, true );
+
+                if ( result == credit_based_channel_base::connection_successful )
+                    local_cid = static_cast< std::uint16_t >( credit_based_channel_base::first_dynamic_cid + index );
+
+                return result;
+            }
+        }
+
+        return credit_based_channel_base::no_resources_available;
+    }
+
+    template < typename ... Options >
+    void signaling_channel< Options... >::reconfigure_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size )
+    {
+        static constexpr std::size_t request_header_size = command_header_size + 4;
+        static constexpr std::size_t response_size       = command_header_size + 2;
+        assert( out_size >= response_size );
+
+        const std::size_t number_of_cids = in_size > request_header_size ? ( in_size - request_header_size ) / 2 : 0;
+
+        if ( number_of_cids == 0 || number_of_cids > max_enhanced_channels || in_size != request_header_size + 2 * number_of_cids )
+        {
+            reject_command( input, in_size, output, out_size );
+            return;
+        }
+
+        out_size = 0;
+
+        if ( input[ 1 ] == invalid_identifier )
+            return;
+
+        using bluetoe::details::read_16bit;
+
+        const std::uint16_t mtu = read_16bit( &input[ 4 ] );
+        const std::uint16_t mps = read_16bit( &input[ 6 ] );
+
+        std::uint16_t result = credit_based_channel_base::reconfiguration_successful;
+
+        if ( mtu < credit_based_channel_base::enhanced_minimum_mtu || mps < credit_based_channel_base::enhanced_minimum_mtu )
+            result = credit_based_channel_base::unacceptable_reconfiguration;
+
+        for ( std::size_t cid = 0; cid != number_of_cids && result == credit_based_channel_base::reconfiguration_successful; ++cid )
+        {
+            // the request lists the channel endpoints of the remote device
+            const credit_based_channel_base* const channel = channel_by_remote_id( read_16bit( &input[ request_header_size + 2 * cid ] ) );
+
+            if ( channel == nullptr || !channel->enhanced_ )
+            {
+                result = credit_based_channel_base::invalid_destination_cid;
+            }
+            else if ( mtu < channel->remote_mtu_ )
+            {
+                result = credit_based_channel_base::mtu_reduction_not_allowed;
+            }
+            else if ( mps < channel->remote_mps_ && number_of_cids > 1 )
+            {
+                result = credit_based_channel_base::mps_reduction_not_allowed;
+            }
+        }
+
+        if ( result == credit_based_channel_base::reconfiguration_successful )
+        {
+            for ( std::size_t cid = 0; cid != number_of_cids; ++cid )
+                channel_by_remote_id( read_16bit( &input[ request_header_size + 2 * cid ] ) )->reconfigure( mtu, mps );
+        }
+
+        out_size = response_size;
+        output[ 0 ] = reconfigure_response_code;
+        output[ 1 ] = input[ 1 ];
+        bluetoe::details::write_16bit( &output[ 2 ], response_size - command_header_size );
+        bluetoe::details::write_16bit( &output[ 4 ], result );
+    }
+
+    template < typename ... Options >
+    void signaling_channel< Options... >::flow_control_credit( const std::uint8_t* input, std::size_t in_size )
+    {
+        static constexpr std::size_t indication_size = command_header_size + 4;
+
+        if ( in_size != indication_size )
+            return;
+
+        const std::uint16_t remote_cid  = bluetoe::details::read_16bit( &input[ 4 ] );
+        const std::uint16_t credits     = bluetoe::details::read_16bit( &input[ 6 ] );
+
+        for ( std::size_t index = 0; index != channels::size; ++index )
+        {
+            credit_based_channel_base& channel = *channels::channel( index );
+
+            if ( channel.connected() && channel.remote_cid_ == remote_cid )
+                channel.add_credits( credits );
+        }
+    }
+
+    template < typename ... Options >
+    void signaling_channel< Options... >::disconnection_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size )
+    {
+        static constexpr std::size_t request_size = command_header_size + 4;
+        assert( out_size >= request_size );
+
+        out_size = 0;
+
+        if ( in_size != request_size || input[ 1 ] == invalid_identifier )
+            return;
+
+        const std::uint16_t local_cid   = bluetoe::details::read_16bit( &input[ 4 ] );
+        const std::uint16_t remote_cid  = bluetoe::details::read_16bit( &input[ 6 ] );
+
+        credit_based_channel_base* const channel = channel_by_id( local_cid );
+
+        // requests for unknown channels are silently discarded
+        if ( channel == nullptr || !channel->connected() || channel->remote_cid_ != remote_cid )
+            return;
+
+        channel->disconnected();
+
+        // the response echos the channel identifiers of the request
+        out_size = request_size;
+        std::copy( input, input + request_size, output );
+        output[ 0 ] = disconnection_response_code;
+    }
+
+    template < typename ... Options >
+    void signaling_channel< Options... >::channel_command_output( std::uint8_t* output, std::size_t& out_size )
+    {
+        static constexpr std::size_t command_size = command_header_size + 4;
+        assert( out_size >= command_size );
+
+        out_size = 0;
+
+        for ( std::size_t index = 0; index != channels::size && out_size == 0; ++index )
+        {
+            credit_based_channel_base& channel = *channels::channel( index );
+
+            if ( !channel.connected() )
+                continue;
+
+            const std::uint16_t local_cid = static_cast< std::uint16_t >( credit_based_channel_base::first_dynamic_cid + index );
+
+            if ( channel.disconnect_ )
+            {
+                output[ 0 ] = disconnection_request_code;
+                bluetoe::details::write_16bit( &output[ 4 ], channel.remote_cid_ );
+                bluetoe::details::write_16bit( &output[ 6 ], local_cid );
+
+                channel.disconnected();
+                out_size = command_size;
+            }
+            else if ( const std::uint16_t credits = channel.take_credits_to_grant() )
+            {
+                output[ 0 ] = flow_control_credit_code;
+                bluetoe::details::write_16bit( &output[ 4 ], local_cid );
+                bluetoe::details::write_16bit( &output[ 6 ], credits );
+
+                out_size = command_size;
+            }
+        }
+
+        if ( out_size )
+        {
+            output[ 1 ] = next_command_identifier();
+            bluetoe::details::write_16bit( &output[ 2 ], command_size - command_header_size );
+        }
+    }
+
+    template < typename ... Options >
+    credit_based_channel_base* signaling_channel< Options... >::channel_by_id( std::uint16_t channel_id ) const
+    {
+        return channel_id < credit_based_channel_base::first_dynamic_cid
+            ? nullptr
+            : channels::channel( channel_id - credit_based_channel_base::first_dynamic_cid );
+    }
+
+    template < typename ... Options >
+    credit_based_channel_base* signaling_channel< Options... >::channel_by_remote_id( std::uint16_t remote_cid ) const
+    {
+        for ( std::size_t index = 0; index != channels::size; ++index )
+        {
+            credit_based_channel_base* const channel = channels::channel( index );
+
+            if ( channel->connected() && channel->remote_cid_ == remote_cid )
+                return channel;
+        }
+
+        return nullptr;
+    }
+
+    template < typename ... Options >
+    std::uint8_t signaling_channel< Options... >::next_command_identifier()
+    {
+        // identifiers 0x80 - 0xff are used for commands without response, to not collide with identifier_
+        command_identifier_ = static_cast< std::uint8_t >( command_identifier_ == 0xff ? 0x80 : command_identifier_ + 1 );
+
+        return command_identifier_;
+    }
+
     template < typename ... Options >
     void signaling_channel< Options... >::reject_command( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size )
     {
@@ -2,22 +2,28 @@
 #define BLUETOE_LINK_LAYER_LINK_LAYER_HPP
 
 #include "buffer.hpp"
+#include "ll_data_pdu_buffer.hpp"
 #include "delta_time.hpp"
 #include "ll_options.hpp"
+#include "phy_encodings.hpp"
 #include "address.hpp"
 #include "channel_map.hpp"
 #include "notification_queue.hpp"
 #include "connection_callbacks.hpp"
 #include "connection_event_callback.hpp"
 #include "l2cap_signaling_channel.hpp"
+#include "l2cap_enhanced_att.hpp"
 #include "white_list.hpp"
 #include "advertising.hpp"
+#include "connection_statistics.hpp"
 #include <bluetoe/meta_types.hpp>
 #include <bluetoe/attribute.hpp>
 #include <bluetoe/meta_tools.hpp>
 #include <bluetoe/security_manager.hpp>
 #include <bluetoe/codes.hpp>
 #include <bluetoe/encryption.hpp>
+#include <bluetoe/multiple_notifications.hpp>
+#include <bluetoe/enhanced_att.hpp>
 
 #include <algorithm>
 #include <cassert>
@@ -43,10 +49,15 @@ namespace link_layer {
             static constexpr std::size_t rx_size = s_type::receive_buffer_size;
         };
 
+        // enhanced ATT bearers are only accepted on encrypted links
+        template < class Server >
+        using link_layer_requires_encryption = std::integral_constant< bool,
+            bluetoe::details::requires_encryption_support_t< Server >::value || Server::number_of_enhanced_att_bearers != 0 >;
+
         template < typename Server, typename ... Options >
         struct security_manager {
             using default_sm = typename bluetoe::details::select_type<
-                bluetoe::details::requires_encryption_support_t< Server >::value,
+                link_layer_requires_encryption< Server >::value,
                 bluetoe::security_manager,
                 bluetoe::no_security_manager
             >::type;
@@ -58,11 +69,35 @@ namespace link_layer {
         };
 
         template < typename ... Options >
+        struct bonding {
+            typedef typename bluetoe::details::find_by_meta_type<
+                bluetoe::details::bonding_meta_type,
+                Options...,
+                bluetoe::no_bonding >::type type;
+        };
+
+        template < class Server >
+        struct enhanced_att_channels {
+            typedef bluetoe::l2cap::enhanced_att_channels<
+                Server::number_of_enhanced_att_bearers,
+                Server::enhanced_att_mtu > type;
+        };
+
+        /*
+         * the signaling channel, selected by the options, extended by the channels of the enhanced ATT bearers
+         */
+        template < class Server, typename ... Options >
         struct signaling_channel {
             typedef typename bluetoe::details::find_by_meta_type<
                 bluetoe::details::signaling_channel_meta_type,
                 Options...,
-                bluetoe::l2cap::no_signaling_channel >::type type;
+                bluetoe::l2cap::no_signaling_channel >::type selected;
+
+            typedef typename std::conditional<
+                Server::number_of_enhanced_att_bearers == 0,
+                selected,
+                typename bluetoe::l2cap::signaling_channel_with_enhanced_att<
+                    selected, typename enhanced_att_channels< Server >::type >::type >::type type;
         };
 
         template < typename ... Options >
@@ -111,6 +146,7 @@ namespace link_layer {
                 impl()
                     : has_key_( false )
                     , encryption_in_progress_( false )
+                    , bonded_key_status_( device_pairing_status::no_key )
                 {}
 
                 LinkLayer& that()
@@ -139,6 +175,12 @@ namespace link_layer {
                         bluetoe::details::uint128_t key;
                         std::tie( has_key_, key ) = that().connection_details_.find_key( ediv, rand );
 
+                        // a key from a previous connection with a bonded peer
+                        bonded_key_status_ = device_pairing_status::no_key;
+
+                        if ( !has_key_ )
+                            std::tie( has_key_, key ) = find_bonded_key( ediv, rand );
+
                         // setup encryption
                         std::tie( skds, ivs ) = that().setup_encryption( key, skdm, ivm );
 
@@ -151,6 +193,9 @@ namespace link_layer {
                         fill< layout_t >( write, { LinkLayer::ll_control_pdu_code, 1, LinkLayer::LL_START_ENC_RSP } );
                         that().start_transmit_encrypted();
                         that().connection_details_.is_encrypted( true );
+
+                        if ( bonded_key_status_ != device_pairing_status::no_key )
+                            that().connection_details_.pairing_status( bonded_key_status_ );
                     }
                     else if ( opcode == LinkLayer::LL_PAUSE_ENC_REQ && size == 1 )
                     {
@@ -211,8 +256,22 @@ namespace link_layer {
                 }
 
             private:
-                bool has_key_;
-                bool encryption_in_progress_;
+                std::pair< bool, bluetoe::details::uint128_t > find_bonded_key( std::uint16_t ediv, std::uint64_t rand )
+                {
+                    bluetoe::bond_data bond;
+
+                    if ( that().find_bond( that().connection_details_.remote_address(), bond ) && bond.ediv == ediv && bond.rand == rand )
+                    {
+                        bonded_key_status_ = bond.status;
+                        return { true, bond.long_term_key };
+                    }
+
+                    return std::pair< bool, bluetoe::details::uint128_t >{};
+                }
+
+                bool                    has_key_;
+                bool                    encryption_in_progress_;
+                device_pairing_status   bonded_key_status_;
             };
         };
 
@@ -239,11 +298,733 @@ namespace link_layer {
         template < class Server, class LinkLayer >
         using select_link_layer_security_impl =
             typename bluetoe::details::select_type<
-                bluetoe::details::requires_encryption_support_t< Server >::value,
+                link_layer_requires_encryption< Server >::value,
                 link_layer_security_impl,
                 link_layer_no_security_impl
             >::type::template impl< LinkLayer >;
 
+        /*
+         * If the MTU is larger than the default MTU, L2CAP PDUs have to be segmented into
+         * a start fragment (LLID 2) and continuation fragments (LLID 1) and reassembled on
+         * the receiving side. Buffers for this are only required, if the MTU is configured to
+         * be larger than the default.
+         */
+        struct link_layer_l2cap_fragmentation_impl
+        {
+            template < class LinkLayer, std::size_t MTU >
+            class impl
+            {
+            public:
+                impl()
+                {
+                    reset_l2cap_fragmentation();
+                }
+
+                LinkLayer& that()
+                {
+                    return static_cast< LinkLayer& >( *this );
+                }
+
+                /*
+                 * takes a received LL data PDU (start or continuation fragment) and returns false,
+                 * if the fragment violates the L2CAP framing. If a complete L2CAP PDU was received,
+                 * sdu will point to the L2CAP PDU, including the L2CAP header.
+                 */
+                bool reassemble_l2cap_sdu( std::uint8_t llid, const std::uint8_t* body, std::size_t size, write_buffer& sdu )
+                {
+                    sdu = write_buffer();
+
+                    if ( llid == LinkLayer::lld_data_pdu_code )
+                    {
+                        rx_size_    = 0;
+                        rx_started_ = true;
+
+                        // L2CAP PDU is not fragmented; no need to copy
+                        if ( size >= l2cap_header_size && ::bluetoe::details::read_16bit( body ) + l2cap_header_size == size )
+                        {
+                            rx_started_ = false;
+                            sdu = write_buffer( body, size );
+
+                            return true;
+                        }
+                    }
+                    else if ( !rx_started_ )
+                    {
+                        // continuation fragment without start fragment
+                        return true;
+                    }
+
+                    if ( rx_size_ + size > sizeof( rx_buffer_ ) )
+                        return false;
+
+                    std::copy( body, body + size, &rx_buffer_[ rx_size_ ] );
+                    rx_size_ += size;
+
+                    if ( rx_size_ < l2cap_header_size )
+                        return true;
+
+                    const std::size_t expected_size = ::bluetoe::details::read_16bit( rx_buffer_ ) + l2cap_header_size;
+
+                    if ( rx_size_ > expected_size || expected_size > sizeof( rx_buffer_ ) )
+                        return false;
+
+                    if ( rx_size_ == expected_size )
+                    {
+                        rx_started_ = false;
+                        sdu = write_buffer( rx_buffer_, rx_size_ );
+                    }
+
+                    return true;
+                }
+
+                /*
+                 * returns the buffer, where an L2CAP PDU (including the L2CAP header) should be assembled
+                 */
+                read_buffer l2cap_output_buffer( const read_buffer& )
+                {
+                    return read_buffer{ tx_buffer_, sizeof( tx_buffer_ ) };
+                }
+
+                /*
+                 * segments the L2CAP PDU of the given size, that was assembled in l2cap_output_buffer(), into LL PDUs.
+                 * The first fragment is placed in ll_buffer. The PDU is followed by the referenced data, which is copied
+                 * directly into the LL PDUs and thus has to stay valid, until all fragments are transmitted.
+                 */
+                void commit_l2cap_output( const read_buffer& ll_buffer, std::uint16_t channel, std::size_t size,
+                    const ::bluetoe::details::output_reference& reference = ::bluetoe::details::output_reference() )
+                {
+                    ::bluetoe::details::write_16bit( &tx_buffer_[ 0 ], static_cast< std::uint16_t >( size + reference.size ) );
+                    ::bluetoe::details::write_16bit( &tx_buffer_[ 2 ], channel );
+
+                    tx_size_      = size + reference.size + l2cap_header_size;
+                    tx_send_      = 0;
+                    tx_reference_ = reference;
+
+                    transmit_l2cap_fragments( ll_buffer );
+                }
+
+                /*
+                 * returns true, if not all fragments of the last L2CAP PDU could be placed in the transmit buffer.
+                 */
+                bool l2cap_output_pending() const
+                {
+                    return tx_send_ != tx_size_;
+                }
+
+                void transmit_pending_l2cap_fragments()
+                {
+                    if ( l2cap_output_pending() )
+                        transmit_l2cap_fragments( read_buffer{ nullptr, 0 } );
+                }
+
+                void reset_l2cap_fragmentation()
+                {
+                    rx_size_    = 0;
+                    rx_started_ = false;
+                    tx_size_    = 0;
+                    tx_send_    = 0;
+                    tx_reference_ = ::bluetoe::details::output_reference();
+                }
+
+            private:
+                void transmit_l2cap_fragments( read_buffer out_buffer )
+                {
+                    using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                    while ( tx_send_ != tx_size_ )
+                    {
+                        if ( out_buffer.empty() )
+                            out_buffer = that().allocate_transmit_buffer();
+
+                        if ( out_buffer.empty() )
+                            return;
+
+                        const std::size_t max_fragment = out_buffer.size - layout_t::data_channel_pdu_memory_size( 0 );
+                        const std::size_t fragment     = std::min( max_fragment, tx_size_ - tx_send_ );
+                        const std::uint8_t llid        = tx_send_ == 0
+                            ? LinkLayer::lld_data_pdu_code
+                            : LinkLayer::lld_continuation_pdu_code;
+
+                        layout_t::header( out_buffer, static_cast< std::uint16_t >( llid | fragment << 8 ) );
+                        copy_l2cap_output( tx_send_, fragment, layout_t::body( out_buffer ).first );
+
+                        that().commit_transmit_buffer( out_buffer );
+
+                        tx_send_  += fragment;
+                        out_buffer = read_buffer{ nullptr, 0 };
+                    }
+                }
+
+                // copies size octets, starting at begin, of the L2CAP PDU in tx_buffer_, followed by the referenced data
+                void copy_l2cap_output( std::size_t begin, std::size_t size, std::uint8_t* output ) const
+                {
+                    const std::size_t buffered = tx_size_ - tx_reference_.size;
+
+                    if ( begin < buffered )
+                    {
+                        const std::size_t chunk = std::min( size, buffered - begin );
+                        output = std::copy( &tx_buffer_[ begin ], &tx_buffer_[ begin + chunk ], output );
+
+                        begin += chunk;
+                        size  -= chunk;
+                    }
+
+                    if ( size != 0 )
+                    {
+                        const std::uint8_t* const referenced = tx_reference_.data + ( begin - buffered );
+                        std::copy( referenced, referenced + size, output );
+                    }
+                }
+
+                // the link layer is not complete, when this class is instanciated
+                static constexpr std::size_t l2cap_header_size = 4;
+
+                std::uint8_t    rx_buffer_[ MTU + l2cap_header_size ];
+                std::size_t     rx_size_;
+                bool            rx_started_;
+
+                std::uint8_t    tx_buffer_[ MTU + l2cap_header_size ];
+                std::size_t     tx_size_;
+                std::size_t     tx_send_;
+                ::bluetoe::details::output_reference tx_reference_;
+            };
+        };
+
+        struct link_layer_no_l2cap_fragmentation_impl
+        {
+            template < class LinkLayer, std::size_t MTU >
+            struct impl
+            {
+                LinkLayer& that()
+                {
+                    return static_cast< LinkLayer& >( *this );
+                }
+
+                bool reassemble_l2cap_sdu( std::uint8_t llid, const std::uint8_t* body, std::size_t size, write_buffer& sdu )
+                {
+                    sdu = write_buffer();
+
+                    // continuation fragments are not expected
+                    if ( llid != LinkLayer::lld_data_pdu_code )
+                        return true;
+
+                    if ( size < LinkLayer::l2cap_header_size || ::bluetoe::details::read_16bit( body ) + LinkLayer::l2cap_header_size != size )
+                        return false;
+
+                    sdu = write_buffer( body, size );
+
+                    return true;
+                }
+
+                read_buffer l2cap_output_buffer( const read_buffer& ll_buffer )
+                {
+                    using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                    return read_buffer{ layout_t::body( ll_buffer ).first, ll_buffer.size - layout_t::data_channel_pdu_memory_size( 0 ) };
+                }
+
+                void commit_l2cap_output( const read_buffer& ll_buffer, std::uint16_t channel, std::size_t size,
+                    const ::bluetoe::details::output_reference& reference = ::bluetoe::details::output_reference() )
+                {
+                    using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                    // the referenced data goes directly behind the part of the L2CAP PDU that is already in the buffer
+                    std::uint8_t* const payload = layout_t::body( ll_buffer ).first + LinkLayer::l2cap_header_size;
+                    std::copy( reference.data, reference.data + reference.size, payload + size );
+                    size += reference.size;
+
+                    fill< layout_t >( ll_buffer, {
+                        LinkLayer::lld_data_pdu_code,
+                        static_cast< std::uint8_t >( size + LinkLayer::l2cap_header_size ),
+                        static_cast< std::uint8_t >( size ),
+                        0,
+                        static_cast< std::uint8_t >( channel ),
+                        static_cast< std::uint8_t >( channel >> 8 ) } );
+
+                    that().commit_transmit_buffer( ll_buffer );
+                }
+
+                bool l2cap_output_pending() const
+                {
+                    return false;
+                }
+
+                void transmit_pending_l2cap_fragments()
+                {
+                }
+
+                void reset_l2cap_fragmentation()
+                {
+                }
+            };
+        };
+
+        template < class LinkLayer, typename ... Options >
+        using select_l2cap_fragmentation_impl =
+            typename bluetoe::details::select_type<
+                ( mtu_size< Options... >::mtu > bluetoe::details::default_att_mtu_size ),
+                link_layer_l2cap_fragmentation_impl,
+                link_layer_no_l2cap_fragmentation_impl
+            >::type::template impl< LinkLayer, mtu_size< Options... >::mtu >;
+
+        /*
+         * Data Length Update procedure; only compiled in, if data_length_extension<> is given
+         */
+        struct link_layer_data_length_impl
+        {
+            template < class LinkLayer, class Parameters >
+            class impl
+            {
+            public:
+                impl()
+                {
+                    reset_data_length();
+                }
+
+                LinkLayer& that()
+                {
+                    return static_cast< LinkLayer& >( *this );
+                }
+
+                bool handle_data_length_pdus( std::uint8_t opcode, std::uint8_t size, const std::uint8_t* body, read_buffer write, bool& commit )
+                {
+                    using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                    if ( opcode == LinkLayer::LL_LENGTH_REQ && size == 9 )
+                    {
+                        const std::uint16_t rx_octets = max_rx_octets();
+                        const std::uint16_t tx_octets = max_tx_octets();
+                        const std::uint16_t rx_time   = transmission_time( rx_octets );
+                        const std::uint16_t tx_time   = transmission_time( tx_octets );
+
+                        fill< layout_t >( write, {
+                            LinkLayer::ll_control_pdu_code, 9, LinkLayer::LL_LENGTH_RSP,
+                            static_cast< std::uint8_t >( rx_octets ), static_cast< std::uint8_t >( rx_octets >> 8 ),
+                            static_cast< std::uint8_t >( rx_time ), static_cast< std::uint8_t >( rx_time >> 8 ),
+                            static_cast< std::uint8_t >( tx_octets ), static_cast< std::uint8_t >( tx_octets >> 8 ),
+                            static_cast< std::uint8_t >( tx_time ), static_cast< std::uint8_t >( tx_time >> 8 ) } );
+
+                        // no need to start the procedure from our side anymore
+                        length_request_pending_ = false;
+                        apply_data_length( body );
+                    }
+                    else if ( opcode == LinkLayer::LL_LENGTH_RSP && size == 9 && length_request_running_ )
+                    {
+                        length_request_running_ = false;
+                        commit = false;
+                        apply_data_length( body );
+                    }
+                    else if ( opcode == LinkLayer::LL_UNKNOWN_RSP && size == 2 && body[ 1 ] == LinkLayer::LL_LENGTH_REQ )
+                    {
+                        length_request_running_ = false;
+                        commit = false;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+
+                    return true;
+                }
+
+                void transmit_pending_data_length_pdus()
+                {
+                    using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                    if ( !length_request_pending_ )
+                        return;
+
+                    auto out_buffer = that().allocate_transmit_buffer();
+                    if ( out_buffer.empty() )
+                        return;
+
+                    const std::uint16_t rx_octets = max_rx_octets();
+                    const std::uint16_t tx_octets = max_tx_octets();
+                    const std::uint16_t rx_time   = transmission_time( rx_octets );
+                    const std::uint16_t tx_time   = transmission_time( tx_octets );
+
+                    fill< layout_t >( out_buffer, {
+                        LinkLayer::ll_control_pdu_code, 9, LinkLayer::LL_LENGTH_REQ,
+                        static_cast< std::uint8_t >( rx_octets ), static_cast< std::uint8_t >( rx_octets >> 8 ),
+                        static_cast< std::uint8_t >( rx_time ), static_cast< std::uint8_t >( rx_time >> 8 ),
+                        static_cast< std::uint8_t >( tx_octets ), static_cast< std::uint8_t >( tx_octets >> 8 ),
+                        static_cast< std::uint8_t >( tx_time ), static_cast< std::uint8_t >( tx_time >> 8 ) } );
+
+                    that().commit_transmit_buffer( out_buffer );
+
+                    length_request_pending_ = false;
+                    length_request_running_ = true;
+                }
+
+                void reset_data_length()
+                {
+                    length_request_pending_ = Parameters::max_octets > min_octets;
+                    length_request_running_ = false;
+                }
+
+            private:
+                static constexpr std::uint16_t min_octets       = 27;
+                static constexpr std::uint16_t min_time         = 328;
+                static constexpr std::size_t   ll_header_size   = 2;
+
+                // transmission time on the 1M PHY, including preamble, access address, header and CRC
+                static std::uint16_t transmission_time( std::uint16_t octets )
+                {
+                    return static_cast< std::uint16_t >( ( octets + 14 ) * 8 );
+                }
+
+                static std::uint16_t octets_by_time( std::uint16_t time )
+                {
+                    return time < min_time ? min_octets : static_cast< std::uint16_t >( time / 8 - 14 );
+                }
+
+                std::uint16_t max_octets( std::size_t max_max_size )
+                {
+                    const std::size_t preferred = std::min< std::size_t >( Parameters::max_octets, octets_by_time( Parameters::max_time ) ) + ll_header_size;
+
+                    return static_cast< std::uint16_t >( LinkLayer::ring_buffer_pdu_size(
+                        std::min< std::size_t >( preferred, LinkLayer::radio_t::max_buffer_size ), max_max_size ) - ll_header_size );
+                }
+
+                std::uint16_t max_rx_octets()
+                {
+                    return max_octets( that().max_max_rx_size() );
+                }
+
+                std::uint16_t max_tx_octets()
+                {
+                    return max_octets( that().max_max_tx_size() );
+                }
+
+                void apply_data_length( const std::uint8_t* body )
+                {
+                    const std::uint16_t remote_rx_octets = ::bluetoe::details::read_16bit( &body[ 1 ] );
+                    const std::uint16_t remote_rx_time   = ::bluetoe::details::read_16bit( &body[ 3 ] );
+                    const std::uint16_t remote_tx_octets = ::bluetoe::details::read_16bit( &body[ 5 ] );
+                    const std::uint16_t remote_tx_time   = ::bluetoe::details::read_16bit( &body[ 7 ] );
+
+                    const std::uint16_t tx_octets = std::min( max_tx_octets(), std::min( remote_rx_octets, octets_by_time( remote_rx_time ) ) );
+                    const std::uint16_t rx_octets = std::min( max_rx_octets(), std::min( remote_tx_octets, octets_by_time( remote_tx_time ) ) );
+
+                    that().max_tx_size( std::max( tx_octets, min_octets ) + ll_header_size );
+                    that().max_rx_size( std::max( rx_octets, min_octets ) + ll_header_size );
+                }
+
+                bool length_request_pending_;
+                bool length_request_running_;
+            };
+        };
+
+        struct link_layer_no_data_length_impl
+        {
+            template < class LinkLayer, class Parameters >
+            struct impl
+            {
+                bool handle_data_length_pdus( std::uint8_t, std::uint8_t, const std::uint8_t*, read_buffer, bool& )
+                {
+                    return false;
+                }
+
+                void transmit_pending_data_length_pdus()
+                {
+                }
+
+                void reset_data_length()
+                {
+                }
+            };
+        };
+
+        template < typename ... Options >
+        struct data_length
+        {
+            using parameters = typename bluetoe::details::find_by_meta_type<
+                data_length_meta_type,
+                Options...,
+                bluetoe::details::no_such_type >::type;
+
+            static constexpr bool enabled = !std::is_same< parameters, bluetoe::details::no_such_type >::value;
+        };
+
+        template < class LinkLayer, typename ... Options >
+        using select_data_length_impl =
+            typename bluetoe::details::select_type<
+                data_length< Options... >::enabled,
+                link_layer_data_length_impl,
+                link_layer_no_data_length_impl
+            >::type::template impl< LinkLayer, typename data_length< Options... >::parameters >;
+
+        /*
+         * PHY Update procedure; only compiled in, if the scheduled radio supports the LE 2M PHY
+         */
+        struct link_layer_phy_update_impl
+        {
+            template < class LinkLayer >
+            class impl
+            {
+            public:
+                impl()
+                    : phy_request_pending_( true )
+                    , receiving_phy_( phy_ll_encoding::le_1m_phy )
+                    , transmitting_phy_( phy_ll_encoding::le_1m_phy )
+                {
+                }
+
+                LinkLayer& that()
+                {
+                    return static_cast< LinkLayer& >( *this );
+                }
+
+                bool handle_phy_pdus( std::uint8_t opcode, std::uint8_t size, const std::uint8_t* body, read_buffer write, bool& commit )
+                {
+                    using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                    if ( opcode == LinkLayer::LL_PHY_REQ && size == 3 )
+                    {
+                        fill< layout_t >( write, {
+                            LinkLayer::ll_control_pdu_code, 3, LinkLayer::LL_PHY_RSP,
+                            supported_phys, supported_phys } );
+
+                        // the master is in charge of the procedure now
+                        phy_request_pending_ = false;
+                    }
+                    else if ( opcode == LinkLayer::LL_UNKNOWN_RSP && size == 2 && body[ 1 ] == LinkLayer::LL_PHY_REQ )
+                    {
+                        phy_request_pending_ = false;
+                        commit = false;
+                    }
+                    else if ( opcode == LinkLayer::LL_REJECT_EXT_IND && size == 3 && body[ 1 ] == LinkLayer::LL_PHY_REQ )
+                    {
+                        commit = false;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+
+                    return true;
+                }
+
+                void transmit_pending_phy_pdus()
+                {
+                    using layout_t = typename pdu_layout_by_radio< typename LinkLayer::radio_t >::pdu_layout;
+
+                    if ( !phy_request_pending_ )
+                        return;
+
+                    auto out_buffer = that().allocate_transmit_buffer();
+                    if ( out_buffer.empty() )
+                        return;
+
+                    fill< layout_t >( out_buffer, {
+                        LinkLayer::ll_control_pdu_code, 3, LinkLayer::LL_PHY_REQ,
+                        phy_ll_encoding::le_2m_phy, phy_ll_encoding::le_2m_phy } );
+
+                    that().commit_transmit_buffer( out_buffer );
+
+                    phy_request_pending_ = false;
+                }
+
+                // body of a LL_PHY_UPDATE_IND, that reached its instant
+                void apply_phy_update( const std::uint8_t* body )
+                {
+                    if ( body[ 1 ] != phy_ll_encoding::le_unchanged_phy )
+                        receiving_phy_ = static_cast< phy_ll_encoding::phy_ll_encoding_t >( body[ 1 ] );
+
+                    if ( body[ 2 ] != phy_ll_encoding::le_unchanged_phy )
+                        transmitting_phy_ = static_cast< phy_ll_encoding::phy_ll_encoding_t >( body[ 2 ] );
+
+                    that().radio_set_phy( receiving_phy_, transmitting_phy_ );
+                }
+
+                // called, when a connection is established or closed; advertising and every new connection start on LE 1M
+                void reset_phy_update()
+                {
+                    phy_request_pending_ = true;
+
+                    if ( receiving_phy_ == phy_ll_encoding::le_1m_phy && transmitting_phy_ == phy_ll_encoding::le_1m_phy )
+                        return;
+
+                    receiving_phy_       = phy_ll_encoding::le_1m_phy;
+                    transmitting_phy_    = phy_ll_encoding::le_1m_phy;
+
+                    that().radio_set_phy( receiving_phy_, transmitting_phy_ );
+                }
+
+            private:
+                static constexpr std::uint8_t supported_phys = phy_ll_encoding::le_1m_phy | phy_ll_encoding::le_2m_phy;
+
+                bool                                phy_request_pending_;
+                phy_ll_encoding::phy_ll_encoding_t  receiving_phy_;
+                phy_ll_encoding::phy_ll_encoding_t  transmitting_phy_;
+            };
+        };
+
+        struct link_layer_no_phy_update_impl
+        {
+            template < class LinkLayer >
+            struct impl
+            {
+                bool handle_phy_pdus( std::uint8_t, std::uint8_t, const std::uint8_t*, read_buffer, bool& )
+                {
+                    return false;
+                }
+
+                void transmit_pending_phy_pdus()
+                {
+                }
+
+                void apply_phy_update( const std::uint8_t* )
+                {
+                }
+
+                void reset_phy_update()
+                {
+                }
+            };
+        };
+
+        template < class Radio >
+        struct radio_supports_2mbit
+        {
+            template < class R >
+            static constexpr bool check( decltype( R::hardware_supports_2mbit )* ) { return R::hardware_supports_2mbit; }
+
+            template < class R >
+            static constexpr bool check( ... ) { return false; }
+
+            static constexpr bool value = check< Radio >( nullptr );
+        };
+
+        template < typename Radio >
+        struct radio_supports_slave_latency
+        {
+            template < class R >
+            static constexpr bool check( decltype( R::hardware_supports_slave_latency )* ) { return R::hardware_supports_slave_latency; }
+
+            template < class R >
+            static constexpr bool check( ... ) { return false; }
+
+            static constexpr bool value = check< Radio >( nullptr );
+        };
+
+        template < bool SlaveLatencySupported >
+        struct reschedule_connection_event_impl
+        {
+            // the connection event state is shared with the radio ISR
+            template < class Radio >
+            using lock_guard = typename Radio::lock_guard;
+
+            template < class Radio >
+            static bool reschedule( Radio& radio, unsigned channel, delta_time start_receive, delta_time end_receive, delta_time connection_interval )
+            {
+                return radio.reschedule_connection_event( channel, start_receive, end_receive, connection_interval );
+            }
+        };
+
+        template <>
+        struct reschedule_connection_event_impl< false >
+        {
+            template < class Radio >
+            using lock_guard = no_lock_guard;
+
+            template < class Radio >
+            static bool reschedule( Radio&, unsigned, delta_time, delta_time, delta_time )
+            {
+                return false;
+            }
+        };
+
+        template < class Radio, class LinkLayer >
+        using select_phy_update_impl =
+            typename bluetoe::details::select_type<
+                radio_supports_2mbit< Radio >::value,
+                link_layer_phy_update_impl,
+                link_layer_no_phy_update_impl
+            >::type::template impl< LinkLayer >;
+
+        /*
+         * multiple notifications per connection event
+         */
+        struct link_layer_multiple_notifications_impl
+        {
+            template < class LinkLayer, class Parameters >
+            class impl
+            {
+            public:
+                impl()
+                {
+                    reset_notifications_per_event();
+                }
+
+                LinkLayer& that()
+                {
+                    return static_cast< LinkLayer& >( *this );
+                }
+
+                void transmit_notifications()
+                {
+                    if ( event_counter_ != that().conn_event_counter_ )
+                    {
+                        event_counter_  = that().conn_event_counter_;
+                        transmitted_    = 0;
+                    }
+
+                    // stops, when the queue is empty or the transmit buffer is full
+                    while ( ( Parameters::max_per_event == 0 || transmitted_ < Parameters::max_per_event )
+                        && that().transmit_notification() )
+                    {
+                        ++transmitted_;
+                    }
+                }
+
+                void reset_notifications_per_event()
+                {
+                    event_counter_ = 0;
+                    transmitted_   = 0;
+                }
+
+            private:
+                std::uint16_t   event_counter_;
+                std::size_t     transmitted_;
+            };
+        };
+
+        struct link_layer_single_notification_impl
+        {
+            template < class LinkLayer, class Parameters >
+            struct impl
+            {
+                void transmit_notifications()
+                {
+                    static_cast< LinkLayer& >( *this ).transmit_notification();
+                }
+
+                void reset_notifications_per_event()
+                {
+                }
+            };
+        };
+
+        template < typename ... Options >
+        struct notifications_per_event
+        {
+            using parameters = typename bluetoe::details::find_by_meta_type<
+                notifications_per_event_meta_type,
+                Options...,
+                bluetoe::details::no_such_type >::type;
+
+            static constexpr bool enabled = !std::is_same< parameters, bluetoe::details::no_such_type >::value;
+        };
+
+        template < class LinkLayer, typename ... Options >
+        using select_notifications_per_event_impl =
+            typename bluetoe::details::select_type<
+                notifications_per_event< Options... >::enabled,
+                link_layer_multiple_notifications_impl,
+                link_layer_single_notification_impl
+            >::type::template impl< LinkLayer, typename notifications_per_event< Options... >::parameters >;
+
         template < typename >
         struct option_passed_to_link_layer_that_is_not_a_valid_option_for_the_link_layer;
 
@@ -253,17 +1034,36 @@ namespace link_layer {
         > {};
     }
 
+    /** @cond HIDDEN_SYMBOLS */
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    class link_layer;
+
+    namespace details {
+        template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+        struct callback_collects_connection_statistics< link_layer< Server, ScheduledRadio, Options... > >
+        {
+            static constexpr bool value = connection_statistics_impl< Options... >::type::collects_connection_statistics;
+        };
+    }
+    /** @endcond */
+
     /**
      * @brief link layer implementation
      *
      * Implements a binding to a server by implementing a link layer on top of a ScheduleRadio device.
      *
+     * If the ScheduleRadio supports moving a scheduled connection event (hardware_supports_slave_latency), the link layer
+     * skips up to slave latency connection events, as long as there is nothing to transmit. Queuing a notification or
+     * indication, or any other output, ends the skipping with the next connection event, that did not already pass.
+     *
      * @sa connectable_undirected_advertising
      * @sa connectable_directed_advertising
      * @sa scannable_undirected_advertising
      * @sa non_connectable_undirected_advertising
      * @sa auto_start_advertising
      * @sa no_auto_start_advertising
+     * @sa bonding
+     * @sa connection_statistics
      */
     template <
         class Server,
@@ -282,6 +1082,8 @@ namespace link_layer {
             link_layer< Server, ScheduledRadio, Options... >
         >,
         public details::security_manager< Server, Options... >::type,
+        public details::bonding< Options... >::type,
+        public details::connection_statistics_impl< Options... >::type,
         public details::white_list<
             ScheduledRadio<
                 details::buffer_sizes< Options... >::tx_size,
@@ -294,8 +1096,18 @@ namespace link_layer {
             link_layer< Server, ScheduledRadio, Options... >,
             Options... >,
         private details::connection_callbacks< Server, Options... >::type,
-        private details::signaling_channel< Options... >::type,
-        private details::select_link_layer_security_impl< Server, link_layer< Server, ScheduledRadio, Options... > >
+        private details::signaling_channel< Server, Options... >::type,
+        private details::select_link_layer_security_impl< Server, link_layer< Server, ScheduledRadio, Options... > >,
+        private details::select_l2cap_fragmentation_impl< link_layer< Server, ScheduledRadio, Options... >, Options... >,
+        private details::select_data_length_impl< link_layer< Server, ScheduledRadio, Options... >, Options... >,
+        private details::select_phy_update_impl<
+            ScheduledRadio<
+                details::buffer_sizes< Options... >::tx_size,
+                details::buffer_sizes< Options... >::rx_size,
+                link_layer< Server, ScheduledRadio, Options... >
+            >,
+            link_layer< Server, ScheduledRadio, Options... > >,
+        private details::select_notifications_per_event_impl< link_layer< Server, ScheduledRadio, Options... >, Options... >
     {
     public:
         link_layer();
@@ -347,10 +1159,39 @@ namespace link_layer {
          */
         void disconnect();
 
+        /**
+         * @brief sets the value of a single AD structure within the advertising data
+         *
+         * If the advertising data already contains an AD structure of the given type with the same size, only the value is
+         * replaced. Otherwise, an existing AD structure of the given type is removed and the new AD structure is appended to the
+         * advertising data. This applies to the AD structures supplied by the server (like the flags) too. This allows to change
+         * a value (like a counter within the manufacturer specific data) with every advertising event without encoding the whole
+         * advertising data again.
+         *
+         * The new advertising data is build in a second buffer and is handed over to the radio callbacks under the radio lock.
+         * If the link layer is currently advertising, the change becomes effective with the next advertising event.
+         *
+         * The function returns false and leaves the advertising data unchanged, if the resulting advertising data would not fit
+         * into an advertising PDU, or if the link layer was not started yet (as the advertising data of the server is not known
+         * before).
+         *
+         * @param ad_type the AD type of the structure (0xff for manufacturer specific data for example)
+         * @param value the AD data
+         * @param size the size of the AD data in octets
+         */
+        bool update_advertising_data( std::uint8_t ad_type, const std::uint8_t* value, std::size_t size );
+
         /**
          * @brief fills the given buffer with l2cap advertising payload
+         *
+         * The advertising data of the server is encoded only once and cached afterwards.
          */
-        std::size_t fill_l2cap_advertising_data( std::uint8_t* buffer, std::size_t buffer_size ) const;
+        std::size_t fill_l2cap_advertising_data( std::uint8_t* buffer, std::size_t buffer_size );
+
+        /**
+         * @brief returns true, if update_advertising_data() changed the advertising data since the last call to fill_l2cap_advertising_data()
+         */
+        bool advertising_data_changed() const;
 
         /**
          * @brief returns the own local device address
@@ -364,9 +1205,22 @@ namespace link_layer {
 
         using layout_t = typename pdu_layout_by_radio< radio_t >::pdu_layout;
 
+        /**
+         * @brief true, if the Channel Selection Algorithm #2 is supported
+         */
+        static constexpr bool channel_selection_algorithm_2_supported =
+            !std::is_same< typename ::bluetoe::details::find_by_meta_type<
+                details::channel_selection_algorithm_meta_type,
+                Options...,
+                ::bluetoe::details::no_such_type >::type, ::bluetoe::details::no_such_type >::value;
+
     private:
 
         friend details::select_link_layer_security_impl< Server, link_layer< Server, ScheduledRadio, Options... > >;
+        friend details::select_l2cap_fragmentation_impl< link_layer< Server, ScheduledRadio, Options... >, Options... >;
+        friend details::select_data_length_impl< link_layer< Server, ScheduledRadio, Options... >, Options... >;
+        friend details::select_phy_update_impl< radio_t, link_layer< Server, ScheduledRadio, Options... > >;
+        friend details::select_notifications_per_event_impl< link_layer< Server, ScheduledRadio, Options... >, Options... >;
 
         static constexpr auto options_test = sizeof(
             details::option_passed_to_link_layer_that_is_not_a_valid_option_for_the_link_layer<
@@ -377,10 +1231,14 @@ namespace link_layer {
             > );
 
         // make sure, that the hardware supports encryption
-        static constexpr bool encryption_required = bluetoe::details::requires_encryption_support_t< Server >::value;
+        static constexpr bool encryption_required = details::link_layer_requires_encryption< Server >::value;
         static_assert( !encryption_required || ( encryption_required && radio_t::hardware_supports_encryption ),
             "The GATT server requires encryption while the selecte hardware binding doesn't provide support for encryption!" );
 
+        // enhanced ATT bearers are opened with Enhanced Credit Based Flow Control, which requires an MPS of at least 64
+        static_assert( Server::number_of_enhanced_att_bearers == 0 || details::mtu_size< Options... >::mtu >= bluetoe::details::enhanced_att_minimum_mtu,
+            "Enhanced ATT bearers require a max_mtu_size<> of at least 64" );
+
         typedef typename details::security_manager< Server, Options... >::type security_manager_t;
 
         typedef notification_queue<
@@ -389,7 +1247,9 @@ namespace link_layer {
 
         typedef typename security_manager_t::template connection_data< notification_queue_t > connection_details_t;
 
-        typedef typename details::signaling_channel< Options... >::type signaling_channel_t;
+        typedef typename details::signaling_channel< Server, Options... >::type signaling_channel_t;
+
+        typedef typename details::enhanced_att_channels< Server >::type enhanced_att_channels_t;
 
         typedef details::select_advertiser_implementation<
             link_layer< Server, ScheduledRadio, Options... >, Options... > advertising_t;
@@ -401,8 +1261,22 @@ namespace link_layer {
         void force_disconnect();
         void start_advertising_impl();
         void wait_for_connection_event();
-        void transmit_notifications();
+        unsigned connection_events_to_skip() const;
+        void cancel_slave_latency();
+        void request_slave_latency_cancellation();
+        bool transmit_notification();
+        std::size_t multiple_notifications_output( std::uint8_t* output, std::size_t out_size, std::size_t first_index );
+        void transmit_pending_att_response();
+        // without enhanced ATT bearers, there are no channels to be served
+        using enhanced_att_enabled = std::integral_constant< bool, enhanced_att_channels_t::size != 0 >;
+        void transmit_enhanced_att_output( std::false_type ) {}
+        void transmit_enhanced_att_output( std::true_type );
+        bool enhanced_att_bearer_output( std::size_t index );
+        void reset_enhanced_att_bearers( std::false_type ) {}
+        void reset_enhanced_att_bearers( std::true_type );
         void transmit_signaling_channel_output();
+        void transmit_credit_based_channels_output();
+        void transmit_security_manager_output();
         void transmit_pending_control_pdus();
 
         static bool lcap_notification_callback( const ::bluetoe::details::notification_data& item, void* usr_arg, typename Server::notification_type type );
@@ -416,6 +1290,11 @@ namespace link_layer {
         ll_result send_control_pdus();
         ll_result handle_ll_control_data( const write_buffer& pdu, read_buffer output );
         ll_result handle_l2cap( const write_buffer& pdu, const read_buffer& output );
+        void adjust_pdu_sizes_to_mtu();
+        void cache_advertising_data();
+        static std::size_t significant_advertising_data_size( const std::uint8_t* data, std::size_t size );
+        static std::size_t find_advertising_data( const std::uint8_t* data, std::size_t size, std::uint8_t ad_type );
+        static std::size_t ring_buffer_pdu_size( std::size_t pdu_size, std::size_t max_max_size );
         ll_result handle_pending_ll_control();
 
         connection_details details() const;
@@ -430,6 +1309,8 @@ namespace link_layer {
 
         static constexpr std::uint8_t   ll_control_pdu_code         = 3;
         static constexpr std::uint8_t   lld_data_pdu_code           = 2;
+        static constexpr std::uint8_t   lld_continuation_pdu_code   = 1;
+        static constexpr std::uint16_t  connect_request_chsel_field = 0x20;
 
         static constexpr std::uint8_t   LL_CONNECTION_UPDATE_REQ    = 0x00;
         static constexpr std::uint8_t   LL_CHANNEL_MAP_REQ          = 0x01;
@@ -449,6 +1330,12 @@ namespace link_layer {
         static constexpr std::uint8_t   LL_CONNECTION_PARAM_RSP     = 0x10;
         static constexpr std::uint8_t   LL_PING_REQ                 = 0x12;
         static constexpr std::uint8_t   LL_PING_RSP                 = 0x13;
+        static constexpr std::uint8_t   LL_LENGTH_REQ               = 0x14;
+        static constexpr std::uint8_t   LL_LENGTH_RSP               = 0x15;
+        static constexpr std::uint8_t   LL_REJECT_EXT_IND           = 0x11;
+        static constexpr std::uint8_t   LL_PHY_REQ                  = 0x16;
+        static constexpr std::uint8_t   LL_PHY_RSP                  = 0x17;
+        static constexpr std::uint8_t   LL_PHY_UPDATE_IND           = 0x18;
 
         static constexpr std::uint8_t   LL_VERSION_NR               = 0x08;
         static constexpr std::uint8_t   LL_VERSION_40               = 0x06;
@@ -475,13 +1362,28 @@ namespace link_layer {
             };
         };
 
+        // second octet of the feature set
+        struct link_layer_feature_2 {
+            enum : std::uint8_t {
+                le_2m_phy                               = 0x01
+            };
+        };
+
         static constexpr std::uint8_t   supported_features =
             link_layer_feature::connection_parameters_request_procedure |
             link_layer_feature::le_ping |
-            ( bluetoe::details::requires_encryption_support_t< Server >::value
+            ( details::link_layer_requires_encryption< Server >::value
                 ? link_layer_feature::le_encryption
+                : 0 ) |
+            ( details::data_length< Options... >::enabled
+                ? link_layer_feature::le_data_packet_length_extension
                 : 0 );
 
+        static constexpr std::uint8_t   supported_features_2 =
+            details::radio_supports_2mbit< radio_t >::value
+                ? link_layer_feature_2::le_2m_phy
+                : 0;
+
         // TODO: calculate the actual needed buffer size for advertising, not the maximum
         static_assert( radio_t::size >= advertising_t::maximum_required_advertising_buffer(), "buffer to small" );
 
@@ -500,6 +1402,8 @@ namespace link_layer {
         write_buffer                    defered_ll_control_pdu_;
         unsigned                        timeouts_til_connection_lost_;
         unsigned                        max_timeouts_til_connection_lost_;
+        unsigned                        skipped_connection_events_;
+        volatile bool                   slave_latency_cancellation_requested_;
         Server*                         server_;
         connection_details_t            connection_details_;
         bool                            termination_send_;
@@ -522,6 +1426,14 @@ namespace link_layer {
         bool                            connection_parameters_request_pending_;
         bool                            connection_parameters_request_running_;
 
+        static constexpr std::size_t    max_advertising_data_size   = 31;
+
+        // server advertising data, changed by update_advertising_data()
+        std::uint8_t                    advertising_data_[ max_advertising_data_size ];
+        std::size_t                     advertising_data_size_;
+        bool                            advertising_data_cached_;
+        volatile bool                   advertising_data_changed_;
+
         // default configuration parameters
         typedef                         advertising_interval< 100 >         default_advertising_interval;
         typedef                         sleep_clock_accuracy_ppm< 500 >     default_sleep_clock_accuracy;
@@ -547,12 +1459,17 @@ namespace link_layer {
         : address_( local_device_address::address( *this ) )
         , current_channel_index_( first_advertising_channel )
         , defered_ll_control_pdu_{ nullptr, 0 }
+        , skipped_connection_events_( 0 )
+        , slave_latency_cancellation_requested_( false )
         , server_( nullptr )
         , connection_details_( std::size_t{ details::mtu_size< Options... >::mtu } )
         , used_features_( supported_features )
         , state_( state::initial )
         , connection_parameters_request_pending_( false )
         , connection_parameters_request_running_( false )
+        , advertising_data_size_( 0 )
+        , advertising_data_cached_( false )
+        , advertising_data_changed_( false )
     {
     }
 
@@ -572,12 +1489,29 @@ namespace link_layer {
 
         if ( state_ == state::connected )
         {
-            transmit_notifications();
+            this->transmit_pending_l2cap_fragments();
+            transmit_pending_att_response();
+            this->transmit_notifications();
             transmit_signaling_channel_output();
+            transmit_enhanced_att_output( enhanced_att_enabled() );
+            transmit_credit_based_channels_output();
+            transmit_security_manager_output();
             transmit_pending_control_pdus();
+
+            if ( !this->transmit_buffer_empty() )
+                cancel_slave_latency();
+        }
+
+        if ( slave_latency_cancellation_requested_ )
+        {
+            slave_latency_cancellation_requested_ = false;
+            cancel_slave_latency();
         }
 
         this->handle_connection_events();
+
+        // expensive calculations of the security manager (like P-256 key generation) are done, when there is nothing else to do
+        static_cast< security_manager_t& >( *this ).idle_processing( connection_details_, *this );
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
@@ -592,14 +1526,22 @@ namespace link_layer {
         {
             const std::uint8_t* const body = layout_t::body( receive ).first;
 
-            if ( channels_.reset( &body[ 28 ], body[ 33 ] & 0x1f )
-              && parse_timing_parameters_from_connect_request( body ) )
+            const bool algorithm_2 = channel_selection_algorithm_2_supported
+                && ( layout_t::header( receive ) & connect_request_chsel_field );
+
+            const bool valid_channels = algorithm_2
+                ? channels_.reset_algorithm_2( &body[ 28 ], read_32( &body[ 12 ] ) )
+                : channels_.reset( &body[ 28 ], body[ 33 ] & 0x1f );
+
+            if ( valid_channels && parse_timing_parameters_from_connect_request( body ) )
             {
                 state_                    = state::connecting;
                 current_channel_index_    = 0;
                 conn_event_counter_       = 0;
                 cumulated_sleep_clock_accuracy_ = sleep_clock_accuracy( body ) + device_sleep_clock_accuracy::accuracy_ppm;
                 timeouts_til_connection_lost_   = num_windows_til_timeout - 1;
+                skipped_connection_events_      = 0;
+                slave_latency_cancellation_requested_ = false;
                 used_features_            = supported_features;
                 connection_parameters_request_pending_ = false;
                 connection_parameters_request_running_ = false;
@@ -612,8 +1554,9 @@ namespace link_layer {
                 window_end += window_end.ppm( cumulated_sleep_clock_accuracy_ );
 
                 this->reset();
+                this->reset_connection_statistics();
                 this->schedule_connection_event(
-                    channels_.data_channel( current_channel_index_ ),
+                    channels_.data_channel( current_channel_index_, conn_event_counter_ ),
                     window_start,
                     window_end,
                     connection_interval_ );
@@ -623,6 +1566,12 @@ namespace link_layer {
 
                 connection_details_ = connection_details_t( std::size_t{ details::mtu_size< Options... >::mtu } );
                 connection_details_.remote_connection_created( remote_address );
+                this->reset_l2cap_fragmentation();
+                this->reset_channels( details::mtu_size< Options... >::mtu );
+                reset_enhanced_att_bearers( enhanced_att_enabled() );
+                this->reset_data_length();
+                this->reset_phy_update();
+                this->reset_notifications_per_event();
             }
         }
     }
@@ -640,6 +1589,9 @@ namespace link_layer {
     {
         assert( state_ == state::connecting || state_ == state::connected || state_ == state::connection_update || state_ == state::disconnecting );
 
+        skipped_connection_events_ = 0;
+        this->statistics_timeout();
+
         if ( timeouts_til_connection_lost_ )
         {
             current_channel_index_ = ( current_channel_index_ + 1 ) % first_advertising_channel;
@@ -667,6 +1619,9 @@ namespace link_layer {
     {
         assert( state_ == state::connecting || state_ == state::connected || state_ == state::connection_update || state_ == state::disconnecting );
 
+        skipped_connection_events_ = 0;
+        const std::uint32_t start_of_processing = this->statistics_start_processing();
+
         if ( state_ == state::connecting )
         {
             this->connection_established( details(), connection_details_, static_cast< radio_t& >( *this ) );
@@ -688,8 +1643,12 @@ namespace link_layer {
         else
         {
             this->transmit_pending_security_pdus();
+            this->transmit_pending_data_length_pdus();
+            this->transmit_pending_phy_pdus();
             wait_for_connection_event();
         }
+
+        this->statistics_connection_event( start_of_processing );
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
@@ -726,6 +1685,7 @@ namespace link_layer {
         termination_send_ = false;
 
         this->reset_encryption();
+        request_slave_latency_cancellation();
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
@@ -754,6 +1714,12 @@ namespace link_layer {
         }
         else
         {
+            // skipped connection events count like missed events: the window widening grows with the distance to the last anchor
+            skipped_connection_events_     = connection_events_to_skip();
+            current_channel_index_         = ( current_channel_index_ + skipped_connection_events_ ) % first_advertising_channel;
+            conn_event_counter_           += skipped_connection_events_;
+            timeouts_til_connection_lost_ -= skipped_connection_events_;
+
             const delta_time window_target = connection_interval_ * ( max_timeouts_til_connection_lost_ - timeouts_til_connection_lost_ + 1 );
             const delta_time window_size   = window_target.ppm( cumulated_sleep_clock_accuracy_ );
 
@@ -762,7 +1728,7 @@ namespace link_layer {
         }
 
         const delta_time time_till_next_event = this->schedule_connection_event(
-                channels_.data_channel( current_channel_index_ ),
+                channels_.data_channel( current_channel_index_, conn_event_counter_ ),
                 window_start,
                 window_end,
                 connection_interval_ );
@@ -771,58 +1737,206 @@ namespace link_layer {
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
-    void link_layer< Server, ScheduledRadio, Options... >::transmit_notifications()
+    unsigned link_layer< Server, ScheduledRadio, Options... >::connection_events_to_skip() const
+    {
+        // only after a successful connection event, with nothing to transmit and no procedure with an instant pending
+        if ( !details::radio_supports_slave_latency< radio_t >::value
+          || state_ != state::connected
+          || timeouts_til_connection_lost_ != max_timeouts_til_connection_lost_
+          || !defered_ll_control_pdu_.empty()
+          || connection_parameters_request_pending_
+          || this->l2cap_output_pending()
+          || connection_details_.pending()
+          || slave_latency_cancellation_requested_
+          || !this->transmit_buffer_empty() )
+        {
+            return 0;
+        }
+
+        // make sure, that the slave listens at least once, before the connection supervision timeout expires
+        return std::min< unsigned >( slave_latency_, max_timeouts_til_connection_lost_ - 1 );
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::cancel_slave_latency()
+    {
+        using reschedule_impl = details::reschedule_connection_event_impl< details::radio_supports_slave_latency< radio_t >::value >;
+
+        // a connection event, that ends while the scheduled event is moved, would update the very same state
+        typename reschedule_impl::template lock_guard< radio_t > lock;
+
+        const unsigned skipped = skipped_connection_events_;
+
+        if ( skipped == 0 )
+            return;
+
+        skipped_connection_events_ = 0;
+
+        // try to move the connection event to the earliest skipped event, that did not already pass
+        for ( unsigned still_skipped = 0; still_skipped != skipped; ++still_skipped )
+        {
+            const unsigned      back          = skipped - still_skipped;
+            const unsigned      channel_index = ( current_channel_index_ + first_advertising_channel - back % first_advertising_channel ) % first_advertising_channel;
+            const std::uint16_t counter       = static_cast< std::uint16_t >( conn_event_counter_ - back );
+
+            const delta_time window_target = connection_interval_ * ( max_timeouts_til_connection_lost_ - timeouts_til_connection_lost_ - back + 1 );
+            const delta_time window_size   = window_target.ppm( cumulated_sleep_clock_accuracy_ );
+
+            if ( reschedule_impl::reschedule(
+                static_cast< radio_t& >( *this ),
+                channels_.data_channel( channel_index, counter ),
+                window_target - window_size,
+                window_target + window_size,
+                connection_interval_ ) )
+            {
+                current_channel_index_         = channel_index;
+                conn_event_counter_            = counter;
+                timeouts_til_connection_lost_ += back;
+
+                return;
+            }
+        }
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::request_slave_latency_cancellation()
+    {
+        // the connection event state is not touched here, as this might be called from the context of the application;
+        // run() cancels the slave latency and no further connection event will be skipped until then
+        slave_latency_cancellation_requested_ = true;
+
+        // let run() return, so that pending output can be placed in the transmit buffer before the connection event
+        if ( skipped_connection_events_ != 0 )
+            this->wake_up();
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    bool link_layer< Server, ScheduledRadio, Options... >::transmit_notification()
     {
         // first check if we have memory to transmit the message, or otherwise notifications would get lost
         auto out_buffer = this->allocate_transmit_buffer();
 
-        if ( out_buffer.empty() )
-            return;
+        if ( out_buffer.empty() || this->l2cap_output_pending() )
+            return false;
 
         const auto notification = connection_details_.dequeue_indication_or_confirmation();
 
-        if ( notification.first != connection_details_t::entry_type::empty )
+        if ( notification.first == connection_details_t::entry_type::empty )
+            return false;
+
+        const read_buffer l2cap_buffer = this->l2cap_output_buffer( out_buffer );
+        std::size_t   out_size = std::min< std::size_t >( l2cap_buffer.size - l2cap_header_size, connection_details_.negotiated_mtu() );
+        std::uint8_t* out_body = l2cap_buffer.buffer;
+
+        if ( notification.first == connection_details_t::entry_type::notification && Server::multiple_handle_value_notifications_supported( connection_details_ ) )
+        {
+            out_size = multiple_notifications_output( &out_body[ l2cap_header_size ], out_size, notification.second );
+        }
+        else if ( notification.first == connection_details_t::entry_type::notification )
+        {
+            server_->notification_output(
+                &out_body[ l2cap_header_size ],
+                out_size,
+                connection_details_,
+                notification.second
+            );
+        }
+        else
         {
-            std::size_t   out_size = out_buffer.size - all_header_size - layout_t::data_channel_pdu_memory_size( 0 );
-            std::uint8_t* out_body = layout_t::body( out_buffer ).first;
+            server_->indication_output(
+                &out_body[ l2cap_header_size ],
+                out_size,
+                connection_details_,
+                notification.second
+            );
 
-            if ( notification.first == connection_details_t::entry_type::notification )
+            // if no output is generate, confirm the indication, or we will wait for ever
+            if ( out_size == 0 )
+                connection_details_.indication_confirmed();
+
+        }
+
+        if ( out_size )
+            this->commit_l2cap_output( out_buffer, l2cap_att_channel, out_size );
+
+        return true;
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    std::size_t link_layer< Server, ScheduledRadio, Options... >::multiple_notifications_output( std::uint8_t* output, std::size_t out_size, std::size_t index )
+    {
+        static constexpr std::size_t opcode_size = 1;
+        static constexpr std::size_t handle_size = 2;
+        static constexpr std::size_t length_size = 2;
+
+        std::size_t size   = opcode_size;
+        std::size_t tuples = 0;
+
+        for ( bool more = true; more; )
+        {
+            std::size_t tuple_size = out_size - size;
+            const auto  result     = server_->multiple_notification_tuple_output( &output[ size ], tuple_size, connection_details_, index );
+
+            if ( result == ::bluetoe::details::notification_tuple_result::added )
             {
-                server_->notification_output(
-                    &out_body[ l2cap_header_size ],
-                    out_size,
-                    connection_details_,
-                    notification.second
-                );
+                size += tuple_size;
+                ++tuples;
             }
-            else
+            else if ( result == ::bluetoe::details::notification_tuple_result::no_space )
             {
-                server_->indication_output(
-                    &out_body[ l2cap_header_size ],
-                    out_size,
-                    connection_details_,
-                    notification.second
-                );
-
-                // if no output is generate, confirm the indication, or we will wait for ever
-                if ( out_size == 0 )
-                    connection_details_.indication_confirmed();
+                // a single, large value is send as plain notification
+                if ( tuples == 0 )
+                {
+                    server_->notification_output( output, out_size, connection_details_, index );
+                    return out_size;
+                }
 
+                // keep the notification for the next PDU
+                connection_details_.queue_notification( index );
+                break;
             }
 
-            if ( out_size )
-            {
-                fill< layout_t >( out_buffer, {
-                    lld_data_pdu_code,
-                    static_cast< std::uint8_t >( out_size + l2cap_header_size ),
-                    static_cast< std::uint8_t >( out_size ),
-                    0,
-                    static_cast< std::uint8_t >( l2cap_att_channel ),
-                    static_cast< std::uint8_t >( l2cap_att_channel >> 8 ) } );
-
-                this->commit_transmit_buffer( out_buffer );
-            }
+            const auto next = connection_details_.dequeue_notification();
+            more  = next.first != connection_details_t::entry_type::empty;
+            index = next.second;
+        }
+
+        if ( tuples == 0 )
+            return 0;
+
+        // the Multiple Handle Value Notification requires at least two tuples
+        if ( tuples == 1 )
+        {
+            output[ 0 ] = ::bluetoe::details::bits( ::bluetoe::details::att_opcodes::notification );
+            std::copy( &output[ opcode_size + handle_size + length_size ], &output[ size ], &output[ opcode_size + handle_size ] );
+
+            return size - length_size;
         }
+
+        output[ 0 ] = ::bluetoe::details::bits( ::bluetoe::details::att_opcodes::multiple_handle_value_notification );
+
+        return size;
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::transmit_pending_att_response()
+    {
+        if ( !connection_details_.att_request_pending() )
+            return;
+
+        auto out_buffer = this->allocate_transmit_buffer();
+
+        if ( out_buffer.empty() || this->l2cap_output_pending() )
+            return;
+
+        const read_buffer l2cap_buffer = this->l2cap_output_buffer( out_buffer );
+        std::size_t   out_size = l2cap_buffer.size - l2cap_header_size;
+        std::uint8_t* out_body = l2cap_buffer.buffer;
+
+        server_->pending_response_output( &out_body[ l2cap_header_size ], out_size, connection_details_ );
+
+        if ( out_size )
+            this->commit_l2cap_output( out_buffer, l2cap_att_channel, out_size );
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
@@ -831,28 +1945,153 @@ namespace link_layer {
         // first check if we have memory to transmit the message, or otherwise notifications would get lost
         auto out_buffer = this->allocate_transmit_buffer();
 
-        if ( out_buffer.empty() )
+        if ( out_buffer.empty() || this->l2cap_output_pending() )
             return;
 
-        std::size_t   out_size = out_buffer.size - all_header_size - layout_t::data_channel_pdu_memory_size( 0 );
-        std::uint8_t* out_body = layout_t::body( out_buffer ).first;
+        const read_buffer l2cap_buffer = this->l2cap_output_buffer( out_buffer );
+        std::size_t   out_size = l2cap_buffer.size - l2cap_header_size;
+        std::uint8_t* out_body = l2cap_buffer.buffer;
 
         this->signaling_channel_output( &out_body[ l2cap_header_size ], out_size );
 
         if ( out_size )
+            this->commit_l2cap_output( out_buffer, l2cap_signaling_channel, out_size );
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::transmit_enhanced_att_output( std::true_type )
+    {
+        for ( std::size_t index = 0; index != enhanced_att_channels_t::size; ++index )
+        {
+            if ( enhanced_att_bearer_output( index ) )
+                cancel_slave_latency();
+        }
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    bool link_layer< Server, ScheduledRadio, Options... >::enhanced_att_bearer_output( std::size_t index )
+    {
+        auto& channel = enhanced_att_channels_t::channel( index );
+        auto& bearer  = connection_details_.bearer( index + 1 );
+
+        if ( !channel.connected() )
+        {
+            // drop a request, that was not answered, before the bearer was closed
+            if ( channel.bearer_open )
+                channel.receive( channel.receive_buffer, sizeof( channel.receive_buffer ) );
+
+            channel.bearer_open = false;
+            return false;
+        }
+
+        // a new bearer starts with a fresh ATT state and the MTU of the L2CAP channel
+        if ( !channel.bearer_open )
+        {
+            bearer = ::bluetoe::details::att_bearer( channel.mtu );
+            channel.bearer_open = true;
+        }
+
+        // the remote device can increase its MTU by reconfiguring the channel
+        if ( bearer.client_mtu() != channel.remote_mtu() )
+            bearer.client_mtu( channel.remote_mtu() );
+
+        // the transmit buffer is still referenced by the channel
+        if ( channel.transmitting() )
+            return false;
+
+        std::size_t out_size = bearer.negotiated_mtu();
+        std::size_t in_size  = 0;
+
+        if ( channel.sdu_received( in_size ) )
+        {
+            if ( in_size != 0 )
+                server_->l2cap_input( channel.receive_buffer, in_size, channel.transmit_buffer, out_size, connection_details_, bearer );
+            else
+                out_size = 0;
+
+            channel.receive( channel.receive_buffer, sizeof( channel.receive_buffer ) );
+        }
+        else if ( bearer.att_request_pending() )
+        {
+            server_->pending_response_output( channel.transmit_buffer, out_size, connection_details_, bearer );
+        }
+        else
+        {
+            const auto notification = connection_details_.dequeue_indication_or_confirmation( bearer.confirmation_pending() );
+
+            if ( notification.first == connection_details_t::entry_type::notification )
+            {
+                server_->notification_output( channel.transmit_buffer, out_size, connection_details_, notification.second );
+            }
+            else if ( notification.first == connection_details_t::entry_type::indication )
+            {
+                server_->indication_output( channel.transmit_buffer, out_size, connection_details_, notification.second );
+
+                if ( out_size )
+                    bearer.indication_sent();
+            }
+            else
+            {
+                out_size = 0;
+            }
+        }
+
+        return out_size != 0 && channel.transmit( channel.transmit_buffer, out_size );
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::reset_enhanced_att_bearers( std::true_type )
+    {
+        for ( std::size_t index = 0; index != enhanced_att_channels_t::size; ++index )
+        {
+            auto& channel = enhanced_att_channels_t::channel( index );
+
+            channel.bearer_open = false;
+            channel.receive( channel.receive_buffer, sizeof( channel.receive_buffer ) );
+        }
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::transmit_credit_based_channels_output()
+    {
+        // fill all free transmit buffers with K-frames; a K-frame is completely copied into the link layer, before
+        // the next K-frame is requested
+        for ( auto out_buffer = this->allocate_transmit_buffer(); !out_buffer.empty() && !this->l2cap_output_pending();
+              out_buffer = this->allocate_transmit_buffer() )
         {
-            fill< layout_t >( out_buffer, {
-                lld_data_pdu_code,
-                static_cast< std::uint8_t >( out_size + l2cap_header_size ),
-                static_cast< std::uint8_t >( out_size ),
-                0,
-                static_cast< std::uint8_t >( l2cap_signaling_channel ),
-                static_cast< std::uint8_t >( l2cap_signaling_channel >> 8 ) } );
+            const read_buffer l2cap_buffer = this->l2cap_output_buffer( out_buffer );
+            std::size_t   out_size = l2cap_buffer.size - l2cap_header_size;
+            std::uint8_t* out_body = l2cap_buffer.buffer;
+            std::uint16_t channel  = 0;
+
+            ::bluetoe::details::output_reference reference;
+            this->channel_output( &out_body[ l2cap_header_size ], out_size, channel, reference );
 
-            this->commit_transmit_buffer( out_buffer );
+            if ( out_size == 0 && reference.empty() )
+                return;
+
+            this->commit_l2cap_output( out_buffer, channel, out_size, reference );
         }
     }
 
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::transmit_security_manager_output()
+    {
+        auto out_buffer = this->allocate_transmit_buffer();
+
+        if ( out_buffer.empty() || this->l2cap_output_pending() )
+            return;
+
+        const read_buffer l2cap_buffer = this->l2cap_output_buffer( out_buffer );
+        std::size_t   out_size = l2cap_buffer.size - l2cap_header_size;
+        std::uint8_t* out_body = l2cap_buffer.buffer;
+
+        static_cast< security_manager_t& >( *this ).l2cap_output( &out_body[ l2cap_header_size ], out_size, connection_details_, *this );
+
+        if ( out_size )
+            this->commit_l2cap_output( out_buffer, l2cap_sm_channel, out_size );
+    }
+
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     void link_layer< Server, ScheduledRadio, Options... >::transmit_pending_control_pdus()
     {
@@ -892,19 +2131,26 @@ namespace link_layer {
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     bool link_layer< Server, ScheduledRadio, Options... >::lcap_notification_callback( const ::bluetoe::details::notification_data& item, void* usr_arg, typename Server::notification_type type )
     {
-        auto& confirmation_queue = static_cast< link_layer< Server, ScheduledRadio, Options... >* >( usr_arg )->connection_details_;
+        auto& self               = *static_cast< link_layer< Server, ScheduledRadio, Options... >* >( usr_arg );
+        auto& confirmation_queue = self.connection_details_;
         switch ( type )
         {
             case Server::notification:
+                self.request_slave_latency_cancellation();
                 return confirmation_queue.queue_notification( item.client_characteristic_configuration_index() );
                 break;
             case Server::indication:
+                self.request_slave_latency_cancellation();
                 return confirmation_queue.queue_indication( item.client_characteristic_configuration_index() );
                 break;
             case Server::confirmation:
                 confirmation_queue.indication_confirmed();
                 return true;
                 break;
+            case Server::pending_response:
+                self.request_slave_latency_cancellation();
+                return true;
+                break;
         }
 
         return true;
@@ -976,6 +2222,9 @@ namespace link_layer {
     void link_layer< Server, ScheduledRadio, Options... >::force_disconnect()
     {
         this->reset_encryption();
+        this->reset_channels( details::mtu_size< Options... >::mtu );
+        reset_enhanced_att_bearers( enhanced_att_enabled() );
+        this->reset_phy_update();
         this->connection_closed( connection_details_, static_cast< radio_t& >( *this ) );
         start_advertising_impl();
     }
@@ -998,7 +2247,10 @@ namespace link_layer {
         if ( result != ll_result::go_ahead || !defered_ll_control_pdu_.empty() )
             return result;
 
-        for ( auto pdu = this->next_received(); pdu.size != 0; )
+        // all fragments of the last L2CAP output have to be transmitted, before new output can be generated
+        this->transmit_pending_l2cap_fragments();
+
+        for ( auto pdu = this->next_received(); pdu.size != 0 && !this->l2cap_output_pending(); )
         {
             auto output = this->allocate_transmit_buffer();
 
@@ -1010,7 +2262,7 @@ namespace link_layer {
                 {
                     result = handle_ll_control_data( pdu, output );
                 }
-                else if ( llid == lld_data_pdu_code && state_ != state::disconnecting )
+                else if ( ( llid == lld_data_pdu_code || llid == lld_continuation_pdu_code ) && state_ != state::disconnecting )
                 {
                     result = handle_l2cap( pdu, output );
                 }
@@ -1125,7 +2377,8 @@ namespace link_layer {
                     ll_control_pdu_code, 9,
                     LL_FEATURE_RSP,
                     used_features_,
-                    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+                    static_cast< std::uint8_t >( supported_features_2 & body[ 2 ] ),
+                    0x00, 0x00, 0x00, 0x00, 0x00, 0x00
                 } );
             }
             else if ( opcode == LL_UNKNOWN_RSP && size == 2 && body[ 1 ] == LL_CONNECTION_PARAM_REQ )
@@ -1157,6 +2410,33 @@ namespace link_layer {
             {
                 // all encryption PDU handled in handle_encryption_pdus()
             }
+            else if ( this->handle_data_length_pdus( opcode, size, body, write, commit ) )
+            {
+                // all data length update PDU handled in handle_data_length_pdus()
+            }
+            else if ( opcode == LL_PHY_UPDATE_IND && size == 5 && details::radio_supports_2mbit< radio_t >::value )
+            {
+                commit = false;
+
+                // no change at all: the procedure is completed and the instant is to be ignored
+                if ( body[ 1 ] != 0 || body[ 2 ] != 0 )
+                {
+                    defered_conn_event_counter_ = read_16( &body[ 3 ] );
+
+                    if ( static_cast< std::uint16_t >( defered_conn_event_counter_ - conn_event_counter_ ) & 0x8000 )
+                    {
+                        result = ll_result::disconnect;
+                    }
+                    else
+                    {
+                        defered_ll_control_pdu_ = pdu;
+                    }
+                }
+            }
+            else if ( this->handle_phy_pdus( opcode, size, body, write, commit ) )
+            {
+                // all other PHY update PDU handled in handle_phy_pdus()
+            }
             else if ( opcode != LL_UNKNOWN_RSP )
             {
                 fill< layout_t >( write, { ll_control_pdu_code, 2, LL_UNKNOWN_RSP, opcode } );
@@ -1177,37 +2457,54 @@ namespace link_layer {
     typename link_layer< Server, ScheduledRadio, Options... >::ll_result link_layer< Server, ScheduledRadio, Options... >::handle_l2cap( const write_buffer& input, const read_buffer& output )
     {
         const std::uint16_t input_header    = layout_t::header( input );
-        const std::uint8_t* const input_body= layout_t::body( input ).first;
         const std::uint8_t  pdu_size        = input_header >> 8;
 
+        write_buffer sdu;
+
+        if ( !this->reassemble_l2cap_sdu( input_header & 0x03, layout_t::body( input ).first, pdu_size, sdu ) )
+            return ll_result::disconnect;
+
+        // L2CAP PDU not complete yet
+        if ( sdu.empty() )
+            return ll_result::go_ahead;
+
+        const std::uint8_t* const input_body= sdu.buffer;
         const std::uint16_t l2cap_size      = read_16( &input_body[ 0 ] );
         const std::uint16_t l2cap_channel   = read_16( &input_body[ 2 ] );
 
-        if ( pdu_size - l2cap_header_size != l2cap_size )
-            return ll_result::disconnect;
+        const read_buffer l2cap_buffer = this->l2cap_output_buffer( output );
+        std::size_t   out_size   = l2cap_buffer.size - l2cap_header_size;
+        std::uint8_t* out_body   = l2cap_buffer.buffer;
 
-        std::size_t   out_size   = output.size - l2cap_header_size - layout_t::data_channel_pdu_memory_size( 0 );
-        std::uint8_t* out_body   = layout_t::body( output ).first;
+        // attribute values, that are copied directly into the LL PDUs
+        ::bluetoe::details::output_reference reference;
 
         if ( l2cap_channel == l2cap_att_channel )
         {
-            server_->l2cap_input( &input_body[ l2cap_header_size ], l2cap_size, &out_body[ l2cap_header_size ], out_size, connection_details_ );
+            server_->l2cap_input( &input_body[ l2cap_header_size ], l2cap_size, &out_body[ l2cap_header_size ], out_size, connection_details_, &reference );
 
             // in case the ATT input changed the MTU size:
-            this->max_rx_size( connection_details_.negotiated_mtu() + all_header_size );
-            this->max_tx_size( connection_details_.negotiated_mtu() + all_header_size );
+            adjust_pdu_sizes_to_mtu();
         }
         else if ( l2cap_channel == l2cap_sm_channel )
         {
             static_cast< security_manager_t& >( *this ).l2cap_input( &input_body[ l2cap_header_size ], l2cap_size, &out_body[ l2cap_header_size ], out_size, connection_details_, *this );
 
-            // in case the pairing status changed
-            connection_details_.pairing_status( connection_details_.local_device_pairing_status() );
+            // in case the pairing status changed; a failed pairing keeps the status of a bonded key
+            if ( connection_details_.local_device_pairing_status() != device_pairing_status::no_key )
+                connection_details_.pairing_status( connection_details_.local_device_pairing_status() );
         }
         else if ( l2cap_channel == l2cap_signaling_channel )
         {
             this->signaling_channel_input(
-                &input_body[ l2cap_header_size ], l2cap_size, &out_body[ l2cap_header_size ], out_size );
+                &input_body[ l2cap_header_size ], l2cap_size, &out_body[ l2cap_header_size ], out_size, connection_details_.is_encrypted() );
+        }
+        else if ( this->channel_input( l2cap_channel, &input_body[ l2cap_header_size ], l2cap_size ) )
+        {
+            out_size = 0;
+
+            // let run() return, so that a received SDU can be consumed
+            this->wake_up();
         }
         else
         {
@@ -1215,21 +2512,37 @@ namespace link_layer {
         }
 
         if ( out_size )
-        {
-            fill< layout_t >( output, {
-                lld_data_pdu_code,
-                static_cast< std::uint8_t >( out_size + l2cap_header_size ),
-                static_cast< std::uint8_t >( out_size ),
-                0,
-                static_cast< std::uint8_t >( l2cap_channel ),
-                static_cast< std::uint8_t >( l2cap_channel >> 8 ) } );
-
-            this->commit_transmit_buffer( output );
-        }
+            this->commit_l2cap_output( output, l2cap_channel, out_size, reference );
 
         return ll_result::go_ahead;
     }
 
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::adjust_pdu_sizes_to_mtu()
+    {
+        // PDU sizes are negotiated by the Data Length Update procedure
+        if ( details::data_length< Options... >::enabled )
+            return;
+
+        // larger L2CAP PDUs are segmented
+        const std::size_t pdu_size = std::min< std::size_t >( connection_details_.negotiated_mtu() + all_header_size, radio_t::max_buffer_size );
+
+        this->max_rx_size( ring_buffer_pdu_size( pdu_size, this->max_max_rx_size() ) );
+        this->max_tx_size( ring_buffer_pdu_size( pdu_size, this->max_max_tx_size() ) );
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    std::size_t link_layer< Server, ScheduledRadio, Options... >::ring_buffer_pdu_size( std::size_t pdu_size, std::size_t max_max_size )
+    {
+        // An empty ring buffer can only hand out (buffer size - 1) / 2 bytes for sure, as the position of the
+        // next allocation depends on the position of the last PDU. Larger PDUs could block the flow of fragments.
+        const std::size_t minimum_size  = radio_t::min_buffer_size;
+        const std::size_t buffer_size   = max_max_size + radio_t::layout_overhead;
+        const std::size_t safe_size     = ( buffer_size - 1 ) / 2 - radio_t::layout_overhead;
+
+        return std::max( minimum_size, std::min( pdu_size, safe_size ) );
+    }
+
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     typename link_layer< Server, ScheduledRadio, Options... >::ll_result link_layer< Server, ScheduledRadio, Options... >::handle_pending_ll_control()
     {
@@ -1244,6 +2557,10 @@ namespace link_layer {
             {
                 channels_.reset( &body[ 1 ] );
             }
+            else if ( opcode == LL_PHY_UPDATE_IND )
+            {
+                this->apply_phy_update( body );
+            }
             else if ( opcode == LL_CONNECTION_UPDATE_REQ )
             {
                 connection_interval_old_ = connection_interval_;
@@ -1306,9 +2623,108 @@ namespace link_layer {
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
-    std::size_t link_layer< Server, ScheduledRadio, Options... >::fill_l2cap_advertising_data( std::uint8_t* buffer, std::size_t buffer_size ) const
+    bool link_layer< Server, ScheduledRadio, Options... >::update_advertising_data( std::uint8_t ad_type, const std::uint8_t* value, std::size_t size )
+    {
+        static constexpr std::size_t ad_header_size = 2;
+
+        if ( !advertising_data_cached_ || size + ad_header_size > max_advertising_data_size )
+            return false;
+
+        // the radio callbacks might read the current advertising data at any time
+        std::uint8_t data[ max_advertising_data_size ];
+        std::size_t  data_size = advertising_data_size_;
+        std::copy( &advertising_data_[ 0 ], &advertising_data_[ data_size ], &data[ 0 ] );
+
+        const std::size_t pos = find_advertising_data( data, data_size, ad_type );
+
+        // same size: replace the value in place
+        if ( pos != data_size && data[ pos ] == size + 1 )
+        {
+            std::copy( value, value + size, &data[ pos + ad_header_size ] );
+        }
+        else
+        {
+            const std::size_t old_size = pos != data_size ? data[ pos ] + 1u : 0u;
+
+            if ( data_size - old_size + size + ad_header_size > max_advertising_data_size )
+                return false;
+
+            std::copy( &data[ pos + old_size ], &data[ data_size ], &data[ pos ] );
+            data_size -= old_size;
+
+            data[ data_size ]     = static_cast< std::uint8_t >( size + 1 );
+            data[ data_size + 1 ] = ad_type;
+            std::copy( value, value + size, &data[ data_size + ad_header_size ] );
+            data_size += size + ad_header_size;
+        }
+
+        typename radio_t::lock_guard lock;
+
+        std::copy( &data[ 0 ], &data[ data_size ], &advertising_data_[ 0 ] );
+        advertising_data_size_    = data_size;
+        advertising_data_changed_ = true;
+
+        return true;
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    std::size_t link_layer< Server, ScheduledRadio, Options... >::fill_l2cap_advertising_data( std::uint8_t* buffer, std::size_t buffer_size )
+    {
+        cache_advertising_data();
+        advertising_data_changed_ = false;
+
+        const std::size_t size = std::min( buffer_size, advertising_data_size_ );
+        std::copy( &advertising_data_[ 0 ], &advertising_data_[ size ], buffer );
+
+        // add aditional empty AD to be visible to Nordic sniffer
+        if ( buffer_size - size < 2u )
+            return size;
+
+        buffer[ size ]     = 0;
+        buffer[ size + 1 ] = 0;
+
+        return size + 2;
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    bool link_layer< Server, ScheduledRadio, Options... >::advertising_data_changed() const
+    {
+        return advertising_data_changed_;
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    void link_layer< Server, ScheduledRadio, Options... >::cache_advertising_data()
+    {
+        if ( advertising_data_cached_ )
+            return;
+
+        advertising_data_size_ = significant_advertising_data_size(
+            advertising_data_, server_->advertising_data( advertising_data_, max_advertising_data_size ) );
+        advertising_data_cached_ = true;
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    std::size_t link_layer< Server, ScheduledRadio, Options... >::significant_advertising_data_size( const std::uint8_t* data, std::size_t size )
+    {
+        std::size_t pos = 0;
+
+        // an AD structure with a length of zero terminates the advertising data
+        while ( pos != size && data[ pos ] != 0 && pos + data[ pos ] + 1 <= size )
+            pos += data[ pos ] + 1;
+
+        return pos;
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    std::size_t link_layer< Server, ScheduledRadio, Options... >::find_advertising_data( const std::uint8_t* data, std::size_t size, std::uint8_t ad_type )
     {
-        return server_->advertising_data( buffer, buffer_size );
+        for ( std::size_t pos = 0; pos != size; pos += data[ pos ] + 1 )
+        {
+            if ( data[ pos + 1 ] == ad_type )
+                return pos;
+        }
+
+        return size;
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
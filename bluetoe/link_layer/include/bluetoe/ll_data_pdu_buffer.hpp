@@ -13,6 +13,181 @@
 namespace bluetoe {
 namespace link_layer {
 
+    namespace details {
+        struct no_lock_guard {
+            no_lock_guard() {}
+
+            no_lock_guard( const no_lock_guard& ) = delete;
+            no_lock_guard& operator=( const no_lock_guard& ) = delete;
+        };
+
+        // the link layer is the CallBack parameter of the scheduled radio, that derives from the ll_data_pdu_buffer
+        template < typename Radio >
+        struct radio_callback
+        {
+            using type = void;
+        };
+
+        template < template < std::size_t, std::size_t, typename > class Radio, std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+        struct radio_callback< Radio< TransmitSize, ReceiveSize, CallBack > >
+        {
+            using type = CallBack;
+        };
+
+        template < template < std::size_t, std::size_t, typename, typename > class Radio, std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, typename Base >
+        struct radio_callback< Radio< TransmitSize, ReceiveSize, CallBack, Base > >
+        {
+            using type = CallBack;
+        };
+
+        /*
+         * true, if the link layer (the CallBack of the scheduled radio) collects connection statistics. The link layer
+         * specializes this trait, because it is not a complete type, when the ll_data_pdu_buffer is instantiated.
+         */
+        template < typename CallBack >
+        struct callback_collects_connection_statistics
+        {
+            static constexpr bool value = false;
+        };
+
+        /*
+         * base of the ll_data_pdu_buffer, that forwards PDU related events to the connection statistics of the link layer,
+         * if the link layer collects statistics. Without statistics, this is an empty base.
+         */
+        template < typename Radio, bool Collect = callback_collects_connection_statistics< typename radio_callback< Radio >::type >::value >
+        class pdu_statistics
+        {
+        protected:
+            void count_transmitted( bool ) {}
+            void count_received() {}
+            void count_acknowledged() {}
+            void count_not_acknowledged() {}
+            void count_crc_error() {}
+            void count_mic_error() {}
+        };
+
+        template < typename Radio >
+        class pdu_statistics< Radio, true >
+        {
+        protected:
+            pdu_statistics()
+                : data_transmitted_( false )
+            {
+            }
+
+            // data is false, if an empty PDU was transmitted
+            void count_transmitted( bool data )
+            {
+                data_transmitted_ = data;
+            }
+
+            void count_received()
+            {
+                callback().statistics_pdu_received();
+            }
+
+            void count_acknowledged()
+            {
+                data_transmitted_ = false;
+                callback().statistics_pdu_acknowledged();
+            }
+
+            void count_not_acknowledged()
+            {
+                if ( data_transmitted_ )
+                    callback().statistics_pdu_retransmitted();
+            }
+
+            void count_crc_error()
+            {
+                callback().statistics_crc_error();
+            }
+
+            void count_mic_error()
+            {
+                callback().statistics_mic_failure();
+            }
+
+        private:
+            using callback_t = typename radio_callback< Radio >::type;
+
+            callback_t& callback()
+            {
+                return static_cast< callback_t& >( static_cast< Radio& >( *this ) );
+            }
+
+            bool data_transmitted_;
+        };
+    }
+
+    /**
+     * @brief the link layer synchronizes the access to the ll_data_pdu_buffer with the radio ISR by a Radio::lock_guard
+     *
+     * Every access of the link layer to the buffers is guarded by an instance of Radio::lock_guard, which usually disables
+     * the radio interrupt. The sequence number of a PDU to be transmitted is assigned, when the PDU is committed.
+     *
+     * This is the default.
+     *
+     * @sa pdu_buffer_synchronization_by_radio
+     * @sa lock_free_pdu_buffers
+     */
+    struct locked_pdu_buffers {
+        /** @cond HIDDEN_SYMBOLS */
+        template < std::size_t Size, typename Buffer, typename Layout >
+        using ring_buffer = pdu_ring_buffer< Size, Buffer, Layout >;
+
+        template < typename Radio >
+        using lock_guard = typename Radio::lock_guard;
+
+        static constexpr bool sequence_numbers_by_radio = false;
+        /** @endcond */
+    };
+
+    /**
+     * @brief the link layer and the radio ISR access the ll_data_pdu_buffer without any lock
+     *
+     * Both ring buffers are implemented as spsc_pdu_ring_buffer, that just use atomic loads and
+     * stores (acquire / release) of their indices. The radio ISR is the consumer of the transmit buffer and
+     * the producer of the receive buffer. Radio::lock_guard is not used and does not have to be provided by the radio.
+     *
+     * To keep all state, that is shared between the link layer and the ISR, in the rings, the sequence number of a
+     * PDU to be transmitted is assigned by the ISR, when the PDU is transmitted for the first time.
+     *
+     * Loads and stores of pointers have to be atomic on the target platform, which is the case on all ARM Cortex-M.
+     *
+     * @sa pdu_buffer_synchronization_by_radio
+     * @sa locked_pdu_buffers
+     */
+    struct lock_free_pdu_buffers {
+        /** @cond HIDDEN_SYMBOLS */
+        template < std::size_t Size, typename Buffer, typename Layout >
+        using ring_buffer = spsc_pdu_ring_buffer< Size, Buffer, Layout >;
+
+        template < typename Radio >
+        using lock_guard = details::no_lock_guard;
+
+        static constexpr bool sequence_numbers_by_radio = true;
+        /** @endcond */
+    };
+
+    /**
+     * @brief selects the synchronization of the ll_data_pdu_buffer between link layer and radio ISR for a radio.
+     *
+     * By default, bluetoe::link_layer::locked_pdu_buffers is used. To override this for a radio R, specialize
+     * bluetoe::link_layer::pdu_buffer_synchronization_by_radio for R:
+     *
+     * @code
+     * template <>
+     * struct pdu_buffer_synchronization_by_radio< R > {
+     *     using synchronization = lock_free_pdu_buffers;
+     * };
+     * @endcode
+     */
+    template < typename Radio >
+    struct pdu_buffer_synchronization_by_radio {
+        using synchronization = locked_pdu_buffers;
+    };
+
     /**
      * @brief ring buffers for ingoing and outgoing LL Data PDUs
      *
@@ -34,7 +209,7 @@ namespace link_layer {
      * an overhead per PDU.
      */
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    class ll_data_pdu_buffer
+    class ll_data_pdu_buffer : public details::pdu_statistics< Radio >
     {
     public:
         /**
@@ -49,6 +224,11 @@ namespace link_layer {
          */
         using layout = typename pdu_layout_by_radio< Radio >::pdu_layout;
 
+        /**
+         * @brief synchronization between link layer and radio, selected by pdu_buffer_synchronization_by_radio
+         */
+        using synchronization = typename pdu_buffer_synchronization_by_radio< Radio >::synchronization;
+
         /**
          * @brief the size of memory in bytes that are return by raw()
          */
@@ -210,6 +390,15 @@ namespace link_layer {
          */
         void commit_transmit_buffer( read_buffer );
 
+        /**
+         * @brief returns true, if all committed PDUs where acknowledged by the peer.
+         *
+         * Used by the link layer to decide whether connection events can be skipped.
+         *
+         * @pre buffer is in running mode
+         */
+        bool transmit_buffer_empty() const;
+
         /**@}*/
 
         /**@{*/
@@ -271,6 +460,11 @@ namespace link_layer {
          */
         write_buffer crc_error();
 
+        /**
+         * @brief This function will be called by the scheduled radio when a PDU was received, that failed the message integrity check
+         */
+        void mic_error();
+
         /**
          * @brief This function will be called by the scheduled radio when a timeout occured.
          */
@@ -290,13 +484,14 @@ namespace link_layer {
         // transmit buffer followed by receive buffer at buffer_[ TransmitSize ]
         std::uint8_t    buffer_[ size ];
 
-        pdu_ring_buffer< ReceiveSize, read_buffer, layout >  receive_buffer_;
+        typename synchronization::template ring_buffer< ReceiveSize, read_buffer, layout >  receive_buffer_;
         volatile std::size_t            max_rx_size_;
 
-        pdu_ring_buffer< TransmitSize, read_buffer, layout > transmit_buffer_;
+        typename synchronization::template ring_buffer< TransmitSize, read_buffer, layout > transmit_buffer_;
         volatile std::size_t            max_tx_size_;
 
         bool                    sequence_number_;
+        bool                    next_sequenced_;
         bool                    next_expected_sequence_number_;
         uint8_t                 empty_[ layout::data_channel_pdu_memory_size( 0 ) ];
         bool                    next_empty_;
@@ -331,6 +526,8 @@ namespace link_layer {
 
         write_buffer set_next_expected_sequence_number( read_buffer ) const;
 
+        void set_sequence_number( read_buffer );
+
         void acknowledge( bool sequence_number );
     };
 
@@ -386,8 +583,10 @@ namespace link_layer {
         transmit_buffer_.reset( transmit_buffer() );
 
         sequence_number_ = false;
+        next_sequenced_  = false;
         next_expected_sequence_number_ = false;
         next_empty_      = false;
+        this->count_transmitted( false );
     }
 
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
@@ -399,7 +598,7 @@ namespace link_layer {
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
     read_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::allocate_transmit_buffer( std::size_t size )
     {
-        typename Radio::lock_guard lock;
+        typename synchronization::template lock_guard< Radio > lock;
 
         return transmit_buffer_.alloc_front( transmit_buffer(), size );
     }
@@ -411,21 +610,24 @@ namespace link_layer {
         static_cast< void >( header_rfu_mask );
 
         // make sure, no NFU bits are set
-        std::uint16_t header = layout::header( pdu );
-        assert( ( header & header_rfu_mask ) == 0 );
+        assert( ( layout::header( pdu ) & header_rfu_mask ) == 0 );
+
+        typename synchronization::template lock_guard< Radio > lock;
+
+        // add sequence number, if not done by the radio, when the PDU is transmitted
+        if ( !synchronization::sequence_numbers_by_radio )
+            set_sequence_number( pdu );
 
-        typename Radio::lock_guard lock;
+        transmit_buffer_.push_front( transmit_buffer(), pdu );
+    }
 
-        // add sequence number
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::set_sequence_number( read_buffer pdu )
+    {
         if ( sequence_number_ )
-        {
-            header |= sn_flag;
-            layout::header( pdu, header );
-        }
+            layout::header( pdu, layout::header( pdu ) | sn_flag );
 
         sequence_number_ = !sequence_number_;
-
-        transmit_buffer_.push_front( transmit_buffer(), pdu );
     }
 
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
@@ -458,6 +660,8 @@ namespace link_layer {
                 layout::header( next, header );
             }
 
+            this->count_transmitted( false );
+
             return set_next_expected_sequence_number( read_buffer{ &empty_[ 0 ], sizeof( empty_ ) } );
         }
         else if ( next.size == 0 )
@@ -473,13 +677,23 @@ namespace link_layer {
             // keep sequence number of empty in mind and increment sequence_number_
             empty_sequence_number_ = sequence_number_;
             sequence_number_ = !sequence_number_;
+            this->count_transmitted( false );
 
             return set_next_expected_sequence_number( read_buffer{ &empty_[ 0 ], sizeof( empty_ ) } );
         }
 
+        // the PDU is transmitted for the first time
+        if ( synchronization::sequence_numbers_by_radio && !next_sequenced_ )
+        {
+            set_sequence_number( next );
+            next_sequenced_ = true;
+        }
+
         if ( transmit_buffer_.more_than_one() )
             layout::header( next, layout::header( next ) | more_data_flag );
 
+        this->count_transmitted( true );
+
         return set_next_expected_sequence_number( next );
     }
 
@@ -499,11 +713,21 @@ namespace link_layer {
             if ( next.empty() )
                 return;
 
+            // a PDU without sequence number was not transmitted jet
+            if ( synchronization::sequence_numbers_by_radio && !next_sequenced_ )
+                return;
+
             const std::uint16_t header = layout::header( next );
             if ( static_cast< bool >( header & sn_flag ) != nesn )
             {
                 transmit_buffer_.pop_end( transmit_buffer() );
+                next_sequenced_   = false;
                 static_cast< Radio* >( this )->increment_transmit_packet_counter();
+                this->count_acknowledged();
+            }
+            else
+            {
+                this->count_not_acknowledged();
             }
         }
     }
@@ -514,10 +738,18 @@ namespace link_layer {
         return allocate_transmit_buffer( max_tx_size_ + layout_overhead );
     }
 
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    bool ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::transmit_buffer_empty() const
+    {
+        typename synchronization::template lock_guard< Radio > lock;
+
+        return transmit_buffer_.next_end().empty();
+    }
+
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
     write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::next_received() const
     {
-        typename Radio::lock_guard lock;
+        typename synchronization::template lock_guard< Radio > lock;
 
         return write_buffer( receive_buffer_.next_end() );
     }
@@ -525,7 +757,7 @@ namespace link_layer {
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
     void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::free_received()
     {
-        typename Radio::lock_guard lock;
+        typename synchronization::template lock_guard< Radio > lock;
 
         receive_buffer_.pop_end( receive_buffer() );
     }
@@ -555,6 +787,7 @@ namespace link_layer {
                 {
                     receive_buffer_.push_front( receive_buffer(), pdu );
                     static_cast< Radio* >( this )->increment_receive_packet_counter();
+                    this->count_received();
                 }
             }
         }
@@ -565,9 +798,17 @@ namespace link_layer {
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
     write_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::crc_error()
     {
+        this->count_crc_error();
+
         return write_buffer{ 0, 0 };
     }
 
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::mic_error()
+    {
+        this->count_mic_error();
+    }
+
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
     void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::timeout()
     {
@@ -139,12 +139,24 @@ namespace link_layer
         static constexpr std::size_t receive_buffer_size  = ReceiveSize;
     };
 
+    namespace details {
+        template < std::uint16_t MaxMTU >
+        struct check_mtu_size {
+            static_assert( MaxMTU >= 23, "The minimum MTU size is 23." );
+            static_assert( MaxMTU <= 512, "The maximum size of an attribute value is 512, so there is no use for a larger MTU." );
+
+            typedef void type;
+        };
+    }
+
     /**
      * @brief define the maximum L2CAP MTU size to be used by the link layer
      *
-     * The default is the minimum of 23.
+     * The default is the minimum of 23. If the MTU is larger than 23, the link layer
+     * will segment outgoing L2CAP PDUs into as many LL data PDUs as necessary and will reassemble
+     * incoming, fragmented L2CAP PDUs. This requires two buffers of MTU + 4 bytes of RAM.
      */
-    template < std::uint8_t MaxMTU >
+    template < std::uint16_t MaxMTU, typename = typename details::check_mtu_size< MaxMTU >::type >
     struct max_mtu_size {
         /** @cond HIDDEN_SYMBOLS */
         struct meta_type :
@@ -155,6 +167,100 @@ namespace link_layer
         /** @endcond */
     };
 
+    namespace details {
+        struct data_length_meta_type {};
+
+        template < std::uint16_t MaxOctets, std::uint16_t MaxTime >
+        struct check_data_length {
+            static_assert( MaxOctets >= 27 && MaxOctets <= 251, "The maximum payload size of a LL PDU must be in the range 27 - 251." );
+            static_assert( MaxTime >= 328 && MaxTime <= 2120, "The maximum transmission time of a LL PDU must be in the range 328us - 2120us." );
+
+            typedef void type;
+        };
+    }
+
+    /**
+     * @brief enables the LE Data Length Extension and defines the preferred, maximum LL PDU payload size and transmission time
+     *
+     * With this option, the link layer responds to a LL_LENGTH_REQ from the master and initiates the Data
+     * Length Update procedure once a connection is established. The negotiated sizes determine the size of the
+     * LL PDUs that are received and transmitted. The link layer will not announce more octets, than fit into the
+     * buffers, configured with buffer_sizes.
+     *
+     * Without this option, the link layer responds to a LL_LENGTH_REQ with an LL_UNKNOWN_RSP.
+     *
+     * @sa buffer_sizes
+     * @sa max_mtu_size
+     */
+    template < std::uint16_t MaxOctets = 251, std::uint16_t MaxTime = 2120, typename = typename details::check_data_length< MaxOctets, MaxTime >::type >
+    struct data_length_extension {
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::data_length_meta_type,
+            details::valid_link_layer_option_meta_type {};
+
+        static constexpr std::uint16_t max_octets = MaxOctets;
+        static constexpr std::uint16_t max_time   = MaxTime;
+        /** @endcond */
+    };
+
+    namespace details {
+        struct channel_selection_algorithm_meta_type {};
+    }
+
+    /**
+     * @brief enables the LE Channel Selection Algorithm #2
+     *
+     * With this option, the link layer indicates support for the Channel Selection Algorithm #2 by setting
+     * the ChSel bit in connectable advertising PDUs. If the master sets the ChSel bit in the connection request too,
+     * the data channel of every connection event is calculated from the connection event counter and the access
+     * address. Otherwise, the precalculated hop sequence of the Channel Selection Algorithm #1 is used.
+     *
+     * The Channel Selection Algorithm #2 distributes the connection events more evenly over the used channels, which
+     * is beneficial in environments, where a set of channels is disturbed by other 2.4GHz traffic.
+     */
+    struct channel_selection_algorithm_2 {
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::channel_selection_algorithm_meta_type,
+            details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+
+    namespace details {
+        struct notifications_per_event_meta_type {};
+    }
+
+    /**
+     * @brief transmit as many notifications and indications per connection event as possible
+     *
+     * By default, the link layer takes at most one notification or indication from the queue of
+     * outstanding notifications, every time the link layer gets control (once per connection event, in
+     * most cases). With this option, the link layer keeps dequeuing and serializing notifications, until
+     * the transmit buffer is full or no more notifications are queued. As long as there are PDUs in the
+     * transmit buffer, the link layer signals the master by setting the MD (more data) flag that it has more
+     * data, so the connection event is extended and the notification throughput at a given connection
+     * interval is multiplied.
+     *
+     * As there can be only one outstanding indication, at most one indication will be sent per connection event.
+     *
+     * @param MaxPerEvent the maximum number of notifications and indications queued for transmission per
+     *        connection event. 0 (the default) means no limit, other than the size of the transmit buffer.
+     *
+     * @sa buffer_sizes
+     */
+    template < std::size_t MaxPerEvent = 0 >
+    struct multiple_notifications_per_event {
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::notifications_per_event_meta_type,
+            details::valid_link_layer_option_meta_type {};
+
+        static constexpr std::size_t max_per_event = MaxPerEvent;
+        /** @endcond */
+    };
+
 }
 }
 
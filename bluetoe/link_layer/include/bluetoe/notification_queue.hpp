@@ -7,6 +7,8 @@
 #include <cassert>
 #include <algorithm>
 #include <iterator>
+#include <type_traits>
+#include <tuple>
 
 namespace bluetoe {
 namespace link_layer {
@@ -40,8 +42,9 @@ namespace link_layer {
      * @param Mixin a class to be mixed in, to allow empty base class optimizations
      *
      * For all function, index is an index into a list of all the characterstics with notifications / indications
-     * enable. The queue is implemented by an array that contains a few bits (2) per characteristic to store the
-     * requested (or queued) notifications / indications.
+     * enable. The queue is implemented by two bitmaps per priority, one for the queued notifications and one for the
+     * queued indications (so 2 bits per characteristic). Finding the next entry to be send scans the bitmaps word
+     * by word, so the costs of a dequeue does not depend on the number of characteristics, that are not queued.
      */
     template < typename Sizes, class Mixin >
     class notification_queue : public Mixin, details::notification_queue_impl_base< Sizes, 0 >
@@ -108,6 +111,26 @@ namespace link_layer {
          */
         std::pair< details::notification_queue_entry_type, std::size_t > dequeue_indication_or_confirmation();
 
+        /**
+         * @brief return a next notification or indication to be send on an additional ATT bearer.
+         *
+         * An additional bearer keeps track of its outstanding confirmation by itself. Indications are only
+         * returned, if confirmation_pending is false. The returned entry is removed.
+         */
+        std::pair< details::notification_queue_entry_type, std::size_t > dequeue_indication_or_confirmation( bool confirmation_pending );
+
+        /**
+         * @brief return the next notification to be send, ignoring all queued indications.
+         *
+         * Used to combine several notifications into one PDU. The returned entry is removed.
+         */
+        std::pair< details::notification_queue_entry_type, std::size_t > dequeue_notification();
+
+        /**
+         * @brief returns true, if there is at least one queued notification or indication
+         */
+        bool pending() const;
+
         /**
          * @brief removes all entries from the queue
          */
@@ -153,6 +176,29 @@ namespace link_layer {
         return result;
     }
 
+    template < typename Sizes, class Mixin >
+    std::pair< details::notification_queue_entry_type, std::size_t > notification_queue< Sizes, Mixin >::dequeue_indication_or_confirmation( bool confirmation_pending )
+    {
+        std::size_t outstanding_confirmation = confirmation_pending ? 0 : details::no_outstanding_indicaton;
+
+        return impl::dequeue_indication_or_confirmation( 0, outstanding_confirmation );
+    }
+
+    template < typename Sizes, class Mixin >
+    std::pair< details::notification_queue_entry_type, std::size_t > notification_queue< Sizes, Mixin >::dequeue_notification()
+    {
+        // pretending an outstanding confirmation keeps all indications in the queue
+        std::size_t outstanding_confirmation = 0;
+
+        return impl::dequeue_indication_or_confirmation( 0, outstanding_confirmation );
+    }
+
+    template < typename Sizes, class Mixin >
+    bool notification_queue< Sizes, Mixin >::pending() const
+    {
+        return impl::pending();
+    }
+
     template < typename Sizes, class Mixin >
     void notification_queue< Sizes, Mixin >::clear_indications_and_confirmations()
     {
@@ -162,6 +208,29 @@ namespace link_layer {
 
     namespace details
     {
+        /*
+         * index of the least significant bit set in word
+         *
+         * @pre word != 0
+         */
+        inline unsigned count_trailing_zeros( std::uint32_t word )
+        {
+            assert( word != 0 );
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+            static_assert( sizeof( unsigned ) >= sizeof( std::uint32_t ), "__builtin_ctz() has to take the whole word" );
+
+            return static_cast< unsigned >( __builtin_ctz( static_cast< unsigned >( word ) ) );
+#else
+            unsigned result = 0;
+
+            for ( ; ( word & 1 ) == 0; word >>= 1 )
+                ++result;
+
+            return result;
+#endif
+        }
+
         // C is introduced to make baseclasses with the very same Size not ambiguous
         template < int Size, int C >
         class notification_queue_impl
@@ -175,93 +244,115 @@ namespace link_layer {
             bool queue_notification( std::size_t index )
             {
                 assert( index < Size );
-                return add( index, notification_bit );
+                return add( notifications_, index );
             }
 
             bool queue_indication( std::size_t index )
             {
                 assert( index < Size );
 
-                return add( index, indication_bit );
+                return add( indications_, index );
             }
 
             std::pair< notification_queue_entry_type, std::size_t > dequeue_indication_or_confirmation( std::size_t offset, std::size_t& outstanding_confirmation )
             {
-                bool ignore_first = true;
+                const bool  indications_allowed = outstanding_confirmation == no_outstanding_indicaton;
+                std::size_t i                   = 0;
 
-                // loop over all entries in a circle
-                for ( std::size_t i = next_; ignore_first || i != next_; i = ( i + 1 ) % Size )
+                // search in a circle, starting with next_
+                if ( !find_first( next_, indications_allowed, i ) && ( next_ == 0 || !find_first( 0, indications_allowed, i ) ) )
+                    return { empty, 0 };
+
+                next_ = ( i + 1 ) % Size;
+
+                if ( indications_allowed && test( indications_, i ) )
                 {
-                    ignore_first = false;
-                    auto entry = at( i );
+                    outstanding_confirmation = i + offset;
+                    remove( indications_, i );
+                    return { indication, i + offset };
+                }
 
-                    if ( entry & indication_bit && outstanding_confirmation == no_outstanding_indicaton )
-                    {
-                        outstanding_confirmation = i + offset;
-                        next_ = ( i + 1 ) % Size;
-                        remove( i, indication_bit );
-                        return { indication, i + offset };
-                    }
-                    else if ( entry & notification_bit )
-                    {
-                        next_ = ( i + 1 ) % Size;
-                        remove( i, notification_bit );
-                        return { notification, i + offset };
-                    }
+                remove( notifications_, i );
+                return { notification, i + offset };
+            }
 
+            bool pending() const
+            {
+                for ( std::size_t word = 0; word != number_of_words; ++word )
+                {
+                    if ( notifications_[ word ] | indications_[ word ] )
+                        return true;
                 }
 
-                return { empty, 0 };
+                return false;
             }
 
             void clear_indications_and_confirmations()
             {
                 next_ = 0;
-                std::fill( std::begin( queue_ ), std::end( queue_ ), 0 );
+                std::fill( std::begin( notifications_ ), std::end( notifications_ ), 0 );
+                std::fill( std::begin( indications_ ), std::end( indications_ ), 0 );
             }
 
         private:
-            int at( std::size_t index )
+            // small queues do not waste memory on unused bits
+            using word_t = typename std::conditional< ( Size <= 8 ), std::uint8_t,
+                           typename std::conditional< ( Size <= 16 ), std::uint16_t, std::uint32_t >::type >::type;
+
+            static constexpr std::size_t bits_per_word   = sizeof( word_t ) * 8;
+            static constexpr std::size_t number_of_words = ( Size + bits_per_word - 1 ) / bits_per_word;
+
+            using bitmap_t = word_t[ number_of_words ];
+
+            /*
+             * finds the first entry at or behind start, that is queued for notification or (if
+             * allowed) for indication. Bits behind Size are never set.
+             */
+            bool find_first( std::size_t start, bool indications_allowed, std::size_t& index ) const
             {
-                const auto bit_offset  = ( index * bits_per_characteristc ) % 8;
-                const auto byte_offset = index * bits_per_characteristc / 8;
-                assert( byte_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
+                std::size_t   word = start / bits_per_word;
+                std::uint32_t mask = ~std::uint32_t( 0 ) << ( start % bits_per_word );
+
+                for ( ; word != number_of_words; ++word, mask = ~std::uint32_t( 0 ) )
+                {
+                    const std::uint32_t queued = mask & ( notifications_[ word ] | ( indications_allowed ? indications_[ word ] : 0 ) );
+
+                    if ( queued )
+                    {
+                        index = word * bits_per_word + count_trailing_zeros( queued );
+                        return true;
+                    }
+                }
 
-                return ( queue_[ byte_offset ] >> bit_offset ) & 0x03;
+                return false;
             }
 
-            bool add( std::size_t index, int bits )
+            static bool test( const bitmap_t& bitmap, std::size_t index )
             {
-                assert( bits & ( ( 1 << bits_per_characteristc ) -1 ) );
-                const auto bit_offset  = ( index * bits_per_characteristc ) % 8;
-                const auto byte_offset = index * bits_per_characteristc / 8;
-                assert( byte_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
+                return bitmap[ index / bits_per_word ] & bit( index );
+            }
 
-                const bool result = ( queue_[ byte_offset ] & ( bits << bit_offset ) ) == 0;
-                queue_[ byte_offset ] |= bits << bit_offset;
+            static bool add( bitmap_t& bitmap, std::size_t index )
+            {
+                const bool result = !test( bitmap, index );
+                bitmap[ index / bits_per_word ] |= bit( index );
 
                 return result;
             }
 
-            void remove( std::size_t index, int bits )
+            static void remove( bitmap_t& bitmap, std::size_t index )
             {
-                assert( bits & ( ( 1 << bits_per_characteristc ) -1 ) );
-                const auto bit_offset  = ( index * bits_per_characteristc ) % 8;
-                const auto byte_offset = index * bits_per_characteristc / 8;
-                assert( byte_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
-
-                queue_[ byte_offset ] &= ~( bits << bit_offset );
+                bitmap[ index / bits_per_word ] &= static_cast< word_t >( ~bit( index ) );
             }
 
-            static constexpr std::size_t bits_per_characteristc = 2;
-
-            enum char_bits {
-                notification_bit = 0x01,
-                indication_bit   = 0x02
-            };
+            static word_t bit( std::size_t index )
+            {
+                return static_cast< word_t >( word_t( 1 ) << ( index % bits_per_word ) );
+            }
 
             std::size_t     next_;
-            std::uint8_t    queue_[ ( Size * bits_per_characteristc + 7 ) / 8 ];
+            bitmap_t        notifications_;
+            bitmap_t        indications_;
         };
 
         /**
@@ -314,6 +405,11 @@ namespace link_layer {
                 return result;
             }
 
+            bool pending() const
+            {
+                return state_ != empty;
+            }
+
             void clear_indications_and_confirmations()
             {
                 state_ = empty;
@@ -334,6 +430,8 @@ namespace link_layer {
                 return { notification_queue_entry_type::empty, 0 };
             }
 
+            bool pending() const { return false; }
+
             void clear_indications_and_confirmations() {}
         };
 
@@ -374,6 +472,11 @@ namespace link_layer {
                 return result;
             }
 
+            bool pending() const
+            {
+                return impl::pending() || base::pending();
+            }
+
             void clear_indications_and_confirmations()
             {
                 impl::clear_indications_and_confirmations();
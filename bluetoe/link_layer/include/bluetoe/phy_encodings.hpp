@@ -0,0 +1,24 @@
+#ifndef BLUETOE_LINK_LAYER_PHY_ENCODINGS_HPP
+#define BLUETOE_LINK_LAYER_PHY_ENCODINGS_HPP
+
+#include <cstdint>
+
+namespace bluetoe {
+    namespace link_layer {
+        namespace details {
+
+            /**
+             * PHYs as encoded in the LL_PHY_REQ, LL_PHY_RSP and LL_PHY_UPDATE_IND PDUs
+             */
+            namespace phy_ll_encoding {
+                enum phy_ll_encoding_t : std::uint8_t {
+                    le_unchanged_phy    = 0x00,
+                    le_1m_phy           = 0x01,
+                    le_2m_phy           = 0x02,
+                    le_coded_phy        = 0x04
+                };
+            }
+        }
+    }
+}
+#endif
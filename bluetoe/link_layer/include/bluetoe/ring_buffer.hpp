@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cassert>
 #include <cstdlib>
+#include <atomic>
 
 #include <bluetoe/buffer.hpp>
 #include <bluetoe/default_pdu_layout.hpp>
@@ -221,6 +222,215 @@ namespace link_layer {
         return end_ != front_ && ( end_ + pdu_length( end_) ) != front_;
     }
 
+    /**
+     * @brief lock-free variant of the pdu_ring_buffer for exactly one producer and exactly one consumer.
+     *
+     * The interface and the memory layout are the same as of the pdu_ring_buffer. The
+     * producer (alloc_front(), push_front()) and the consumer (next_end(), pop_end(), more_than_one())
+     * can run concurrently (for example the link layer and the radio ISR), without any further locking.
+     *
+     * Every index is written by one side only: front_ by the producer and end_ by the consumer. Both
+     * are published with release semantic and read with acquire semantic by the other side, so that
+     * the content of a PDU is visible to the consumer before the PDU and the memory of a freed PDU
+     * is not reused by the producer, before the consumer is done with it. As the producer can not move
+     * end_, the consumer follows a wrap of the ring lazily.
+     */
+    template < std::size_t Size, typename Buffer = read_buffer, typename Layout = default_pdu_layout >
+    class spsc_pdu_ring_buffer
+    {
+    public:
+        /**
+         * @brief the size of the buffer in bytes
+         */
+        static constexpr std::size_t size = Size;
+
+        /**
+         * @brief sets up the ring to be empty
+         * @pre buffer must point to an array of at least Size bytes
+         */
+        explicit spsc_pdu_ring_buffer( std::uint8_t* buffer );
+
+        /**
+         * @brief resets the ring to be empty
+         *
+         * Must not be called concurrently to any other function.
+         * @pre buffer must point to an array of at least Size bytes
+         */
+        void reset( std::uint8_t* buffer );
+
+        /**
+         * @brief return a writeable PDU buffer of at least size bytes at the front of the ring
+         *
+         * @sa pdu_ring_buffer::alloc_front
+         */
+        Buffer alloc_front( std::uint8_t* buffer, std::size_t size ) const;
+
+        /**
+         * @brief stores the allocated PDU in the ring and publishes it to the consumer.
+         *
+         * @sa pdu_ring_buffer::push_front
+         */
+        void push_front( std::uint8_t* buffer, const Buffer& pdu );
+
+        /**
+         * @brief returns the next PDU from the ring.
+         *
+         * If no PDU is stored in the ring, the function will return an empty write_buffer.
+         */
+        Buffer next_end() const;
+
+        /**
+         * @brief frees the last PDU at the end of the ring
+         *
+         * @pre next_end().size != 0
+         */
+        void pop_end( std::uint8_t* buffer );
+
+        /**
+         * @brief returns true, if the buffer contains at least 2 elements
+         */
+        bool more_than_one() const;
+
+    private:
+        static constexpr std::uint16_t  wrap_mark = 0;
+
+        static std::size_t pdu_length( const std::uint8_t* p );
+
+        // position of the oldest PDU, taking a not jet followed wrap of the ring into account
+        std::uint8_t* wrapped_end( std::uint8_t* end, const std::uint8_t* front ) const;
+
+        // same invariants as pdu_ring_buffer, except that end_ might point to a wrap mark
+        // or to the end of the buffer, if the ring is not empty.
+        std::uint8_t*                   begin_;
+        std::atomic< std::uint8_t* >    end_;
+        std::atomic< std::uint8_t* >    front_;
+    };
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    spsc_pdu_ring_buffer< Size, Buffer, Layout >::spsc_pdu_ring_buffer( std::uint8_t* buffer )
+    {
+        reset( buffer );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void spsc_pdu_ring_buffer< Size, Buffer, Layout >::reset( std::uint8_t* buffer )
+    {
+        assert( buffer );
+        begin_ = buffer;
+        front_.store( buffer, std::memory_order_relaxed );
+        end_.store( buffer, std::memory_order_relaxed );
+
+        Layout::header( buffer, wrap_mark );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    Buffer spsc_pdu_ring_buffer< Size, Buffer, Layout >::alloc_front( std::uint8_t* buffer, std::size_t size ) const
+    {
+        assert( buffer == begin_ );
+        assert( size >= Layout::data_channel_pdu_memory_size( 0 ) );
+
+        std::uint8_t* const front = front_.load( std::memory_order_relaxed );
+        std::uint8_t* const end   = end_.load( std::memory_order_acquire );
+
+        // buffer splited? There must be one byte left to not overflow the ring.
+        if ( end > front && static_cast< std::ptrdiff_t >( size ) < end - front )
+        {
+            return Buffer{ front, size };
+        }
+
+        if ( front >= end )
+        {
+            const std::uint8_t* end_of_buffer = buffer + Size;
+
+            // allocate at the end?
+            if ( static_cast< std::ptrdiff_t >( size ) <= end_of_buffer - front )
+            {
+                return Buffer{ front, size };
+            }
+
+            // allocate at the begining? Again, there must be one byte left between the end front and the end
+            if ( static_cast< std::ptrdiff_t >( size ) < end - buffer )
+            {
+                return Buffer{ buffer, size };
+            }
+        }
+
+        return Buffer{ 0, 0 };
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void spsc_pdu_ring_buffer< Size, Buffer, Layout >::push_front( std::uint8_t* buffer, const Buffer& pdu )
+    {
+        assert( pdu.size >= pdu_length( pdu.buffer ) );
+
+        std::uint8_t* const front         = front_.load( std::memory_order_relaxed );
+        const std::uint8_t* end_of_buffer = buffer + Size;
+
+        // set size to 0 to force the consumer to wrap here
+        if ( front != pdu.buffer && front + 1 < end_of_buffer )
+        {
+            Layout::header( front, wrap_mark );
+        }
+
+        front_.store( pdu.buffer + pdu_length( pdu.buffer ), std::memory_order_release );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    Buffer spsc_pdu_ring_buffer< Size, Buffer, Layout >::next_end() const
+    {
+        std::uint8_t* const front = front_.load( std::memory_order_acquire );
+        std::uint8_t*       end   = end_.load( std::memory_order_relaxed );
+
+        if ( front == end )
+            return Buffer{ 0, 0 };
+
+        end = wrapped_end( end, front );
+
+        return Buffer{ end, pdu_length( end ) };
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void spsc_pdu_ring_buffer< Size, Buffer, Layout >::pop_end( std::uint8_t* buffer )
+    {
+        assert( buffer == begin_ );
+        static_cast< void >( buffer );
+
+        std::uint8_t* const front = front_.load( std::memory_order_acquire );
+        std::uint8_t*       end   = wrapped_end( end_.load( std::memory_order_relaxed ), front );
+
+        end_.store( end + pdu_length( end ), std::memory_order_release );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    bool spsc_pdu_ring_buffer< Size, Buffer, Layout >::more_than_one() const
+    {
+        std::uint8_t* const front = front_.load( std::memory_order_acquire );
+        std::uint8_t*       end   = end_.load( std::memory_order_relaxed );
+
+        if ( front == end )
+            return false;
+
+        end = wrapped_end( end, front );
+
+        return end + pdu_length( end ) != front;
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    std::uint8_t* spsc_pdu_ring_buffer< Size, Buffer, Layout >::wrapped_end( std::uint8_t* end, const std::uint8_t* front ) const
+    {
+        const std::uint8_t* end_of_buffer = begin_ + Size;
+
+        return end != front && ( end + 1 >= end_of_buffer || end[ 1 ] == wrap_mark )
+            ? begin_
+            : end;
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    std::size_t spsc_pdu_ring_buffer< Size, Buffer, Layout >::pdu_length( const std::uint8_t* p )
+    {
+        return Layout::data_channel_pdu_memory_size( Layout::header( p ) >> 8 );
+    }
+
 }
 }
 
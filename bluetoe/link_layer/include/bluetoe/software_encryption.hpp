@@ -0,0 +1,428 @@
+#ifndef BLUETOE_LINK_LAYER_SOFTWARE_ENCRYPTION_HPP
+#define BLUETOE_LINK_LAYER_SOFTWARE_ENCRYPTION_HPP
+
+#include <bluetoe/aes.hpp>
+#include <bluetoe/bits.hpp>
+#include <bluetoe/security_manager.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+
+namespace bluetoe {
+namespace link_layer {
+
+    namespace details {
+
+        /*
+         * AES-CCM, as used to encrypt and authenticate the payload of link layer data channel PDUs
+         * (Core Specification Vol 6, Part E): a 4 octet MIC, a 2 octet length field, the first octet of
+         * the PDU header with NESN, SN and MD masked out as additional authenticated data and a
+         * 13 octet nonce, that consists of the 39 bit packet counter, the direction bit and the IV.
+         */
+        class ll_ccm
+        {
+        public:
+            static constexpr std::size_t mic_size = 4;
+
+            /*
+             * key is the session key in the byte order of FIPS-197 (most significant octet first)
+             */
+            ll_ccm( const std::uint8_t* key, std::uint64_t iv );
+
+            /*
+             * encrypts size bytes of payload in place and appends the MIC
+             */
+            void encrypt( std::uint64_t packet_counter, bool master_to_slave, std::uint8_t header, std::uint8_t* payload, std::size_t size ) const;
+
+            /*
+             * decrypts size bytes of payload (including the MIC) in place and returns true, if the MIC is valid
+             */
+            bool decrypt( std::uint64_t packet_counter, bool master_to_slave, std::uint8_t header, std::uint8_t* payload, std::size_t size ) const;
+
+        private:
+            static constexpr std::size_t    block_size  = bluetoe::details::aes128::block_size;
+            static constexpr std::size_t    nonce_size  = 13;
+            static constexpr std::uint8_t   header_mask = 0xe3;
+
+            void nonce( std::uint64_t packet_counter, bool master_to_slave, std::uint8_t* output ) const;
+            void mac( const std::uint8_t* nonce, std::uint8_t header, const std::uint8_t* payload, std::size_t size, std::uint8_t* output ) const;
+            void crypt( const std::uint8_t* nonce, std::uint8_t* payload, std::size_t size, std::uint8_t* mic ) const;
+
+            bluetoe::details::aes128 cipher_;
+            std::uint64_t            iv_;
+        };
+    }
+
+    /**
+     * @brief software implementation of the encryption related functions of a scheduled_radio_with_encryption
+     *
+     * A radio without hardware support for AES-CCM can derive from this class to implement the security functions
+     * of bluetoe::link_layer::scheduled_radio_with_encryption (c1(), s1(), setup_encryption() and start / stop the
+     * encryption in both directions) in software and then indicate hardware_supports_encryption. The radio itself
+     * has to provide create_srand() and create_long_term_key(), as they depend on a source of random numbers.
+     * setup_encryption() uses create_srand() for the slaves part of the session key diversifier and of the IV.
+     *
+     * The radio implementation calls encrypt_transmitted_pdu() for every new PDU that is going to be transmitted
+     * while transmit_encrypted() and decrypt_received_pdu() for every new PDU that was received while
+     * receive_encrypted(). Retransmissions and received, repeated PDUs must not be passed to these functions again,
+     * as they advance the packet counters. PDUs with an empty payload are not encrypted.
+     *
+     * The session key is expanded once per encryption setup; encrypting or decrypting a PDU takes 2 AES block operations
+     * per 16 octets of payload and 3 additional operations.
+     *
+     * @tparam Radio the derived radio implementation, that provides create_srand()
+     *
+     * @sa scheduled_radio_with_encryption
+     */
+    template < class Radio >
+    class software_encryption
+    {
+    public:
+        /**
+         * @brief number of octets, added by the encryption to the PDU payload
+         */
+        static constexpr std::size_t mic_size = details::ll_ccm::mic_size;
+
+        software_encryption();
+
+        /**
+         * @brief Confirm value generation function c1 for LE Legacy Pairing
+         */
+        bluetoe::details::uint128_t c1(
+            const bluetoe::details::uint128_t& temp_key,
+            const bluetoe::details::uint128_t& rand,
+            const bluetoe::details::uint128_t& p1,
+            const bluetoe::details::uint128_t& p2 ) const;
+
+        /**
+         * @brief Key generation function s1 for LE Legacy Pairing
+         */
+        bluetoe::details::uint128_t s1(
+            const bluetoe::details::uint128_t& temp_key,
+            const bluetoe::details::uint128_t& srand,
+            const bluetoe::details::uint128_t& mrand );
+
+        /**
+         * @brief derives the session key and the IV from the long term key and the masters and slaves parts
+         */
+        std::pair< std::uint64_t, std::uint32_t > setup_encryption( bluetoe::details::uint128_t key, std::uint64_t skdm, std::uint32_t ivm );
+
+        /**
+         * @brief start the encryption of received PDUs with the next connection event.
+         */
+        void start_receive_encrypted();
+
+        /**
+         * @brief start to encrypt transmitted PDUs with the next connection event.
+         */
+        void start_transmit_encrypted();
+
+        /**
+         * @brief stop receiving encrypted with the next connection event.
+         */
+        void stop_receive_encrypted();
+
+        /**
+         * @brief stop transmitting encrypted with the next connection event.
+         */
+        void stop_transmit_encrypted();
+
+        /**
+         * @brief returns true, if received PDUs have to be decrypted
+         */
+        bool receive_encrypted() const;
+
+        /**
+         * @brief returns true, if PDUs to be transmitted have to be encrypted
+         */
+        bool transmit_encrypted() const;
+
+        /**
+         * @brief encrypts size octets of payload in place and appends the MIC
+         *
+         * The caller has to provide room for mic_size additional octets and to increment the length field
+         * of the PDU header accordingly, if size is not zero.
+         */
+        void encrypt_transmitted_pdu( std::uint8_t header, std::uint8_t* payload, std::size_t size );
+
+        /**
+         * @brief decrypts size octets of payload (including the MIC) in place
+         *
+         * Returns false, if the MIC is invalid. In this case, the link layer connection has to be
+         * terminated (Vol 6, Part B, 5.1.3.1). On success, the caller has to decrement the length
+         * field of the PDU header by mic_size, if size is not zero.
+         */
+        bool decrypt_received_pdu( std::uint8_t header, std::uint8_t* payload, std::size_t size );
+
+    private:
+        static bluetoe::details::uint128_t aes_le( const bluetoe::details::uint128_t& key, const bluetoe::details::uint128_t& data );
+        static bluetoe::details::uint128_t xor_( bluetoe::details::uint128_t a, const bluetoe::details::uint128_t& b );
+
+        // the session key and IV are only valid after setup_encryption()
+        details::ll_ccm ccm_;
+        std::uint64_t   rx_counter_;
+        std::uint64_t   tx_counter_;
+        bool            rx_encrypted_;
+        bool            tx_encrypted_;
+    };
+
+    // implementation
+    /** @cond HIDDEN_SYMBOLS */
+    namespace details {
+        inline ll_ccm::ll_ccm( const std::uint8_t* key, std::uint64_t iv )
+            : cipher_( key )
+            , iv_( iv )
+        {
+        }
+
+        inline void ll_ccm::encrypt( std::uint64_t packet_counter, bool master_to_slave, std::uint8_t header, std::uint8_t* payload, std::size_t size ) const
+        {
+            std::uint8_t n[ nonce_size ];
+            nonce( packet_counter, master_to_slave, n );
+
+            mac( n, header, payload, size, payload + size );
+            crypt( n, payload, size, payload + size );
+        }
+
+        inline bool ll_ccm::decrypt( std::uint64_t packet_counter, bool master_to_slave, std::uint8_t header, std::uint8_t* payload, std::size_t size ) const
+        {
+            if ( size < mic_size )
+                return false;
+
+            size -= mic_size;
+
+            std::uint8_t n[ nonce_size ];
+            nonce( packet_counter, master_to_slave, n );
+
+            std::uint8_t received_mic[ mic_size ];
+            std::copy( payload + size, payload + size + mic_size, &received_mic[ 0 ] );
+            crypt( n, payload, size, &received_mic[ 0 ] );
+
+            std::uint8_t expected_mic[ mic_size ];
+            mac( n, header, payload, size, &expected_mic[ 0 ] );
+
+            std::uint8_t difference = 0;
+            for ( std::size_t i = 0; i != mic_size; ++i )
+                difference |= received_mic[ i ] ^ expected_mic[ i ];
+
+            return difference == 0;
+        }
+
+        inline void ll_ccm::nonce( std::uint64_t packet_counter, bool master_to_slave, std::uint8_t* output ) const
+        {
+            // 39 bit packet counter, least significant octet first, followed by the direction bit
+            bluetoe::details::write_32bit( output, static_cast< std::uint32_t >( packet_counter ) );
+            output[ 4 ] = static_cast< std::uint8_t >( ( ( packet_counter >> 32 ) & 0x7f ) | ( master_to_slave ? 0x80 : 0x00 ) );
+
+            bluetoe::details::write_64bit( output + 5, iv_ );
+        }
+
+        inline void ll_ccm::mac( const std::uint8_t* n, std::uint8_t header, const std::uint8_t* payload, std::size_t size, std::uint8_t* output ) const
+        {
+            // B0: flags (Adata, M = 4, L = 2), nonce and payload length
+            std::uint8_t x[ block_size ] = { 0x49 };
+            std::copy( n, n + nonce_size, &x[ 1 ] );
+            x[ 14 ] = static_cast< std::uint8_t >( size >> 8 );
+            x[ 15 ] = static_cast< std::uint8_t >( size );
+            cipher_.encrypt( x, x );
+
+            // B1: length of the additional authenticated data and the masked header
+            x[ 1 ] ^= 0x01;
+            x[ 2 ] ^= header & header_mask;
+            cipher_.encrypt( x, x );
+
+            for ( std::size_t pos = 0; pos < size; pos += block_size )
+            {
+                const std::size_t chunk = std::min( block_size, size - pos );
+
+                for ( std::size_t i = 0; i != chunk; ++i )
+                    x[ i ] ^= payload[ pos + i ];
+
+                cipher_.encrypt( x, x );
+            }
+
+            std::copy( &x[ 0 ], &x[ mic_size ], output );
+        }
+
+        inline void ll_ccm::crypt( const std::uint8_t* n, std::uint8_t* payload, std::size_t size, std::uint8_t* mic ) const
+        {
+            // A0 encrypts the MIC, A1 ... An the payload
+            std::uint8_t a[ block_size ] = { 0x01 };
+            std::copy( n, n + nonce_size, &a[ 1 ] );
+
+            std::uint8_t key_stream[ block_size ];
+            cipher_.encrypt( a, key_stream );
+
+            for ( std::size_t i = 0; i != mic_size; ++i )
+                mic[ i ] ^= key_stream[ i ];
+
+            std::uint16_t counter = 1;
+
+            for ( std::size_t pos = 0; pos < size; pos += block_size, ++counter )
+            {
+                a[ 14 ] = static_cast< std::uint8_t >( counter >> 8 );
+                a[ 15 ] = static_cast< std::uint8_t >( counter );
+                cipher_.encrypt( a, key_stream );
+
+                const std::size_t chunk = std::min( block_size, size - pos );
+
+                for ( std::size_t i = 0; i != chunk; ++i )
+                    payload[ pos + i ] ^= key_stream[ i ];
+            }
+        }
+    }
+
+    template < class Radio >
+    software_encryption< Radio >::software_encryption()
+        : ccm_( bluetoe::details::uint128_t{{ 0 }}.data(), 0 )
+        , rx_counter_( 0 )
+        , tx_counter_( 0 )
+        , rx_encrypted_( false )
+        , tx_encrypted_( false )
+    {
+    }
+
+    template < class Radio >
+    bluetoe::details::uint128_t software_encryption< Radio >::c1(
+        const bluetoe::details::uint128_t& temp_key,
+        const bluetoe::details::uint128_t& rand,
+        const bluetoe::details::uint128_t& p1,
+        const bluetoe::details::uint128_t& p2 ) const
+    {
+        // c1 (k, r, preq, pres, iat, rat, ia, ra) = e(k, e(k, r XOR p1) XOR p2)
+        const auto p1_ = aes_le( temp_key, xor_( rand, p1 ) );
+
+        return aes_le( temp_key, xor_( p1_, p2 ) );
+    }
+
+    template < class Radio >
+    bluetoe::details::uint128_t software_encryption< Radio >::s1(
+        const bluetoe::details::uint128_t& temp_key,
+        const bluetoe::details::uint128_t& srand,
+        const bluetoe::details::uint128_t& mrand )
+    {
+        bluetoe::details::uint128_t r;
+        std::copy( &srand[ 0 ], &srand[ 8 ], &r[ 8 ] );
+        std::copy( &mrand[ 0 ], &mrand[ 8 ], &r[ 0 ] );
+
+        return aes_le( temp_key, r );
+    }
+
+    template < class Radio >
+    std::pair< std::uint64_t, std::uint32_t > software_encryption< Radio >::setup_encryption(
+        bluetoe::details::uint128_t key, std::uint64_t skdm, std::uint32_t ivm )
+    {
+        const bluetoe::details::uint128_t random = static_cast< Radio& >( *this ).create_srand();
+        const std::uint64_t skds = bluetoe::details::read_32bit( &random[ 0 ] )
+                                 | static_cast< std::uint64_t >( bluetoe::details::read_32bit( &random[ 4 ] ) ) << 32;
+        const std::uint32_t ivs  = bluetoe::details::read_32bit( &random[ 8 ] );
+
+        // SKD = SKDs || SKDm, IV = IVs || IVm
+        bluetoe::details::uint128_t session_key_diversifier;
+        bluetoe::details::write_64bit( &session_key_diversifier[ 0 ], skdm );
+        bluetoe::details::write_64bit( &session_key_diversifier[ 8 ], skds );
+
+        const bluetoe::details::uint128_t session_key = aes_le( key, session_key_diversifier );
+
+        bluetoe::details::uint128_t ccm_key;
+        std::reverse_copy( session_key.begin(), session_key.end(), ccm_key.begin() );
+
+        ccm_ = details::ll_ccm( ccm_key.data(), static_cast< std::uint64_t >( ivm ) | ( static_cast< std::uint64_t >( ivs ) << 32 ) );
+
+        return { skds, ivs };
+    }
+
+    template < class Radio >
+    void software_encryption< Radio >::start_receive_encrypted()
+    {
+        rx_counter_   = 0;
+        rx_encrypted_ = true;
+    }
+
+    template < class Radio >
+    void software_encryption< Radio >::start_transmit_encrypted()
+    {
+        tx_counter_   = 0;
+        tx_encrypted_ = true;
+    }
+
+    template < class Radio >
+    void software_encryption< Radio >::stop_receive_encrypted()
+    {
+        rx_encrypted_ = false;
+    }
+
+    template < class Radio >
+    void software_encryption< Radio >::stop_transmit_encrypted()
+    {
+        tx_encrypted_ = false;
+    }
+
+    template < class Radio >
+    bool software_encryption< Radio >::receive_encrypted() const
+    {
+        return rx_encrypted_;
+    }
+
+    template < class Radio >
+    bool software_encryption< Radio >::transmit_encrypted() const
+    {
+        return tx_encrypted_;
+    }
+
+    template < class Radio >
+    void software_encryption< Radio >::encrypt_transmitted_pdu( std::uint8_t header, std::uint8_t* payload, std::size_t size )
+    {
+        if ( size == 0 )
+            return;
+
+        // the slave transmits with direction bit 0
+        ccm_.encrypt( tx_counter_, false, header, payload, size );
+        ++tx_counter_;
+    }
+
+    template < class Radio >
+    bool software_encryption< Radio >::decrypt_received_pdu( std::uint8_t header, std::uint8_t* payload, std::size_t size )
+    {
+        if ( size == 0 )
+            return true;
+
+        if ( !ccm_.decrypt( rx_counter_, true, header, payload, size ) )
+            return false;
+
+        ++rx_counter_;
+
+        return true;
+    }
+
+    template < class Radio >
+    bluetoe::details::uint128_t software_encryption< Radio >::aes_le( const bluetoe::details::uint128_t& key, const bluetoe::details::uint128_t& data )
+    {
+        // Bluetoe stores keys and data least significant octet first, AES expects the most significant octet first
+        bluetoe::details::uint128_t buffer;
+
+        std::reverse_copy( key.begin(), key.end(), buffer.begin() );
+        const bluetoe::details::aes128 cipher( buffer.data() );
+
+        std::reverse_copy( data.begin(), data.end(), buffer.begin() );
+        cipher.encrypt( buffer.data(), buffer.data() );
+        std::reverse( buffer.begin(), buffer.end() );
+
+        return buffer;
+    }
+
+    template < class Radio >
+    bluetoe::details::uint128_t software_encryption< Radio >::xor_( bluetoe::details::uint128_t a, const bluetoe::details::uint128_t& b )
+    {
+        for ( std::size_t i = 0; i != a.size(); ++i )
+            a[ i ] ^= b[ i ];
+
+        return a;
+    }
+    /** @endcond */
+}
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <buffer.hpp>
 #include <address.hpp>
 #include <ll_data_pdu_buffer.hpp>
+#include <phy_encodings.hpp>
 
 namespace bluetoe {
 namespace link_layer {
@@ -111,6 +112,9 @@ namespace link_layer {
 
         /**
          * @brief type to allow ll_data_pdu_buffer to synchronize the access to the buffer data structures.
+         *
+         * The link layer uses the lock_guard too, to synchronize state that is shared with the radio callbacks
+         * (like the advertising data and the connection event state).
          */
         class lock_guard;
 
@@ -214,6 +218,36 @@ namespace link_layer {
          * @brief indication no support for encryption
          */
         static constexpr bool hardware_supports_encryption = false;
+
+        /**
+         * @brief indication no support for the LE 2M PHY
+         */
+        static constexpr bool hardware_supports_2mbit = false;
+
+        /**
+         * @brief indication no support for moving a scheduled connection event
+         *
+         * If a radio sets this to true, it has to implement reschedule_connection_event() and the link layer
+         * will use the slave latency negotiated with the master to skip idle connection events.
+         */
+        static constexpr bool hardware_supports_slave_latency = false;
+
+        /**
+         * @brief moves the connection event, that was scheduled last, to an earlier point in time
+         *
+         * The parameters have the very same meaning as the parameters to schedule_connection_event() and are based
+         * on the same T0. The function returns false and leaves the current scheduling as it is, if it is too late to
+         * start receiving at start_receive or if the connection event already started. This function is only called
+         * from the context of run(), while the link layer holds a lock_guard, so that no connection event can end
+         * while the connection event is moved.
+         *
+         * Only required, if hardware_supports_slave_latency is true.
+         */
+        bool reschedule_connection_event(
+            unsigned                                    channel,
+            bluetoe::link_layer::delta_time             start_receive,
+            bluetoe::link_layer::delta_time             end_receive,
+            bluetoe::link_layer::delta_time             connection_interval );
     };
 
     /**
@@ -308,6 +342,34 @@ namespace link_layer {
         void stop_transmit_encrypted();
     };
 
+    /**
+     * @brief extension of a scheduled_radio with the ability to use the LE 2M PHY
+     *
+     * If a scheduled radio indicates support for the LE 2M PHY, the link layer will announce
+     * that feature and take part in the PHY Update procedure.
+     */
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+    class scheduled_radio_with_2mbit : public scheduled_radio< TransmitSize, ReceiveSize, CallBack >
+    {
+    public:
+        /**
+         * @brief indication support for the LE 2M PHY
+         */
+        static constexpr bool hardware_supports_2mbit = true;
+
+        /**
+         * @brief change the PHYs used for receiving and transmitting, starting with the next connection event.
+         *
+         * The function is called by the link layer at the instant of a PHY Update procedure, before
+         * the connection event at the instant is scheduled. Both parameters are one of details::phy_ll_encoding::le_1m_phy
+         * or details::phy_ll_encoding::le_2m_phy. The radio has to adjust all PHY dependent timing (receive windows,
+         * packet durations) accordingly; T_IFS stays at 150µs.
+         */
+        void radio_set_phy(
+            details::phy_ll_encoding::phy_ll_encoding_t receiving_phy,
+            details::phy_ll_encoding::phy_ll_encoding_t transmitting_phy );
+    };
+
     /**
      * @brief type that provides types and functions to access the differnt parts of a receiving PDU.
      *
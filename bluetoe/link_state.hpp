@@ -4,23 +4,28 @@
 #include <bluetoe/pairing_status.hpp>
 #include <bluetoe/codes.hpp>
 
+#include <array>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+
 namespace bluetoe {
 namespace details {
 
     /**
-     * @brief Attributes of a link
-     *
-     * Data that is required / provided by the link_layer or by any
-     * l2cap layer service (ATT/SM).
+     * @brief ATT state of a single bearer
      *
-     * Currently, this state data is required by the link_layer,
-     * the ATT layer (server.hpp) and by the security manager.
+     * Every ATT bearer of a link has its own MTU and its own outstanding transactions. The unenhanced
+     * bearer on the fixed ATT channel is part of every link_state; enhanced bearers are optional.
      */
-    template < class ATTState >
-    class link_state : public ATTState
+    class att_bearer
     {
     public:
-        explicit link_state( std::uint16_t server_mtu );
+        /**
+         * @brief a bearer with the given server MTU and a client MTU of 23
+         */
+        explicit att_bearer( std::uint16_t server_mtu = details::default_att_mtu_size );
 
         /**
          * @brief returns the negotiated MTU
@@ -49,6 +54,121 @@ namespace details {
          */
         std::uint16_t server_mtu() const;
 
+        /**
+         * @brief parks an ATT request, that can not be answered immediately
+         *
+         * sequence is a number, that is incremented with every parked request of the connection. It is used to
+         * apply completions to the parked requests in the order, in which the requests were parked.
+         *
+         * @post att_request_pending()
+         * @post !att_request_completion_pending()
+         */
+        void park_att_request( std::uint8_t opcode, std::uint16_t handle, std::uint16_t offset, std::uint8_t sequence );
+
+        /**
+         * @brief returns true, if an ATT request was parked and not completed yet
+         */
+        bool att_request_pending() const;
+
+        /**
+         * @brief opcode, attribute handle and offset of the parked request
+         * @pre att_request_pending()
+         */
+        std::uint8_t pending_att_opcode() const;
+        std::uint16_t pending_att_handle() const;
+        std::uint16_t pending_att_offset() const;
+        std::uint8_t pending_att_sequence() const;
+
+        /**
+         * @brief the application completed the parked request with the given result
+         *
+         * @pre att_request_pending()
+         * @post att_request_completion_pending()
+         */
+        void complete_att_request( std::uint8_t error_code );
+
+        /**
+         * @brief returns true, if the parked request was completed, but not answered yet
+         */
+        bool att_request_completion_pending() const;
+
+        /**
+         * @brief result of the completion of the parked request
+         * @pre att_request_completion_pending()
+         */
+        std::uint8_t att_request_completion_error() const;
+
+        /**
+         * @brief removes the parked ATT request
+         *
+         * @post !att_request_pending()
+         * @post !att_request_completion_pending()
+         */
+        void att_request_completed();
+
+        /**
+         * @brief an indication was sent on an enhanced bearer
+         *
+         * The unenhanced bearer keeps track of its outstanding confirmation in the notification queue.
+         * @post confirmation_pending()
+         */
+        void indication_sent();
+
+        /**
+         * @brief the client confirmed the last indication, sent on this bearer
+         *
+         * @post !confirmation_pending()
+         */
+        void confirmation_received();
+
+        /**
+         * @brief returns true, if a confirmation to an indication, sent on this bearer, is outstanding
+         */
+        bool confirmation_pending() const;
+
+    private:
+        std::uint16_t               server_mtu_;
+        std::uint16_t               client_mtu_;
+        std::uint8_t                pending_opcode_;
+        std::uint16_t               pending_handle_;
+        std::uint16_t               pending_offset_;
+        std::uint8_t                pending_sequence_;
+        bool                        completion_pending_;
+        std::uint8_t                completion_error_;
+        bool                        confirmation_pending_;
+    };
+
+    /**
+     * @brief Attributes of a link
+     *
+     * Data that is required / provided by the link_layer or by any
+     * l2cap layer service (ATT/SM).
+     *
+     * Currently, this state data is required by the link_layer,
+     * the ATT layer (server.hpp) and by the security manager.
+     *
+     * The link_state is the unenhanced ATT bearer. EnhancedBearers is the number of additional,
+     * enhanced ATT bearers.
+     */
+    template < class ATTState, std::size_t EnhancedBearers = 0 >
+    class link_state : public ATTState, public att_bearer
+    {
+    public:
+        explicit link_state( std::uint16_t server_mtu );
+
+        /**
+         * @brief number of ATT bearers, including the unenhanced bearer
+         */
+        static constexpr std::size_t number_of_bearers = EnhancedBearers + 1;
+
+        /**
+         * @brief ATT bearer by index
+         *
+         * Index 0 is the unenhanced bearer (the link_state itself), followed by the enhanced bearers.
+         * @pre index < number_of_bearers
+         */
+        att_bearer& bearer( std::size_t index );
+
         /**
          * @brief returns true, if the connection is currently encrypted
          */
@@ -75,75 +195,167 @@ namespace details {
         connection_security_attributes security_attributes() const;
 
     private:
-        std::uint16_t               server_mtu_;
-        std::uint16_t               client_mtu_;
         bool                        encrypted_;
         device_pairing_status       pairing_status_;
+        std::array< att_bearer, EnhancedBearers > enhanced_bearers_;
     };
 
     /** @cond HIDDEN_SYMBOLS */
-    template < class ATTState >
-    link_state< ATTState >::link_state( std::uint16_t server_mtu )
-        : ATTState()
-        , server_mtu_( server_mtu )
+    inline att_bearer::att_bearer( std::uint16_t server_mtu )
+        : server_mtu_( server_mtu )
         , client_mtu_( details::default_att_mtu_size )
-        , encrypted_( false )
-        , pairing_status_( device_pairing_status::no_key )
+        , pending_opcode_( 0 )
+        , pending_handle_( 0 )
+        , pending_offset_( 0 )
+        , pending_sequence_( 0 )
+        , completion_pending_( false )
+        , completion_error_( 0 )
+        , confirmation_pending_( false )
     {
         assert( server_mtu >= details::default_att_mtu_size );
     }
 
-    template < class ATTState >
-    std::uint16_t link_state< ATTState >::negotiated_mtu() const
+    inline std::uint16_t att_bearer::negotiated_mtu() const
     {
         return std::min( server_mtu_, client_mtu_ );
     }
 
-    template < class ATTState >
-    void link_state< ATTState >::client_mtu( std::uint16_t mtu )
+    inline void att_bearer::client_mtu( std::uint16_t mtu )
     {
         assert( mtu >= details::default_att_mtu_size );
         client_mtu_ = mtu;
     }
 
-    template < class ATTState >
-    std::uint16_t link_state< ATTState >::client_mtu() const
+    inline std::uint16_t att_bearer::client_mtu() const
     {
         return client_mtu_;
     }
 
-    template < class ATTState >
-    std::uint16_t link_state< ATTState >::server_mtu() const
+    inline std::uint16_t att_bearer::server_mtu() const
     {
         return server_mtu_;
     }
 
-    template < class ATTState >
-    bool link_state< ATTState >::is_encrypted() const
+    inline void att_bearer::park_att_request( std::uint8_t opcode, std::uint16_t handle, std::uint16_t offset, std::uint8_t sequence )
+    {
+        assert( opcode != 0 );
+
+        pending_opcode_     = opcode;
+        pending_handle_     = handle;
+        pending_offset_     = offset;
+        pending_sequence_   = sequence;
+        completion_pending_ = false;
+    }
+
+    inline bool att_bearer::att_request_pending() const
+    {
+        return pending_opcode_ != 0;
+    }
+
+    inline std::uint8_t att_bearer::pending_att_opcode() const
+    {
+        return pending_opcode_;
+    }
+
+    inline std::uint16_t att_bearer::pending_att_handle() const
+    {
+        return pending_handle_;
+    }
+
+    inline std::uint16_t att_bearer::pending_att_offset() const
+    {
+        return pending_offset_;
+    }
+
+    inline std::uint8_t att_bearer::pending_att_sequence() const
+    {
+        return pending_sequence_;
+    }
+
+    inline void att_bearer::complete_att_request( std::uint8_t error_code )
+    {
+        assert( att_request_pending() );
+
+        completion_pending_ = true;
+        completion_error_   = error_code;
+    }
+
+    inline bool att_bearer::att_request_completion_pending() const
+    {
+        return completion_pending_;
+    }
+
+    inline std::uint8_t att_bearer::att_request_completion_error() const
+    {
+        return completion_error_;
+    }
+
+    inline void att_bearer::att_request_completed()
+    {
+        pending_opcode_     = 0;
+        completion_pending_ = false;
+    }
+
+    inline void att_bearer::indication_sent()
+    {
+        confirmation_pending_ = true;
+    }
+
+    inline void att_bearer::confirmation_received()
+    {
+        confirmation_pending_ = false;
+    }
+
+    inline bool att_bearer::confirmation_pending() const
+    {
+        return confirmation_pending_;
+    }
+
+    template < class ATTState, std::size_t EnhancedBearers >
+    link_state< ATTState, EnhancedBearers >::link_state( std::uint16_t server_mtu )
+        : ATTState()
+        , att_bearer( server_mtu )
+        , encrypted_( false )
+        , pairing_status_( device_pairing_status::no_key )
+    {
+    }
+
+    template < class ATTState, std::size_t EnhancedBearers >
+    att_bearer& link_state< ATTState, EnhancedBearers >::bearer( std::size_t index )
+    {
+        assert( index < number_of_bearers );
+
+        return index == 0
+            ? static_cast< att_bearer& >( *this )
+            : enhanced_bearers_[ index - 1 ];
+    }
+
+    template < class ATTState, std::size_t EnhancedBearers >
+    bool link_state< ATTState, EnhancedBearers >::is_encrypted() const
     {
         return encrypted_;
     }
 
-    template < class ATTState >
-    void link_state< ATTState >::is_encrypted( bool encrypted )
+    template < class ATTState, std::size_t EnhancedBearers >
+    void link_state< ATTState, EnhancedBearers >::is_encrypted( bool encrypted )
     {
         encrypted_ = encrypted;
     }
 
-    template < class ATTState >
-    device_pairing_status link_state< ATTState >::pairing_status() const
+    template < class ATTState, std::size_t EnhancedBearers >
+    device_pairing_status link_state< ATTState, EnhancedBearers >::pairing_status() const
     {
         return pairing_status_;
     }
 
-    template < class ATTState >
-    void link_state< ATTState >::pairing_status( device_pairing_status status )
+    template < class ATTState, std::size_t EnhancedBearers >
+    void link_state< ATTState, EnhancedBearers >::pairing_status( device_pairing_status status )
     {
         pairing_status_ = status;
     }
 
-    template < class ATTState >
-    connection_security_attributes link_state< ATTState >::security_attributes() const
+    template < class ATTState, std::size_t EnhancedBearers >
+    connection_security_attributes link_state< ATTState, EnhancedBearers >::security_attributes() const
     {
         return connection_security_attributes{ encrypted_, pairing_status_ };
     }
@@ -0,0 +1,54 @@
+#ifndef BLUETOE_MULTIPLE_NOTIFICATIONS_HPP
+#define BLUETOE_MULTIPLE_NOTIFICATIONS_HPP
+
+#include <bluetoe/meta_types.hpp>
+
+namespace bluetoe {
+
+    namespace details {
+        struct multiple_notifications_meta_type {};
+
+        /*
+         * result of adding a handle, length, value tuple to a Multiple Handle Value Notification
+         */
+        enum class notification_tuple_result {
+            // the tuple was added to the PDU
+            added,
+            // notifications are not enabled, or the value could not be read; the notification is dropped
+            skipped,
+            // the value does not fit into the remaining space of the PDU
+            no_space
+        };
+    }
+
+    /**
+     * @brief combine several queued notifications into one ATT Multiple Handle Value Notification
+     *
+     * With this option, the link layer takes as many queued notifications from the notification queue,
+     * as fit into one ATT PDU and sends them as a single ATT_MULTIPLE_HANDLE_VALUE_NTF, containing a
+     * handle, length and value tuple for every notified characteristic. For a lot of small characteristic
+     * values, this saves the ATT and L2CAP overhead per value and the number of LL PDUs per connection event.
+     *
+     * If only a single notification is queued or the value of a characteristic does not fit into the
+     * remaining space of the PDU, a plain ATT Handle Value Notification is sent. Values are never truncated
+     * within a Multiple Handle Value Notification; a value, that does not fit, is sent with the next PDU.
+     *
+     * The Multiple Handle Value Notification was introduced with Bluetooth 5.2. A GATT client announces its
+     * support for this PDU by writing to the Client Supported Features characteristic. So this option takes only
+     * effect in combination with bluetoe::gatt_caching and only for clients that announced their support. All
+     * other clients receive plain notifications.
+     *
+     * @sa server
+     * @sa notify
+     * @sa gatt_caching
+     */
+    struct multiple_handle_value_notifications {
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::multiple_notifications_meta_type,
+            details::valid_server_option_meta_type {};
+        /** @endcond */
+    };
+}
+
+#endif
@@ -0,0 +1,315 @@
+#ifndef BLUETOE_NOTIFICATION_FIFO_HPP
+#define BLUETOE_NOTIFICATION_FIFO_HPP
+
+#include <bluetoe/meta_types.hpp>
+#include <bluetoe/meta_tools.hpp>
+
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <tuple>
+
+namespace bluetoe {
+
+    namespace details {
+        struct notification_fifo_meta_type {};
+    }
+
+    /**
+     * @brief captures the value of a characteristic with every call to server::notify() into a FIFO of Depth samples
+     *
+     * By default, notifying a characteristic just queues the characteristic for notification and the value is read,
+     * when the link layer fills the next PDU. Samples, that are produced faster than the connection interval, are
+     * lost. With this option, every call to server::notify() copies the current value of a
+     * bluetoe::bind_characteristic_value into a ring of Depth samples. The link layer drains the ring in order and
+     * packs as many samples, as fit into the negotiated MTU, into a single ATT Handle Value Notification. So the
+     * client has to know the size of a sample, to split the notified value.
+     *
+     * If the FIFO is full, server::notify() returns false and the sample is not captured. The samples are dropped,
+     * when the client has not subscribed for notifications. The memory for the FIFO is statically allocated per
+     * bound value. The FIFO itself is lock free, but server::notify() also queues the characteristic in the link
+     * layer, which is not interrupt safe. So server::notify() has to be called from the same context, that calls
+     * the link layers run() function.
+     *
+     * The option has no effect on indications and on reading the characteristic value.
+     *
+     * Example:
+     * @code
+        struct acceleration {
+            std::int16_t x, y, z;
+        } sample;
+
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0xD0B10674, 0x6DDD, 0x4B59, 0x89CA, 0xA009B78C956B >,
+            bluetoe::bind_characteristic_value< decltype( sample ), &sample >,
+            bluetoe::no_write_access,
+            bluetoe::notify,
+            bluetoe::notification_fifo< 16 > >
+     * @endcode
+     * @sa bind_characteristic_value
+     * @sa server::notify
+     */
+    template < std::size_t Depth >
+    struct notification_fifo {
+        static_assert( Depth > 0, "a notification FIFO needs room for at least one sample" );
+
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr std::size_t depth = Depth;
+
+        struct meta_type :
+            details::notification_fifo_meta_type,
+            details::valid_characteristic_option_meta_type {};
+        /** @endcond */
+    };
+
+    namespace details {
+
+        /*
+         * single producer, single consumer ring of samples with SampleSize octets
+         */
+        template < std::size_t SampleSize, std::size_t Depth >
+        class sample_fifo
+        {
+        public:
+            sample_fifo()
+                : write_( 0 )
+                , read_( 0 )
+            {
+            }
+
+            // producer: returns false, if the FIFO is full
+            bool push( const std::uint8_t* sample )
+            {
+                const std::size_t write = write_.load( std::memory_order_relaxed );
+                const std::size_t next  = increment( write );
+
+                if ( next == read_.load( std::memory_order_acquire ) )
+                    return false;
+
+                std::copy( sample, sample + SampleSize, &samples_[ write ][ 0 ] );
+                write_.store( next, std::memory_order_release );
+
+                return true;
+            }
+
+            // consumer: copies as many whole samples, as fit into the output. At least one sample is removed,
+            // if the FIFO is not empty, even if it has to be truncated.
+            std::size_t pop( std::uint8_t* output, std::size_t size )
+            {
+                const std::size_t write = write_.load( std::memory_order_acquire );
+                      std::size_t read  = read_.load( std::memory_order_relaxed );
+                      std::size_t used  = 0;
+
+                for ( ; read != write && ( used + SampleSize <= size || used == 0 ); read = increment( read ) )
+                {
+                    const std::size_t copy = std::min( SampleSize, size - used );
+                    std::copy( &samples_[ read ][ 0 ], &samples_[ read ][ copy ], output + used );
+                    used += copy;
+                }
+
+                read_.store( read, std::memory_order_release );
+
+                return used;
+            }
+
+            // consumer
+            bool empty() const
+            {
+                return read_.load( std::memory_order_relaxed ) == write_.load( std::memory_order_acquire );
+            }
+
+            // consumer
+            void clear()
+            {
+                read_.store( write_.load( std::memory_order_acquire ), std::memory_order_release );
+            }
+
+        private:
+            // one slot is always unused to distinguish a full from an empty FIFO
+            static constexpr std::size_t slots = Depth + 1;
+
+            static std::size_t increment( std::size_t index )
+            {
+                return index + 1 == slots ? 0 : index + 1;
+            }
+
+            std::uint8_t                samples_[ slots ][ SampleSize ];
+            std::atomic< std::size_t >  write_;
+            std::atomic< std::size_t >  read_;
+        };
+
+        /*
+         * statically allocated FIFO of a bound characteristic value
+         */
+        template < typename T, T* Ptr, std::size_t Depth >
+        struct bound_value_fifo
+        {
+            static constexpr bool enabled = true;
+
+            static bool capture()
+            {
+                return fifo_.push( static_cast< const std::uint8_t* >( static_cast< const void* >( Ptr ) ) );
+            }
+
+            static std::size_t output( std::uint8_t* output, std::size_t size )
+            {
+                return fifo_.pop( output, size );
+            }
+
+            static bool empty()
+            {
+                return fifo_.empty();
+            }
+
+            static void clear()
+            {
+                fifo_.clear();
+            }
+
+        private:
+            static sample_fifo< sizeof( T ), Depth > fifo_;
+        };
+
+        template < typename T, T* Ptr, std::size_t Depth >
+        sample_fifo< sizeof( T ), Depth > bound_value_fifo< T, Ptr, Depth >::fifo_;
+
+        struct no_bound_value_fifo
+        {
+            static constexpr bool enabled = false;
+        };
+
+        template < typename T, T* Ptr, typename Option >
+        struct select_bound_value_fifo
+        {
+            using type = bound_value_fifo< T, Ptr, Option::depth >;
+        };
+
+        template < typename T, T* Ptr >
+        struct select_bound_value_fifo< T, Ptr, no_such_type >
+        {
+            using type = no_bound_value_fifo;
+        };
+
+        template < typename T, T* Ptr, typename ... Options >
+        using bound_value_notification_fifo = typename select_bound_value_fifo<
+            T, Ptr,
+            typename find_by_meta_type< notification_fifo_meta_type, Options..., no_such_type >::type >::type;
+
+        /*
+         * a value type, that supports notification_fifo, provides the selected FIFO as notification_samples
+         */
+        template < typename ValueType >
+        struct notification_fifo_of
+        {
+            template < class V >
+            static typename V::notification_samples check( typename V::notification_samples* );
+
+            template < class V >
+            static no_bound_value_fifo check( ... );
+
+            using type = decltype( check< ValueType >( nullptr ) );
+        };
+
+        struct notification_fifo_entry
+        {
+            bool        (*capture)();
+            std::size_t (*output)( std::uint8_t*, std::size_t );
+            bool        (*empty)();
+            void        (*clear)();
+        };
+
+        template < typename Fifo, bool Enabled = Fifo::enabled >
+        struct notification_fifo_entry_for
+        {
+            static constexpr notification_fifo_entry entry()
+            {
+                return notification_fifo_entry{ &Fifo::capture, &Fifo::output, &Fifo::empty, &Fifo::clear };
+            }
+        };
+
+        template < typename Fifo >
+        struct notification_fifo_entry_for< Fifo, false >
+        {
+            static constexpr notification_fifo_entry entry()
+            {
+                return notification_fifo_entry{ nullptr, nullptr, nullptr, nullptr };
+            }
+        };
+
+        template < typename Characteristic >
+        struct characteristic_has_notification_fifo
+        {
+            static constexpr bool value = notification_fifo_of< typename Characteristic::characteristic_t::value_type >::type::enabled;
+        };
+
+        /*
+         * dispatches to the FIFOs of the notifiable characteristics by notification index. Without any
+         * FIFO, there is no table at all.
+         */
+        template < typename Characteristics, bool Enabled = count_if< Characteristics, characteristic_has_notification_fifo >::value != 0 >
+        struct notification_fifo_table
+        {
+            static bool has_fifo( std::size_t )
+            {
+                return false;
+            }
+
+            static bool capture( std::size_t )
+            {
+                return true;
+            }
+
+            static std::size_t output( std::size_t, std::uint8_t*, std::size_t )
+            {
+                return 0;
+            }
+
+            static bool empty( std::size_t )
+            {
+                return true;
+            }
+
+            static void clear( std::size_t ) {}
+        };
+
+        template < typename ... Characteristics >
+        struct notification_fifo_table< std::tuple< Characteristics... >, true >
+        {
+            static bool has_fifo( std::size_t index )
+            {
+                return entries[ index ].capture != nullptr;
+            }
+
+            static bool capture( std::size_t index )
+            {
+                return entries[ index ].capture();
+            }
+
+            static std::size_t output( std::size_t index, std::uint8_t* output, std::size_t size )
+            {
+                return entries[ index ].output( output, size );
+            }
+
+            static bool empty( std::size_t index )
+            {
+                return entries[ index ].empty();
+            }
+
+            static void clear( std::size_t index )
+            {
+                entries[ index ].clear();
+            }
+
+        private:
+            static constexpr notification_fifo_entry entries[ sizeof...( Characteristics ) ] = {
+                notification_fifo_entry_for< typename notification_fifo_of< typename Characteristics::characteristic_t::value_type >::type >::entry()...
+            };
+        };
+
+        template < typename ... Characteristics >
+        constexpr notification_fifo_entry notification_fifo_table< std::tuple< Characteristics... >, true >::entries[ sizeof...( Characteristics ) ];
+    }
+}
+
+#endif
@@ -12,11 +12,15 @@
 #include <bluetoe/client_characteristic_configuration.hpp>
 #include <bluetoe/write_queue.hpp>
 #include <bluetoe/gap_service.hpp>
+#include <bluetoe/gatt_caching.hpp>
 #include <bluetoe/appearance.hpp>
 #include <bluetoe/mixin.hpp>
 #include <bluetoe/find_notification_data.hpp>
 #include <bluetoe/outgoing_priority.hpp>
 #include <bluetoe/link_state.hpp>
+#include <bluetoe/attribute_table.hpp>
+#include <bluetoe/multiple_notifications.hpp>
+#include <bluetoe/enhanced_att.hpp>
 #include <cstdint>
 #include <cstddef>
 #include <algorithm>
@@ -57,6 +61,9 @@ namespace bluetoe {
      * @sa server_name
      * @sa appearance
      * @sa requires_encryption
+     * @sa flat_attribute_table
+     * @sa multiple_handle_value_notifications
+     * @sa gatt_caching
      */
     template < typename ... Options >
     class server : private details::write_queue< typename details::find_by_meta_type< details::write_queue_meta_type, Options... >::type >,
@@ -69,7 +76,21 @@ namespace bluetoe {
         // append gap serivce for gatt servers
         using gap_service_definition = typename details::find_by_meta_type< details::gap_service_definition_meta_type,
             Options..., gap_service_for_gatt_servers >::type;
-        using services = typename gap_service_definition::template add_service< services_without_gap, Options... >::type;
+        using services_without_gatt = typename gap_service_definition::template add_service< services_without_gap, Options... >::type;
+
+        using enhanced_att_definition = typename details::find_by_meta_type< details::enhanced_att_meta_type, Options..., no_enhanced_att >::type;
+
+        static constexpr std::size_t   number_of_enhanced_att_bearers = enhanced_att_definition::bearers;
+        static constexpr std::uint16_t enhanced_att_mtu               = enhanced_att_definition::mtu;
+
+        // append generic attribute service, if GATT caching is enabled
+        using gatt_caching_definition = typename details::find_by_meta_type< details::gatt_caching_meta_type,
+            Options..., no_gatt_caching >::type;
+        using services = typename gatt_caching_definition::template add_service<
+            services_without_gatt, number_of_enhanced_att_bearers != 0 >::type;
+
+        static_assert( number_of_enhanced_att_bearers == 0 || !std::is_same< gatt_caching_definition, no_gatt_caching >::value,
+            "Enhanced ATT bearers require bluetoe::gatt_caching, to announce the support in the Server Supported Features characteristic" );
 
         static constexpr std::size_t number_of_client_configs = details::sum_by< services, details::sum_by_client_configs >::value;
 
@@ -81,6 +102,15 @@ namespace bluetoe {
             "Only one of bluetoe::higher_outgoing_priority<> or bluetoe::lower_outgoing_priority<> per server allowed!" );
 
         using cccd_indices = typename details::find_notification_data_in_list< notification_priority, services >::cccd_indices;
+
+        using notification_fifos = details::notification_fifo_table<
+            typename details::find_notification_data_in_list< notification_priority, services >::characteristics_sorted_by_priority >;
+
+        using attribute_table = typename details::find_by_meta_type< details::attribute_table_meta_type, Options..., details::recursive_attribute_table >::type;
+
+        static constexpr bool multiple_handle_value_notifications_enabled = !std::is_same<
+            typename details::find_by_meta_type< details::multiple_notifications_meta_type, Options..., details::no_such_type >::type,
+            details::no_such_type >::value;
         /** @endcond */
 
         /**
@@ -91,7 +121,8 @@ namespace bluetoe {
          * be reset with a new connection.
          */
         using connection_data = details::link_state<
-            details::client_characteristic_configurations< number_of_client_configs > >;
+            details::client_characteristic_configurations< number_of_client_configs + gatt_caching_definition::number_of_client_configs >,
+            number_of_enhanced_att_bearers >;
 
         /**
          * @brief a server takes no runtime construction parameters
@@ -130,7 +161,10 @@ namespace bluetoe {
         @endcode
 
          * @return The function will return false, if the given notification was ignored, because the
-         *         characteristic is already queued for notification, but not yet send out.
+         *         characteristic is already queued for notification, but not yet send out. For a characteristic
+         *         with a notification_fifo, the function returns false, if the FIFO is full.
+         *
+         * @sa notification_fifo
          */
         template < class T >
         bool notify( const T& value );
@@ -213,13 +247,85 @@ namespace bluetoe {
         template < class CharacteristicUUID >
         bool configured_for_notifications_or_indications( const details::client_characteristic_configuration& ) const;
 
+        /**
+         * @brief completes a Read or Read Blob Request, for which a read handler returned bluetoe::error_codes::pending
+         *
+         * A read handler, that can not provide the characteristic value immediately (for example, because a sensor
+         * has to be sampled first), returns bluetoe::error_codes::pending. The request is parked in the connection
+         * state and no response is send. Once the value is available, the application calls this function. The link
+         * layer then calls the read handler again, with the same offset, and sends the read response with the next
+         * connection event. If the handler returns pending again, the request stays parked.
+         *
+         * If error_code is not bluetoe::error_codes::success, the handler is not called again and an error response
+         * with the given error code is send.
+         *
+         * It's safe to call this function from an interrupt service routine. There is at most one pending request
+         * per ATT bearer, as an ATT client must not send a new request on a bearer, before the previous request was
+         * answered. With enhanced ATT bearers (see enhanced_att), every call completes one parked request of the same
+         * kind. The completions are applied in the order, in which the requests were parked. All completions have to
+         * be called from the same context.
+         *
+         * Example:
+         @code
+        std::uint8_t read_pressure( std::size_t read_size, std::uint8_t* out_buffer, std::size_t& out_size )
+        {
+            if ( !sample_available )
+            {
+                start_conversion();
+                return bluetoe::error_codes::pending;
+            }
+
+            sample_available = false;
+            ...
+            return bluetoe::error_codes::success;
+        }
+
+        void conversion_done_isr()
+        {
+            sample_available = true;
+            gatt_server.complete_pending_read();
+        }
+        @endcode
+         *
+         * @sa complete_pending_write
+         * @sa bluetoe::error_codes::pending
+         */
+        void complete_pending_read( std::uint8_t error_code = error_codes::success );
+
+        /**
+         * @brief completes a Write Request, for which a write handler returned bluetoe::error_codes::pending
+         *
+         * The written value was passed to the write handler, when the request was received. This function just
+         * sends the write response, or an error response, if error_code is not bluetoe::error_codes::success.
+         *
+         * @sa complete_pending_read
+         * @sa bluetoe::error_codes::pending
+         */
+        void complete_pending_write( std::uint8_t error_code = error_codes::success );
+
         /** @cond HIDDEN_SYMBOLS */
         // function relevant only for l2cap layers
         /**
          * @brief function to be called by a L2CAP implementation to provide the input from the L2CAP layer and the data assiziate with the connection
+         *
+         * If the L2CAP implementation passes a reference, the response to a Read or Read Blob Request may refer to the value of
+         * the attribute, instead of containing a copy. If the reference is not empty after the call, the response consists of the
+         * out_size octets in output, followed by the reference->size octets at reference->data.
+         */
+        template < typename ConnectionData >
+        void l2cap_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData&,
+            details::output_reference* reference = nullptr );
+
+        /**
+         * @brief input from the given ATT bearer of the connection
+         *
+         * The MTU and the outstanding request and confirmation are taken from the bearer. All other connection related
+         * data (client characteristic configurations, security) is shared by all bearers of the connection.
+         * The unenhanced ATT bearer is the connection data itself.
          */
         template < typename ConnectionData >
-        void l2cap_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
+        void l2cap_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData&,
+            details::att_bearer& bearer, details::output_reference* reference = nullptr );
 
         /**
          * @brief returns the advertising data to the L2CAP implementation
@@ -230,7 +336,8 @@ namespace bluetoe {
         enum notification_type {
             notification,
             indication,
-            confirmation
+            confirmation,
+            pending_response
         };
 
         typedef bool (*lcap_notification_callback_t)( const details::notification_data& item, void* usr_arg, notification_type type );
@@ -249,6 +356,39 @@ namespace bluetoe {
 
         void indication_output( std::uint8_t* output, std::size_t& out_size, connection_data& connection, std::size_t client_characteristic_configuration_index );
 
+        /**
+         * @brief appends the handle, length and value tuple of the indexed characteristic to a Multiple Handle Value Notification
+         *
+         * out_size is the remaining space in the PDU. If the tuple was added, out_size is set to the size of the tuple.
+         */
+        details::notification_tuple_result multiple_notification_tuple_output( std::uint8_t* output, std::size_t& out_size, connection_data& connection, std::size_t client_characteristic_configuration_index );
+
+        /**
+         * @brief returns true, if Multiple Handle Value Notifications can be sent to the client of the connection
+         *
+         * The server has to be configured with multiple_handle_value_notifications and the client has to announce its support
+         * through the Client Supported Features characteristic (see gatt_caching).
+         */
+        static bool multiple_handle_value_notifications_supported( connection_data& connection );
+
+        /**
+         * @brief generates the response to a parked ATT request, after it was completed by the application
+         *
+         * The server calls the notification callback with pending_response as type, when a parked request was completed.
+         * If there is no response available, out_size is set to 0.
+         */
+        template < typename ConnectionData >
+        void pending_response_output( std::uint8_t* output, std::size_t& out_size, ConnectionData& connection );
+
+        /**
+         * @brief generates the response to a parked ATT request of the given bearer
+         *
+         * A completion is applied to the bearer with the oldest parked request of the completed kind, that is
+         * not completed yet.
+         */
+        template < typename ConnectionData >
+        void pending_response_output( std::uint8_t* output, std::size_t& out_size, ConnectionData& connection, details::att_bearer& bearer );
+
         /**
          * @attention this function must be called with every client that got disconnected.
          */
@@ -264,6 +404,12 @@ namespace bluetoe {
 
         static_assert( std::tuple_size< services >::value > 0, "A server should at least contain one service." );
 
+        bool queue_notification( const details::notification_data& data );
+        void complete_pending_request( std::uint8_t completion, std::uint8_t error_code );
+        template < typename ConnectionData >
+        void assign_completions( ConnectionData& connection );
+        void notification_fifo_output( std::uint8_t* output, std::size_t& out_size, connection_data& connection, const details::notification_data& data );
+
         void error_response( std::uint8_t opcode, details::att_error_codes error_code, std::uint16_t handle, std::uint8_t* output, std::size_t& out_size );
         void error_response( std::uint8_t opcode, details::att_error_codes error_code, std::uint8_t* output, std::size_t& out_size );
 
@@ -281,21 +427,26 @@ namespace bluetoe {
         bool check_size_and_handle( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, std::uint16_t& handle );
         bool check_handle( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, std::uint16_t& handle );
 
-        template < typename ConnectionData >
-        void handle_exchange_mtu_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
+        void handle_exchange_mtu_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, details::att_bearer&, bool enhanced_bearer );
         void handle_find_information_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size );
         void handle_find_by_type_value_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size );
         template < typename ConnectionData >
         void handle_read_by_type_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
         template < typename ConnectionData >
-        void handle_read_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
+        void handle_read_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData&, details::att_bearer&, details::output_reference* );
+        template < typename ConnectionData >
+        void handle_read_blob_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData&, details::att_bearer&, details::output_reference* );
         template < typename ConnectionData >
-        void handle_read_blob_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
+        void read_response( details::att_opcodes opcode, std::uint16_t handle, std::uint16_t offset, std::uint8_t* output, std::size_t& out_size, ConnectionData&, details::att_bearer& );
+        template < typename ConnectionData >
+        bool read_response_by_reference( std::uint16_t handle, std::uint16_t offset, details::att_opcodes opcode, std::uint8_t* output, std::size_t& out_size, ConnectionData&, details::output_reference& );
         void handle_read_by_group_type_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size );
         template < typename ConnectionData >
         void handle_read_multiple_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
         template < typename ConnectionData >
-        void handle_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
+        void handle_read_multiple_variable_length_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
+        template < typename ConnectionData >
+        void handle_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData&, details::att_bearer& );
         template < typename ConnectionData >
         void handle_write_command( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
 
@@ -305,7 +456,7 @@ namespace bluetoe {
         void handle_execute_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data&, const details::no_such_type& );
         template < typename WriteQueue >
         void handle_execute_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data&, const WriteQueue& );
-        void handle_value_confirmation( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data& );
+        void handle_value_confirmation( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, details::att_bearer&, bool enhanced_bearer );
 
         template < class Iterator, class Filter = details::all_uuid_filter >
         void all_attributes( std::uint16_t starting_handle, std::uint16_t ending_handle, Iterator&, const Filter& filter = details::all_uuid_filter() );
@@ -321,6 +472,19 @@ namespace bluetoe {
         lcap_notification_callback_t l2cap_cb_;
         void*                        l2cap_arg_;
 
+        // there can not be more parked requests, than there are ATT bearers
+        static constexpr std::size_t max_completions = number_of_enhanced_att_bearers + 1;
+
+        // opcodes of the completed, parked requests and the results, queued by complete_pending_read() / complete_pending_write()
+        // and assigned to the parked requests by assign_completions()
+        volatile std::uint8_t        completed_opcodes_[ max_completions ];
+        volatile std::uint8_t        completion_errors_[ max_completions ];
+        volatile std::uint8_t        completions_written_;
+        volatile std::uint8_t        completions_read_;
+
+        // incremented with every parked request
+        std::uint8_t                 parked_requests_;
+
         static constexpr auto options_test = sizeof(
             details::option_passed_to_server_that_is_not_a_valid_option_for_a_server<
                 typename details::find_by_not_meta_type<
@@ -376,16 +540,33 @@ namespace bluetoe {
     template < typename ... Options >
     server< Options... >::server()
         : l2cap_cb_( nullptr )
+        , completions_written_( 0 )
+        , completions_read_( 0 )
+        , parked_requests_( 0 )
     {
+        gatt_caching_definition::template calculate_database_hash< server< Options... > >();
+    }
 
+    template < typename ... Options >
+    template < typename ConnectionData >
+    void server< Options... >::l2cap_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection,
+        details::output_reference* reference )
+    {
+        l2cap_input( input, in_size, output, out_size, connection, static_cast< details::att_bearer& >( connection ), reference );
     }
 
     template < typename ... Options >
     template < typename ConnectionData >
-    void server< Options... >::l2cap_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection )
+    void server< Options... >::l2cap_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection,
+        details::att_bearer& bearer, details::output_reference* reference )
     {
+        if ( reference )
+            *reference = details::output_reference();
+
         // clip the output size to the negotiated mtu
-        out_size = std::min< std::size_t >( out_size, connection.negotiated_mtu() );
+        out_size = std::min< std::size_t >( out_size, bearer.negotiated_mtu() );
+
+        const bool enhanced_bearer = &bearer != &static_cast< details::att_bearer& >( connection );
 
         assert( in_size != 0 );
         assert( out_size >= details::default_att_mtu_size );
@@ -395,7 +576,7 @@ namespace bluetoe {
         switch ( opcode )
         {
         case details::att_opcodes::exchange_mtu_request:
-            handle_exchange_mtu_request( input, in_size, output, out_size, connection );
+            handle_exchange_mtu_request( input, in_size, output, out_size, bearer, enhanced_bearer );
             break;
         case details::att_opcodes::find_information_request:
             handle_find_information_request( input, in_size, output, out_size );
@@ -407,10 +588,10 @@ namespace bluetoe {
             handle_read_by_type_request( input, in_size, output, out_size, connection );
             break;
         case details::att_opcodes::read_request:
-            handle_read_request( input, in_size, output, out_size, connection );
+            handle_read_request( input, in_size, output, out_size, connection, bearer, reference );
             break;
         case details::att_opcodes::read_blob_request:
-            handle_read_blob_request( input, in_size, output, out_size, connection );
+            handle_read_blob_request( input, in_size, output, out_size, connection, bearer, reference );
             break;
         case details::att_opcodes::read_by_group_type_request:
             handle_read_by_group_type_request( input, in_size, output, out_size );
@@ -418,8 +599,11 @@ namespace bluetoe {
         case details::att_opcodes::read_multiple_request:
             handle_read_multiple_request( input, in_size, output, out_size, connection );
             break;
+        case details::att_opcodes::read_multiple_variable_length_request:
+            handle_read_multiple_variable_length_request( input, in_size, output, out_size, connection );
+            break;
         case details::att_opcodes::write_request:
-            handle_write_request( input, in_size, output, out_size, connection );
+            handle_write_request( input, in_size, output, out_size, connection, bearer );
             break;
         case details::att_opcodes::write_command:
             handle_write_command( input, in_size, output, out_size, connection );
@@ -431,7 +615,7 @@ namespace bluetoe {
             handle_execute_write_request( input, in_size, output, out_size, connection, write_queue_type() );
             break;
         case details::att_opcodes::confirmation:
-            handle_value_confirmation( input, in_size, output, out_size, connection );
+            handle_value_confirmation( input, in_size, output, out_size, bearer, enhanced_bearer );
             break;
         default:
             error_response( *input, details::att_error_codes::request_not_supported, output, out_size );
@@ -542,10 +726,7 @@ namespace bluetoe {
         const details::notification_data data = find_notification_data( &value );
         assert( data.valid() );
 
-        if ( l2cap_cb_ )
-            return l2cap_cb_( data, l2cap_arg_, notification );
-
-        return false;
+        return queue_notification( data );
     }
 
     template < typename ... Options >
@@ -561,10 +742,7 @@ namespace bluetoe {
 
         const auto data = details::find_notification_by_uuid< notification_priority, services, typename characteristic::characteristic_t >::data();
 
-        if ( l2cap_cb_ )
-            return l2cap_cb_( data, l2cap_arg_, notification );
-
-        return false;
+        return queue_notification( data );
     }
 
     template < typename ... Options >
@@ -640,11 +818,36 @@ namespace bluetoe {
         l2cap_arg_ = usr_arg;
     }
 
+    template < typename ... Options >
+    bool server< Options... >::queue_notification( const details::notification_data& data )
+    {
+        if ( !l2cap_cb_ )
+            return false;
+
+        const std::size_t index = data.client_characteristic_configuration_index();
+
+        // every captured sample will be notified, even if the characteristic is already queued
+        if ( notification_fifos::has_fifo( index ) )
+        {
+            if ( !notification_fifos::capture( index ) )
+                return false;
+
+            l2cap_cb_( data, l2cap_arg_, notification );
+
+            return true;
+        }
+
+        return l2cap_cb_( data, l2cap_arg_, notification );
+    }
+
     template < typename ... Options >
     void server< Options... >::notification_output( std::uint8_t* output, std::size_t& out_size, connection_data& connection, const details::notification_data& data )
     {
         assert( data.valid() );
 
+        if ( notification_fifos::has_fifo( data.client_characteristic_configuration_index() ) )
+            return notification_fifo_output( output, out_size, connection, data );
+
         if ( connection.client_configurations().flags( data.client_characteristic_configuration_index() ) & details::client_characteristic_configuration_notification_enabled &&
              out_size >= 3 )
         {
@@ -666,6 +869,44 @@ namespace bluetoe {
         }
     }
 
+    template < typename ... Options >
+    void server< Options... >::notification_fifo_output( std::uint8_t* output, std::size_t& out_size, connection_data& connection, const details::notification_data& data )
+    {
+        const std::size_t index = data.client_characteristic_configuration_index();
+
+        if ( ( connection.client_configurations().flags( index ) & details::client_characteristic_configuration_notification_enabled ) == 0 )
+        {
+            notification_fifos::clear( index );
+            out_size = 0;
+
+            return;
+        }
+
+        if ( out_size < 3 )
+        {
+            out_size = 0;
+            return;
+        }
+
+        const std::size_t samples_size = notification_fifos::output( index, output + 3, out_size - 3 );
+
+        // the characteristic might have been queued again, after all samples were transmitted
+        if ( samples_size == 0 )
+        {
+            out_size = 0;
+            return;
+        }
+
+        *output = bits( details::att_opcodes::notification );
+        details::write_handle( output +1, data.handle() );
+
+        out_size = 3 + samples_size;
+
+        // keep the characteristic queued, until all samples are transmitted
+        if ( !notification_fifos::empty( index ) && l2cap_cb_ )
+            l2cap_cb_( data, l2cap_arg_, notification );
+    }
+
     template < typename ... Options >
     void server< Options... >::notification_output( std::uint8_t* output, std::size_t& out_size, connection_data& connection, std::size_t client_characteristic_configuration_index )
     {
@@ -699,6 +940,168 @@ namespace bluetoe {
         }
     }
 
+    template < typename ... Options >
+    details::notification_tuple_result server< Options... >::multiple_notification_tuple_output( std::uint8_t* output, std::size_t& out_size, connection_data& connection, std::size_t client_characteristic_configuration_index )
+    {
+        static constexpr std::size_t tuple_header_size = 4;
+
+        const auto data = find_notification_data_by_index( client_characteristic_configuration_index );
+        assert( data.valid() );
+
+        const std::size_t available = out_size;
+        out_size = 0;
+
+        if ( ( connection.client_configurations().flags( data.client_characteristic_configuration_index() ) & details::client_characteristic_configuration_notification_enabled ) == 0 )
+        {
+            notification_fifos::clear( data.client_characteristic_configuration_index() );
+            return details::notification_tuple_result::skipped;
+        }
+
+        // samples from a FIFO are always packed into a plain notification
+        if ( available <= tuple_header_size || notification_fifos::has_fifo( data.client_characteristic_configuration_index() ) )
+            return details::notification_tuple_result::no_space;
+
+        auto read = details::attribute_access_arguments::read( output + tuple_header_size, output + available, 0, connection.client_configurations(), connection.security_attributes(), this );
+        auto attr = attribute_at( data.handle() - 1 );
+
+        if ( attr.access( read, data.handle() ) != details::attribute_access_result::success )
+            return details::notification_tuple_result::skipped;
+
+        // a value that fills the remaining space completely, might have been truncated; values are never truncated
+        if ( tuple_header_size + read.buffer_size == available )
+        {
+            std::uint8_t probe;
+            auto rest = details::attribute_access_arguments::read( &probe, &probe + 1, read.buffer_size, connection.client_configurations(), connection.security_attributes(), this );
+
+            if ( attr.access( rest, data.handle() ) != details::attribute_access_result::success || rest.buffer_size != 0 )
+                return details::notification_tuple_result::no_space;
+        }
+
+        details::write_handle( output, data.handle() );
+        details::write_16bit( output + 2, static_cast< std::uint16_t >( read.buffer_size ) );
+        out_size = tuple_header_size + read.buffer_size;
+
+        return details::notification_tuple_result::added;
+    }
+
+    template < typename ... Options >
+    bool server< Options... >::multiple_handle_value_notifications_supported( connection_data& connection )
+    {
+        return multiple_handle_value_notifications_enabled
+            && gatt_caching_definition::template client_supports< server< Options... > >(
+                connection.client_configurations(), details::client_supported_features::multiple_handle_value_notifications );
+    }
+
+    template < typename ... Options >
+    void server< Options... >::complete_pending_read( std::uint8_t error_code )
+    {
+        complete_pending_request( bits( details::att_opcodes::read_request ), error_code );
+    }
+
+    template < typename ... Options >
+    void server< Options... >::complete_pending_write( std::uint8_t error_code )
+    {
+        complete_pending_request( bits( details::att_opcodes::write_request ), error_code );
+    }
+
+    template < typename ... Options >
+    void server< Options... >::complete_pending_request( std::uint8_t completion, std::uint8_t error_code )
+    {
+        const std::uint8_t written = completions_written_;
+
+        // more completions than parked requests
+        if ( static_cast< std::uint8_t >( written - completions_read_ ) == max_completions )
+            return;
+
+        completed_opcodes_[ written % max_completions ] = completion;
+        completion_errors_[ written % max_completions ] = error_code;
+        completions_written_ = static_cast< std::uint8_t >( written + 1 );
+
+        if ( l2cap_cb_ )
+            l2cap_cb_( details::notification_data(), l2cap_arg_, pending_response );
+    }
+
+    template < typename ... Options >
+    template < typename ConnectionData >
+    void server< Options... >::assign_completions( ConnectionData& connection )
+    {
+        for ( std::uint8_t read = completions_read_; read != completions_written_; ++read )
+        {
+            const std::uint8_t completion = completed_opcodes_[ read % max_completions ];
+            const std::uint8_t error_code = completion_errors_[ read % max_completions ];
+            completions_read_ = static_cast< std::uint8_t >( read + 1 );
+
+            // the oldest parked request of the completed kind, that is not completed yet
+            details::att_bearer* oldest = nullptr;
+
+            for ( std::size_t index = 0; index != ConnectionData::number_of_bearers; ++index )
+            {
+                details::att_bearer& bearer = connection.bearer( index );
+
+                if ( !bearer.att_request_pending() || bearer.att_request_completion_pending() )
+                    continue;
+
+                const bool write = bearer.pending_att_opcode() == bits( details::att_opcodes::write_request );
+
+                if ( write != ( completion == bits( details::att_opcodes::write_request ) ) )
+                    continue;
+
+                if ( oldest == nullptr
+                  || static_cast< std::uint8_t >( parked_requests_ - bearer.pending_att_sequence() ) > static_cast< std::uint8_t >( parked_requests_ - oldest->pending_att_sequence() ) )
+                {
+                    oldest = &bearer;
+                }
+            }
+
+            // a completion without parked request is dropped
+            if ( oldest )
+                oldest->complete_att_request( error_code );
+        }
+    }
+
+    template < typename ... Options >
+    template < typename ConnectionData >
+    void server< Options... >::pending_response_output( std::uint8_t* output, std::size_t& out_size, ConnectionData& connection )
+    {
+        pending_response_output( output, out_size, connection, static_cast< details::att_bearer& >( connection ) );
+    }
+
+    template < typename ... Options >
+    template < typename ConnectionData >
+    void server< Options... >::pending_response_output( std::uint8_t* output, std::size_t& out_size, ConnectionData& connection, details::att_bearer& bearer )
+    {
+        assign_completions( connection );
+
+        if ( !bearer.att_request_pending() || !bearer.att_request_completion_pending() )
+        {
+            out_size = 0;
+            return;
+        }
+
+        const std::uint8_t  opcode     = bearer.pending_att_opcode();
+        const std::uint16_t handle     = bearer.pending_att_handle();
+        const std::uint16_t offset     = bearer.pending_att_offset();
+        const std::uint8_t  error_code = bearer.att_request_completion_error();
+        const bool          write      = opcode == bits( details::att_opcodes::write_request );
+
+        bearer.att_request_completed();
+        out_size = std::min< std::size_t >( out_size, bearer.negotiated_mtu() );
+
+        if ( error_code != error_codes::success )
+        {
+            error_response( opcode, static_cast< details::att_error_codes >( error_code ), handle, output, out_size );
+        }
+        else if ( write )
+        {
+            *output  = bits( details::att_opcodes::write_response );
+            out_size = 1;
+        }
+        else
+        {
+            read_response( static_cast< details::att_opcodes >( opcode ), handle, offset, output, out_size, connection, bearer );
+        }
+    }
+
     template < typename ... Options >
     void server< Options... >::client_disconnected( connection_data& client )
     {
@@ -708,7 +1111,7 @@ namespace bluetoe {
     template < typename ... Options >
     details::attribute server< Options... >::attribute_at( std::size_t index )
     {
-        return details::attribute_from_service_list< services, server< Options... >, cccd_indices >::attribute_at( index );
+        return attribute_table::template attribute_at< services, server< Options... >, cccd_indices >( index );
     }
 
     template < typename ... Options >
@@ -742,7 +1145,7 @@ namespace bluetoe {
         // if it can be copied lossles into a att_error_codes, it is a att_error_codes
         const details::att_error_codes result = static_cast< details::att_error_codes >( access_code );
 
-        return static_cast< details::attribute_access_result >( result ) == access_code
+        return static_cast< details::attribute_access_result >( result ) == access_code && access_code != details::attribute_access_result::pending
             ? result
             : default_att_code;
     }
@@ -810,9 +1213,12 @@ namespace bluetoe {
     }
 
     template < typename ... Options >
-    template < typename ConnectionData >
-    void server< Options... >::handle_exchange_mtu_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection )
+    void server< Options... >::handle_exchange_mtu_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, details::att_bearer& bearer, bool enhanced_bearer )
     {
+        // the MTU of an enhanced bearer is the MTU of the L2CAP channel
+        if ( enhanced_bearer )
+            return error_response( *input, details::att_error_codes::request_not_supported, output, out_size );
+
         if ( in_size != 3 )
             return error_response( *input, details::att_error_codes::invalid_pdu, output, out_size );
 
@@ -821,10 +1227,10 @@ namespace bluetoe {
         if ( mtu < details::default_att_mtu_size )
             return error_response( *input, details::att_error_codes::invalid_pdu, output, out_size );
 
-        connection.client_mtu( mtu );
+        bearer.client_mtu( mtu );
 
         *output = bits( details::att_opcodes::exchange_mtu_response );
-        details::write_16bit( output + 1, connection.server_mtu() );
+        details::write_16bit( output + 1, bearer.server_mtu() );
 
         out_size = 3u;
     }
@@ -945,30 +1351,27 @@ namespace bluetoe {
 
     template < typename ... Options >
     template < typename ConnectionData >
-    void server< Options... >::handle_read_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection )
+    void server< Options... >::handle_read_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection,
+        details::att_bearer& bearer, details::output_reference* reference )
     {
         std::uint16_t handle;
 
         if ( !check_size_and_handle< 3 >( input, in_size, output, out_size, handle ) )
             return;
 
-        auto read = details::attribute_access_arguments::read( output + 1, output + out_size, 0, connection.client_configurations(), connection.security_attributes(), this );
-        auto rc   = attribute_at( handle - 1 ).access( read, handle );
+        if ( reference && read_response_by_reference( handle, 0, details::att_opcodes::read_response, output, out_size, connection, *reference ) )
+            return;
 
-        if ( rc == details::attribute_access_result::success )
-        {
-            *output  = bits( details::att_opcodes::read_response );
-            out_size = 1 + read.buffer_size;
-        }
-        else
-        {
-            error_response( *input, details::att_error_codes::read_not_permitted, handle, output, out_size );
-        }
+        // completions, that arrived so far, belong to requests, that were parked before this request
+        assign_completions( connection );
+
+        read_response( details::att_opcodes::read_request, handle, 0, output, out_size, connection, bearer );
     }
 
     template < typename ... Options >
     template < typename ConnectionData >
-    void server< Options... >::handle_read_blob_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection )
+    void server< Options... >::handle_read_blob_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection,
+        details::att_bearer& bearer, details::output_reference* reference )
     {
         std::uint16_t handle;
 
@@ -977,23 +1380,61 @@ namespace bluetoe {
 
         const std::uint16_t offset = details::read_16bit( input + 3 );
 
+        if ( reference && read_response_by_reference( handle, offset, details::att_opcodes::read_blob_response, output, out_size, connection, *reference ) )
+            return;
+
+        assign_completions( connection );
+
+        read_response( details::att_opcodes::read_blob_request, handle, offset, output, out_size, connection, bearer );
+     }
+
+    template < typename ... Options >
+    template < typename ConnectionData >
+    void server< Options... >::read_response( details::att_opcodes opcode, std::uint16_t handle, std::uint16_t offset, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection,
+        details::att_bearer& bearer )
+    {
         auto read = details::attribute_access_arguments::read( output + 1, output + out_size, offset, connection.client_configurations(), connection.security_attributes(), this );
         auto rc   = attribute_at( handle - 1 ).access( read, handle );
 
         if ( rc == details::attribute_access_result::success )
         {
-            *output  = bits( details::att_opcodes::read_blob_response );
+            *output  = bits( opcode == details::att_opcodes::read_request
+                ? details::att_opcodes::read_response
+                : details::att_opcodes::read_blob_response );
             out_size = 1 + read.buffer_size;
         }
-        else if ( rc == details::attribute_access_result::invalid_offset )
+        else if ( rc == details::attribute_access_result::pending )
         {
-            error_response( *input, details::att_error_codes::invalid_offset, handle, output, out_size );
+            bearer.park_att_request( bits( opcode ), handle, offset, parked_requests_++ );
+            out_size = 0;
+        }
+        else if ( rc == details::attribute_access_result::invalid_offset && opcode == details::att_opcodes::read_blob_request )
+        {
+            error_response( bits( opcode ), details::att_error_codes::invalid_offset, handle, output, out_size );
         }
         else
         {
-            error_response( *input, details::att_error_codes::read_not_permitted, handle, output, out_size );
+            error_response( bits( opcode ), details::att_error_codes::read_not_permitted, handle, output, out_size );
         }
-     }
+    }
+
+    template < typename ... Options >
+    template < typename ConnectionData >
+    bool server< Options... >::read_response_by_reference( std::uint16_t handle, std::uint16_t offset, details::att_opcodes opcode,
+        std::uint8_t* output, std::size_t& out_size, ConnectionData& connection, details::output_reference& reference )
+    {
+        auto read = details::attribute_access_arguments::read_reference( offset, connection.client_configurations(), connection.security_attributes(), this );
+
+        // attributes that do not support references and all errors are handled by the usual read
+        if ( attribute_at( handle - 1 ).access( read, handle ) != details::attribute_access_result::success )
+            return false;
+
+        *output   = bits( opcode );
+        reference = details::output_reference( read.buffer, std::min( read.buffer_size, out_size - 1 ) );
+        out_size  = 1;
+
+        return true;
+    }
 
     namespace details {
         template < typename Server >
@@ -1101,12 +1542,9 @@ namespace bluetoe {
         template < typename CCCDIndices, typename ServiceList, typename Server >
         struct collect_primary_services
         {
-            collect_primary_services( std::uint8_t*& output, std::uint8_t* end, std::uint16_t starting_index, std::uint16_t starting_handle, std::uint16_t ending_handle, std::uint8_t& attribute_data_size, Server& server )
+            collect_primary_services( std::uint8_t*& output, std::uint8_t* end, std::uint8_t& attribute_data_size, Server& server )
                 : output_( output )
                 , end_( end )
-                , index_( starting_index )
-                , starting_handle_( starting_handle )
-                , ending_handle_( ending_handle )
                 , first_( true )
                 , is_128bit_uuid_( true )
                 , attribute_data_size_( attribute_data_size )
@@ -1115,30 +1553,25 @@ namespace bluetoe {
             }
 
             template< typename Service >
-            void each()
+            bool each( std::uint16_t handle )
             {
-                if ( starting_handle_ <= index_ && index_ <= ending_handle_ )
+                if ( first_ )
                 {
-                    if ( first_ )
-                    {
-                        is_128bit_uuid_         = Service::uuid::is_128bit;
-                        first_                  = false;
-                        attribute_data_size_    = is_128bit_uuid_ ? 16 + 4 : 2 + 4;
-                    }
-
-                    /// TODO: ClientCharacteristicIndex is derivable from Service and ServiceList, if 0 is used,
-                    /// some templates are most likely more than once instanciated
-                    output_ = Service::template read_primary_service_response< CCCDIndices, 0, ServiceList, Server >( output_, end_, index_, is_128bit_uuid_, server_ );
+                    is_128bit_uuid_         = Service::uuid::is_128bit;
+                    first_                  = false;
+                    attribute_data_size_    = is_128bit_uuid_ ? 16 + 4 : 2 + 4;
                 }
 
-                index_ += Service::number_of_attributes;
+                /// TODO: ClientCharacteristicIndex is derivable from Service and ServiceList, if 0 is used,
+                /// some templates are most likely more than once instanciated
+                output_ = Service::template read_primary_service_response< CCCDIndices, 0, ServiceList, Server >( output_, end_, handle, is_128bit_uuid_, server_ );
+
+                // no need to look at further services, once the output is full
+                return end_ - output_ >= attribute_data_size_;
             }
 
                   std::uint8_t*&  output_;
                   std::uint8_t*   end_;
-                  std::uint16_t   index_;
-            const std::uint16_t   starting_handle_;
-            const std::uint16_t   ending_handle_;
                   bool            first_;
                   bool            is_128bit_uuid_;
                   std::uint8_t&   attribute_data_size_;
@@ -1164,7 +1597,8 @@ namespace bluetoe {
         ++begin; // gap for the size
 
         std::uint8_t* const data_begin = begin;
-        details::for_< services >::each( details::collect_primary_services< cccd_indices, services, server< Options... > >( begin, end, 1, starting_handle, ending_handle, *(begin -1 ), *this ) );
+        details::collect_primary_services< cccd_indices, services, server< Options... > > collector( begin, end, *(begin -1 ), *this );
+        details::services_in_range< services >::each( starting_handle, ending_handle, collector );
 
         if ( begin == data_begin )
         {
@@ -1222,7 +1656,61 @@ namespace bluetoe {
 
     template < typename ... Options >
     template < typename ConnectionData >
-    void server< Options... >::handle_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection )
+    void server< Options... >::handle_read_multiple_variable_length_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* const output, std::size_t& out_size, ConnectionData& cc )
+    {
+        static constexpr std::size_t length_size = 2;
+
+        if ( in_size < 5 || in_size % 2 == 0 )
+            return error_response( *input, details::att_error_codes::invalid_pdu, output, out_size );
+
+        const std::uint8_t opcode = *input;
+        ++input;
+        --in_size;
+
+        std::uint8_t* const end_output = output + out_size;
+        std::uint8_t*       out_ptr    = output;
+
+        *out_ptr = bits( details::att_opcodes::read_multiple_variable_length_response );
+        ++out_ptr;
+
+        for ( const std::uint8_t* const end_input = input + in_size; input != end_input; input += 2 )
+        {
+            const std::uint16_t handle = details::read_handle( input );
+
+            if ( handle == 0 )
+                return error_response( opcode, details::att_error_codes::invalid_handle, handle, output, out_size );
+
+            if ( handle > number_of_attributes )
+                return error_response( opcode, details::att_error_codes::attribute_not_found, handle, output, out_size );
+
+            // the length value tuple list is truncated to the MTU, but all handles have to be valid
+            if ( end_output - out_ptr <= static_cast< std::ptrdiff_t >( length_size ) )
+                continue;
+
+            auto read = details::attribute_access_arguments::read( out_ptr + length_size, end_output, 0, cc.client_configurations(), cc.security_attributes(), this );
+            auto rc   = attribute_at( handle - 1 ).access( read, handle );
+
+            if ( rc == details::attribute_access_result::success )
+            {
+                // the length of a truncated tuple is the number of octets copied
+                const std::size_t value_size = std::min< std::size_t >( read.buffer_size, end_output - out_ptr - length_size );
+
+                details::write_16bit( out_ptr, static_cast< std::uint16_t >( value_size ) );
+                out_ptr += length_size + value_size;
+            }
+            else
+            {
+                return error_response( opcode, access_result_to_att_code( rc, details::att_error_codes::read_not_permitted ), handle, output, out_size );
+            }
+        }
+
+        out_size = out_ptr - output;
+    }
+
+    template < typename ... Options >
+    template < typename ConnectionData >
+    void server< Options... >::handle_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection,
+        details::att_bearer& bearer )
     {
         if ( in_size < 3 )
             return error_response( *input, details::att_error_codes::invalid_pdu, output, out_size );
@@ -1232,6 +1720,11 @@ namespace bluetoe {
         if ( !check_handle( input, in_size, output, out_size, handle ) )
             return;
 
+        const bool request = *input == bits( details::att_opcodes::write_request );
+
+        if ( request )
+            assign_completions( connection );
+
         auto write = details::attribute_access_arguments::write( input + 3, input + in_size, 0, connection.client_configurations(), connection.security_attributes(), this );
         auto rc    = attribute_at( handle - 1 ).access( write, handle );
 
@@ -1240,6 +1733,14 @@ namespace bluetoe {
             *output  = bits( details::att_opcodes::write_response );
             out_size = 1;
         }
+        else if ( rc == details::attribute_access_result::pending )
+        {
+            // there is no response to a write command, that could be deferred
+            if ( request )
+                bearer.park_att_request( *input, handle, 0, parked_requests_++ );
+
+            out_size = 0;
+        }
         else if ( rc == details::attribute_access_result::invalid_attribute_value_length )
         {
             error_response( *input, details::att_error_codes::invalid_attribute_value_length, handle, output, out_size );
@@ -1255,7 +1756,7 @@ namespace bluetoe {
     void server< Options... >::handle_write_command( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& cc )
     {
         // just like a write request
-        handle_write_request( input, in_size, output, out_size, cc );
+        handle_write_request( input, in_size, output, out_size, cc, cc );
 
         // but ignore all output
         out_size = 0;
@@ -1343,14 +1844,17 @@ namespace bluetoe {
     }
 
     template < typename ... Options >
-    void server< Options... >::handle_value_confirmation( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data& )
+    void server< Options... >::handle_value_confirmation( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, details::att_bearer& bearer, bool enhanced_bearer )
     {
         if ( in_size != 1 )
             return error_response( *input, static_cast< details::att_error_codes >( 0x04 ), output, out_size );
 
         out_size = 0;
 
-        if ( l2cap_cb_ )
+        // an enhanced bearer keeps track of its own outstanding confirmation
+        if ( enhanced_bearer )
+            bearer.confirmation_received();
+        else if ( l2cap_cb_ )
             l2cap_cb_( details::notification_data(), l2cap_arg_, confirmation );
     }
 
@@ -1371,11 +1875,8 @@ namespace bluetoe {
         template < class Iterator, class Filter, class AllServices, class Server >
         struct services_by_group
         {
-            services_by_group( std::uint16_t starting_handle, std::uint16_t ending_handle, Iterator& iterator, const Filter& filter, bool& found )
-                : starting_handle_( starting_handle )
-                , ending_handle_( ending_handle )
-                , index_( 1 )
-                , iterator_( iterator )
+            services_by_group( Iterator& iterator, const Filter& filter, bool& found )
+                : iterator_( iterator )
                 , filter_( filter )
                 , found_( found )
             {
@@ -1383,24 +1884,20 @@ namespace bluetoe {
             }
 
             template< typename Service >
-            void each()
+            bool each( std::uint16_t handle )
             {
-                if ( starting_handle_ <= index_ && index_ <= ending_handle_ )
-                {
-                    const details::attribute& attr = Server::attribute_at( index_ - 1 );
+                const details::attribute& attr = Server::attribute_at( handle - 1 );
 
-                    if ( filter_( index_, attr ) )
-                    {
-                        found_ = iterator_.template operator()< Service >( index_, attr ) || found_;
-                    }
-                }
+                if ( !filter_( handle, attr ) )
+                    return true;
+
+                // the iterator is not able to take more services, if it reports false
+                const bool added = iterator_.template operator()< Service >( handle, attr );
+                found_ = added || found_;
 
-                index_ += Service::number_of_attributes;
+                return added;
             }
 
-            std::uint16_t   starting_handle_;
-            std::uint16_t   ending_handle_;
-            std::uint16_t   index_;
             Iterator&       iterator_;
             const Filter&   filter_;
             bool&           found_;
@@ -1412,8 +1909,8 @@ namespace bluetoe {
     bool server< Options... >::all_services_by_group( std::uint16_t starting_handle, std::uint16_t ending_handle, Iterator& iterator, const Filter& filter )
     {
         bool result = false;
-        details::services_by_group< Iterator, Filter, services, server< Options...  > > service_iterator( starting_handle, ending_handle, iterator, filter, result );
-        details::for_< services >::each( service_iterator );
+        details::services_by_group< Iterator, Filter, services, server< Options...  > > service_iterator( iterator, filter, result );
+        details::services_in_range< services >::each( starting_handle, ending_handle, service_iterator );
 
         return result;
     }
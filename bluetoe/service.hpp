@@ -13,6 +13,7 @@
 #include <cstddef>
 #include <cassert>
 #include <algorithm>
+#include <iterator>
 #include <type_traits>
 
 namespace bluetoe {
@@ -32,6 +33,16 @@ namespace bluetoe {
         template < typename ... Options >
         struct count_service_attributes;
 
+        template < typename ... Options >
+        using attribute_generation_parameters = typename
+                add_type<
+                    service_defintion_tag, // force generation of service generation attribute
+                    typename find_all_by_meta_type<
+                        include_service_meta_type,
+                        Options...
+                    >::type
+                >::type;
+
         template < typename >
         struct option_passed_to_service_that_is_not_a_valid_option_for_a_service;
 
@@ -171,6 +182,17 @@ namespace bluetoe {
         template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename ServiceList, typename Server >
         static details::attribute attribute_at( std::size_t index );
 
+        /**
+         * list of types, that generate all attributes of the service, including the attributes of all characteristics
+         */
+        template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename ServiceList, typename Server >
+        using attribute_generators = typename details::add_type<
+            typename details::generate_attribute_list<
+                details::attribute_generation_parameters< Options... >,
+                CCCDIndices, ClientCharacteristicIndex, service< Options... >, Server, std::tuple< Options..., ServiceList > >::attribute_generators,
+            typename details::attribute_generators_list< characteristics, CCCDIndices, ClientCharacteristicIndex, service< Options... >, Server >::type
+        >::type;
+
         /**
          * @brief assembles one data packet for a "Read by Group Type Response"
          */
@@ -262,19 +284,6 @@ namespace bluetoe {
 
     /** @cond HIDDEN_SYMBOLS */
 
-    // service implementation
-    namespace details {
-        template < typename ... Options >
-        using attribute_generation_parameters = typename
-                add_type<
-                    service_defintion_tag, // force generation of service generation attribute
-                    typename find_all_by_meta_type<
-                        include_service_meta_type,
-                        Options...
-                    >::type
-                >::type;
-    }
-
     template < typename ... Options >
     template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename ServiceList, typename Server >
     details::attribute service< Options... >::attribute_at( std::size_t index )
@@ -352,6 +361,92 @@ namespace bluetoe {
             static constexpr std::uint16_t end_service_handle       = next::end_service_handle;
         };
 
+        /*
+         * calls f.each< Service >( handle ) for all services in ServiceList, starting with the first service,
+         * which has the handle FirstHandle. The iteration stops at the first service that starts behind
+         * ending_handle or when f.each() returns false.
+         */
+        template < typename ServiceList, std::uint16_t FirstHandle >
+        struct services_from;
+
+        template < std::uint16_t FirstHandle >
+        struct services_from< std::tuple<>, FirstHandle >
+        {
+            template < class F >
+            static void each( std::uint16_t, F& )
+            {
+            }
+        };
+
+        template < typename Service, typename ... Ss, std::uint16_t FirstHandle >
+        struct services_from< std::tuple< Service, Ss... >, FirstHandle >
+        {
+            static constexpr std::uint16_t first_handle = FirstHandle;
+
+            template < class F >
+            static void each( std::uint16_t ending_handle, F& f )
+            {
+                if ( FirstHandle <= ending_handle && f.template each< Service >( FirstHandle ) )
+                    services_from< std::tuple< Ss... >, FirstHandle + Service::number_of_attributes >::each( ending_handle, f );
+            }
+        };
+
+        /*
+         * The start handles of all services are known at compile time. services_in_range< ServiceList >::each()
+         * performs a binary search for the first service, that starts at or behind starting_handle and
+         * continues the iteration from there, without visiting the services in front of that service.
+         */
+        template < typename ServiceList, std::uint16_t Handle = 1, typename ... Entries >
+        struct services_in_range;
+
+        template < typename Service, typename ... Ss, std::uint16_t Handle, typename ... Entries >
+        struct services_in_range< std::tuple< Service, Ss... >, Handle, Entries... >
+            : services_in_range< std::tuple< Ss... >, Handle + Service::number_of_attributes,
+                Entries..., services_from< std::tuple< Service, Ss... >, Handle > >
+        {
+        };
+
+        template < std::uint16_t Handle, typename ... Entries >
+        struct services_in_range< std::tuple<>, Handle, Entries... >
+        {
+            template < class F >
+            static void each( std::uint16_t starting_handle, std::uint16_t ending_handle, F& f )
+            {
+                // the most common case: the client starts with the very first service
+                if ( starting_handle <= 1 )
+                    return first_entry::each( ending_handle, f );
+
+                const std::uint16_t* const end   = &first_handles[ sizeof...( Entries ) ];
+                const std::uint16_t* const first = std::lower_bound( &first_handles[ 0 ], end, starting_handle );
+
+                if ( first != end )
+                    entries< F >::functions[ first - &first_handles[ 0 ] ]( ending_handle, f );
+            }
+
+        private:
+            using first_entry = typename std::tuple_element< 0, std::tuple< Entries..., services_from< std::tuple<>, Handle > > >::type;
+
+            // one extra element to not end up with an empty array
+            static const std::uint16_t first_handles[ sizeof...( Entries ) + 1 ];
+
+            template < class F >
+            struct entries
+            {
+                static void (* const functions[ sizeof...( Entries ) + 1 ])( std::uint16_t, F& );
+            };
+        };
+
+        template < std::uint16_t Handle, typename ... Entries >
+        const std::uint16_t services_in_range< std::tuple<>, Handle, Entries... >::first_handles[ sizeof...( Entries ) + 1 ] = {
+            Entries::first_handle..., 0
+        };
+
+        template < std::uint16_t Handle, typename ... Entries >
+        template < class F >
+        void (* const services_in_range< std::tuple<>, Handle, Entries... >::entries< F >::functions[ sizeof...( Entries ) + 1 ])( std::uint16_t, F& ) = {
+            &Entries::template each< F >..., &services_from< std::tuple<>, Handle >::template each< F >
+        };
+
         /*
          * service declaration
          */
@@ -0,0 +1,598 @@
+#ifndef BLUETOE_SM_BONDING_HPP
+#define BLUETOE_SM_BONDING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <algorithm>
+#include <iterator>
+
+#include <bluetoe/address.hpp>
+#include <bluetoe/pairing_status.hpp>
+#include <bluetoe/ll_meta_types.hpp>
+#include <bluetoe/crypto_toolbox.hpp>
+
+namespace bluetoe {
+
+    namespace details {
+        struct bonding_meta_type {};
+    }
+
+    /**
+     * @brief security information, that is stored for a bonded peer device
+     *
+     * The peer is identified by its identity address. If the peer distributed its identity resolving key (IRK) during
+     * pairing, the identity address is the address from the Identity Address Information and the bond is found by
+     * every resolvable private address, that the peer generates from its IRK. Otherwise, the identity is the device
+     * address, that was used to establish the connection in which the bond was created.
+     */
+    struct bond_data
+    {
+        /**
+         * @brief identity address of the peer device
+         */
+        link_layer::device_address      identity;
+
+        /**
+         * @brief the long term key, shared with the peer
+         */
+        std::array< std::uint8_t, 16 >  long_term_key;
+
+        /**
+         * @brief Rand value, that the peer uses to identify the long term key in LL_ENC_REQ (0 for LE Secure Connections)
+         */
+        std::uint64_t                   rand;
+
+        /**
+         * @brief EDIV value, that the peer uses to identify the long term key in LL_ENC_REQ (0 for LE Secure Connections)
+         */
+        std::uint16_t                   ediv;
+
+        /**
+         * @brief the pairing method, that was used to create the long term key
+         */
+        device_pairing_status           status;
+
+        /**
+         * @brief the identity resolving key of the peer; all zero, if the peer did not distribute an IRK
+         */
+        std::array< std::uint8_t, 16 >  identity_resolving_key;
+    };
+
+    namespace details {
+        /*
+         * true, if the bond belongs to the peer with the given device address
+         */
+        inline bool bond_matches( const bond_data& bond, const link_layer::device_address& address )
+        {
+            return bond.identity == address || resolvable_by( address, bond.identity_resolving_key.data() );
+        }
+    }
+
+    /**
+     * @brief link layer option to disable bonding
+     *
+     * Keys created during pairing are only valid for the current connection. This is the default.
+     *
+     * @sa bonding
+     */
+    class no_bonding
+    {
+    public:
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool bonding_supported = false;
+
+        bool store_bond( const bond_data& )
+        {
+            return false;
+        }
+
+        bool find_bond( const link_layer::device_address&, bond_data& )
+        {
+            return false;
+        }
+
+        struct meta_type :
+            details::bonding_meta_type,
+            link_layer::details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+    /**
+     * @brief link layer option to enable bonding
+     *
+     * With bonding, the security manager announces bonding in the pairing response and the keys of a
+     * pairing with a peer that requests bonding too, are stored in the given KeyStore. When a bonded peer
+     * reconnects and requests encryption, the link layer answers the LL_ENC_REQ with the stored long term key
+     * and the connection is encrypted without a new pairing.
+     *
+     * A KeyStore has to provide the following functions:
+     *
+     * @code
+     * // stores the bond, replacing an existing bond to the same identity; returns false, if the bond could not be stored
+     * bool store_bond( const bluetoe::bond_data& bond );
+     *
+     * // looks up the bond to the given peer identity, or to the peer, that generated the given resolvable private
+     * // address; returns false, if there is no such bond
+     * bool find_bond( const bluetoe::link_layer::device_address& address, bluetoe::bond_data& bond );
+     *
+     * // removes all bonds
+     * void remove_bonds();
+     * @endcode
+     *
+     * The link layer derives from the KeyStore, so the functions of the KeyStore are accessible through the link layer.
+     *
+     * Currently, only bluetoe::lesc_security_manager supports bonding. It requests the identity resolving key of
+     * peers, that request bonding, so that bonded peers using resolvable private addresses are recognized.
+     *
+     * @sa ram_key_store
+     * @sa flash_key_store
+     * @sa no_bonding
+     */
+    template < class KeyStore >
+    class bonding : public KeyStore
+    {
+    public:
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool bonding_supported = true;
+
+        struct meta_type :
+            details::bonding_meta_type,
+            link_layer::details::valid_link_layer_option_meta_type {};
+        /** @endcond */
+    };
+
+    /**
+     * @brief key store, that keeps up to Size bonds in RAM
+     *
+     * The bonds are lost with a reset of the device. If all entries are in use, a new bond replaces the oldest bond.
+     *
+     * @sa bonding
+     */
+    template < std::size_t Size >
+    class ram_key_store
+    {
+    public:
+        static_assert( Size > 0, "a key store without entries makes no sense" );
+
+        ram_key_store()
+            : size_( 0 )
+            , next_( 0 )
+        {
+        }
+
+        /**
+         * @brief stores the bond, replacing an existing bond to the same identity or the oldest bond
+         */
+        bool store_bond( const bond_data& bond )
+        {
+            for ( std::size_t index = 0; index != size_; ++index )
+            {
+                if ( bonds_[ index ].identity == bond.identity )
+                {
+                    bonds_[ index ] = bond;
+                    return true;
+                }
+            }
+
+            bonds_[ next_ ] = bond;
+            next_ = ( next_ + 1 ) % Size;
+            size_ = std::min( size_ + 1, Size );
+
+            return true;
+        }
+
+        /**
+         * @brief looks up the bond to the given peer identity or resolvable private address
+         */
+        bool find_bond( const link_layer::device_address& address, bond_data& bond )
+        {
+            for ( std::size_t index = 0; index != size_; ++index )
+            {
+                if ( details::bond_matches( bonds_[ index ], address ) )
+                {
+                    bond = bonds_[ index ];
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief removes all bonds
+         */
+        void remove_bonds()
+        {
+            size_ = 0;
+            next_ = 0;
+        }
+
+    private:
+        std::array< bond_data, Size >   bonds_;
+        std::size_t                     size_;
+        std::size_t                     next_;
+    };
+
+    /**
+     * @brief key store, that keeps bonds in two pages of a NOR flash
+     *
+     * The bonds are appended as records to the active page. A bond that replaces a bond to the same identity is
+     * simply appended; the last record of an identity is valid. When the active page is full, the last record
+     * of every identity is copied to the other page, which then becomes the active page. If the page can not
+     * hold all identities, the oldest bonds are dropped.
+     *
+     * A record is written in two steps: first the record data and then a commit word. Records without commit word,
+     * due to a reset while writing, are ignored. The active page is marked by a header with a generation counter,
+     * that is written after all records were copied. So a reset at every point in time leaves a consistent set of bonds.
+     *
+     * Flash has to provide the following interface to access two pages of erasable flash memory:
+     *
+     * @code
+     * // size of a page in bytes
+     * static constexpr std::size_t page_size;
+     *
+     * // reads size bytes at offset from page 0 or 1
+     * void read( std::size_t page, std::size_t offset, std::uint8_t* data, std::size_t size );
+     *
+     * // programs size bytes at offset in page 0 or 1; only bits that are set can be cleared
+     * void write( std::size_t page, std::size_t offset, const std::uint8_t* data, std::size_t size );
+     *
+     * // sets all bytes of page 0 or 1 to 0xff
+     * void erase( std::size_t page );
+     * @endcode
+     *
+     * All writes are aligned to 4 bytes and have a size of a multiple of 4 bytes.
+     *
+     * @sa bonding
+     */
+    template < class Flash >
+    class flash_key_store
+    {
+    public:
+        flash_key_store()
+            : initialized_( false )
+            , active_page_( 0 )
+            , generation_( 0 )
+            , next_slot_( 0 )
+        {
+        }
+
+        /**
+         * @brief stores the bond, replacing an existing bond to the same identity
+         *
+         * A bond, that is equal to the stored bond of the identity, is not written again.
+         */
+        bool store_bond( const bond_data& bond );
+
+        /**
+         * @brief looks up the bond to the given peer identity or resolvable private address
+         */
+        bool find_bond( const link_layer::device_address& address, bond_data& bond );
+
+        /**
+         * @brief removes all bonds
+         */
+        void remove_bonds();
+
+        /**
+         * @brief access to the underlying flash
+         */
+        Flash& flash()
+        {
+            return flash_;
+        }
+
+    private:
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr std::size_t    header_size     = 4;
+        static constexpr std::size_t    commit_size     = 4;
+        static constexpr std::size_t    data_size       = 52;
+        static constexpr std::size_t    record_size     = commit_size + data_size;
+        static constexpr std::size_t    slots           = ( Flash::page_size - header_size ) / record_size;
+        static constexpr std::uint32_t  erased_word     = 0xffffffff;
+
+        static_assert( slots > 0, "flash page is too small to store a single bond" );
+
+        using record_t = std::array< std::uint8_t, data_size >;
+
+        static std::size_t slot_offset( std::size_t slot )
+        {
+            return header_size + slot * record_size;
+        }
+
+        void initialize();
+        std::uint32_t read_word( std::size_t page, std::size_t offset );
+        void write_word( std::size_t page, std::size_t offset, std::uint32_t value );
+        bool is_free( std::size_t page, std::size_t slot );
+        bool read_record( std::size_t page, std::size_t slot, record_t& record );
+        void write_record( std::size_t page, std::size_t slot, const record_t& record );
+        bool last_record_of_identity( std::size_t page, std::size_t slot, const record_t& record );
+        void compact( const record_t& record );
+
+        static record_t encode( const bond_data& bond );
+        static bond_data decode( const record_t& record );
+        static bool same_identity( const record_t& lhs, const record_t& rhs );
+
+        Flash           flash_;
+        bool            initialized_;
+        std::size_t     active_page_;
+        std::uint32_t   generation_;
+        std::size_t     next_slot_;
+        /** @endcond */
+    };
+
+    // implementation
+    /** @cond HIDDEN_SYMBOLS */
+    template < class Flash >
+    bool flash_key_store< Flash >::store_bond( const bond_data& bond )
+    {
+        initialize();
+
+        const record_t record = encode( bond );
+
+        bond_data stored;
+        if ( find_bond( bond.identity, stored ) && encode( stored ) == record )
+            return true;
+
+        if ( next_slot_ == slots )
+        {
+            compact( record );
+        }
+        else
+        {
+            write_record( active_page_, next_slot_, record );
+            ++next_slot_;
+        }
+
+        return true;
+    }
+
+    template < class Flash >
+    bool flash_key_store< Flash >::find_bond( const link_layer::device_address& address, bond_data& bond )
+    {
+        initialize();
+
+        bool found = false;
+        record_t record;
+
+        // the last record of an identity is the valid one
+        for ( std::size_t slot = 0; slot != next_slot_; ++slot )
+        {
+            if ( read_record( active_page_, slot, record ) )
+            {
+                const bond_data candidate = decode( record );
+
+                if ( details::bond_matches( candidate, address ) )
+                {
+                    bond  = candidate;
+                    found = true;
+                }
+            }
+        }
+
+        return found;
+    }
+
+    template < class Flash >
+    void flash_key_store< Flash >::remove_bonds()
+    {
+        initialize();
+
+        const std::size_t new_page = 1 - active_page_;
+
+        flash_.erase( new_page );
+        write_word( new_page, 0, generation_ + 1 );
+        flash_.erase( active_page_ );
+
+        active_page_ = new_page;
+        ++generation_;
+        next_slot_   = 0;
+    }
+
+    template < class Flash >
+    void flash_key_store< Flash >::initialize()
+    {
+        if ( initialized_ )
+            return;
+
+        initialized_ = true;
+
+        const std::uint32_t generations[ 2 ] = { read_word( 0, 0 ), read_word( 1, 0 ) };
+
+        if ( generations[ 0 ] == erased_word && generations[ 1 ] == erased_word )
+        {
+            flash_.erase( 0 );
+            write_word( 0, 0, 0 );
+            active_page_ = 0;
+        }
+        else if ( generations[ 0 ] == erased_word || generations[ 1 ] == erased_word )
+        {
+            active_page_ = generations[ 0 ] == erased_word ? 1 : 0;
+        }
+        else
+        {
+            // both pages are valid, if there was a reset before the old page was erased
+            active_page_ = static_cast< std::int32_t >( generations[ 1 ] - generations[ 0 ] ) > 0 ? 1 : 0;
+        }
+
+        generation_ = read_word( active_page_, 0 );
+
+        // records are appended; the first free slot follows the last used slot
+        next_slot_ = slots;
+        while ( next_slot_ != 0 && is_free( active_page_, next_slot_ - 1 ) )
+            --next_slot_;
+    }
+
+    template < class Flash >
+    std::uint32_t flash_key_store< Flash >::read_word( std::size_t page, std::size_t offset )
+    {
+        std::uint8_t buffer[ 4 ];
+        flash_.read( page, offset, &buffer[ 0 ], sizeof( buffer ) );
+
+        return buffer[ 0 ] | ( buffer[ 1 ] << 8 ) | ( buffer[ 2 ] << 16 ) | ( static_cast< std::uint32_t >( buffer[ 3 ] ) << 24 );
+    }
+
+    template < class Flash >
+    void flash_key_store< Flash >::write_word( std::size_t page, std::size_t offset, std::uint32_t value )
+    {
+        const std::uint8_t buffer[ 4 ] = {
+            static_cast< std::uint8_t >( value ),
+            static_cast< std::uint8_t >( value >> 8 ),
+            static_cast< std::uint8_t >( value >> 16 ),
+            static_cast< std::uint8_t >( value >> 24 )
+        };
+
+        flash_.write( page, offset, &buffer[ 0 ], sizeof( buffer ) );
+    }
+
+    template < class Flash >
+    bool flash_key_store< Flash >::is_free( std::size_t page, std::size_t slot )
+    {
+        std::uint8_t buffer[ record_size ];
+        flash_.read( page, slot_offset( slot ), &buffer[ 0 ], sizeof( buffer ) );
+
+        return std::all_of( std::begin( buffer ), std::end( buffer ), []( std::uint8_t b ) { return b == 0xff; } );
+    }
+
+    template < class Flash >
+    bool flash_key_store< Flash >::read_record( std::size_t page, std::size_t slot, record_t& record )
+    {
+        if ( read_word( page, slot_offset( slot ) ) != 0 )
+            return false;
+
+        flash_.read( page, slot_offset( slot ) + commit_size, record.data(), record.size() );
+
+        return true;
+    }
+
+    template < class Flash >
+    void flash_key_store< Flash >::write_record( std::size_t page, std::size_t slot, const record_t& record )
+    {
+        flash_.write( page, slot_offset( slot ) + commit_size, record.data(), record.size() );
+        write_word( page, slot_offset( slot ), 0 );
+    }
+
+    template < class Flash >
+    bool flash_key_store< Flash >::last_record_of_identity( std::size_t page, std::size_t slot, const record_t& record )
+    {
+        record_t later;
+
+        for ( std::size_t next = slot + 1; next != next_slot_; ++next )
+        {
+            if ( read_record( page, next, later ) && same_identity( record, later ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    template < class Flash >
+    void flash_key_store< Flash >::compact( const record_t& new_record )
+    {
+        const std::size_t old_page = active_page_;
+        const std::size_t new_page = 1 - active_page_;
+
+        // the number of bonds to copy, without the bond to the identity of the new record
+        std::size_t bonds = 0;
+        record_t record;
+
+        for ( std::size_t slot = 0; slot != next_slot_; ++slot )
+        {
+            if ( read_record( old_page, slot, record ) && !same_identity( record, new_record ) && last_record_of_identity( old_page, slot, record ) )
+                ++bonds;
+        }
+
+        // drop the oldest bonds, if there is not enough room
+        std::size_t drop = bonds < slots ? 0 : bonds - slots + 1;
+        std::size_t copied = 0;
+
+        flash_.erase( new_page );
+
+        for ( std::size_t slot = 0; slot != next_slot_; ++slot )
+        {
+            if ( read_record( old_page, slot, record ) && !same_identity( record, new_record ) && last_record_of_identity( old_page, slot, record ) )
+            {
+                if ( drop != 0 )
+                {
+                    --drop;
+                }
+                else
+                {
+                    write_record( new_page, copied, record );
+                    ++copied;
+                }
+            }
+        }
+
+        write_record( new_page, copied, new_record );
+        ++copied;
+
+        // the new page becomes valid with the header and the old page becomes obsolete
+        write_word( new_page, 0, generation_ + 1 );
+        flash_.erase( old_page );
+
+        active_page_ = new_page;
+        ++generation_;
+        next_slot_   = copied;
+    }
+
+    template < class Flash >
+    typename flash_key_store< Flash >::record_t flash_key_store< Flash >::encode( const bond_data& bond )
+    {
+        record_t record;
+        record.fill( 0 );
+
+        auto out = record.begin();
+        *out++ = bond.identity.is_random() ? 1 : 0;
+        out = std::copy( bond.identity.begin(), bond.identity.end(), out );
+        *out++ = static_cast< std::uint8_t >( bond.status );
+        out = std::copy( bond.long_term_key.begin(), bond.long_term_key.end(), out );
+
+        for ( std::size_t byte = 0; byte != 2; ++byte )
+            *out++ = static_cast< std::uint8_t >( bond.ediv >> ( 8 * byte ) );
+
+        for ( std::size_t byte = 0; byte != 8; ++byte )
+            *out++ = static_cast< std::uint8_t >( bond.rand >> ( 8 * byte ) );
+
+        std::copy( bond.identity_resolving_key.begin(), bond.identity_resolving_key.end(), out );
+
+        return record;
+    }
+
+    template < class Flash >
+    bond_data flash_key_store< Flash >::decode( const record_t& record )
+    {
+        bond_data bond;
+
+        auto in = record.begin();
+        const bool is_random = *in++ != 0;
+        bond.identity = link_layer::device_address( &*in, is_random );
+        in += 6;
+        bond.status = static_cast< device_pairing_status >( *in++ );
+        std::copy( in, in + bond.long_term_key.size(), bond.long_term_key.begin() );
+        in += bond.long_term_key.size();
+
+        bond.ediv = 0;
+        for ( std::size_t byte = 0; byte != 2; ++byte )
+            bond.ediv |= static_cast< std::uint16_t >( *in++ << ( 8 * byte ) );
+
+        bond.rand = 0;
+        for ( std::size_t byte = 0; byte != 8; ++byte )
+            bond.rand |= static_cast< std::uint64_t >( *in++ ) << ( 8 * byte );
+
+        std::copy( in, in + bond.identity_resolving_key.size(), bond.identity_resolving_key.begin() );
+
+        return bond;
+    }
+
+    template < class Flash >
+    bool flash_key_store< Flash >::same_identity( const record_t& lhs, const record_t& rhs )
+    {
+        // address type and address
+        return std::equal( lhs.begin(), lhs.begin() + 7, rhs.begin() );
+    }
+    /** @endcond */
+}
+
+#endif
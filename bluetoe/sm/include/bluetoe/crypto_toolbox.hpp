@@ -0,0 +1,188 @@
+#ifndef BLUETOE_SM_CRYPTO_TOOLBOX_HPP
+#define BLUETOE_SM_CRYPTO_TOOLBOX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include <bluetoe/aes.hpp>
+#include <bluetoe/address.hpp>
+
+namespace bluetoe {
+namespace details {
+
+    /*
+     * Functions of the LE Secure Connections cryptographic toolbox (Core Specification Vol 3, Part H, 2.2.6 - 2.2.8).
+     *
+     * All parameters and results are in the byte order of the Security Manager Protocol (least significant octet
+     * first). AES-CMAC works on the most significant octet first, so the functions reverse all values.
+     */
+
+    /*
+     * confirm value generation function f4( U, V, X, Z ) = AES-CMAC_X( U || V || Z ); U and V are 256 bit, X and the result are 128 bit
+     */
+    void f4( const std::uint8_t* u, const std::uint8_t* v, const std::uint8_t* x, std::uint8_t z, std::uint8_t* result );
+
+    /*
+     * key generation function f5( W, N1, N2, A1, A2 ) with the 256 bit DHKey W; yields the 128 bit MacKey and LTK
+     */
+    void f5( const std::uint8_t* w, const std::uint8_t* n1, const std::uint8_t* n2,
+        const link_layer::device_address& a1, const link_layer::device_address& a2,
+        std::uint8_t* mac_key, std::uint8_t* ltk );
+
+    /*
+     * check value generation function f6( W, N1, N2, R, IOcap, A1, A2 ) = AES-CMAC_W( N1 || N2 || R || IOcap || A1 || A2 )
+     *
+     * IOcap is the IO Capability, OOB data flag and AuthReq, in the order of the Pairing Request and Response PDUs.
+     */
+    void f6( const std::uint8_t* w, const std::uint8_t* n1, const std::uint8_t* n2, const std::uint8_t* r, const std::uint8_t* io_cap,
+        const link_layer::device_address& a1, const link_layer::device_address& a2, std::uint8_t* result );
+
+    /*
+     * random address hash function ah( k, r ) = e( k, r' ) mod 2^24, with r' = padding || r; k is the 128 bit IRK,
+     * r and the result are 24 bit
+     */
+    void ah( const std::uint8_t* k, const std::uint8_t* r, std::uint8_t* result );
+
+    /*
+     * true, if address is a resolvable private address, that was generated from the identity resolving key irk
+     */
+    bool resolvable_by( const link_layer::device_address& address, const std::uint8_t* irk );
+
+    // implementation
+    /** @cond HIDDEN_SYMBOLS */
+    namespace crypto_toolbox {
+        static constexpr std::size_t key_size        = aes128::block_size;
+        static constexpr std::size_t address_size    = 7;
+
+        inline void reverse_update( aes_cmac& mac, const std::uint8_t* data, std::size_t size )
+        {
+            std::uint8_t buffer[ 32 ];
+
+            while ( size != 0 )
+            {
+                const std::size_t chunk = std::min( size, sizeof( buffer ) );
+                std::reverse_copy( data + size - chunk, data + size, &buffer[ 0 ] );
+                mac.update( &buffer[ 0 ], chunk );
+
+                size -= chunk;
+            }
+        }
+
+        inline void update( aes_cmac& mac, const link_layer::device_address& address )
+        {
+            // the address type is the most significant octet of the 56 bit value
+            std::uint8_t buffer[ address_size ] = { std::uint8_t( address.is_random() ? 0x01 : 0x00 ) };
+            std::reverse_copy( address.begin(), address.end(), &buffer[ 1 ] );
+
+            mac.update( &buffer[ 0 ], sizeof( buffer ) );
+        }
+
+        inline aes_cmac reversed_key_cmac( const std::uint8_t* key )
+        {
+            std::uint8_t reversed[ key_size ];
+            std::reverse_copy( key, key + key_size, &reversed[ 0 ] );
+
+            return aes_cmac( reversed );
+        }
+
+        inline void finish( aes_cmac& mac, std::uint8_t* result )
+        {
+            mac.finish( result );
+            std::reverse( result, result + key_size );
+        }
+    }
+
+    inline void f4( const std::uint8_t* u, const std::uint8_t* v, const std::uint8_t* x, std::uint8_t z, std::uint8_t* result )
+    {
+        aes_cmac mac = crypto_toolbox::reversed_key_cmac( x );
+        crypto_toolbox::reverse_update( mac, u, 32 );
+        crypto_toolbox::reverse_update( mac, v, 32 );
+        mac.update( &z, 1 );
+
+        crypto_toolbox::finish( mac, result );
+    }
+
+    inline void f5( const std::uint8_t* w, const std::uint8_t* n1, const std::uint8_t* n2,
+        const link_layer::device_address& a1, const link_layer::device_address& a2,
+        std::uint8_t* mac_key, std::uint8_t* ltk )
+    {
+        static const std::uint8_t salt[ crypto_toolbox::key_size ] = {
+            0x6c, 0x88, 0x83, 0x91, 0xaa, 0xf5, 0xa5, 0x38, 0x60, 0x37, 0x0b, 0xdb, 0x5a, 0x60, 0x83, 0xbe
+        };
+
+        static const std::uint8_t key_id[] = { 0x62, 0x74, 0x6c, 0x65 };
+        static const std::uint8_t length[] = { 0x01, 0x00 };
+
+        std::uint8_t t[ crypto_toolbox::key_size ];
+
+        aes_cmac key_mac( salt );
+        crypto_toolbox::reverse_update( key_mac, w, 32 );
+        key_mac.finish( t );
+
+        for ( std::uint8_t counter = 0; counter != 2; ++counter )
+        {
+            aes_cmac mac( t );
+            mac.update( &counter, 1 );
+            mac.update( key_id, sizeof( key_id ) );
+            crypto_toolbox::reverse_update( mac, n1, crypto_toolbox::key_size );
+            crypto_toolbox::reverse_update( mac, n2, crypto_toolbox::key_size );
+            crypto_toolbox::update( mac, a1 );
+            crypto_toolbox::update( mac, a2 );
+            mac.update( length, sizeof( length ) );
+
+            crypto_toolbox::finish( mac, counter == 0 ? mac_key : ltk );
+        }
+    }
+
+    inline void f6( const std::uint8_t* w, const std::uint8_t* n1, const std::uint8_t* n2, const std::uint8_t* r, const std::uint8_t* io_cap,
+        const link_layer::device_address& a1, const link_layer::device_address& a2, std::uint8_t* result )
+    {
+        aes_cmac mac = crypto_toolbox::reversed_key_cmac( w );
+        crypto_toolbox::reverse_update( mac, n1, crypto_toolbox::key_size );
+        crypto_toolbox::reverse_update( mac, n2, crypto_toolbox::key_size );
+        crypto_toolbox::reverse_update( mac, r, crypto_toolbox::key_size );
+        crypto_toolbox::reverse_update( mac, io_cap, 3 );
+        crypto_toolbox::update( mac, a1 );
+        crypto_toolbox::update( mac, a2 );
+
+        crypto_toolbox::finish( mac, result );
+    }
+
+    inline void ah( const std::uint8_t* k, const std::uint8_t* r, std::uint8_t* result )
+    {
+        static constexpr std::size_t hash_size = 3;
+
+        std::uint8_t key[ crypto_toolbox::key_size ];
+        std::reverse_copy( k, k + crypto_toolbox::key_size, &key[ 0 ] );
+
+        std::uint8_t plain[ crypto_toolbox::key_size ] = { 0 };
+        std::reverse_copy( r, r + hash_size, &plain[ crypto_toolbox::key_size - hash_size ] );
+
+        std::uint8_t cipher[ crypto_toolbox::key_size ];
+        aes128( key ).encrypt( plain, cipher );
+
+        std::reverse_copy( &cipher[ crypto_toolbox::key_size - hash_size ], &cipher[ crypto_toolbox::key_size ], result );
+    }
+
+    inline bool resolvable_by( const link_layer::device_address& address, const std::uint8_t* irk )
+    {
+        static constexpr std::uint8_t address_type_mask = 0xc0;
+        static constexpr std::uint8_t resolvable_type   = 0x40;
+
+        // an IRK of all zeros is used by devices, that do not have an IRK
+        if ( !address.is_random() || ( address.msb() & address_type_mask ) != resolvable_type
+          || std::all_of( irk, irk + crypto_toolbox::key_size, []( std::uint8_t b ) { return b == 0; } ) )
+            return false;
+
+        // the lower 24 bits of the address are the hash, the upper 24 bits are prand
+        std::uint8_t hash[ 3 ];
+        ah( irk, address.begin() + 3, &hash[ 0 ] );
+
+        return std::equal( &hash[ 0 ], &hash[ 3 ], address.begin() );
+    }
+    /** @endcond */
+}
+}
+
+#endif
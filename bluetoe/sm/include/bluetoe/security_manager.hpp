@@ -10,6 +10,9 @@
 #include <bluetoe/address.hpp>
 #include <bluetoe/link_state.hpp>
 #include <bluetoe/pairing_status.hpp>
+#include <bluetoe/p256.hpp>
+#include <bluetoe/crypto_toolbox.hpp>
+#include <bluetoe/bonding.hpp>
 
 namespace bluetoe {
 
@@ -80,6 +83,71 @@ namespace bluetoe {
             pairing_completed,
         };
 
+        enum class lesc_pairing_state : std::uint8_t {
+            idle,
+            pairing_requested,
+            public_key_exchanged,
+            random_exchanged,
+            pairing_completed
+        };
+
+        enum class authentication_requirements : std::uint8_t {
+            bonding             = 0x01,
+            mitm                = 0x04,
+            secure_connections  = 0x08,
+            keypress            = 0x10
+        };
+
+        enum class key_distribution : std::uint8_t {
+            enc_key             = 0x01,
+            id_key              = 0x02,
+            sign_key            = 0x04,
+            link_key            = 0x08
+        };
+
+        // keys, that are expected from the initiator after the pairing completed
+        enum class lesc_expected_key : std::uint8_t {
+            none,
+            identity_information,
+            identity_address_information
+        };
+
+        static constexpr std::size_t    pairing_req_resp_size = 7;
+        static constexpr std::uint8_t   min_max_key_size = 7;
+        static constexpr std::uint8_t   max_max_key_size = 16;
+
+        /*
+         * checks the parameters of a Pairing Request PDU with the size pairing_req_resp_size
+         */
+        inline bool valid_pairing_request( const std::uint8_t* input )
+        {
+            const std::uint8_t io_capability                = input[ 1 ];
+            const std::uint8_t oob_data_flag                = input[ 2 ];
+            const std::uint8_t auth_req                     = input[ 3 ];
+            const std::uint8_t max_key_size                 = input[ 4 ];
+            const std::uint8_t initiator_key_distribution   = input[ 5 ];
+            const std::uint8_t responder_key_distribution   = input[ 6 ];
+
+            return !(
+                ( io_capability > static_cast< std::uint8_t >( io_capabilities::last ) )
+             || ( oob_data_flag & ~0x01 )
+             || ( auth_req & 0xC0 )
+             || ( max_key_size < min_max_key_size || max_key_size > max_max_key_size )
+             || ( initiator_key_distribution & 0xf0 )
+             || ( responder_key_distribution & 0xf0 )
+            );
+        }
+
+        /*
+         * shortens a key (least significant octet first) to the negotiated encryption key size by
+         * setting the most significant octets to zero
+         */
+        inline void shorten_key( uint128_t& key, std::uint8_t key_size )
+        {
+            assert( key_size >= min_max_key_size && key_size <= max_max_key_size );
+            std::fill( std::next( key.begin(), key_size ), key.end(), 0 );
+        }
+
         inline void error_response( details::sm_error_codes error_code, std::uint8_t* output, std::size_t& out_size )
         {
             output[ 0 ] = static_cast< std::uint8_t >( sm_opcodes::pairing_failed );
@@ -214,11 +282,16 @@ namespace bluetoe {
         template < class OtherConnectionData, class SecurityFunctions >
         void l2cap_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& );
 
+        template < class OtherConnectionData, class SecurityFunctions >
+        void l2cap_output( std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& );
+
+        template < class OtherConnectionData, class SecurityFunctions >
+        void idle_processing( connection_data< OtherConnectionData >&, SecurityFunctions& );
+
         typedef details::security_manager_meta_type meta_type;
     private:
-        static constexpr std::uint8_t   min_max_key_size = 7;
-        static constexpr std::uint8_t   max_max_key_size = 16;
-        static constexpr std::size_t    pairing_req_resp_size = 7;
+        static constexpr std::size_t    pairing_req_resp_size = details::pairing_req_resp_size;
+        static constexpr std::uint8_t   max_max_key_size = details::max_max_key_size;
 
         template < class OtherConnectionData, class SecurityFunctions >
         void handle_pairing_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& );
@@ -246,6 +319,326 @@ namespace bluetoe {
         /** @endcond */
     };
 
+    /**
+     * @brief A Security manager implementation that supports LE Secure Connections pairing.
+     *
+     * The pairing uses the Just Works association model; the resulting long term key is unauthenticated. Pairing
+     * requests from devices that do not support LE Secure Connections are rejected (Secure Connections Only Mode).
+     * LE legacy pairing is implemented by bluetoe::security_manager.
+     *
+     * The point multiplications dominate the costs of a pairing. To keep them out of the pairing latency, the
+     * local key pair is created in idle time, before the pairing starts, and the Diffie-Hellman key is calculated in
+     * idle time between the public key exchange and the DHKey check. Idle time is, when the link layer has
+     * nothing else to do after a connection event. A new key pair is created for every pairing.
+     *
+     * The Pairing Public Key PDU is 65 octets long, so the link layer has to be configured with an L2CAP MTU of at
+     * least 65 octets (bluetoe::link_layer::max_mtu_size); otherwise pairing is not supported.
+     *
+     * If the link layer is configured with bluetoe::bonding and the initiator requests bonding too, the long term
+     * key is stored in the key store and used to encrypt later connections to the same peer. If the initiator offers
+     * its identity key, the security manager requests it. The bond is then stored under the distributed identity
+     * address, together with the identity resolving key, so that the peer is recognized by its resolvable private
+     * addresses.
+     *
+     * @tparam EllipticCurve implementation of the P-256 operations. The default is a constant time software
+     *         implementation. A binding that has hardware support for P-256 can provide a class with the same
+     *         static functions as bluetoe::details::p256 (public_key(), is_valid_public_key() and dh_key()).
+     */
+    template < class EllipticCurve = details::p256 >
+    class lesc_security_manager
+    {
+    public:
+        /** @cond HIDDEN_SYMBOLS */
+        template < class OtherConnectionData >
+        class connection_data : public OtherConnectionData
+        {
+        public:
+            template < class ... Args >
+            connection_data( Args&&... args )
+                : OtherConnectionData( args... )
+                , state_( details::lesc_pairing_state::idle )
+                , confirm_pending_( false )
+                , dh_key_pending_( false )
+                , dh_key_valid_( false )
+            {}
+
+            details::lesc_pairing_state state() const
+            {
+                return state_;
+            }
+
+            void remote_connection_created( const bluetoe::link_layer::device_address& remote )
+            {
+                remote_addr_ = remote;
+            }
+
+            const bluetoe::link_layer::device_address& remote_address() const
+            {
+                return remote_addr_;
+            }
+
+            void pairing_request( const std::uint8_t* io_cap, std::uint8_t key_size, std::uint8_t initiator_key_distribution )
+            {
+                assert( state_ == details::lesc_pairing_state::idle );
+                state_ = details::lesc_pairing_state::pairing_requested;
+
+                std::copy( io_cap, io_cap + state_data_.pairing_state.io_cap.size(), state_data_.pairing_state.io_cap.begin() );
+                state_data_.pairing_state.key_size = key_size;
+                state_data_.pairing_state.initiator_key_distribution = initiator_key_distribution;
+            }
+
+            void public_key_exchanged( const std::uint8_t* remote_public_key, const details::uint128_t& nb )
+            {
+                assert( state_ == details::lesc_pairing_state::pairing_requested );
+                state_ = details::lesc_pairing_state::public_key_exchanged;
+
+                std::copy( remote_public_key, remote_public_key + EllipticCurve::public_key_size, state_data_.pairing_state.remote_public_key.begin() );
+                state_data_.pairing_state.nb = nb;
+                confirm_pending_ = true;
+                dh_key_pending_  = true;
+                dh_key_valid_    = false;
+            }
+
+            void confirm_sent()
+            {
+                confirm_pending_ = false;
+            }
+
+            void dh_key_calculated( bool valid )
+            {
+                dh_key_pending_ = false;
+                dh_key_valid_   = valid;
+            }
+
+            void random_exchanged( const std::uint8_t* na )
+            {
+                assert( state_ == details::lesc_pairing_state::public_key_exchanged );
+                state_ = details::lesc_pairing_state::random_exchanged;
+
+                std::copy( na, na + state_data_.pairing_state.na.size(), state_data_.pairing_state.na.begin() );
+            }
+
+            void pairing_completed( const details::uint128_t& long_term_key, bool identity_expected )
+            {
+                assert( state_ == details::lesc_pairing_state::random_exchanged );
+                state_ = details::lesc_pairing_state::pairing_completed;
+
+                state_data_.completed_state.long_term_key = long_term_key;
+                state_data_.completed_state.identity_resolving_key.fill( 0 );
+                state_data_.completed_state.expected_key = identity_expected
+                    ? details::lesc_expected_key::identity_information
+                    : details::lesc_expected_key::none;
+            }
+
+            void identity_information_received( const std::uint8_t* identity_resolving_key )
+            {
+                assert( expected_key() == details::lesc_expected_key::identity_information );
+
+                std::copy( identity_resolving_key, identity_resolving_key + state_data_.completed_state.identity_resolving_key.size(),
+                    state_data_.completed_state.identity_resolving_key.begin() );
+                state_data_.completed_state.expected_key = details::lesc_expected_key::identity_address_information;
+            }
+
+            void identity_address_information_received()
+            {
+                assert( expected_key() == details::lesc_expected_key::identity_address_information );
+
+                state_data_.completed_state.expected_key = details::lesc_expected_key::none;
+            }
+
+            // drops the distributed keys, but keeps the generated long term key of the encrypted link
+            void key_distribution_failed()
+            {
+                assert( keys_generated() );
+
+                state_data_.completed_state.identity_resolving_key.fill( 0 );
+                state_data_.completed_state.expected_key = details::lesc_expected_key::none;
+            }
+
+            bool keys_generated() const
+            {
+                return state_ == details::lesc_pairing_state::pairing_completed;
+            }
+
+            details::lesc_expected_key expected_key() const
+            {
+                return state_ == details::lesc_pairing_state::pairing_completed
+                    ? state_data_.completed_state.expected_key
+                    : details::lesc_expected_key::none;
+            }
+
+            const details::uint128_t& long_term_key() const
+            {
+                return state_data_.completed_state.long_term_key;
+            }
+
+            const details::uint128_t& identity_resolving_key() const
+            {
+                return state_data_.completed_state.identity_resolving_key;
+            }
+
+            std::pair< bool, details::uint128_t > find_key( std::uint16_t ediv, std::uint64_t rand ) const
+            {
+                if ( ediv == 0 && rand == 0 && state_ == details::lesc_pairing_state::pairing_completed )
+                    return { true, state_data_.completed_state.long_term_key };
+
+                return std::pair< bool, details::uint128_t >{};
+            }
+
+            void error_reset()
+            {
+                state_           = details::lesc_pairing_state::idle;
+                confirm_pending_ = false;
+                dh_key_pending_  = false;
+            }
+
+            bool confirm_pending() const
+            {
+                return confirm_pending_;
+            }
+
+            bool dh_key_pending() const
+            {
+                return dh_key_pending_;
+            }
+
+            bool dh_key_valid() const
+            {
+                return dh_key_valid_;
+            }
+
+            const std::array< std::uint8_t, 3 >& io_cap() const
+            {
+                return state_data_.pairing_state.io_cap;
+            }
+
+            std::uint8_t key_size() const
+            {
+                return state_data_.pairing_state.key_size;
+            }
+
+            std::uint8_t initiator_key_distribution() const
+            {
+                return state_data_.pairing_state.initiator_key_distribution;
+            }
+
+            const std::array< std::uint8_t, EllipticCurve::public_key_size >& remote_public_key() const
+            {
+                return state_data_.pairing_state.remote_public_key;
+            }
+
+            std::array< std::uint8_t, EllipticCurve::dh_key_size >& dh_key()
+            {
+                return state_data_.pairing_state.dh_key;
+            }
+
+            const details::uint128_t& na() const
+            {
+                return state_data_.pairing_state.na;
+            }
+
+            const details::uint128_t& nb() const
+            {
+                return state_data_.pairing_state.nb;
+            }
+
+            device_pairing_status local_device_pairing_status() const
+            {
+                return state_ == details::lesc_pairing_state::pairing_completed
+                    ? bluetoe::device_pairing_status::unauthenticated_key
+                    : bluetoe::device_pairing_status::no_key;
+            }
+
+        private:
+            bluetoe::link_layer::device_address remote_addr_;
+            details::lesc_pairing_state         state_;
+            bool                                confirm_pending_;
+            bool                                dh_key_pending_;
+            bool                                dh_key_valid_;
+
+            union {
+                struct {
+                    std::array< std::uint8_t, 3 >                                   io_cap;
+                    std::uint8_t                                                    key_size;
+                    std::uint8_t                                                    initiator_key_distribution;
+                    std::array< std::uint8_t, EllipticCurve::public_key_size >      remote_public_key;
+                    std::array< std::uint8_t, EllipticCurve::dh_key_size >          dh_key;
+                    details::uint128_t                                              na;
+                    details::uint128_t                                              nb;
+                }                                   pairing_state;
+
+                struct {
+                    details::uint128_t          long_term_key;
+                    details::uint128_t          identity_resolving_key;
+                    details::lesc_expected_key  expected_key;
+                }                                   completed_state;
+            }                       state_data_;
+        };
+
+        lesc_security_manager()
+            : key_pair_valid_( false )
+        {
+        }
+
+        template < class OtherConnectionData, class SecurityFunctions >
+        void l2cap_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& );
+
+        /*
+         * output, that is not a direct response to an input: the Pairing Confirm, that follows the Pairing Public Key
+         */
+        template < class OtherConnectionData, class SecurityFunctions >
+        void l2cap_output( std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& );
+
+        /*
+         * calculates a pending Diffie-Hellman key and the key pair for the next pairing
+         */
+        template < class OtherConnectionData, class SecurityFunctions >
+        void idle_processing( connection_data< OtherConnectionData >&, SecurityFunctions& );
+
+        typedef details::security_manager_meta_type meta_type;
+    private:
+        static constexpr std::size_t    public_key_pdu_size = 1 + EllipticCurve::public_key_size;
+        static constexpr std::size_t    value_pdu_size = 17;
+
+        template < class OtherConnectionData, class SecurityFunctions >
+        void handle_pairing_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& );
+
+        template < class OtherConnectionData, class SecurityFunctions >
+        void handle_pairing_public_key( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& );
+
+        template < class OtherConnectionData >
+        void handle_pairing_random( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& );
+
+        template < class OtherConnectionData, class SecurityFunctions >
+        void handle_pairing_dhkey_check( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& );
+
+        template < class OtherConnectionData >
+        void handle_identity_information( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& );
+
+        template < class OtherConnectionData, class SecurityFunctions >
+        void handle_identity_address_information( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& );
+
+        template < class OtherConnectionData >
+        void error_response( details::sm_error_codes error_code, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& );
+
+        template < class OtherConnectionData >
+        void key_distribution_error( details::sm_error_codes error_code, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& );
+
+        template < class SecurityFunctions >
+        void create_key_pair( SecurityFunctions& );
+
+        template < class OtherConnectionData >
+        void calculate_dh_key( connection_data< OtherConnectionData >& );
+
+        template < class SecurityFunctions >
+        static const std::uint8_t* local_io_cap();
+
+        std::array< std::uint8_t, EllipticCurve::private_key_size > private_key_;
+        std::array< std::uint8_t, EllipticCurve::public_key_size >  public_key_;
+        bool                                                        key_pair_valid_;
+        /** @endcond */
+    };
+
     /**
      * @brief current default implementation of the security manager, that actievly rejects every pairing attempt.
      */
@@ -275,6 +668,12 @@ namespace bluetoe {
         template < class OtherConnectionData, class SecurityFunctions >
         void l2cap_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& );
 
+        template < class OtherConnectionData, class SecurityFunctions >
+        void l2cap_output( std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& );
+
+        template < class OtherConnectionData, class SecurityFunctions >
+        void idle_processing( connection_data< OtherConnectionData >&, SecurityFunctions& );
+
         typedef details::security_manager_meta_type meta_type;
         /** @endcond */
     };
@@ -327,24 +726,8 @@ namespace bluetoe {
         if ( state.state() != details::pairing_state::idle )
             return error_response( sm_error_codes::unspecified_reason, output, out_size, state );
 
-        const std::uint8_t io_capability                = input[ 1 ];
-        const std::uint8_t oob_data_flag                = input[ 2 ];
-        const std::uint8_t auth_req                     = input[ 3 ];
-        const std::uint8_t max_key_size                 = input[ 4 ];
-        const std::uint8_t initiator_key_distribution   = input[ 5 ];
-        const std::uint8_t responder_key_distribution   = input[ 6 ];
-
-        if (
-            ( io_capability > static_cast< std::uint8_t >( io_capabilities::last ) )
-         || ( oob_data_flag & ~0x01 )
-         || ( auth_req & 0xC0 )
-         || ( max_key_size < min_max_key_size || max_key_size > max_max_key_size )
-         || ( initiator_key_distribution & 0xf0 )
-         || ( responder_key_distribution & 0xf0 )
-        )
-        {
+        if ( !valid_pairing_request( input ) )
             return error_response( sm_error_codes::invalid_parameters, output, out_size, state );
-        }
 
         create_pairing_response( output, out_size );
 
@@ -424,6 +807,17 @@ namespace bluetoe {
         state.pairing_completed( stk );
     }
 
+    template < class OtherConnectionData, class SecurityFunctions >
+    void security_manager::l2cap_output( std::uint8_t*, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& )
+    {
+        out_size = 0;
+    }
+
+    template < class OtherConnectionData, class SecurityFunctions >
+    void security_manager::idle_processing( connection_data< OtherConnectionData >&, SecurityFunctions& )
+    {
+    }
+
     template < class OtherConnectionData >
     void security_manager::error_response( details::sm_error_codes error_code, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& state )
     {
@@ -463,12 +857,352 @@ namespace bluetoe {
     }
 
 
+    template < class EllipticCurve >
+    template < class OtherConnectionData, class SecurityFunctions >
+    void lesc_security_manager< EllipticCurve >::l2cap_input(
+        const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& state, SecurityFunctions& func )
+    {
+        using namespace bluetoe::details;
+
+        // is there at least an opcode?
+        if ( in_size == 0 )
+            return error_response( sm_error_codes::invalid_parameters, output, out_size, state );
+
+        assert( out_size >= default_att_mtu_size );
+
+        const sm_opcodes opcode = static_cast< sm_opcodes >( input[ 0 ] );
+
+        switch ( opcode )
+        {
+            case sm_opcodes::pairing_request:
+                handle_pairing_request( input, in_size, output, out_size, state, func );
+                break;
+            case sm_opcodes::pairing_public_key:
+                handle_pairing_public_key( input, in_size, output, out_size, state, func );
+                break;
+            case sm_opcodes::pairing_random:
+                handle_pairing_random( input, in_size, output, out_size, state );
+                break;
+            case sm_opcodes::pairing_dhkey_check:
+                handle_pairing_dhkey_check( input, in_size, output, out_size, state, func );
+                break;
+            case sm_opcodes::identity_information:
+                handle_identity_information( input, in_size, output, out_size, state );
+                break;
+            case sm_opcodes::identity_address_information:
+                handle_identity_address_information( input, in_size, output, out_size, state, func );
+                break;
+            default:
+                error_response( sm_error_codes::command_not_supported, output, out_size, state );
+        }
+    }
+
+    template < class EllipticCurve >
+    template < class OtherConnectionData, class SecurityFunctions >
+    void lesc_security_manager< EllipticCurve >::l2cap_output(
+        std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& state, SecurityFunctions& )
+    {
+        using namespace details;
+
+        if ( !state.confirm_pending() || out_size < value_pdu_size )
+        {
+            out_size = 0;
+            return;
+        }
+
+        // Cb = f4( PKbx, PKax, Nb, 0 )
+        out_size = value_pdu_size;
+        output[ 0 ] = static_cast< std::uint8_t >( sm_opcodes::pairing_confirm );
+        f4( public_key_.data(), state.remote_public_key().data(), state.nb().data(), 0, &output[ 1 ] );
+
+        state.confirm_sent();
+    }
+
+    template < class EllipticCurve >
+    template < class OtherConnectionData, class SecurityFunctions >
+    void lesc_security_manager< EllipticCurve >::idle_processing( connection_data< OtherConnectionData >& state, SecurityFunctions& func )
+    {
+        // the key pair has to stay, until the confirm value, that depends on the local public key, was sent
+        if ( state.dh_key_pending() && !state.confirm_pending() )
+            calculate_dh_key( state );
+
+        create_key_pair( func );
+    }
+
+    template < class EllipticCurve >
+    template < class OtherConnectionData, class SecurityFunctions >
+    void lesc_security_manager< EllipticCurve >::handle_pairing_request(
+        const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& state, SecurityFunctions& )
+    {
+        using namespace details;
+
+        if ( in_size != pairing_req_resp_size )
+            return error_response( sm_error_codes::invalid_parameters, output, out_size, state );
+
+        if ( state.state() != lesc_pairing_state::idle )
+            return error_response( sm_error_codes::unspecified_reason, output, out_size, state );
+
+        if ( !valid_pairing_request( input ) )
+            return error_response( sm_error_codes::invalid_parameters, output, out_size, state );
+
+        if ( ( input[ 3 ] & static_cast< std::uint8_t >( authentication_requirements::secure_connections ) ) == 0 )
+            return error_response( sm_error_codes::authentication_requirements, output, out_size, state );
+
+        if ( out_size < public_key_pdu_size )
+            return error_response( sm_error_codes::pairing_not_supported, output, out_size, state );
+
+        // if both devices request bonding, the initiator is asked for its identity resolving key and identity address
+        const bool bonding = SecurityFunctions::bonding_supported
+            && ( input[ 3 ] & static_cast< std::uint8_t >( authentication_requirements::bonding ) );
+        const std::uint8_t initiator_key_distribution = bonding
+            ? static_cast< std::uint8_t >( input[ 5 ] & static_cast< std::uint8_t >( key_distribution::id_key ) )
+            : 0;
+
+        // the encryption key size is the smaller of both maximum key sizes
+        state.pairing_request( &input[ 1 ], std::min( input[ 4 ], max_max_key_size ), initiator_key_distribution );
+
+        const std::uint8_t* const io_cap = local_io_cap< SecurityFunctions >();
+
+        out_size = pairing_req_resp_size;
+        output[ 0 ] = static_cast< std::uint8_t >( sm_opcodes::pairing_response );
+        std::copy( io_cap, io_cap + 3, &output[ 1 ] );
+        output[ 4 ] = max_max_key_size;
+        output[ 5 ] = initiator_key_distribution;
+        output[ 6 ] = 0;
+    }
+
+    template < class EllipticCurve >
+    template < class OtherConnectionData, class SecurityFunctions >
+    void lesc_security_manager< EllipticCurve >::handle_pairing_public_key(
+        const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& state, SecurityFunctions& func )
+    {
+        using namespace details;
+
+        if ( in_size != public_key_pdu_size )
+            return error_response( sm_error_codes::invalid_parameters, output, out_size, state );
+
+        if ( state.state() != lesc_pairing_state::pairing_requested )
+            return error_response( sm_error_codes::unspecified_reason, output, out_size, state );
+
+        // usually, the key pair was already created in idle time
+        create_key_pair( func );
+
+        const std::uint8_t* const remote_key = &input[ 1 ];
+
+        // a public key, that is not on the curve, or that reflects the local public key is rejected
+        if ( !EllipticCurve::is_valid_public_key( remote_key )
+          || std::equal( remote_key, remote_key + EllipticCurve::public_key_size / 2, public_key_.begin() ) )
+            return error_response( sm_error_codes::dhkey_check_failed, output, out_size, state );
+
+        state.public_key_exchanged( remote_key, func.create_srand() );
+
+        out_size = public_key_pdu_size;
+        output[ 0 ] = static_cast< std::uint8_t >( sm_opcodes::pairing_public_key );
+        std::copy( public_key_.begin(), public_key_.end(), &output[ 1 ] );
+    }
+
+    template < class EllipticCurve >
+    template < class OtherConnectionData >
+    void lesc_security_manager< EllipticCurve >::handle_pairing_random(
+        const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& state )
+    {
+        using namespace details;
+
+        if ( in_size != value_pdu_size )
+            return error_response( sm_error_codes::invalid_parameters, output, out_size, state );
+
+        if ( state.state() != lesc_pairing_state::public_key_exchanged || state.confirm_pending() )
+            return error_response( sm_error_codes::unspecified_reason, output, out_size, state );
+
+        state.random_exchanged( &input[ 1 ] );
+
+        out_size = value_pdu_size;
+        output[ 0 ] = static_cast< std::uint8_t >( sm_opcodes::pairing_random );
+        std::copy( state.nb().begin(), state.nb().end(), &output[ 1 ] );
+    }
+
+    template < class EllipticCurve >
+    template < class OtherConnectionData, class SecurityFunctions >
+    void lesc_security_manager< EllipticCurve >::handle_pairing_dhkey_check(
+        const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& state, SecurityFunctions& func )
+    {
+        using namespace details;
+
+        if ( in_size != value_pdu_size )
+            return error_response( sm_error_codes::invalid_parameters, output, out_size, state );
+
+        if ( state.state() != lesc_pairing_state::random_exchanged )
+            return error_response( sm_error_codes::unspecified_reason, output, out_size, state );
+
+        // if there was not enough idle time since the public key exchange
+        if ( state.dh_key_pending() )
+            calculate_dh_key( state );
+
+        if ( !state.dh_key_valid() )
+            return error_response( sm_error_codes::dhkey_check_failed, output, out_size, state );
+
+        const bluetoe::link_layer::device_address& initiator = state.remote_address();
+        const bluetoe::link_layer::device_address  responder = func.local_address();
+
+        uint128_t mac_key;
+        uint128_t long_term_key;
+        f5( state.dh_key().data(), state.na().data(), state.nb().data(), initiator, responder, mac_key.data(), long_term_key.data() );
+
+        // Ea = f6( MacKey, Na, Nb, rb, IOcapA, A, B ), with rb = 0 for Just Works
+        const uint128_t r = {{ 0 }};
+        uint128_t check;
+        f6( mac_key.data(), state.na().data(), state.nb().data(), r.data(), state.io_cap().data(), initiator, responder, check.data() );
+
+        if ( !std::equal( check.begin(), check.end(), &input[ 1 ] ) )
+            return error_response( sm_error_codes::dhkey_check_failed, output, out_size, state );
+
+        // Eb = f6( MacKey, Nb, Na, ra, IOcapB, B, A )
+        out_size = value_pdu_size;
+        output[ 0 ] = static_cast< std::uint8_t >( sm_opcodes::pairing_dhkey_check );
+        f6( mac_key.data(), state.nb().data(), state.na().data(), r.data(), local_io_cap< SecurityFunctions >(), responder, initiator, &output[ 1 ] );
+
+        shorten_key( long_term_key, state.key_size() );
+
+        // bonding takes place, if both devices request bonding; the key is identified by EDIV = 0 and Rand = 0
+        const std::uint8_t bonding_flag = static_cast< std::uint8_t >( authentication_requirements::bonding );
+        const bool         bonding      = SecurityFunctions::bonding_supported && ( state.io_cap()[ 2 ] & bonding_flag );
+        const bool         identity     = state.initiator_key_distribution() & static_cast< std::uint8_t >( key_distribution::id_key );
+
+        state.pairing_completed( long_term_key, identity );
+
+        // with identity information, the bond is stored, when the initiator distributed its identity address
+        if ( bonding && !identity )
+            func.store_bond( bond_data{ initiator, long_term_key, 0, 0, state.local_device_pairing_status(), {{ 0 }} } );
+    }
+
+    template < class EllipticCurve >
+    template < class OtherConnectionData >
+    void lesc_security_manager< EllipticCurve >::handle_identity_information(
+        const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& state )
+    {
+        using namespace details;
+
+        if ( in_size != value_pdu_size )
+            return key_distribution_error( sm_error_codes::invalid_parameters, output, out_size, state );
+
+        if ( state.expected_key() != lesc_expected_key::identity_information )
+            return key_distribution_error( sm_error_codes::unspecified_reason, output, out_size, state );
+
+        state.identity_information_received( &input[ 1 ] );
+        out_size = 0;
+    }
+
+    template < class EllipticCurve >
+    template < class OtherConnectionData, class SecurityFunctions >
+    void lesc_security_manager< EllipticCurve >::handle_identity_address_information(
+        const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& state, SecurityFunctions& func )
+    {
+        using namespace details;
+
+        static constexpr std::size_t    pdu_size = 8;
+        static constexpr std::uint8_t   static_random_address_type = 0x01;
+
+        if ( in_size != pdu_size || input[ 1 ] > static_random_address_type )
+            return key_distribution_error( sm_error_codes::invalid_parameters, output, out_size, state );
+
+        if ( state.expected_key() != lesc_expected_key::identity_address_information )
+            return key_distribution_error( sm_error_codes::unspecified_reason, output, out_size, state );
+
+        state.identity_address_information_received();
+        out_size = 0;
+
+        const bluetoe::link_layer::device_address identity( &input[ 2 ], input[ 1 ] == static_random_address_type );
+
+        func.store_bond( bond_data{ identity, state.long_term_key(), 0, 0, state.local_device_pairing_status(), state.identity_resolving_key() } );
+    }
+
+    template < class EllipticCurve >
+    template < class OtherConnectionData >
+    void lesc_security_manager< EllipticCurve >::error_response( details::sm_error_codes error_code, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& state )
+    {
+        state.error_reset();
+        details::error_response( error_code, output, out_size );
+    }
+
+    template < class EllipticCurve >
+    template < class OtherConnectionData >
+    void lesc_security_manager< EllipticCurve >::key_distribution_error( details::sm_error_codes error_code, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >& state )
+    {
+        if ( !state.keys_generated() )
+            return error_response( error_code, output, out_size, state );
+
+        // the link is already encrypted with the generated key, only the distributed keys are rejected
+        state.key_distribution_failed();
+        details::error_response( error_code, output, out_size );
+    }
+
+    template < class EllipticCurve >
+    template < class SecurityFunctions >
+    void lesc_security_manager< EllipticCurve >::create_key_pair( SecurityFunctions& func )
+    {
+        static constexpr std::size_t random_size = std::tuple_size< details::uint128_t >::value;
+
+        while ( !key_pair_valid_ )
+        {
+            for ( std::size_t pos = 0; pos != private_key_.size(); pos += random_size )
+            {
+                const details::uint128_t random = func.create_srand();
+                std::copy( random.begin(), random.end(), &private_key_[ pos ] );
+            }
+
+            key_pair_valid_ = EllipticCurve::public_key( private_key_.data(), public_key_.data() );
+        }
+    }
+
+    template < class EllipticCurve >
+    template < class OtherConnectionData >
+    void lesc_security_manager< EllipticCurve >::calculate_dh_key( connection_data< OtherConnectionData >& state )
+    {
+        assert( key_pair_valid_ );
+
+        std::array< std::uint8_t, EllipticCurve::dh_key_size > dh_key;
+        const bool valid = EllipticCurve::dh_key( private_key_.data(), state.remote_public_key().data(), dh_key.data() );
+
+        state.dh_key() = dh_key;
+        state.dh_key_calculated( valid );
+
+        // the key pair is used for a single pairing
+        key_pair_valid_ = false;
+    }
+
+    template < class EllipticCurve >
+    template < class SecurityFunctions >
+    const std::uint8_t* lesc_security_manager< EllipticCurve >::local_io_cap()
+    {
+        // IO Capability, OOB data flag and AuthReq of the Pairing Response
+        static const std::uint8_t io_cap[] = {
+            static_cast< std::uint8_t >( details::io_capabilities::no_input_no_output ),
+            0,
+            static_cast< std::uint8_t >(
+                static_cast< std::uint8_t >( details::authentication_requirements::secure_connections )
+              | ( SecurityFunctions::bonding_supported ? static_cast< std::uint8_t >( details::authentication_requirements::bonding ) : 0 ) )
+        };
+
+        return &io_cap[ 0 ];
+    }
+
     template < class OtherConnectionData, class SecurityFunctions >
     void no_security_manager::l2cap_input( const std::uint8_t*, std::size_t, std::uint8_t* output, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& )
     {
         error_response( details::sm_error_codes::pairing_not_supported, output, out_size );
     }
 
+    template < class OtherConnectionData, class SecurityFunctions >
+    void no_security_manager::l2cap_output( std::uint8_t*, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& )
+    {
+        out_size = 0;
+    }
+
+    template < class OtherConnectionData, class SecurityFunctions >
+    void no_security_manager::idle_processing( connection_data< OtherConnectionData >&, SecurityFunctions& )
+    {
+    }
+
     /** @endcond */
 }
 #endif
@@ -29,6 +29,9 @@ namespace details {
         insufficient_encryption         = 0x0f,
         insufficient_authentication     = 0x05,
 
+        // the result of a read or write will be provided later (error_codes::pending)
+        pending                         = 0x7f,
+
         // returned when access type is compare_128bit_uuid and the attribute contains a 128bit uuid and
         // the buffer in attribute_access_arguments is equal to the contained uuid.
         uuid_equal                      = 0x100,
@@ -39,7 +42,10 @@ namespace details {
         read,
         write,
         compare_128bit_uuid,
-        compare_value
+        compare_value,
+        // asks for the location of the value instead of a copy; if supported, the attribute sets buffer and
+        // buffer_size to the part of the value, starting at buffer_offset.
+        read_reference
     };
 
     struct attribute_access_arguments
@@ -123,6 +129,22 @@ namespace details {
             };
         }
 
+        static constexpr attribute_access_arguments read_reference( std::size_t offset,
+            const client_characteristic_configuration& cc,
+            const connection_security_attributes& cs,
+            void* server )
+        {
+            return attribute_access_arguments{
+                attribute_access_type::read_reference,
+                nullptr,
+                0,
+                offset,
+                cc,
+                cs,
+                server
+            };
+        }
+
         static constexpr attribute_access_arguments check_write( void* server )
         {
             return attribute_access_arguments{
@@ -165,6 +187,32 @@ namespace details {
         }
     };
 
+    /*
+     * Part of an output, that was not copied into the output buffer but refers to the value of an attribute
+     */
+    struct output_reference
+    {
+        const std::uint8_t* data;
+        std::size_t         size;
+
+        constexpr output_reference()
+            : data( nullptr )
+            , size( 0 )
+        {
+        }
+
+        constexpr output_reference( const std::uint8_t* d, std::size_t s )
+            : data( d )
+            , size( s )
+        {
+        }
+
+        constexpr bool empty() const
+        {
+            return size == 0;
+        }
+    };
+
     typedef attribute_access_result ( *attribute_access )( attribute_access_arguments&, std::uint16_t attribute_handle );
 
     /*
@@ -219,6 +267,34 @@ namespace details {
         }
     };
 
+    /*
+     * Given that T is a tuple with elements that implement attribute_generators< CCCDIndices, std::size_t, Service, Server >, the type
+     * concatenates the generators of all elements into one list.
+     */
+    template < typename T, typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server >
+    struct attribute_generators_list;
+
+    template < typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename Service, typename Server >
+    struct attribute_generators_list< std::tuple<>, CCCDIndices, ClientCharacteristicIndex, Service, Server >
+    {
+        using type = std::tuple<>;
+    };
+
+    template <
+        typename T,
+        typename ...Ts,
+        typename CCCDIndices,
+        std::size_t ClientCharacteristicIndex,
+        typename Service,
+        typename Server >
+    struct attribute_generators_list< std::tuple< T, Ts... >, CCCDIndices, ClientCharacteristicIndex, Service, Server >
+    {
+        using type = typename add_type<
+            typename T::template attribute_generators< CCCDIndices, ClientCharacteristicIndex, Service, Server >,
+            typename attribute_generators_list< std::tuple< Ts... >, CCCDIndices, ClientCharacteristicIndex + T::number_of_client_configs, Service, Server >::type
+        >::type;
+    };
+
     /*
      * Iterating the list of services is the same, but needs less parameters
      */
@@ -260,6 +336,35 @@ namespace details {
         }
     };
 
+    template < typename Services, typename Server, typename CCCDIndices, std::size_t ClientCharacteristicIndex = 0, typename AllServices = Services >
+    struct attribute_generators_from_service_list;
+
+    template < typename Server, typename CCCDIndices, std::size_t ClientCharacteristicIndex, typename AllServices >
+    struct attribute_generators_from_service_list< std::tuple<>, Server, CCCDIndices, ClientCharacteristicIndex, AllServices >
+    {
+        using type = std::tuple<>;
+    };
+
+    template <
+        typename T,
+        typename ...Ts,
+        typename Server,
+        typename CCCDIndices,
+        std::size_t ClientCharacteristicIndex,
+        typename AllServices >
+    struct attribute_generators_from_service_list< std::tuple< T, Ts... >, Server, CCCDIndices, ClientCharacteristicIndex, AllServices >
+    {
+        using type = typename add_type<
+            typename T::template attribute_generators< CCCDIndices, ClientCharacteristicIndex, AllServices, Server >,
+            typename attribute_generators_from_service_list<
+                std::tuple< Ts... >,
+                Server,
+                CCCDIndices,
+                ClientCharacteristicIndex + T::number_of_client_configs,
+                AllServices >::type
+        >::type;
+    };
+
     /**
      * @brief data needed to send an indication or notification to the l2cap layer
      */
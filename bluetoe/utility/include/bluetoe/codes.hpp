@@ -35,7 +35,10 @@ namespace details {
         write_command               = 0x52,
         notification                = 0x1B,
         indication                  = 0x1D,
-        confirmation                = 0x1E
+        confirmation                = 0x1E,
+        read_multiple_variable_length_request   = 0x20,
+        read_multiple_variable_length_response  = 0x21,
+        multiple_handle_value_notification      = 0x23
 
     };
 
@@ -61,7 +64,9 @@ namespace details {
         unlikely_error,
         insufficient_encryption,
         unsupported_group_type,
-        insufficient_resources
+        insufficient_resources,
+        database_out_of_sync,
+        value_not_allowed
     };
 
     constexpr std::uint8_t bits( att_error_codes c )
@@ -84,8 +89,12 @@ namespace details {
         secondary_service                   = 0x2801,
         include                             = 0x2802,
         characteristic                      = 0x2803,
+        characteristic_extended_properties  = 0x2900,
         characteristic_user_description     = 0x2901,
         client_characteristic_configuration = 0x2902,
+        server_characteristic_configuration = 0x2903,
+        characteristic_presentation_format  = 0x2904,
+        characteristic_aggregate_format     = 0x2905,
 
         internal_128bit_uuid    = 1
     };
@@ -236,6 +245,23 @@ namespace error_codes {
          */
         insufficient_resources,
 
+        /**
+         * The server requests the client to rediscover the database.
+         */
+        database_out_of_sync,
+
+        /**
+         * The attribute parameter value was not allowed.
+         */
+        value_not_allowed,
+
+        /**
+         * Not an ATT error code: A read or write handler returns pending, if the result of a Read, Read Blob or
+         * Write Request is not available yet. The request is parked and the response is send, after the
+         * application called server::complete_pending_read() or server::complete_pending_write().
+         */
+        pending                             = 0x7f,
+
         /**
          * Start of range for application specific error codes
          */
@@ -0,0 +1,532 @@
+#ifndef BLUETOE_P256_HPP
+#define BLUETOE_P256_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace bluetoe {
+namespace details {
+
+    /*
+     * Software implementation of the NIST P-256 elliptic curve operations, that are used by LE Secure Connections:
+     * calculating the public key to a private key and the Diffie-Hellman key from the own private key and the
+     * public key of the remote device.
+     *
+     * The implementation is constant time: the scalar multiplication is a Montgomery ladder with co-Z point
+     * additions (Goundar, Joye, Miyaji) on a scalar with fixed bit length, the field arithmetic uses masks instead
+     * of branches and there are no memory accesses, that depend on the private key. Field elements are kept in
+     * Montgomery representation.
+     *
+     * All keys are in the byte order of the Security Manager Protocol (least significant octet first). A public key
+     * is the X coordinate, followed by the Y coordinate.
+     */
+    class p256
+    {
+    public:
+        static constexpr std::size_t private_key_size = 32;
+        static constexpr std::size_t public_key_size  = 64;
+        static constexpr std::size_t dh_key_size      = 32;
+
+        /*
+         * calculates the public key to the given private key. Returns false, if the private key is not in the range [1, n-1],
+         * or if it is one of the few keys close to 0 or n, for which the ladder degenerates; in that case, an other private key
+         * has to be used.
+         */
+        static bool public_key( const std::uint8_t* private_key, std::uint8_t* public_key );
+
+        /*
+         * returns true, if the given public key is a point on the curve
+         */
+        static bool is_valid_public_key( const std::uint8_t* public_key );
+
+        /*
+         * calculates the Diffie-Hellman key (the X coordinate of private_key * remote_public_key). Returns false,
+         * if the remote public key is not a point on the curve or if the private key is not valid (see public_key()).
+         */
+        static bool dh_key( const std::uint8_t* private_key, const std::uint8_t* remote_public_key, std::uint8_t* dh_key );
+
+    private:
+        static constexpr std::size_t words = 8;
+
+        struct element {
+            std::uint32_t w[ words ];
+        };
+
+        static const element& modulus();
+        static const element& order();
+        static const element& one();
+
+        static element load( const std::uint8_t* input );
+        static void store( const element& value, std::uint8_t* output );
+
+        static std::uint32_t mask( std::uint32_t bit );
+        static std::uint32_t add( element& r, const element& a, const element& b );
+        static std::uint32_t sub( element& r, const element& a, const element& b );
+        static void select( element& r, const element& a, const element& b, std::uint32_t mask );
+        static void swap( element& a, element& b, std::uint32_t mask );
+        static bool equal( const element& a, const element& b );
+
+        static void mod_add( element& r, const element& a, const element& b );
+        static void mod_sub( element& r, const element& a, const element& b );
+        static void mul( element& r, const element& a, const element& b );
+        static void inverse( element& r, const element& a );
+        static element to_montgomery( const element& a );
+        static element from_montgomery( const element& a );
+
+        static bool valid_private_key( const element& k );
+        static bool on_curve( const element& x, const element& y );
+
+        static void initial_double( element& x1, element& y1, element& x2, element& y2 );
+        static void xycz_add( element& x1, element& y1, element& x2, element& y2 );
+        static void xycz_addc( element& x1, element& y1, element& x2, element& y2 );
+        static void multiply( element& x, element& y, const element& scalar );
+    };
+
+    // implementation
+    /** @cond HIDDEN_SYMBOLS */
+    inline const p256::element& p256::modulus()
+    {
+        static const element p = { { 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0xffffffff } };
+
+        return p;
+    }
+
+    inline const p256::element& p256::order()
+    {
+        static const element n = { { 0xfc632551, 0xf3b9cac2, 0xa7179e84, 0xbce6faad, 0xffffffff, 0xffffffff, 0x00000000, 0xffffffff } };
+
+        return n;
+    }
+
+    inline const p256::element& p256::one()
+    {
+        // 2^256 mod p
+        static const element r = { { 0x00000001, 0x00000000, 0x00000000, 0xffffffff, 0xffffffff, 0xffffffff, 0xfffffffe, 0x00000000 } };
+
+        return r;
+    }
+
+    inline p256::element p256::load( const std::uint8_t* input )
+    {
+        element result;
+
+        for ( std::size_t i = 0; i != words; ++i, input += 4 )
+            result.w[ i ] = std::uint32_t( input[ 0 ] ) | std::uint32_t( input[ 1 ] ) << 8 | std::uint32_t( input[ 2 ] ) << 16 | std::uint32_t( input[ 3 ] ) << 24;
+
+        return result;
+    }
+
+    inline void p256::store( const element& value, std::uint8_t* output )
+    {
+        for ( std::size_t i = 0; i != words; ++i )
+        {
+            for ( std::size_t b = 0; b != 4; ++b )
+                *output++ = static_cast< std::uint8_t >( value.w[ i ] >> ( 8 * b ) );
+        }
+    }
+
+    inline std::uint32_t p256::mask( std::uint32_t bit )
+    {
+        return 0u - bit;
+    }
+
+    inline std::uint32_t p256::add( element& r, const element& a, const element& b )
+    {
+        std::uint64_t carry = 0;
+
+        for ( std::size_t i = 0; i != words; ++i )
+        {
+            carry += std::uint64_t( a.w[ i ] ) + b.w[ i ];
+            r.w[ i ] = static_cast< std::uint32_t >( carry );
+            carry >>= 32;
+        }
+
+        return static_cast< std::uint32_t >( carry );
+    }
+
+    inline std::uint32_t p256::sub( element& r, const element& a, const element& b )
+    {
+        std::uint32_t borrow = 0;
+
+        for ( std::size_t i = 0; i != words; ++i )
+        {
+            const std::uint64_t diff = std::uint64_t( a.w[ i ] ) - b.w[ i ] - borrow;
+            r.w[ i ] = static_cast< std::uint32_t >( diff );
+            borrow   = static_cast< std::uint32_t >( diff >> 32 ) & 1;
+        }
+
+        return borrow;
+    }
+
+    inline void p256::select( element& r, const element& a, const element& b, std::uint32_t mask )
+    {
+        for ( std::size_t i = 0; i != words; ++i )
+            r.w[ i ] = ( a.w[ i ] & mask ) | ( b.w[ i ] & ~mask );
+    }
+
+    inline void p256::swap( element& a, element& b, std::uint32_t mask )
+    {
+        for ( std::size_t i = 0; i != words; ++i )
+        {
+            const std::uint32_t diff = ( a.w[ i ] ^ b.w[ i ] ) & mask;
+            a.w[ i ] ^= diff;
+            b.w[ i ] ^= diff;
+        }
+    }
+
+    inline bool p256::equal( const element& a, const element& b )
+    {
+        std::uint32_t diff = 0;
+
+        for ( std::size_t i = 0; i != words; ++i )
+            diff |= a.w[ i ] ^ b.w[ i ];
+
+        return diff == 0;
+    }
+
+    inline void p256::mod_add( element& r, const element& a, const element& b )
+    {
+        element sum, reduced;
+        const std::uint32_t carry  = add( sum, a, b );
+        const std::uint32_t borrow = sub( reduced, sum, modulus() );
+
+        // the sum has to be reduced, if it overflowed or if it is not smaller than p
+        select( r, reduced, sum, mask( carry | ( borrow ^ 1 ) ) );
+    }
+
+    inline void p256::mod_sub( element& r, const element& a, const element& b )
+    {
+        element diff, corrected;
+        const std::uint32_t borrow = sub( diff, a, b );
+        add( corrected, diff, modulus() );
+
+        select( r, corrected, diff, mask( borrow ) );
+    }
+
+    inline void p256::mul( element& r, const element& a, const element& b )
+    {
+        // Montgomery multiplication (CIOS): r = a * b * 2^-256 mod p
+        const element& p = modulus();
+        std::uint32_t  t[ words + 2 ] = { 0 };
+
+        for ( std::size_t i = 0; i != words; ++i )
+        {
+            std::uint64_t carry = 0;
+
+            for ( std::size_t j = 0; j != words; ++j )
+            {
+                carry += t[ j ] + std::uint64_t( a.w[ j ] ) * b.w[ i ];
+                t[ j ] = static_cast< std::uint32_t >( carry );
+                carry >>= 32;
+            }
+
+            carry += t[ words ];
+            t[ words ]     = static_cast< std::uint32_t >( carry );
+            t[ words + 1 ] = static_cast< std::uint32_t >( carry >> 32 );
+
+            // -p^-1 mod 2^32 is 1 for the P-256 prime
+            const std::uint32_t m = t[ 0 ];
+            carry = ( t[ 0 ] + std::uint64_t( m ) * p.w[ 0 ] ) >> 32;
+
+            for ( std::size_t j = 1; j != words; ++j )
+            {
+                carry += t[ j ] + std::uint64_t( m ) * p.w[ j ];
+                t[ j - 1 ] = static_cast< std::uint32_t >( carry );
+                carry >>= 32;
+            }
+
+            carry += t[ words ];
+            t[ words - 1 ] = static_cast< std::uint32_t >( carry );
+            t[ words ]     = t[ words + 1 ] + static_cast< std::uint32_t >( carry >> 32 );
+        }
+
+        element result, reduced;
+
+        for ( std::size_t i = 0; i != words; ++i )
+            result.w[ i ] = t[ i ];
+
+        const std::uint32_t borrow = sub( reduced, result, p );
+        select( r, reduced, result, mask( t[ words ] | ( borrow ^ 1 ) ) );
+    }
+
+    inline void p256::inverse( element& r, const element& a )
+    {
+        // a^(p-2); the exponent is public, so square and multiply does not leak anything about a
+        element exponent = modulus();
+        exponent.w[ 0 ] -= 2;
+
+        element result = one();
+
+        for ( std::size_t bit = words * 32; bit-- != 0; )
+        {
+            mul( result, result, result );
+
+            if ( ( exponent.w[ bit / 32 ] >> ( bit % 32 ) ) & 1 )
+                mul( result, result, a );
+        }
+
+        r = result;
+    }
+
+    inline p256::element p256::to_montgomery( const element& a )
+    {
+        // 2^512 mod p
+        static const element r2 = { { 0x00000003, 0x00000000, 0xffffffff, 0xfffffffb, 0xfffffffe, 0xffffffff, 0xfffffffd, 0x00000004 } };
+
+        element result;
+        mul( result, a, r2 );
+
+        return result;
+    }
+
+    inline p256::element p256::from_montgomery( const element& a )
+    {
+        static const element raw_one = { { 1, 0, 0, 0, 0, 0, 0, 0 } };
+
+        element result;
+        mul( result, a, raw_one );
+
+        return result;
+    }
+
+    inline bool p256::valid_private_key( const element& k )
+    {
+        element ignored;
+        std::uint32_t non_zero = 0;
+
+        for ( std::size_t i = 0; i != words; ++i )
+            non_zero |= k.w[ i ];
+
+        return ( sub( ignored, k, order() ) & std::uint32_t( non_zero != 0 ) ) != 0;
+    }
+
+    inline bool p256::on_curve( const element& x, const element& y )
+    {
+        static const element b = { { 0x27d2604b, 0x3bce3c3e, 0xcc53b0f6, 0x651d06b0, 0x769886bc, 0xb3ebbd55, 0xaa3a93e7, 0x5ac635d8 } };
+
+        element ignored;
+
+        if ( sub( ignored, x, modulus() ) == 0 || sub( ignored, y, modulus() ) == 0 )
+            return false;
+
+        const element mx = to_montgomery( x );
+        const element my = to_montgomery( y );
+
+        // y^2 = x^3 - 3x + b
+        element left, right, three_x;
+        mul( left, my, my );
+
+        mul( right, mx, mx );
+        mul( right, right, mx );
+        mod_add( three_x, mx, mx );
+        mod_add( three_x, three_x, mx );
+        mod_sub( right, right, three_x );
+        mod_add( right, right, to_montgomery( b ) );
+
+        return equal( left, right );
+    }
+
+    inline void p256::initial_double( element& x1, element& y1, element& x2, element& y2 )
+    {
+        // (x1, y1) is the affine point P; results are 2P in (x1, y1) and P in (x2, y2), both with the same Z = 2 * y1
+        element z, s, m, t;
+
+        mod_add( z, y1, y1 );
+
+        mul( t, y1, y1 );
+        mul( s, x1, t );
+        mod_add( s, s, s );
+        mod_add( s, s, s );                 // S = 4 x y^2
+
+        mul( t, t, t );
+        mod_add( t, t, t );
+        mod_add( t, t, t );
+        mod_add( t, t, t );                 // 8 y^4
+
+        mul( m, x1, x1 );
+        mod_sub( m, m, one() );
+        mod_add( x2, m, m );
+        mod_add( m, m, x2 );                // M = 3 (x^2 - 1)
+
+        // P with Z
+        mul( x2, z, z );
+        mul( y2, x2, z );
+        mul( y2, y2, y1 );
+        mul( x2, x2, x1 );
+
+        // 2P: X = M^2 - 2S, Y = M (S - X) - 8 y^4
+        mul( x1, m, m );
+        mod_sub( x1, x1, s );
+        mod_sub( x1, x1, s );
+        mod_sub( s, s, x1 );
+        mul( y1, m, s );
+        mod_sub( y1, y1, t );
+    }
+
+    inline void p256::xycz_add( element& x1, element& y1, element& x2, element& y2 )
+    {
+        // P = (x1, y1), Q = (x2, y2) with the same Z => P with the new Z in (x1, y1) and P + Q in (x2, y2)
+        element t;
+
+        mod_sub( t, x2, x1 );
+        mul( t, t, t );                     // A = (x2 - x1)^2
+        mul( x1, x1, t );                   // B = x1 A
+        mul( x2, x2, t );                   // C = x2 A
+        mod_sub( y2, y2, y1 );
+        mul( t, y2, y2 );                   // D = (y2 - y1)^2
+
+        mod_sub( t, t, x1 );
+        mod_sub( t, t, x2 );                // x3 = D - B - C
+        mod_sub( x2, x2, x1 );
+        mul( y1, y1, x2 );                  // y1 (C - B)
+        mod_sub( x2, x1, t );
+        mul( y2, y2, x2 );
+        mod_sub( y2, y2, y1 );              // y3 = (y2 - y1) (B - x3) - y1 (C - B)
+
+        x2 = t;
+    }
+
+    inline void p256::xycz_addc( element& x1, element& y1, element& x2, element& y2 )
+    {
+        // P = (x1, y1), Q = (x2, y2) with the same Z => P - Q in (x1, y1) and P + Q in (x2, y2), again with the same Z
+        element t5, t6, t7;
+
+        mod_sub( t5, x2, x1 );
+        mul( t5, t5, t5 );                  // A = (x2 - x1)^2
+        mul( x1, x1, t5 );                  // B = x1 A
+        mul( x2, x2, t5 );                  // C = x2 A
+        mod_add( t5, y2, y1 );
+        mod_sub( y2, y2, y1 );
+
+        mod_sub( t6, x2, x1 );
+        mul( y1, y1, t6 );                  // E = y1 (C - B)
+        mod_add( t6, x1, x2 );              // B + C
+        mul( x2, y2, y2 );
+        mod_sub( x2, x2, t6 );              // x3 = (y2 - y1)^2 - (B + C)
+
+        mod_sub( t7, x1, x2 );
+        mul( y2, y2, t7 );
+        mod_sub( y2, y2, y1 );              // y3 = (y2 - y1) (B - x3) - E
+
+        mul( t7, t5, t5 );
+        mod_sub( t7, t7, t6 );              // x3' = (y2 + y1)^2 - (B + C)
+        mod_sub( t6, t7, x1 );
+        mul( t6, t6, t5 );
+        mod_sub( y1, t6, y1 );              // y3' = (y2 + y1) (x3' - B) - E
+
+        x1 = t7;
+    }
+
+    inline void p256::multiply( element& x, element& y, const element& scalar )
+    {
+        // (x, y) is an affine point in Montgomery representation and is replaced by scalar * (x, y)
+        const element px = x;
+        const element py = y;
+
+        // k + n or k + 2n has bit 256 set, which makes the number of ladder steps independent from k
+        element k, k2n;
+        const std::uint32_t carry = add( k, scalar, order() );
+        add( k2n, k, order() );
+        select( k, k, k2n, mask( carry ) );
+
+        element rx[ 2 ] = { px, px };
+        element ry[ 2 ] = { py, py };
+        initial_double( rx[ 1 ], ry[ 1 ], rx[ 0 ], ry[ 0 ] );
+
+        std::uint32_t swap_mask = 0;
+
+        for ( std::size_t bit = words * 32 - 1; bit != 0; --bit )
+        {
+            swap_mask = mask( ( ( k.w[ bit / 32 ] >> ( bit % 32 ) ) & 1 ) ^ 1 );
+
+            swap( rx[ 0 ], rx[ 1 ], swap_mask );
+            swap( ry[ 0 ], ry[ 1 ], swap_mask );
+
+            xycz_addc( rx[ 1 ], ry[ 1 ], rx[ 0 ], ry[ 0 ] );
+            xycz_add( rx[ 0 ], ry[ 0 ], rx[ 1 ], ry[ 1 ] );
+
+            swap( rx[ 0 ], rx[ 1 ], swap_mask );
+            swap( ry[ 0 ], ry[ 1 ], swap_mask );
+        }
+
+        swap_mask = mask( ( k.w[ 0 ] & 1 ) ^ 1 );
+
+        swap( rx[ 0 ], rx[ 1 ], swap_mask );
+        swap( ry[ 0 ], ry[ 1 ], swap_mask );
+
+        xycz_addc( rx[ 1 ], ry[ 1 ], rx[ 0 ], ry[ 0 ] );
+
+        // (rx[ 1 ], ry[ 1 ]) is now +/-P; the inverse of the final Z is derived from comparing it with the affine P
+        element z, negated;
+        mod_sub( z, rx[ 1 ], rx[ 0 ] );
+        mod_sub( negated, element(), z );
+        select( z, negated, z, swap_mask );
+
+        mul( z, z, ry[ 1 ] );
+        mul( z, z, px );
+        inverse( z, z );
+        mul( z, z, py );
+        mul( z, z, rx[ 1 ] );
+
+        xycz_add( rx[ 0 ], ry[ 0 ], rx[ 1 ], ry[ 1 ] );
+
+        swap( rx[ 0 ], rx[ 1 ], swap_mask );
+        swap( ry[ 0 ], ry[ 1 ], swap_mask );
+
+        // back to affine coordinates
+        element z2;
+        mul( z2, z, z );
+        mul( x, rx[ 0 ], z2 );
+        mul( z2, z2, z );
+        mul( y, ry[ 0 ], z2 );
+    }
+
+    inline bool p256::public_key( const std::uint8_t* private_key, std::uint8_t* public_key )
+    {
+        static const element gx = { { 0xd898c296, 0xf4a13945, 0x2deb33a0, 0x77037d81, 0x63a440f2, 0xf8bce6e5, 0xe12c4247, 0x6b17d1f2 } };
+        static const element gy = { { 0x37bf51f5, 0xcbb64068, 0x6b315ece, 0x2bce3357, 0x7c0f9e16, 0x8ee7eb4a, 0xfe1a7f9b, 0x4fe342e2 } };
+
+        const element k = load( private_key );
+
+        if ( !valid_private_key( k ) )
+            return false;
+
+        element x = to_montgomery( gx );
+        element y = to_montgomery( gy );
+        multiply( x, y, k );
+
+        store( from_montgomery( x ), public_key );
+        store( from_montgomery( y ), public_key + public_key_size / 2 );
+
+        return is_valid_public_key( public_key );
+    }
+
+    inline bool p256::is_valid_public_key( const std::uint8_t* public_key )
+    {
+        return on_curve( load( public_key ), load( public_key + public_key_size / 2 ) );
+    }
+
+    inline bool p256::dh_key( const std::uint8_t* private_key, const std::uint8_t* remote_public_key, std::uint8_t* dh_key )
+    {
+        const element k  = load( private_key );
+        const element rx = load( remote_public_key );
+        const element ry = load( remote_public_key + public_key_size / 2 );
+
+        if ( !valid_private_key( k ) || !on_curve( rx, ry ) )
+            return false;
+
+        element x = to_montgomery( rx );
+        element y = to_montgomery( ry );
+        multiply( x, y, k );
+
+        x = from_montgomery( x );
+        y = from_montgomery( y );
+        store( x, dh_key );
+
+        return on_curve( x, y );
+    }
+    /** @endcond */
+}
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include <bluetoe/aes.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+
+namespace {
+    // RFC 4493 / FIPS-197 key
+    const std::uint8_t key[ 16 ] = {
+        0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+        0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+    };
+
+    const std::uint8_t message[ 64 ] = {
+        0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+        0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+        0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+        0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+    };
+
+    std::vector< std::uint8_t > cmac( std::size_t size, std::size_t chunk_size )
+    {
+        bluetoe::details::aes_cmac mac( key );
+
+        for ( std::size_t pos = 0; pos < size; pos += chunk_size )
+            mac.update( &message[ pos ], std::min( chunk_size, size - pos ) );
+
+        std::vector< std::uint8_t > result( 16 );
+        mac.finish( &result[ 0 ] );
+
+        return result;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( fips_197_example_vector )
+{
+    const std::uint8_t fips_key[ 16 ] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+    };
+
+    const std::uint8_t plain[ 16 ] = {
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+    };
+
+    const std::uint8_t expected[ 16 ] = {
+        0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+    };
+
+    std::uint8_t cipher[ 16 ];
+    bluetoe::details::aes128( fips_key ).encrypt( plain, cipher );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( cipher ), std::end( cipher ), std::begin( expected ), std::end( expected ) );
+}
+
+BOOST_AUTO_TEST_CASE( encrypt_in_place )
+{
+    const std::uint8_t expected[ 16 ] = {
+        0x3a, 0xd7, 0x7b, 0xb4, 0x0d, 0x7a, 0x36, 0x60, 0xa8, 0x9e, 0xca, 0xf3, 0x24, 0x66, 0xef, 0x97
+    };
+
+    std::uint8_t block[ 16 ];
+    std::copy( std::begin( message ), std::begin( message ) + 16, std::begin( block ) );
+
+    bluetoe::details::aes128( key ).encrypt( block, block );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( block ), std::end( block ), std::begin( expected ), std::end( expected ) );
+}
+
+BOOST_AUTO_TEST_CASE( cmac_empty_message )
+{
+    const std::vector< std::uint8_t > expected = {
+        0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46
+    };
+
+    BOOST_CHECK( cmac( 0, 16 ) == expected );
+}
+
+BOOST_AUTO_TEST_CASE( cmac_single_block )
+{
+    const std::vector< std::uint8_t > expected = {
+        0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c
+    };
+
+    BOOST_CHECK( cmac( 16, 16 ) == expected );
+    BOOST_CHECK( cmac( 16, 3 ) == expected );
+}
+
+BOOST_AUTO_TEST_CASE( cmac_incomplete_last_block )
+{
+    const std::vector< std::uint8_t > expected = {
+        0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27
+    };
+
+    BOOST_CHECK( cmac( 40, 40 ) == expected );
+    BOOST_CHECK( cmac( 40, 1 ) == expected );
+    BOOST_CHECK( cmac( 40, 7 ) == expected );
+}
+
+BOOST_AUTO_TEST_CASE( cmac_four_blocks )
+{
+    const std::vector< std::uint8_t > expected = {
+        0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe
+    };
+
+    BOOST_CHECK( cmac( 64, 64 ) == expected );
+    BOOST_CHECK( cmac( 64, 16 ) == expected );
+    BOOST_CHECK( cmac( 64, 5 ) == expected );
+}
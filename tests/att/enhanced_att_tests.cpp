@@ -0,0 +1,240 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_servers.hpp"
+
+namespace {
+    std::uint8_t large_value[ 100 ];
+    std::uint8_t indicated_value = 0x42;
+
+    bool          sample_available = false;
+    const std::uint8_t sample[] = { 0x01, 0x02 };
+
+    std::uint8_t read_sensor( std::size_t offset, std::size_t read_size, std::uint8_t* out_buffer, std::size_t& out_size )
+    {
+        if ( !sample_available )
+            return bluetoe::error_codes::pending;
+
+        out_size = std::min( read_size, sizeof( sample ) - offset );
+        std::copy( &sample[ offset ], &sample[ offset + out_size ], out_buffer );
+
+        return bluetoe::error_codes::success;
+    }
+
+    using eatt_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::bind_characteristic_value< decltype( large_value ), &large_value >,
+                bluetoe::no_write_access
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0002 >,
+                bluetoe::free_read_blob_handler< &read_sensor >
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0003 >,
+                bluetoe::bind_characteristic_value< std::uint8_t, &indicated_value >,
+                bluetoe::no_write_access,
+                bluetoe::indicate
+            >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers,
+        bluetoe::gatt_caching,
+        bluetoe::enhanced_att< 2 >
+    >;
+
+    struct enhanced : test::request_with_reponse< eatt_server, 100 >
+    {
+        enhanced()
+        {
+            sample_available = false;
+
+            for ( std::size_t i = 0; i != sizeof( large_value ); ++i )
+                large_value[ i ] = static_cast< std::uint8_t >( i );
+
+            // the bearer is opened by the link layer with the MTU of the L2CAP channel
+            bearer = bluetoe::details::att_bearer( 64 );
+            bearer.client_mtu( 64 );
+        }
+
+        void bearer_input( const std::initializer_list< std::uint8_t >& input )
+        {
+            bearer_input( input, bearer );
+        }
+
+        void bearer_input( const std::initializer_list< std::uint8_t >& input, bluetoe::details::att_bearer& input_bearer )
+        {
+            const std::vector< std::uint8_t > values( input );
+
+            response_size = 100;
+            eatt_server::l2cap_input( &values[ 0 ], values.size(), response, response_size, connection, input_bearer );
+        }
+
+        bluetoe::details::att_bearer& bearer = connection.bearer( 1 );
+    };
+}
+
+BOOST_AUTO_TEST_CASE( connection_data_contains_the_enhanced_bearers )
+{
+    BOOST_CHECK_EQUAL( eatt_server::number_of_enhanced_att_bearers, 2u );
+    BOOST_CHECK_EQUAL( eatt_server::connection_data::number_of_bearers, 3u );
+    BOOST_CHECK_EQUAL( test::small_temperature_service::connection_data::number_of_bearers, 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( unenhanced_bearer_is_the_connection_itself, enhanced )
+{
+    BOOST_CHECK_EQUAL( &connection.bearer( 0 ), static_cast< bluetoe::details::att_bearer* >( &connection ) );
+    BOOST_CHECK_NE( &connection.bearer( 1 ), &connection.bearer( 2 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( response_is_clipped_to_the_mtu_of_the_bearer, enhanced )
+{
+    bearer_input( { 0x0A, 0x03, 0x00 } );
+    BOOST_CHECK_EQUAL( response_size, 64u );
+
+    connection.client_mtu( 23 );
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+    BOOST_CHECK_EQUAL( response_size, 23u );
+}
+
+BOOST_FIXTURE_TEST_CASE( mtu_exchange_is_not_supported_on_an_enhanced_bearer, enhanced )
+{
+    bearer_input( { 0x02, 0x00, 0x01 } );
+
+    expected_result( { 0x01, 0x02, 0x00, 0x00, 0x06 } );
+    BOOST_CHECK_EQUAL( bearer.client_mtu(), 64u );
+}
+
+BOOST_FIXTURE_TEST_CASE( parked_request_does_not_block_other_bearers, enhanced )
+{
+    bearer_input( { 0x0A, 0x05, 0x00 } );
+    BOOST_CHECK_EQUAL( response_size, 0u );
+    BOOST_CHECK( bearer.att_request_pending() );
+
+    // the unenhanced bearer is still serving requests
+    BOOST_CHECK( !connection.att_request_pending() );
+    l2cap_input( { 0x0A, 0x07, 0x00 } );
+    expected_result( { 0x0B, 0x42 } );
+
+    sample_available = true;
+    complete_pending_read();
+
+    std::uint8_t buffer[ 64 ];
+    std::size_t  size = sizeof( buffer );
+
+    // the completion belongs to the parked request of the enhanced bearer
+    pending_response_output( buffer, size, connection );
+    BOOST_CHECK_EQUAL( size, 0u );
+
+    size = sizeof( buffer );
+    pending_response_output( buffer, size, connection, bearer );
+
+    const std::vector< std::uint8_t > expected = { 0x0B, 0x01, 0x02 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( &buffer[ 0 ], &buffer[ size ], expected.begin(), expected.end() );
+    BOOST_CHECK( !bearer.att_request_pending() );
+}
+
+BOOST_FIXTURE_TEST_CASE( request_on_an_other_bearer_keeps_the_completion, enhanced )
+{
+    bearer_input( { 0x0A, 0x05, 0x00 } );
+
+    sample_available = true;
+    complete_pending_read();
+
+    // a request on the unenhanced bearer, before the link layer picked up the completion
+    l2cap_input( { 0x0A, 0x07, 0x00 } );
+
+    std::uint8_t buffer[ 64 ];
+    std::size_t  size = sizeof( buffer );
+    pending_response_output( buffer, size, connection, bearer );
+
+    BOOST_CHECK_EQUAL( size, 3u );
+}
+
+BOOST_FIXTURE_TEST_CASE( completions_are_applied_to_every_parked_bearer, enhanced )
+{
+    bluetoe::details::att_bearer& other = connection.bearer( 2 );
+    other = bluetoe::details::att_bearer( 64 );
+
+    bearer_input( { 0x0A, 0x05, 0x00 } );
+    bearer_input( { 0x0C, 0x05, 0x00, 0x01, 0x00 }, other );
+
+    BOOST_CHECK( bearer.att_request_pending() );
+    BOOST_CHECK( other.att_request_pending() );
+
+    sample_available = true;
+    complete_pending_read();
+    complete_pending_read();
+
+    std::uint8_t buffer[ 64 ];
+    std::size_t  size = sizeof( buffer );
+    pending_response_output( buffer, size, connection, other );
+
+    const std::vector< std::uint8_t > expected_blob = { 0x0D, 0x02 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( &buffer[ 0 ], &buffer[ size ], expected_blob.begin(), expected_blob.end() );
+
+    size = sizeof( buffer );
+    pending_response_output( buffer, size, connection, bearer );
+
+    const std::vector< std::uint8_t > expected_read = { 0x0B, 0x01, 0x02 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( &buffer[ 0 ], &buffer[ size ], expected_read.begin(), expected_read.end() );
+
+    BOOST_CHECK( !bearer.att_request_pending() );
+    BOOST_CHECK( !other.att_request_pending() );
+}
+
+BOOST_FIXTURE_TEST_CASE( completions_are_applied_in_the_order_of_parking, enhanced )
+{
+    bluetoe::details::att_bearer& other = connection.bearer( 2 );
+    other = bluetoe::details::att_bearer( 64 );
+
+    bearer_input( { 0x0A, 0x05, 0x00 }, other );
+    bearer_input( { 0x0A, 0x05, 0x00 } );
+
+    // the first completion belongs to the request, that was parked first
+    complete_pending_read( bluetoe::error_codes::insufficient_resources );
+
+    std::uint8_t buffer[ 64 ];
+    std::size_t  size = sizeof( buffer );
+    pending_response_output( buffer, size, connection, bearer );
+    BOOST_CHECK_EQUAL( size, 0u );
+    BOOST_CHECK( bearer.att_request_pending() );
+
+    size = sizeof( buffer );
+    pending_response_output( buffer, size, connection, other );
+
+    const std::vector< std::uint8_t > expected_error = { 0x01, 0x0A, 0x05, 0x00, 0x11 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( &buffer[ 0 ], &buffer[ size ], expected_error.begin(), expected_error.end() );
+
+    sample_available = true;
+    complete_pending_read();
+
+    size = sizeof( buffer );
+    pending_response_output( buffer, size, connection, bearer );
+
+    const std::vector< std::uint8_t > expected_read = { 0x0B, 0x01, 0x02 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( &buffer[ 0 ], &buffer[ size ], expected_read.begin(), expected_read.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( confirmation_on_an_enhanced_bearer, enhanced )
+{
+    bearer.indication_sent();
+    BOOST_CHECK( bearer.confirmation_pending() );
+
+    bearer_input( { 0x1E } );
+
+    BOOST_CHECK_EQUAL( response_size, 0u );
+    BOOST_CHECK( !bearer.confirmation_pending() );
+
+    // the confirmation was not reported for the unenhanced bearer
+    BOOST_CHECK( notification_type != eatt_server::confirmation );
+}
+
+BOOST_FIXTURE_TEST_CASE( confirmation_on_the_unenhanced_bearer, enhanced )
+{
+    l2cap_input( { 0x1E } );
+
+    BOOST_CHECK_EQUAL( notification_type, eatt_server::confirmation );
+}
@@ -54,6 +54,15 @@ std::uint8_t read_value( std::size_t notification_index )
     return out_buffer[ value_notification_pdu_min_size - 1 ];
 }
 
+template < class Server >
+struct find_by_value : Server
+{
+    static bluetoe::details::notification_data find( const void* value )
+    {
+        return find_by_value().find_notification_data( value );
+    }
+};
+
 template < class UUID, const std::uint8_t* Value >
 using characteristic =
     bluetoe::characteristic<
@@ -191,6 +200,42 @@ BOOST_AUTO_TEST_CASE( two_services_with_similar_characteristic_priorities_but_di
     BOOST_CHECK_EQUAL( read_value< server >( 5 ), 0xAa );
 }
 
+BOOST_AUTO_TEST_CASE( find_by_value_yields_the_notification_index )
+{
+    using server = bluetoe::server<
+        bluetoe::service<
+            A,
+            characteristic< A_a, &value_Aa >,
+            characteristic< A_b, &value_Ab >,
+            characteristic< A_c, &value_Ac >,
+            bluetoe::higher_outgoing_priority< A_c, A_b >
+        >,
+        bluetoe::service<
+            B,
+            characteristic< B_a, &value_Ba >,
+            characteristic_without_cccd< B_b, &value_Bb >,
+            characteristic< B_c, &value_Bc >,
+            bluetoe::higher_outgoing_priority< B_c >
+        >,
+        bluetoe::higher_outgoing_priority< B >
+    >;
+
+    BOOST_CHECK_EQUAL( find_by_value< server >::find( &value_Bc ).client_characteristic_configuration_index(), 0u );
+    BOOST_CHECK_EQUAL( find_by_value< server >::find( &value_Ba ).client_characteristic_configuration_index(), 1u );
+    BOOST_CHECK_EQUAL( find_by_value< server >::find( &value_Ac ).client_characteristic_configuration_index(), 2u );
+    BOOST_CHECK_EQUAL( find_by_value< server >::find( &value_Ab ).client_characteristic_configuration_index(), 3u );
+    BOOST_CHECK_EQUAL( find_by_value< server >::find( &value_Aa ).client_characteristic_configuration_index(), 4u );
+
+    // the value handle is the same, that is used to notify by index
+    for ( const std::uint8_t* value : { &value_Aa, &value_Ab, &value_Ac, &value_Ba, &value_Bc } )
+    {
+        const auto data = find_by_value< server >::find( value );
+        BOOST_CHECK_EQUAL( read_value< server >( data.client_characteristic_configuration_index() ), *value );
+    }
+
+    BOOST_CHECK( !find_by_value< server >::find( &value_Bb ).valid() );
+}
+
 template < int I >
 using int_c = std::integral_constant< std::size_t, I >;
 
@@ -71,6 +71,22 @@ BOOST_AUTO_TEST_SUITE( notifications_by_value )
         } );
     }
 
+    BOOST_FIXTURE_TEST_CASE( value_that_fills_the_remaining_space_is_not_truncated, test::request_with_reponse< large_value_notify_server > )
+    {
+        l2cap_input( { 0x12, 0x04, 0x00, 0x01, 0x00 } );
+        expected_result( { 0x13 } );
+
+        std::uint8_t buffer[ 4 + sizeof( large_buffer ) ];
+        std::size_t  size = sizeof( buffer );
+
+        BOOST_CHECK( multiple_notification_tuple_output( buffer, size, connection, 0 ) == bluetoe::details::notification_tuple_result::added );
+        BOOST_CHECK_EQUAL( size, sizeof( buffer ) );
+        BOOST_CHECK_EQUAL( buffer[ 2 ], sizeof( large_buffer ) );
+
+        size = sizeof( buffer ) - 1;
+        BOOST_CHECK( multiple_notification_tuple_output( buffer, size, connection, 0 ) == bluetoe::details::notification_tuple_result::no_space );
+    }
+
     std::uint8_t value_a1 = 1;
     std::uint8_t value_a2 = 2;
     std::uint8_t value_b1 = 3;
@@ -146,6 +162,128 @@ BOOST_AUTO_TEST_SUITE( notifications_by_value )
     }
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE( notification_fifo )
+
+    std::uint32_t sample = 0;
+
+    typedef bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8B >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8B >,
+                bluetoe::bind_characteristic_value< std::uint32_t, &sample >,
+                bluetoe::notify,
+                bluetoe::notification_fifo< 6 >
+            >
+        >
+    > fifo_server;
+
+    struct subscribed : test::request_with_reponse< fifo_server >
+    {
+        subscribed()
+        {
+            // the FIFO is statically allocated and thus shared by all tests
+            notification_fifos::clear( 0 );
+
+            l2cap_input( { 0x12, 0x04, 0x00, 0x01, 0x00 } );
+            expected_result( { 0x13 } );
+        }
+
+        bool notify_sample( std::uint32_t value )
+        {
+            sample = value;
+            return notify( sample );
+        }
+    };
+
+    BOOST_AUTO_TEST_CASE( no_fifo_without_option )
+    {
+        BOOST_CHECK( !test::small_temperature_service::notification_fifos::has_fifo( 0 ) );
+        BOOST_CHECK( fifo_server::notification_fifos::has_fifo( 0 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( samples_are_notified_in_order, subscribed )
+    {
+        BOOST_CHECK( notify_sample( 0x04030201 ) );
+        BOOST_CHECK( notify_sample( 0x08070605 ) );
+        BOOST_CHECK( notify_sample( 0x0c0b0a09 ) );
+
+        // the bound value changed in the meantime
+        sample = 0;
+
+        expected_output( sample, {
+            0x1B, 0x03, 0x00,
+            0x01, 0x02, 0x03, 0x04,
+            0x05, 0x06, 0x07, 0x08,
+            0x09, 0x0a, 0x0b, 0x0c
+        } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( samples_are_packed_up_to_the_mtu, subscribed )
+    {
+        for ( std::uint32_t value = 1; value != 7; ++value )
+            BOOST_CHECK( notify_sample( value ) );
+
+        // 20 octets for 5 samples
+        expected_output( sample, {
+            0x1B, 0x03, 0x00,
+            0x01, 0x00, 0x00, 0x00,
+            0x02, 0x00, 0x00, 0x00,
+            0x03, 0x00, 0x00, 0x00,
+            0x04, 0x00, 0x00, 0x00,
+            0x05, 0x00, 0x00, 0x00
+        } );
+
+        // the characteristic is queued again for the remaining sample
+        BOOST_CHECK( notification.valid() );
+        notification.clear();
+
+        expected_output( sample, {
+            0x1B, 0x03, 0x00,
+            0x06, 0x00, 0x00, 0x00
+        } );
+
+        // no more samples
+        BOOST_CHECK( !notification.valid() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( no_notification_without_samples, subscribed )
+    {
+        BOOST_CHECK( notify_sample( 1 ) );
+        expected_output( sample, {
+            0x1B, 0x03, 0x00,
+            0x01, 0x00, 0x00, 0x00
+        } );
+
+        // queued again, after the FIFO was drained
+        expected_output( sample, {} );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( full_fifo_rejects_samples, subscribed )
+    {
+        for ( std::uint32_t value = 1; value != 7; ++value )
+            BOOST_CHECK( notify_sample( value ) );
+
+        BOOST_CHECK( !notify_sample( 7 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( samples_are_dropped_without_subscription, test::request_with_reponse< fifo_server > )
+    {
+        notification_fifos::clear( 0 );
+
+        sample = 1;
+        BOOST_CHECK( notify( sample ) );
+        expected_output( sample, {} );
+
+        l2cap_input( { 0x12, 0x04, 0x00, 0x01, 0x00 } );
+        expected_result( { 0x13 } );
+
+        // the dropped sample is not notified
+        expected_output( sample, {} );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE( notifications_by_uuid )
 
     static const std::uint16_t value1 = 0x1111;
@@ -641,6 +779,8 @@ BOOST_AUTO_TEST_SUITE( priorites_charactieristics )
                 notification_queue.indication_confirmed();
                 return true;
                 break;
+            case dts_server_t< dts_service >::pending_response:
+                break;
         }
 
         return true;
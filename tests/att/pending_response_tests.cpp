@@ -0,0 +1,206 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_servers.hpp"
+
+namespace {
+    bool          sample_available = false;
+    unsigned      conversions      = 0;
+    std::uint8_t  written_value    = 0;
+    std::uint8_t  write_result     = bluetoe::error_codes::pending;
+
+    const std::uint8_t sample[] = { 0x01, 0x02, 0x03, 0x04 };
+
+    std::uint8_t read_sensor( std::size_t offset, std::size_t read_size, std::uint8_t* out_buffer, std::size_t& out_size )
+    {
+        if ( !sample_available )
+        {
+            ++conversions;
+            return bluetoe::error_codes::pending;
+        }
+
+        if ( offset > sizeof( sample ) )
+            return bluetoe::error_codes::invalid_offset;
+
+        out_size = std::min( read_size, sizeof( sample ) - offset );
+        std::copy( &sample[ offset ], &sample[ offset + out_size ], out_buffer );
+
+        return bluetoe::error_codes::success;
+    }
+
+    std::uint8_t write_actuator( std::size_t write_size, const std::uint8_t* value )
+    {
+        if ( write_size != 1 )
+            return bluetoe::error_codes::invalid_attribute_value_length;
+
+        written_value = *value;
+
+        return write_result;
+    }
+
+    using sensor_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::free_read_blob_handler< &read_sensor >,
+                bluetoe::free_raw_write_handler< &write_actuator >
+            >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers
+    >;
+
+    struct sensor : test::request_with_reponse< sensor_server >
+    {
+        sensor()
+        {
+            sample_available = false;
+            conversions      = 0;
+            written_value    = 0;
+            write_result     = bluetoe::error_codes::pending;
+        }
+
+        std::vector< std::uint8_t > pending_response()
+        {
+            std::uint8_t buffer[ 23 ];
+            std::size_t  size = sizeof( buffer );
+
+            pending_response_output( &buffer[ 0 ], size, connection );
+
+            return std::vector< std::uint8_t >( &buffer[ 0 ], &buffer[ size ] );
+        }
+
+        void expected_pending_response( const std::initializer_list< std::uint8_t >& expected )
+        {
+            const std::vector< std::uint8_t > response = pending_response();
+            BOOST_CHECK_EQUAL_COLLECTIONS( response.begin(), response.end(), expected.begin(), expected.end() );
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( pending_read_request_is_parked, sensor )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+
+    BOOST_CHECK_EQUAL( response_size, 0u );
+    BOOST_CHECK_EQUAL( conversions, 1u );
+    BOOST_CHECK( connection.att_request_pending() );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_response_before_completion, sensor )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+
+    expected_pending_response( {} );
+    BOOST_CHECK( connection.att_request_pending() );
+}
+
+BOOST_FIXTURE_TEST_CASE( completed_read_is_answered, sensor )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+
+    sample_available = true;
+    complete_pending_read();
+
+    BOOST_CHECK_EQUAL( notification_type, sensor_server::pending_response );
+    expected_pending_response( { 0x0B, 0x01, 0x02, 0x03, 0x04 } );
+    BOOST_CHECK( !connection.att_request_pending() );
+
+    // only one response per request
+    expected_pending_response( {} );
+}
+
+BOOST_FIXTURE_TEST_CASE( completed_read_blob_uses_the_requested_offset, sensor )
+{
+    l2cap_input( { 0x0C, 0x03, 0x00, 0x02, 0x00 } );
+    BOOST_CHECK_EQUAL( response_size, 0u );
+
+    sample_available = true;
+    complete_pending_read();
+
+    expected_pending_response( { 0x0D, 0x03, 0x04 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( read_completed_with_an_error, sensor )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+
+    complete_pending_read( bluetoe::error_codes::application_error_start );
+
+    expected_pending_response( { 0x01, 0x0A, 0x03, 0x00, 0x80 } );
+    BOOST_CHECK( !connection.att_request_pending() );
+}
+
+BOOST_FIXTURE_TEST_CASE( read_stays_parked_if_the_handler_is_still_pending, sensor )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+
+    complete_pending_read();
+
+    expected_pending_response( {} );
+    BOOST_CHECK_EQUAL( conversions, 2u );
+    BOOST_CHECK( connection.att_request_pending() );
+
+    sample_available = true;
+    complete_pending_read();
+
+    expected_pending_response( { 0x0B, 0x01, 0x02, 0x03, 0x04 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( completed_write_is_answered, sensor )
+{
+    l2cap_input( { 0x12, 0x03, 0x00, 0x2A } );
+
+    BOOST_CHECK_EQUAL( response_size, 0u );
+    BOOST_CHECK_EQUAL( written_value, 0x2A );
+    BOOST_CHECK( connection.att_request_pending() );
+
+    complete_pending_write();
+
+    expected_pending_response( { 0x13 } );
+    BOOST_CHECK( !connection.att_request_pending() );
+}
+
+BOOST_FIXTURE_TEST_CASE( write_completed_with_an_error, sensor )
+{
+    l2cap_input( { 0x12, 0x03, 0x00, 0x2A } );
+
+    complete_pending_write( bluetoe::error_codes::write_not_permitted );
+
+    expected_pending_response( { 0x01, 0x12, 0x03, 0x00, 0x03 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( pending_write_command_is_not_parked, sensor )
+{
+    l2cap_input( { 0x52, 0x03, 0x00, 0x2A } );
+
+    BOOST_CHECK_EQUAL( response_size, 0u );
+    BOOST_CHECK_EQUAL( written_value, 0x2A );
+    BOOST_CHECK( !connection.att_request_pending() );
+}
+
+BOOST_FIXTURE_TEST_CASE( completion_of_the_wrong_request_type_is_ignored, sensor )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+
+    sample_available = true;
+    complete_pending_write();
+
+    expected_pending_response( {} );
+    BOOST_CHECK( connection.att_request_pending() );
+}
+
+BOOST_FIXTURE_TEST_CASE( completion_before_the_request_is_ignored, sensor )
+{
+    complete_pending_write();
+
+    l2cap_input( { 0x12, 0x03, 0x00, 0x2A } );
+
+    expected_pending_response( {} );
+    BOOST_CHECK( connection.att_request_pending() );
+}
+
+BOOST_FIXTURE_TEST_CASE( read_by_type_skips_pending_values, sensor )
+{
+    BOOST_CHECK( check_error_response( { 0x08, 0x01, 0x00, 0xff, 0xff, 0x01, 0x00 }, 0x08, 0x0001, 0x0A ) );
+}
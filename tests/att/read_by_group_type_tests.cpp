@@ -186,4 +186,42 @@ BOOST_FIXTURE_TEST_CASE( output_to_small_to_read_all_services, test::request_wit
     BOOST_CHECK_EQUAL_COLLECTIONS( &response[ 0 ], &response[ response_size ], std::begin( expected_result ), std::end( expected_result ) );
 }
 
+BOOST_FIXTURE_TEST_CASE( starting_handle_within_a_service, test::request_with_reponse< server_with_4_bicycles > )
+{
+    l2cap_input( { 0x10, 0x02, 0x00, 0xff, 0xff, 0x00, 0x28 } );
+
+    static const std::uint8_t expected_result[] = {
+        0x11, 0x06,                 // response code, size
+        0x06, 0x00, 0x0A, 0x00,
+        0x16, 0x18,
+        0x0B, 0x00, 0x0F, 0x00,
+        0x16, 0x18,
+        0x10, 0x00, 0x14, 0x00,
+        0x16, 0x18
+    };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( &response[ 0 ], &response[ response_size ], std::begin( expected_result ), std::end( expected_result ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( ending_handle_within_a_service, test::request_with_reponse< server_with_4_bicycles > )
+{
+    l2cap_input( { 0x10, 0x06, 0x00, 0x0C, 0x00, 0x00, 0x28 } );
+
+    static const std::uint8_t expected_result[] = {
+        0x11, 0x06,                 // response code, size
+        0x06, 0x00, 0x0A, 0x00,
+        0x16, 0x18,
+        0x0B, 0x00, 0x0F, 0x00,
+        0x16, 0x18
+    };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( &response[ 0 ], &response[ response_size ], std::begin( expected_result ), std::end( expected_result ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( starting_handle_behind_the_last_service_start, test::request_with_reponse< server_with_4_bicycles > )
+{
+    BOOST_CHECK( check_error_response(
+        { 0x10, 0x11, 0x00, 0x14, 0x00, 0x00, 0x28 }, 0x10, 0x0011, 0x0a ) );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,156 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_servers.hpp"
+
+BOOST_AUTO_TEST_SUITE( read_multiple_variable_length_errors )
+
+BOOST_FIXTURE_TEST_CASE( pdu_to_small, test::small_temperature_service_with_response<> )
+{
+    BOOST_CHECK( check_error_response( { 0x20, 0x02, 0x00 }, 0x20, 0x0000, 0x04 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( pdu_half_an_handle, test::small_temperature_service_with_response<> )
+{
+    BOOST_CHECK( check_error_response( { 0x20, 0x02, 0x00, 0x03, 0x00, 0x04 }, 0x20, 0x0000, 0x04 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( the_first_handle_is_invalid, test::small_temperature_service_with_response<> )
+{
+    BOOST_CHECK( check_error_response( { 0x20, 0x00, 0x00, 0x03, 0x00 }, 0x20, 0x0000, 0x01 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( the_second_handle_is_unknown, test::small_temperature_service_with_response<> )
+{
+    BOOST_CHECK( check_error_response( { 0x20, 0x02, 0x00, 0xf4, 0xff }, 0x20, 0xfff4, 0x0A ) );
+}
+
+typedef bluetoe::server<
+    bluetoe::service<
+        bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+            bluetoe::bind_characteristic_value< decltype( test::temperature_value ), &test::temperature_value >,
+            bluetoe::no_read_access
+        >
+    >
+> unreadable_server;
+
+BOOST_FIXTURE_TEST_CASE( attribute_not_readable, test::request_with_reponse< unreadable_server > )
+{
+    BOOST_CHECK( check_error_response( { 0x20, 0x03, 0x00, 0x02, 0x00 }, 0x20, 0x0003, 0x02 ) );
+}
+
+static std::uint8_t insufficient_authentication_handler( std::size_t, std::uint8_t*, std::size_t& )
+{
+    return bluetoe::error_codes::insufficient_authentication;
+}
+
+typedef bluetoe::server<
+    bluetoe::service<
+        bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+            bluetoe::free_read_handler< &insufficient_authentication_handler >
+        >
+    >
+> authenticated_server;
+
+BOOST_FIXTURE_TEST_CASE( access_error_is_reported, test::request_with_reponse< authenticated_server > )
+{
+    BOOST_CHECK( check_error_response( { 0x20, 0x03, 0x00, 0x02, 0x00 }, 0x20, 0x0003, 0x05 ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( read_multiple_variable_length )
+
+BOOST_FIXTURE_TEST_CASE( read_two_attributes, test::small_temperature_service_with_response< > )
+{
+    l2cap_input( { 0x20, 0x03, 0x00, 0x01, 0x00 } );
+
+    expected_result( {
+        0x21,                                           // opcode
+        0x02, 0x00,                                     // length
+        0x04, 0x01,                                     // Characteristic Value
+        0x10, 0x00,                                     // length
+        0xA9, 0x3C, 0xC7, 0x5B, 0xED, 0x4E, 0x8A, 0xA2, // Primary Service
+        0x9F, 0x49, 0xE2, 0x0D, 0x94, 0x40, 0x8B, 0x8C
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( last_attribute_clipped, test::small_temperature_service_with_response< > )
+{
+    // the Primary Service does not fit into the response, but the handle is still checked
+    l2cap_input( { 0x20, 0x03, 0x00, 0x02, 0x00, 0x01, 0x00 } );
+
+    expected_result( {
+        0x21,                                           // opcode
+        0x02, 0x00,                                     // length
+        0x04, 0x01,                                     // Characteristic Value
+        0x10, 0x00,                                     // length of the included part
+        0x02, 0x03, 0x00,                               // Characteristic Declaration, clipped at the mtu of 23
+        0xAA, 0x3C, 0xC7, 0x5B, 0xED, 0x4E, 0x8A, 0xA2,
+        0x9F, 0x49, 0xE2, 0x0D, 0x94
+    } );
+}
+
+static std::uint8_t large_value[ 30 ] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+    0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13,
+    0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D
+};
+
+// a read handler, that reports the size of the whole value, instead of the number of octets copied
+static std::uint8_t whole_value_size_handler( std::size_t read_size, std::uint8_t* out_buffer, std::size_t& out_size )
+{
+    std::copy( &large_value[ 0 ], &large_value[ std::min( read_size, sizeof( large_value ) ) ], out_buffer );
+    out_size = sizeof( large_value );
+
+    return bluetoe::error_codes::success;
+}
+
+typedef bluetoe::server<
+    bluetoe::service<
+        bluetoe::service_uuid16< 0x1234 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid16< 0x1235 >,
+            bluetoe::bind_characteristic_value< decltype( large_value ), &large_value >
+        >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid16< 0x1236 >,
+            bluetoe::free_read_handler< &whole_value_size_handler >
+        >
+    >
+> large_value_server;
+
+BOOST_FIXTURE_TEST_CASE( length_of_a_clipped_value_is_the_copied_length, test::request_with_reponse< large_value_server > )
+{
+    l2cap_input( { 0x20, 0x03, 0x00, 0x03, 0x00 } );
+
+    expected_result( {
+        0x21,                                           // opcode
+        0x14, 0x00,                                     // length of the included part
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+        0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( length_is_limited_to_the_copied_length, test::request_with_reponse< large_value_server > )
+{
+    l2cap_input( { 0x20, 0x05, 0x00, 0x05, 0x00 } );
+
+    expected_result( {
+        0x21,                                           // opcode
+        0x14, 0x00,                                     // length of the included part
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+        0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( handles_behind_the_mtu_are_checked, test::small_temperature_service_with_response< > )
+{
+    BOOST_CHECK( check_error_response( { 0x20, 0x03, 0x00, 0x02, 0x00, 0xf4, 0xff }, 0x20, 0xfff4, 0x0A ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -84,3 +84,90 @@ BOOST_FIXTURE_TEST_CASE( read_first_part_of_blob, test::request_with_reponse< bl
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( read_by_reference )
+
+static const std::uint8_t const_blob[ 100 ] = { 0x01, 0x02, 0x03 };
+static std::uint8_t zero_copy_blob[ 10 ] = { 0 };
+
+typedef bluetoe::server<
+    bluetoe::service<
+        bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+            bluetoe::bind_characteristic_value< decltype( const_blob ), &const_blob >
+        >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAB >,
+            bluetoe::bind_characteristic_value< decltype( read_requests::blob ), &read_requests::blob >
+        >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAC >,
+            bluetoe::bind_characteristic_value< decltype( zero_copy_blob ), &zero_copy_blob >,
+            bluetoe::zero_copy_read
+        >
+    >
+> reference_server;
+
+struct reference_fixture : test::request_with_reponse< reference_server >
+{
+    void read_with_reference( const std::initializer_list< std::uint8_t >& input )
+    {
+        const std::vector< std::uint8_t > values( input );
+
+        response_size = mtu_size;
+        reference_server::l2cap_input( &values[ 0 ], values.size(), response, response_size, connection, &reference );
+    }
+
+    bluetoe::details::output_reference reference;
+};
+
+BOOST_FIXTURE_TEST_CASE( const_value_is_read_by_reference, reference_fixture )
+{
+    read_with_reference( { 0x0A, 0x03, 0x00 } );
+
+    BOOST_CHECK_EQUAL( response_size, 1u );
+    BOOST_CHECK_EQUAL( response[ 0 ], 0x0B );
+    BOOST_CHECK( reference.data == &const_blob[ 0 ] );
+    BOOST_CHECK_EQUAL( reference.size, mtu_size - 1 );
+}
+
+BOOST_FIXTURE_TEST_CASE( blob_is_read_by_reference, reference_fixture )
+{
+    read_with_reference( { 0x0C, 0x03, 0x00, 90, 0x00 } );
+
+    BOOST_CHECK_EQUAL( response_size, 1u );
+    BOOST_CHECK_EQUAL( response[ 0 ], 0x0D );
+    BOOST_CHECK( reference.data == &const_blob[ 90 ] );
+    BOOST_CHECK_EQUAL( reference.size, 10u );
+}
+
+BOOST_FIXTURE_TEST_CASE( mutable_value_is_copied_by_default, reference_fixture )
+{
+    read_with_reference( { 0x0A, 0x05, 0x00 } );
+
+    BOOST_CHECK_EQUAL( response_size, mtu_size );
+    BOOST_CHECK_EQUAL( response[ 0 ], 0x0B );
+    BOOST_CHECK( reference.empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( zero_copy_value_is_read_by_reference, reference_fixture )
+{
+    read_with_reference( { 0x0A, 0x07, 0x00 } );
+
+    BOOST_CHECK_EQUAL( response_size, 1u );
+    BOOST_CHECK( reference.data == &zero_copy_blob[ 0 ] );
+    BOOST_CHECK_EQUAL( reference.size, sizeof( zero_copy_blob ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( invalid_offset_is_reported, reference_fixture )
+{
+    read_with_reference( { 0x0C, 0x03, 0x00, 101, 0x00 } );
+
+    static const std::uint8_t expected_result[] = { 0x01, 0x0C, 0x03, 0x00, 0x07 };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( &response[ 0 ], &response[ response_size ], std::begin( expected_result ), std::end( expected_result ) );
+    BOOST_CHECK( reference.empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
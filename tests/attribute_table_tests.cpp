@@ -0,0 +1,138 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/server.hpp>
+#include <bluetoe/attribute_table.hpp>
+
+#include "test_servers.hpp"
+
+namespace {
+    std::uint16_t temperature = 0x0104;
+    std::uint8_t  humidity    = 42;
+    std::uint32_t pressure    = 0x12345678;
+
+    constexpr char server_name[]      = "Test Server";
+    constexpr char temperature_name[] = "Temperature";
+
+    template < typename ... Options >
+    using test_server = bluetoe::server<
+        bluetoe::server_name< server_name >,
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::characteristic_name< temperature_name >,
+                bluetoe::bind_characteristic_value< decltype( temperature ), &temperature >,
+                bluetoe::notify
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+                bluetoe::bind_characteristic_value< decltype( humidity ), &humidity >,
+                bluetoe::no_write_access
+            >
+        >,
+        bluetoe::service<
+            bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+            bluetoe::include_service< bluetoe::service_uuid16< 0x1234 > >,
+            bluetoe::characteristic<
+                bluetoe::bind_characteristic_value< decltype( pressure ), &pressure >,
+                bluetoe::indicate
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0002 >,
+                bluetoe::bind_characteristic_value< decltype( humidity ), &humidity >,
+                bluetoe::notify,
+                bluetoe::indicate
+            >
+        >,
+        Options...
+    >;
+
+    using recursive_server = test_server<>;
+    using flat_server      = test_server< bluetoe::flat_attribute_table >;
+
+    std::vector< std::uint8_t > read_attribute( const bluetoe::details::attribute& attr, std::uint16_t handle )
+    {
+        std::uint8_t buffer[ 100 ];
+        auto read = bluetoe::details::attribute_access_arguments::read( buffer, 0 );
+
+        if ( attr.access( read, handle ) != bluetoe::details::attribute_access_result::success )
+            return std::vector< std::uint8_t >();
+
+        return std::vector< std::uint8_t >( &buffer[ 0 ], &buffer[ read.buffer_size ] );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( flat_table_is_selected_by_option )
+{
+    BOOST_CHECK( ( std::is_same< recursive_server::attribute_table, bluetoe::details::recursive_attribute_table >::value ) );
+    BOOST_CHECK( ( std::is_same< flat_server::attribute_table, bluetoe::flat_attribute_table >::value ) );
+}
+
+BOOST_AUTO_TEST_CASE( flat_table_contains_all_attributes )
+{
+    using table = bluetoe::details::flat_attribute_table_impl<
+        bluetoe::details::attribute_generators_from_service_list< flat_server::services, flat_server, flat_server::cccd_indices >::type >;
+
+    // 2 service declarations, 1 include, 4 characteristic declarations and values, 1 name, 3 CCCDs + GAP service with 5 attributes
+    BOOST_CHECK_EQUAL( table::size, 2u + 1u + 8u + 1u + 3u + 5u );
+}
+
+BOOST_AUTO_TEST_CASE( flat_table_yields_the_same_attributes )
+{
+    using table = bluetoe::details::flat_attribute_table_impl<
+        bluetoe::details::attribute_generators_from_service_list< flat_server::services, flat_server, flat_server::cccd_indices >::type >;
+
+    for ( std::size_t index = 0; index != table::size; ++index )
+    {
+        const bluetoe::details::attribute recursive = recursive_server::attribute_at( index );
+        const bluetoe::details::attribute flat      = flat_server::attribute_at( index );
+        const std::uint16_t               handle    = static_cast< std::uint16_t >( index + 1 );
+
+        BOOST_CHECK_EQUAL( recursive.uuid, flat.uuid );
+
+        // the CCCDs can not be read without connection data
+        if ( flat.uuid != 0x2902 )
+        {
+            const auto recursive_value = read_attribute( recursive, handle );
+            const auto flat_value      = read_attribute( flat, handle );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS( recursive_value.begin(), recursive_value.end(), flat_value.begin(), flat_value.end() );
+        }
+    }
+}
+
+template < class Server >
+struct discovery : test::request_with_reponse< Server, 100 >
+{
+    std::vector< std::uint8_t > request( const std::initializer_list< std::uint8_t >& input )
+    {
+        this->l2cap_input( input );
+
+        return std::vector< std::uint8_t >( this->response, this->response + this->response_size );
+    }
+};
+
+BOOST_AUTO_TEST_CASE( att_responses_are_equal )
+{
+    discovery< recursive_server > recursive;
+    discovery< flat_server >      flat;
+
+    const std::initializer_list< std::uint8_t > requests[] = {
+        { 0x04, 0x01, 0x00, 0xff, 0xff },                   // Find Information
+        { 0x04, 0x09, 0x00, 0xff, 0xff },                   // Find Information, 128 bit UUIDs
+        { 0x08, 0x01, 0x00, 0xff, 0xff, 0x03, 0x28 },       // Read By Type, characteristic declarations
+        { 0x10, 0x01, 0x00, 0xff, 0xff, 0x00, 0x28 },       // Read By Group Type, primary services
+        { 0x06, 0x01, 0x00, 0xff, 0xff, 0x00, 0x28, 0x34, 0x12 }, // Find By Type Value
+        { 0x0A, 0x03, 0x00 },                               // Read
+        { 0x0A, 0x0B, 0x00 }                                // Read
+    };
+
+    for ( const auto& req : requests )
+    {
+        const auto expected = recursive.request( req );
+        const auto result   = flat.request( req );
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( expected.begin(), expected.end(), result.begin(), result.end() );
+    }
+}
@@ -0,0 +1,292 @@
+#include <bluetoe/server.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_servers.hpp"
+
+#include <vector>
+
+namespace {
+    using caching_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::fixed_uint8_value< 0x42 >
+            >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers,
+        bluetoe::gatt_caching
+    >;
+
+    std::uint8_t notified_value = 0;
+
+    using notifying_caching_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::bind_characteristic_value< decltype( notified_value ), &notified_value >,
+                bluetoe::notify
+            >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers,
+        bluetoe::gatt_caching
+    >;
+
+    using caching_server_with_gap = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::fixed_uint8_value< 0x42 >
+            >
+        >,
+        bluetoe::gatt_caching
+    >;
+
+    constexpr char value_name[] = "Value";
+
+    using mixed_caching_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::characteristic_name< value_name >,
+                bluetoe::fixed_uint8_value< 0x42 >
+            >
+        >,
+        bluetoe::service<
+            bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+            bluetoe::include_service< bluetoe::service_uuid16< 0x1234 > >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+                bluetoe::bind_characteristic_value< decltype( notified_value ), &notified_value >,
+                bluetoe::notify
+            >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers,
+        bluetoe::gatt_caching
+    >;
+
+    using all_features_caching_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::bind_characteristic_value< decltype( notified_value ), &notified_value >,
+                bluetoe::notify
+            >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers,
+        bluetoe::gatt_caching,
+        bluetoe::multiple_handle_value_notifications,
+        bluetoe::enhanced_att< 1 >
+    >;
+
+    template < class Server >
+    std::vector< std::uint8_t > database_hash()
+    {
+        test::request_with_reponse< Server > server;
+
+        // Read By Type Request, 1, 0xffff, <<Database Hash>>
+        server.l2cap_input( { 0x08, 0x01, 0x00, 0xff, 0xff, 0x2A, 0x2B } );
+
+        BOOST_REQUIRE_EQUAL( server.response_size, 2u + 2u + 16u );
+        BOOST_REQUIRE_EQUAL( server.response[ 0 ], 0x09 );
+
+        return std::vector< std::uint8_t >( &server.response[ 4 ], &server.response[ server.response_size ] );
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( gatt_service_is_added_behind_all_services, test::request_with_reponse< caching_server > )
+{
+    // Read By Group Type Request, 1, 0xffff, <<primary service>>
+    l2cap_input( { 0x10, 0x01, 0x00, 0xff, 0xff, 0x00, 0x28 } );
+    expected_result( {
+        0x11, 0x06,
+        0x01, 0x00, 0x03, 0x00, 0x34, 0x12,
+        0x04, 0x00, 0x08, 0x00, 0x01, 0x18
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( gatt_service_characteristics, test::request_with_reponse< caching_server > )
+{
+    // Read By Type Request, 4, 0xffff, <<characteristic>>
+    l2cap_input( { 0x08, 0x04, 0x00, 0xff, 0xff, 0x03, 0x28 } );
+    expected_result( {
+        0x09, 0x07,
+        0x05, 0x00, 0x0A, 0x06, 0x00, 0x29, 0x2B,   // Client Supported Features: read, write
+        0x07, 0x00, 0x02, 0x08, 0x00, 0x2A, 0x2B    // Database Hash: read
+    } );
+}
+
+/*
+ * The expected hashes are calculated with an independent AES-CMAC implementation (verified against the
+ * RFC 4493 test vectors) over the handle, type and value tuples, as defined in Core Vol 3, Part G, 7.3.1.
+ */
+BOOST_AUTO_TEST_CASE( database_hash_is_the_aes_cmac_over_the_attribute_table )
+{
+    // 0x0001, 0x2800, 0x1234
+    // 0x0002, 0x2803, 0x02, 0x0003, 0x0001
+    // 0x0004, 0x2800, 0x1801
+    // 0x0005, 0x2803, 0x0A, 0x0006, 0x2B29
+    // 0x0007, 0x2803, 0x02, 0x0008, 0x2B2A
+    const std::vector< std::uint8_t > expected = {
+        0xFC, 0x30, 0x25, 0x1D, 0x1E, 0x53, 0x2A, 0x30, 0x9F, 0x80, 0x0A, 0x80, 0x40, 0x2C, 0x15, 0x70
+    };
+    const std::vector< std::uint8_t > hash = database_hash< caching_server >();
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( hash.begin(), hash.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( client_characteristic_configurations_are_part_of_the_hash )
+{
+    // 0x0001, 0x2800, 0x1234
+    // 0x0002, 0x2803, 0x1A, 0x0003, 0x0001
+    // 0x0004, 0x2902
+    // 0x0005, 0x2800, 0x1801
+    // 0x0006, 0x2803, 0x0A, 0x0007, 0x2B29
+    // 0x0008, 0x2803, 0x02, 0x0009, 0x2B2A
+    const std::vector< std::uint8_t > expected = {
+        0x84, 0x8E, 0x33, 0x5B, 0x3E, 0x2C, 0x57, 0xC7, 0x8C, 0x2A, 0x33, 0x4B, 0xEC, 0x29, 0xA9, 0x2C
+    };
+    const std::vector< std::uint8_t > hash = database_hash< notifying_caching_server >();
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( hash.begin(), hash.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( includes_descriptors_and_128bit_uuids_are_part_of_the_hash )
+{
+    // 0x0001, 0x2800, 0x1234
+    // 0x0002, 0x2803, 0x02, 0x0003, 0x0001
+    // 0x0004, 0x2901
+    // 0x0005, 0x2800, 8C8B4094-0DE2-499F-A28A-4EED5BC73CA9
+    // 0x0006, 0x2802, 0x0001, 0x0004, 0x1234
+    // 0x0007, 0x2803, 0x1A, 0x0008, 8C8B4094-0DE2-499F-A28A-4EED5BC73CAA
+    // 0x0009, 0x2902
+    // 0x000A, 0x2800, 0x1801
+    // 0x000B, 0x2803, 0x0A, 0x000C, 0x2B29
+    // 0x000D, 0x2803, 0x02, 0x000E, 0x2B2A
+    const std::vector< std::uint8_t > expected = {
+        0x4B, 0x83, 0xEB, 0xEF, 0x6B, 0x72, 0x3E, 0xF9, 0x56, 0xAE, 0x51, 0xFE, 0x30, 0x54, 0x03, 0x28
+    };
+    const std::vector< std::uint8_t > hash = database_hash< mixed_caching_server >();
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( hash.begin(), hash.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( different_databases_have_different_hashes )
+{
+    BOOST_CHECK( database_hash< caching_server >() != database_hash< caching_server_with_gap >() );
+    BOOST_CHECK( database_hash< caching_server >() != database_hash< notifying_caching_server >() );
+}
+
+BOOST_FIXTURE_TEST_CASE( database_hash_is_not_writable, test::request_with_reponse< caching_server > )
+{
+    BOOST_CHECK( check_error_response( {
+        0x12, 0x08, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        0x12, 0x0008, 0x03 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_client_supported_features_by_default, test::request_with_reponse< caching_server > )
+{
+    l2cap_input( { 0x0A, 0x06, 0x00 } );
+    expected_result( { 0x0B, 0x00 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( client_supported_features_are_stored, test::request_with_reponse< caching_server > )
+{
+    l2cap_input( { 0x12, 0x06, 0x00, 0x01 } );
+    expected_result( { 0x13 } );
+
+    l2cap_input( { 0x0A, 0x06, 0x00 } );
+    expected_result( { 0x0B, 0x01 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( unsupported_client_features_are_ignored, test::request_with_reponse< caching_server > )
+{
+    // neither enhanced ATT, nor multiple handle value notifications are supported by the server
+    l2cap_input( { 0x12, 0x06, 0x00, 0xff } );
+    expected_result( { 0x13 } );
+
+    l2cap_input( { 0x0A, 0x06, 0x00 } );
+    expected_result( { 0x0B, 0x01 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( supported_client_features_depend_on_the_server, test::request_with_reponse< all_features_caching_server > )
+{
+    l2cap_input( { 0x12, 0x07, 0x00, 0xff } );
+    expected_result( { 0x13 } );
+
+    l2cap_input( { 0x0A, 0x07, 0x00 } );
+    expected_result( { 0x0B, 0x07 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( server_supported_features_announce_enhanced_att, test::request_with_reponse< all_features_caching_server > )
+{
+    // Read By Type Request, 1, 0xffff, <<Server Supported Features>>
+    l2cap_input( { 0x08, 0x01, 0x00, 0xff, 0xff, 0x3A, 0x2B } );
+    expected_result( {
+        0x09, 0x03,
+        0x0B, 0x00, 0x01
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_server_supported_features_without_enhanced_att, test::request_with_reponse< caching_server > )
+{
+    BOOST_CHECK( check_error_response( { 0x08, 0x01, 0x00, 0xff, 0xff, 0x3A, 0x2B }, 0x08, 0x0001, 0x0A ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( client_supported_features_can_not_be_cleared, test::request_with_reponse< caching_server > )
+{
+    l2cap_input( { 0x12, 0x06, 0x00, 0x01 } );
+    expected_result( { 0x13 } );
+
+    BOOST_CHECK( check_error_response( { 0x12, 0x06, 0x00, 0x04 }, 0x12, 0x0006, 0x13 ) );
+
+    l2cap_input( { 0x0A, 0x06, 0x00 } );
+    expected_result( { 0x0B, 0x01 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( client_supported_features_are_one_octet, test::request_with_reponse< caching_server > )
+{
+    BOOST_CHECK( check_error_response( { 0x12, 0x06, 0x00, 0x01, 0x00 }, 0x12, 0x0006, 0x0d ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( client_supported_features_are_stored_per_connection, test::request_with_reponse< notifying_caching_server > )
+{
+    notifying_caching_server::connection_data other_connection( 23 );
+
+    // enable notifications and all supported client features
+    l2cap_input( { 0x12, 0x04, 0x00, 0x01, 0x00 } );
+    expected_result( { 0x13 } );
+    l2cap_input( { 0x12, 0x07, 0x00, 0x07 } );
+    expected_result( { 0x13 } );
+
+    l2cap_input( { 0x0A, 0x04, 0x00 } );
+    expected_result( { 0x0B, 0x01, 0x00 } );
+    l2cap_input( { 0x0A, 0x07, 0x00 } );
+    expected_result( { 0x0B, 0x01 } );
+
+    l2cap_input( { 0x0A, 0x07, 0x00 }, other_connection );
+    expected_result( { 0x0B, 0x00 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( client_supported_features_are_copied_when_read_by_reference, test::request_with_reponse< caching_server > )
+{
+    l2cap_input( { 0x12, 0x06, 0x00, 0x01 } );
+    expected_result( { 0x13 } );
+
+    // the link layer always passes an output_reference
+    const std::uint8_t request[] = { 0x0A, 0x06, 0x00 };
+    bluetoe::details::output_reference reference;
+
+    response_size = mtu_size;
+    caching_server::l2cap_input( request, sizeof( request ), response, response_size, connection, &reference );
+
+    BOOST_CHECK( reference.empty() );
+    expected_result( { 0x0B, 0x01 } );
+}
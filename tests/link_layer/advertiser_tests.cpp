@@ -49,10 +49,22 @@ struct link_layer_base
         return buffer_;
     }
 
+    std::size_t fill_l2cap_advertising_data( std::uint8_t*, std::size_t )
+    {
+        return 0;
+    }
+
+    bool advertising_data_changed() const
+    {
+        return false;
+    }
+
     std::uint8_t buffer_[ 1024 ];
     bool advertisment_scheduled;
 
     using radio_t = test::radio< 100, 100, link_layer_base< Connect, Respond > >;
+
+    static constexpr bool channel_selection_algorithm_2_supported = false;
 };
 
 struct single_advertiser_without_white_list :
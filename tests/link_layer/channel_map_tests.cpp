@@ -199,3 +199,51 @@ BOOST_FIXTURE_TEST_CASE( real_life_example, all_channels_but_25 )
     BOOST_CHECK_EQUAL( data_channel( 30 ), 1u );
     BOOST_CHECK_EQUAL( data_channel( 35 ), 31u );
 }
+
+/*
+ * Channel Selection Algorithm #2, sample data from Vol 6, Part C, 3 of the core spec
+ */
+static constexpr std::uint32_t sample_access_address = 0x8E89BED6;
+
+static constexpr std::uint8_t nine_channels_map[] = { 0x00, 0x06, 0xE0, 0x00, 0x1E };
+
+BOOST_FIXTURE_TEST_CASE( algorithm_2_all_channels, bluetoe::link_layer::channel_map )
+{
+    BOOST_REQUIRE( reset_algorithm_2( all_channel_map, sample_access_address ) );
+    BOOST_CHECK( algorithm_2() );
+
+    BOOST_CHECK_EQUAL( data_channel( 0, 0 ), 25u );
+    BOOST_CHECK_EQUAL( data_channel( 1, 1 ), 20u );
+    BOOST_CHECK_EQUAL( data_channel( 2, 2 ), 6u );
+    BOOST_CHECK_EQUAL( data_channel( 3, 3 ), 21u );
+}
+
+BOOST_FIXTURE_TEST_CASE( algorithm_2_remapped_channels, bluetoe::link_layer::channel_map )
+{
+    BOOST_REQUIRE( reset_algorithm_2( nine_channels_map, sample_access_address ) );
+
+    BOOST_CHECK_EQUAL( data_channel( 6, 6 ), 23u );
+    BOOST_CHECK_EQUAL( data_channel( 7, 7 ), 9u );  // unmapped channel 14
+    BOOST_CHECK_EQUAL( data_channel( 8, 8 ), 34u ); // unmapped channel 17
+}
+
+BOOST_FIXTURE_TEST_CASE( algorithm_2_keeps_the_channel_identifier, bluetoe::link_layer::channel_map )
+{
+    BOOST_REQUIRE( reset_algorithm_2( all_channel_map, sample_access_address ) );
+    BOOST_REQUIRE( reset( nine_channels_map ) );
+    BOOST_CHECK( algorithm_2() );
+
+    BOOST_CHECK_EQUAL( data_channel( 7, 7 ), 9u );
+}
+
+BOOST_FIXTURE_TEST_CASE( algorithm_2_channel_map_shall_contain_at_least_two_bits, bluetoe::link_layer::channel_map )
+{
+    BOOST_CHECK( !reset_algorithm_2( only_one_channel_map, sample_access_address ) );
+    BOOST_CHECK( !reset_algorithm_2( only_one_channel_and_some_rfu_bits_map, sample_access_address ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( algorithm_1_ignores_the_event_counter, all_channel_5 )
+{
+    BOOST_CHECK( !algorithm_2() );
+    BOOST_CHECK_EQUAL( data_channel( 1, 4711 ), 10u );
+}
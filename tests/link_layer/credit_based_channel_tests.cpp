@@ -0,0 +1,894 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+#include <bluetoe/l2cap_signaling_channel.hpp>
+
+#include "connected.hpp"
+
+#include <new>
+#include <vector>
+
+namespace {
+    using log_channel_t    = bluetoe::l2cap::credit_based_channel< 0x0080, 100 >;
+    using control_channel_t = bluetoe::l2cap::credit_based_channel< 0x0081, 23 >;
+
+    log_channel_t       log_channel;
+    control_channel_t   control_channel;
+
+    using signaling = bluetoe::l2cap::signaling_channel<
+        bluetoe::l2cap::bind_channel< log_channel_t, log_channel >,
+        bluetoe::l2cap::bind_channel< control_channel_t, control_channel >
+    >;
+
+    struct channel : signaling
+    {
+        channel()
+        {
+            // the channels are static objects, shared by all tests
+            new ( &log_channel ) log_channel_t();
+            new ( &control_channel ) control_channel_t();
+
+            reset_channels( 27 );
+        }
+
+        void signaling_channel_input( std::initializer_list< std::uint8_t > pdu, std::initializer_list< std::uint8_t > expected )
+        {
+            std::size_t out_size = sizeof( buffer );
+            signaling::signaling_channel_input( pdu.begin(), pdu.size(), buffer, out_size, false );
+
+            BOOST_REQUIRE_EQUAL_COLLECTIONS( expected.begin(), expected.end(), &buffer[ 0 ], &buffer[ out_size ] );
+        }
+
+        void signaling_channel_output( std::initializer_list< std::uint8_t > expected )
+        {
+            std::size_t out_size = sizeof( buffer );
+            signaling::signaling_channel_output( buffer, out_size );
+
+            BOOST_REQUIRE_EQUAL_COLLECTIONS( expected.begin(), expected.end(), &buffer[ 0 ], &buffer[ out_size ] );
+        }
+
+        bool channel_input( std::uint16_t channel_id, std::initializer_list< std::uint8_t > frame )
+        {
+            return signaling::channel_input( channel_id, frame.begin(), frame.size() );
+        }
+
+        // returns the K-frame with the referenced data appended
+        std::vector< std::uint8_t > channel_output( std::uint16_t expected_channel_id = 0x0041 )
+        {
+            std::size_t   out_size   = 27;
+            std::uint16_t channel_id = 0;
+            bluetoe::details::output_reference reference;
+
+            signaling::channel_output( buffer, out_size, channel_id, reference );
+
+            std::vector< std::uint8_t > result( &buffer[ 0 ], &buffer[ out_size ] );
+            result.insert( result.end(), reference.data, reference.data + reference.size );
+
+            if ( !result.empty() )
+                BOOST_CHECK_EQUAL( channel_id, expected_channel_id );
+
+            return result;
+        }
+
+        void connect_log_channel( std::uint8_t expected_credits = 0, std::uint8_t credits = 0 )
+        {
+            signaling_channel_input(
+                {
+                    0x14, 0x02, 0x0A, 0x00,
+                    0x80, 0x00,             // SPSM
+                    0x41, 0x00,             // source CID
+                    0x17, 0x00,             // MTU
+                    0x17, 0x00,             // MPS
+                    credits, 0x00           // initial credits
+                },
+                {
+                    0x15, 0x02, 0x0A, 0x00,
+                    0x40, 0x00,             // destination CID
+                    0x64, 0x00,             // MTU
+                    0x1B, 0x00,             // MPS
+                    expected_credits, 0x00, // initial credits
+                    0x00, 0x00              // result: successful
+                }
+            );
+        }
+
+        std::uint8_t buffer[ 27 ];
+        std::uint8_t sdu[ 100 ];
+    };
+
+    struct connected_channel : channel
+    {
+        connected_channel()
+        {
+            BOOST_REQUIRE( log_channel.receive( sdu, sizeof( sdu ) ) );
+            connect_log_channel( 1 );
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( channels_are_not_connected_by_default, channel )
+{
+    BOOST_CHECK( !log_channel.connected() );
+    BOOST_CHECK( !control_channel.connected() );
+    signaling_channel_output( {} );
+    BOOST_CHECK( channel_output().empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( connection_to_unknown_spsm_is_rejected, channel )
+{
+    signaling_channel_input(
+        {
+            0x14, 0x02, 0x0A, 0x00,
+            0x90, 0x00, 0x41, 0x00, 0x17, 0x00, 0x17, 0x00, 0x05, 0x00
+        },
+        {
+            0x15, 0x02, 0x0A, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x02, 0x00              // result: SPSM not supported
+        }
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( connection_is_accepted, channel )
+{
+    connect_log_channel();
+
+    BOOST_CHECK( log_channel.connected() );
+    BOOST_CHECK( !control_channel.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( second_channel_gets_the_next_channel_id, channel )
+{
+    signaling_channel_input(
+        {
+            0x14, 0x03, 0x0A, 0x00,
+            0x81, 0x00, 0x42, 0x00, 0x17, 0x00, 0x17, 0x00, 0x05, 0x00
+        },
+        {
+            0x15, 0x03, 0x0A, 0x00,
+            0x41, 0x00, 0x17, 0x00, 0x1B, 0x00, 0x00, 0x00,
+            0x00, 0x00
+        }
+    );
+
+    BOOST_CHECK( control_channel.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( invalid_source_cid_is_rejected, channel )
+{
+    signaling_channel_input(
+        {
+            0x14, 0x02, 0x0A, 0x00,
+            0x80, 0x00, 0x04, 0x00, 0x17, 0x00, 0x17, 0x00, 0x05, 0x00
+        },
+        {
+            0x15, 0x02, 0x0A, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x09, 0x00              // result: invalid source CID
+        }
+    );
+
+    BOOST_CHECK( !log_channel.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( allocated_source_cid_is_rejected, channel )
+{
+    connect_log_channel();
+
+    signaling_channel_input(
+        {
+            0x14, 0x03, 0x0A, 0x00,
+            0x81, 0x00, 0x41, 0x00, 0x17, 0x00, 0x17, 0x00, 0x05, 0x00
+        },
+        {
+            0x15, 0x03, 0x0A, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x0A, 0x00              // result: source CID already allocated
+        }
+    );
+
+    BOOST_CHECK( !control_channel.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( connected_channel_has_no_resources, channel )
+{
+    connect_log_channel();
+
+    signaling_channel_input(
+        {
+            0x14, 0x03, 0x0A, 0x00,
+            0x80, 0x00, 0x42, 0x00, 0x17, 0x00, 0x17, 0x00, 0x05, 0x00
+        },
+        {
+            0x15, 0x03, 0x0A, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x04, 0x00              // result: no resources available
+        }
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( too_small_mps_is_rejected, channel )
+{
+    signaling_channel_input(
+        {
+            0x14, 0x02, 0x0A, 0x00,
+            0x80, 0x00, 0x41, 0x00, 0x17, 0x00, 0x16, 0x00, 0x05, 0x00
+        },
+        {
+            0x15, 0x02, 0x0A, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x0B, 0x00              // result: unacceptable parameters
+        }
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( credit_is_granted_when_a_buffer_is_provided, channel )
+{
+    connect_log_channel();
+    signaling_channel_output( {} );
+
+    BOOST_CHECK( log_channel.receive( sdu, sizeof( sdu ) ) );
+
+    signaling_channel_output( {
+        0x16, 0x81, 0x04, 0x00,
+        0x40, 0x00,             // CID
+        0x01, 0x00              // credits
+    } );
+
+    signaling_channel_output( {} );
+}
+
+BOOST_FIXTURE_TEST_CASE( buffer_smaller_than_mtu_is_refused, channel )
+{
+    BOOST_CHECK( !log_channel.receive( sdu, 99 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( sdu_is_received_into_the_buffer, connected_channel )
+{
+    std::size_t size = 0;
+    BOOST_CHECK( !log_channel.sdu_received( size ) );
+
+    BOOST_CHECK( channel_input( 0x0040, { 0x03, 0x00, 0x01, 0x02, 0x03 } ) );
+
+    BOOST_REQUIRE( log_channel.sdu_received( size ) );
+    BOOST_CHECK_EQUAL( size, 3u );
+    BOOST_CHECK_EQUAL( sdu[ 0 ], 0x01 );
+    BOOST_CHECK_EQUAL( sdu[ 2 ], 0x03 );
+
+    // no more credits, till the next buffer is provided
+    signaling_channel_output( {} );
+}
+
+BOOST_FIXTURE_TEST_CASE( segmented_sdu_is_received, connected_channel )
+{
+    BOOST_CHECK( channel_input( 0x0040, {
+        0x1E, 0x00,
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+        0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13,
+        0x14, 0x15, 0x16, 0x17, 0x18
+    } ) );
+
+    std::size_t size = 0;
+    BOOST_CHECK( !log_channel.sdu_received( size ) );
+
+    // credit for the remaining 5 octets
+    signaling_channel_output( {
+        0x16, 0x81, 0x04, 0x00,
+        0x40, 0x00,
+        0x01, 0x00
+    } );
+
+    BOOST_CHECK( channel_input( 0x0040, { 0x19, 0x1A, 0x1B, 0x1C, 0x1D } ) );
+
+    BOOST_REQUIRE( log_channel.sdu_received( size ) );
+    BOOST_CHECK_EQUAL( size, 30u );
+
+    for ( std::size_t i = 0; i != size; ++i )
+        BOOST_CHECK_EQUAL( sdu[ i ], i );
+}
+
+BOOST_FIXTURE_TEST_CASE( frame_without_credit_disconnects_the_channel, connected_channel )
+{
+    BOOST_CHECK( channel_input( 0x0040, { 0x01, 0x00, 0x01 } ) );
+    BOOST_CHECK( channel_input( 0x0040, { 0x01, 0x00, 0x02 } ) );
+
+    signaling_channel_output( {
+        0x06, 0x81, 0x04, 0x00,
+        0x41, 0x00,             // destination CID
+        0x40, 0x00              // source CID
+    } );
+
+    BOOST_CHECK( !log_channel.connected() );
+    BOOST_CHECK( !channel_input( 0x0042, { 0x01, 0x00, 0x02 } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( sdu_larger_than_mtu_disconnects_the_channel, connected_channel )
+{
+    BOOST_CHECK( channel_input( 0x0040, { 0x65, 0x00, 0x01 } ) );
+
+    signaling_channel_output( {
+        0x06, 0x81, 0x04, 0x00,
+        0x41, 0x00,
+        0x40, 0x00
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( remote_device_disconnects_the_channel, connected_channel )
+{
+    signaling_channel_input(
+        {
+            0x06, 0x07, 0x04, 0x00,
+            0x40, 0x00, 0x41, 0x00
+        },
+        {
+            0x07, 0x07, 0x04, 0x00,
+            0x40, 0x00, 0x41, 0x00
+        }
+    );
+
+    BOOST_CHECK( !log_channel.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( disconnection_of_unknown_channel_is_ignored, connected_channel )
+{
+    signaling_channel_input(
+        {
+            0x06, 0x07, 0x04, 0x00,
+            0x40, 0x00, 0x42, 0x00
+        },
+        {}
+    );
+
+    BOOST_CHECK( log_channel.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( transmit_requires_a_connection, channel )
+{
+    static const std::uint8_t data[] = { 1, 2, 3 };
+
+    BOOST_CHECK( !log_channel.transmit( data, sizeof( data ) ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( sdu_is_segmented_into_k_frames, channel )
+{
+    connect_log_channel( 0, 2 );
+
+    std::uint8_t data[ 23 ];
+    for ( std::size_t i = 0; i != sizeof( data ); ++i )
+        data[ i ] = static_cast< std::uint8_t >( i );
+
+    BOOST_REQUIRE( log_channel.transmit( data, sizeof( data ) ) );
+    BOOST_CHECK( !log_channel.transmit( data, sizeof( data ) ) );
+
+    // remote MPS is 23
+    const std::vector< std::uint8_t > first = channel_output();
+    BOOST_REQUIRE_EQUAL( first.size(), 23u );
+    BOOST_CHECK_EQUAL( first[ 0 ], 23u );
+    BOOST_CHECK_EQUAL( first[ 1 ], 0u );
+    BOOST_CHECK_EQUAL_COLLECTIONS( first.begin() + 2, first.end(), &data[ 0 ], &data[ 21 ] );
+
+    const std::vector< std::uint8_t > second = channel_output();
+    BOOST_CHECK_EQUAL_COLLECTIONS( second.begin(), second.end(), &data[ 21 ], &data[ 23 ] );
+
+    // the link layer still refers to the last K-frame
+    BOOST_CHECK( log_channel.transmitting() );
+    BOOST_CHECK( channel_output().empty() );
+    BOOST_CHECK( !log_channel.transmitting() );
+}
+
+BOOST_FIXTURE_TEST_CASE( transmission_waits_for_credits, channel )
+{
+    connect_log_channel();
+
+    static const std::uint8_t data[] = { 1, 2, 3 };
+    BOOST_REQUIRE( log_channel.transmit( data, sizeof( data ) ) );
+
+    BOOST_CHECK( channel_output().empty() );
+
+    signaling_channel_input(
+        {
+            0x16, 0x04, 0x04, 0x00,
+            0x41, 0x00,             // CID of the remote device
+            0x01, 0x00
+        },
+        {}
+    );
+
+    const std::vector< std::uint8_t > frame = channel_output();
+    const std::vector< std::uint8_t > expected = { 0x03, 0x00, 0x01, 0x02, 0x03 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( frame.begin(), frame.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( connection_reset_closes_all_channels, connected_channel )
+{
+    reset_channels( 27 );
+
+    BOOST_CHECK( !log_channel.connected() );
+}
+
+namespace {
+    using sensor_channel_t = bluetoe::l2cap::credit_based_channel< 0x0090, 100 >;
+
+    sensor_channel_t    sensor_channel_a;
+    sensor_channel_t    sensor_channel_b;
+
+    using enhanced_signaling = bluetoe::l2cap::signaling_channel<
+        bluetoe::l2cap::bind_channel< sensor_channel_t, sensor_channel_a >,
+        bluetoe::l2cap::bind_channel< sensor_channel_t, sensor_channel_b >,
+        bluetoe::l2cap::bind_channel< control_channel_t, control_channel >
+    >;
+
+    struct enhanced_channels : enhanced_signaling
+    {
+        enhanced_channels()
+        {
+            new ( &sensor_channel_a ) sensor_channel_t();
+            new ( &sensor_channel_b ) sensor_channel_t();
+            new ( &control_channel ) control_channel_t();
+
+            // Enhanced Credit Based Flow Control requires an MPS of at least 64
+            reset_channels( 64 );
+        }
+
+        void signaling_channel_input( std::initializer_list< std::uint8_t > pdu, std::initializer_list< std::uint8_t > expected )
+        {
+            std::size_t out_size = sizeof( buffer );
+            enhanced_signaling::signaling_channel_input( pdu.begin(), pdu.size(), buffer, out_size, false );
+
+            BOOST_REQUIRE_EQUAL_COLLECTIONS( expected.begin(), expected.end(), &buffer[ 0 ], &buffer[ out_size ] );
+        }
+
+        void signaling_channel_output( std::initializer_list< std::uint8_t > expected )
+        {
+            std::size_t out_size = sizeof( buffer );
+            enhanced_signaling::signaling_channel_output( buffer, out_size );
+
+            BOOST_REQUIRE_EQUAL_COLLECTIONS( expected.begin(), expected.end(), &buffer[ 0 ], &buffer[ out_size ] );
+        }
+
+        // returns the remote channel identifier of the next K-frame, or 0, if there is nothing to transmit
+        std::uint16_t channel_output()
+        {
+            std::size_t   out_size   = sizeof( buffer );
+            std::uint16_t channel_id = 0;
+            bluetoe::details::output_reference reference;
+
+            enhanced_signaling::channel_output( buffer, out_size, channel_id, reference );
+
+            return out_size != 0 || !reference.empty() ? channel_id : 0;
+        }
+
+        std::uint8_t buffer[ 27 ];
+        std::uint8_t sdu_a[ 100 ];
+        std::uint8_t sdu_b[ 100 ];
+    };
+
+    struct connected_enhanced_channels : enhanced_channels
+    {
+        connected_enhanced_channels()
+        {
+            BOOST_REQUIRE( sensor_channel_a.receive( sdu_a, sizeof( sdu_a ) ) );
+            BOOST_REQUIRE( sensor_channel_b.receive( sdu_b, sizeof( sdu_b ) ) );
+
+            signaling_channel_input(
+                {
+                    0x17, 0x03, 0x0C, 0x00,
+                    0x90, 0x00,             // SPSM
+                    0x40, 0x00,             // MTU
+                    0x50, 0x00,             // MPS
+                    0x05, 0x00,             // initial credits
+                    0x41, 0x00, 0x42, 0x00  // source CIDs
+                },
+                {
+                    0x18, 0x03, 0x0C, 0x00,
+                    0x64, 0x00,             // MTU
+                    0x40, 0x00,             // MPS
+                    0x01, 0x00,             // initial credits
+                    0x00, 0x00,             // result: successful
+                    0x40, 0x00, 0x41, 0x00  // destination CIDs
+                }
+            );
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( enhanced_connection_opens_multiple_channels, connected_enhanced_channels )
+{
+    BOOST_CHECK( sensor_channel_a.connected() );
+    BOOST_CHECK( sensor_channel_b.connected() );
+    BOOST_CHECK( !control_channel.connected() );
+    BOOST_CHECK_EQUAL( sensor_channel_a.remote_mtu(), 0x40 );
+    BOOST_CHECK_EQUAL( sensor_channel_b.remote_mtu(), 0x40 );
+
+    signaling_channel_output( {} );
+}
+
+BOOST_FIXTURE_TEST_CASE( enhanced_connection_without_free_channel, enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x17, 0x03, 0x0E, 0x00,
+            0x90, 0x00, 0x40, 0x00, 0x40, 0x00, 0x05, 0x00,
+            0x41, 0x00, 0x42, 0x00, 0x43, 0x00
+        },
+        {
+            0x18, 0x03, 0x0E, 0x00,
+            0x64, 0x00, 0x40, 0x00, 0x00, 0x00,
+            0x04, 0x00,                         // result: some connections refused - insufficient resources
+            0x40, 0x00, 0x41, 0x00, 0x00, 0x00
+        }
+    );
+
+    BOOST_CHECK( sensor_channel_a.connected() );
+    BOOST_CHECK( sensor_channel_b.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( enhanced_connection_to_unknown_spsm_is_refused, enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x17, 0x03, 0x0C, 0x00,
+            0x91, 0x00, 0x40, 0x00, 0x40, 0x00, 0x05, 0x00,
+            0x41, 0x00, 0x42, 0x00
+        },
+        {
+            0x18, 0x03, 0x0C, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x02, 0x00,                         // result: SPSM not supported
+            0x00, 0x00, 0x00, 0x00
+        }
+    );
+
+    BOOST_CHECK( !sensor_channel_a.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( enhanced_connection_requires_a_channel_mtu_of_64, enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x17, 0x03, 0x0A, 0x00,
+            0x81, 0x00, 0x40, 0x00, 0x40, 0x00, 0x05, 0x00,
+            0x41, 0x00
+        },
+        {
+            0x18, 0x03, 0x0A, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x02, 0x00,                         // result: SPSM not supported
+            0x00, 0x00
+        }
+    );
+
+    BOOST_CHECK( !control_channel.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( enhanced_connection_with_unacceptable_parameters, enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x17, 0x03, 0x0C, 0x00,
+            0x90, 0x00, 0x40, 0x00, 0x3F, 0x00, 0x05, 0x00,
+            0x41, 0x00, 0x42, 0x00
+        },
+        {
+            0x18, 0x03, 0x0C, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x0B, 0x00,                         // result: unacceptable parameters
+            0x00, 0x00, 0x00, 0x00
+        }
+    );
+
+    BOOST_CHECK( !sensor_channel_a.connected() );
+    BOOST_CHECK( !sensor_channel_b.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( enhanced_connection_with_invalid_and_duplicate_source_cids, enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x17, 0x03, 0x0E, 0x00,
+            0x90, 0x00, 0x40, 0x00, 0x40, 0x00, 0x05, 0x00,
+            0x20, 0x00, 0x41, 0x00, 0x41, 0x00
+        },
+        {
+            0x18, 0x03, 0x0E, 0x00,
+            0x64, 0x00, 0x40, 0x00, 0x00, 0x00,
+            0x09, 0x00,                         // result: invalid source CID
+            0x00, 0x00, 0x40, 0x00, 0x00, 0x00
+        }
+    );
+
+    BOOST_CHECK( sensor_channel_a.connected() );
+    BOOST_CHECK( !sensor_channel_b.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( missing_initial_credits_are_granted_later, enhanced_channels )
+{
+    BOOST_REQUIRE( sensor_channel_b.receive( sdu_b, sizeof( sdu_b ) ) );
+
+    signaling_channel_input(
+        {
+            0x17, 0x03, 0x0C, 0x00,
+            0x90, 0x00, 0x40, 0x00, 0x40, 0x00, 0x05, 0x00,
+            0x41, 0x00, 0x42, 0x00
+        },
+        {
+            0x18, 0x03, 0x0C, 0x00,
+            0x64, 0x00, 0x40, 0x00,
+            0x00, 0x00,                         // initial credits: only the second channel has a buffer
+            0x00, 0x00,
+            0x40, 0x00, 0x41, 0x00
+        }
+    );
+
+    signaling_channel_output( {
+        0x16, 0x81, 0x04, 0x00,
+        0x41, 0x00,             // CID
+        0x01, 0x00              // credits
+    } );
+
+    signaling_channel_output( {} );
+}
+
+BOOST_FIXTURE_TEST_CASE( malformed_enhanced_connection_request_is_rejected, enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x17, 0x03, 0x14, 0x00,
+            0x90, 0x00, 0x40, 0x00, 0x40, 0x00, 0x05, 0x00,
+            0x41, 0x00, 0x42, 0x00, 0x43, 0x00, 0x44, 0x00, 0x45, 0x00, 0x46, 0x00
+        },
+        {
+            0x01, 0x03, 0x02, 0x00, 0x00, 0x00
+        }
+    );
+
+    BOOST_CHECK( !sensor_channel_a.connected() );
+}
+
+BOOST_FIXTURE_TEST_CASE( enhanced_channels_are_reconfigured, connected_enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x19, 0x04, 0x08, 0x00,
+            0x80, 0x00,             // MTU
+            0x50, 0x00,             // MPS
+            0x41, 0x00, 0x42, 0x00  // destination CIDs
+        },
+        {
+            0x1A, 0x04, 0x02, 0x00,
+            0x00, 0x00              // result: successful
+        }
+    );
+
+    BOOST_CHECK_EQUAL( sensor_channel_a.remote_mtu(), 0x80 );
+    BOOST_CHECK_EQUAL( sensor_channel_b.remote_mtu(), 0x80 );
+}
+
+BOOST_FIXTURE_TEST_CASE( mtu_of_enhanced_channels_can_not_be_reduced, connected_enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x19, 0x04, 0x06, 0x00,
+            0x80, 0x00, 0x50, 0x00, 0x41, 0x00
+        },
+        {
+            0x1A, 0x04, 0x02, 0x00, 0x00, 0x00
+        }
+    );
+
+    signaling_channel_input(
+        {
+            0x19, 0x05, 0x08, 0x00,
+            0x7F, 0x00, 0x50, 0x00, 0x41, 0x00, 0x42, 0x00
+        },
+        {
+            0x1A, 0x05, 0x02, 0x00,
+            0x01, 0x00              // result: reduction in size of MTU not allowed
+        }
+    );
+
+    BOOST_CHECK_EQUAL( sensor_channel_a.remote_mtu(), 0x80 );
+    BOOST_CHECK_EQUAL( sensor_channel_b.remote_mtu(), 0x40 );
+}
+
+BOOST_FIXTURE_TEST_CASE( mps_can_only_be_reduced_for_a_single_channel, connected_enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x19, 0x04, 0x08, 0x00,
+            0x40, 0x00, 0x40, 0x00, 0x41, 0x00, 0x42, 0x00
+        },
+        {
+            0x1A, 0x04, 0x02, 0x00,
+            0x02, 0x00              // result: reduction in size of MPS not allowed for more than one channel
+        }
+    );
+
+    signaling_channel_input(
+        {
+            0x19, 0x05, 0x06, 0x00,
+            0x40, 0x00, 0x40, 0x00, 0x41, 0x00
+        },
+        {
+            0x1A, 0x05, 0x02, 0x00, 0x00, 0x00
+        }
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( reconfiguration_of_unknown_channel_is_refused, connected_enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x19, 0x04, 0x08, 0x00,
+            0x80, 0x00, 0x50, 0x00, 0x41, 0x00, 0x43, 0x00
+        },
+        {
+            0x1A, 0x04, 0x02, 0x00,
+            0x03, 0x00              // result: invalid destination CID
+        }
+    );
+
+    BOOST_CHECK_EQUAL( sensor_channel_a.remote_mtu(), 0x40 );
+}
+
+BOOST_FIXTURE_TEST_CASE( reconfiguration_with_unacceptable_parameters_is_refused, connected_enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x19, 0x04, 0x06, 0x00,
+            0x80, 0x00, 0x3F, 0x00, 0x41, 0x00
+        },
+        {
+            0x1A, 0x04, 0x02, 0x00,
+            0x04, 0x00              // result: unacceptable parameters
+        }
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( channels_take_turns_in_transmitting, connected_enhanced_channels )
+{
+    static const std::uint8_t data[ 40 ] = { 0 };
+
+    BOOST_REQUIRE( sensor_channel_a.transmit( data, sizeof( data ) ) );
+    BOOST_REQUIRE( sensor_channel_b.transmit( data, sizeof( data ) ) );
+
+    // every SDU takes two K-frames
+    BOOST_CHECK_EQUAL( channel_output(), 0x0041 );
+    BOOST_CHECK_EQUAL( channel_output(), 0x0042 );
+    BOOST_CHECK_EQUAL( channel_output(), 0x0041 );
+    BOOST_CHECK_EQUAL( channel_output(), 0x0042 );
+    BOOST_CHECK_EQUAL( channel_output(), 0x0000 );
+}
+
+BOOST_FIXTURE_TEST_CASE( le_connection_uses_a_free_channel_with_the_spsm, enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x14, 0x02, 0x0A, 0x00,
+            0x90, 0x00, 0x41, 0x00, 0x40, 0x00, 0x40, 0x00, 0x05, 0x00
+        },
+        {
+            0x15, 0x02, 0x0A, 0x00,
+            0x40, 0x00, 0x64, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00
+        }
+    );
+
+    signaling_channel_input(
+        {
+            0x14, 0x03, 0x0A, 0x00,
+            0x90, 0x00, 0x42, 0x00, 0x40, 0x00, 0x40, 0x00, 0x05, 0x00
+        },
+        {
+            0x15, 0x03, 0x0A, 0x00,
+            0x41, 0x00, 0x64, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00
+        }
+    );
+
+    BOOST_CHECK( sensor_channel_a.connected() );
+    BOOST_CHECK( sensor_channel_b.connected() );
+
+    signaling_channel_input(
+        {
+            0x14, 0x04, 0x0A, 0x00,
+            0x90, 0x00, 0x43, 0x00, 0x40, 0x00, 0x40, 0x00, 0x05, 0x00
+        },
+        {
+            0x15, 0x04, 0x0A, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x04, 0x00              // result: no resources available
+        }
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( le_credit_based_channel_can_not_be_reconfigured, enhanced_channels )
+{
+    signaling_channel_input(
+        {
+            0x14, 0x02, 0x0A, 0x00,
+            0x90, 0x00, 0x41, 0x00, 0x40, 0x00, 0x40, 0x00, 0x05, 0x00
+        },
+        {
+            0x15, 0x02, 0x0A, 0x00,
+            0x40, 0x00, 0x64, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00
+        }
+    );
+
+    signaling_channel_input(
+        {
+            0x19, 0x04, 0x06, 0x00,
+            0x80, 0x00, 0x40, 0x00, 0x41, 0x00
+        },
+        {
+            0x1A, 0x04, 0x02, 0x00, 0x03, 0x00
+        }
+    );
+}
+
+namespace {
+    struct link_layer_with_channels : unconnected_base< signaling, bluetoe::link_layer::buffer_sizes< 61u, 61u > >
+    {
+        link_layer_with_channels()
+        {
+            new ( &log_channel ) log_channel_t();
+            new ( &control_channel ) control_channel_t();
+
+            respond_to( 37, valid_connection_request_pdu );
+        }
+
+        std::uint8_t sdu[ 100 ];
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( link_layer_routes_k_frames_to_the_channel, link_layer_with_channels )
+{
+    log_channel.receive( sdu, sizeof( sdu ) );
+
+    ll_data_pdu(
+        {
+            0x0E, 0x00, 0x05, 0x00,
+            0x14, 0x02, 0x0A, 0x00,
+            0x80, 0x00, 0x41, 0x00, 0x17, 0x00, 0x17, 0x00, 0x02, 0x00
+        } );
+    ll_data_pdu(
+        {
+            0x04, 0x00, 0x40, 0x00,
+            0x02, 0x00, 0xAA, 0xBB
+        } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    check_outgoing_l2cap_pdu( {
+        0x0E, 0x00, 0x05, 0x00,
+        0x15, 0x02, 0x0A, 0x00,
+        0x40, 0x00, 0x64, 0x00, 0x17, 0x00, 0x01, 0x00, 0x00, 0x00
+    } );
+
+    std::size_t size = 0;
+    BOOST_REQUIRE( log_channel.sdu_received( size ) );
+    BOOST_CHECK_EQUAL( size, 2u );
+    BOOST_CHECK_EQUAL( sdu[ 1 ], 0xBB );
+}
+
+BOOST_FIXTURE_TEST_CASE( link_layer_transmits_k_frames, link_layer_with_channels )
+{
+    static const std::uint8_t data[] = { 0x11, 0x22, 0x33 };
+
+    ll_data_pdu(
+        {
+            0x0E, 0x00, 0x05, 0x00,
+            0x14, 0x02, 0x0A, 0x00,
+            0x80, 0x00, 0x41, 0x00, 0x17, 0x00, 0x17, 0x00, 0x02, 0x00
+        } );
+    ll_function_call( [this](){
+        log_channel.transmit( data, sizeof( data ) );
+        this->wake_up();
+    } );
+    ll_empty_pdus( 3 );
+
+    run( 2 );
+
+    check_outgoing_l2cap_pdu( {
+        0x05, 0x00, 0x41, 0x00,
+        0x03, 0x00, 0x11, 0x22, 0x33
+    } );
+}
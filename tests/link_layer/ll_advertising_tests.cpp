@@ -1087,3 +1087,137 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( stop_count_down, LinkLayer, all_fixtures )
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( update_advertising_data )
+
+    static const std::uint8_t manufacturer_data[] = { 0x69, 0x02, 0x01, 0x02 };
+    static const std::uint8_t updated_data[]      = { 0x69, 0x02, 0x03, 0x04 };
+
+    std::vector< std::uint8_t > advertising_data( const test::advertising_data& adv )
+    {
+        // header and advertising address
+        return std::vector< std::uint8_t >( adv.transmitted_data.begin() + 8, adv.transmitted_data.end() );
+    }
+
+    std::vector< std::uint8_t > server_advertising_data()
+    {
+        advertising_and_connect link_layer;
+        link_layer.run();
+
+        auto result = advertising_data( link_layer.advertisings().front() );
+
+        // remove the empty AD
+        result.resize( result.size() - 2 );
+
+        return result;
+    }
+
+    std::vector< std::uint8_t > expected_advertising_data( const std::initializer_list< std::uint8_t >& added )
+    {
+        std::vector< std::uint8_t > result = server_advertising_data();
+        result.insert( result.end(), added.begin(), added.end() );
+        result.insert( result.end(), { 0x00, 0x00 } );
+
+        return result;
+    }
+
+BOOST_FIXTURE_TEST_CASE( ad_structure_is_appended, advertising_and_connect )
+{
+    run();
+
+    BOOST_CHECK( update_advertising_data( 0xff, manufacturer_data, sizeof( manufacturer_data ) ) );
+    end_of_simulation( bluetoe::link_layer::delta_time::seconds( 20 ) );
+    run();
+
+    const auto expected = expected_advertising_data( { 0x05, 0xff, 0x69, 0x02, 0x01, 0x02 } );
+    const auto data     = advertising_data( advertisings().back() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( data.begin(), data.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( ad_structure_with_different_size_is_replaced, advertising_and_connect )
+{
+    run();
+
+    BOOST_CHECK( update_advertising_data( 0xff, manufacturer_data, 2 ) );
+    BOOST_CHECK( update_advertising_data( 0xff, manufacturer_data, sizeof( manufacturer_data ) ) );
+    end_of_simulation( bluetoe::link_layer::delta_time::seconds( 20 ) );
+    run();
+
+    const auto expected = expected_advertising_data( { 0x05, 0xff, 0x69, 0x02, 0x01, 0x02 } );
+    const auto data     = advertising_data( advertisings().back() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( data.begin(), data.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( value_is_updated_in_the_current_advertising_pdu, advertising_and_connect )
+{
+    run();
+
+    BOOST_CHECK( update_advertising_data( 0xff, manufacturer_data, sizeof( manufacturer_data ) ) );
+    end_of_simulation( bluetoe::link_layer::delta_time::seconds( 20 ) );
+    run();
+
+    BOOST_CHECK( update_advertising_data( 0xff, updated_data, sizeof( updated_data ) ) );
+    end_of_simulation( bluetoe::link_layer::delta_time::seconds( 40 ) );
+    run();
+
+    const auto expected = expected_advertising_data( { 0x05, 0xff, 0x69, 0x02, 0x03, 0x04 } );
+    const auto data     = advertising_data( advertisings().back() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( data.begin(), data.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( ad_structure_of_the_server_is_replaced, advertising_and_connect )
+{
+    static const std::uint8_t flags[] = { 0x04 };
+
+    run();
+
+    BOOST_CHECK( update_advertising_data( 0x01, flags, sizeof( flags ) ) );
+    end_of_simulation( bluetoe::link_layer::delta_time::seconds( 20 ) );
+    run();
+
+    auto expected = expected_advertising_data( {} );
+    BOOST_REQUIRE_EQUAL( expected[ 1 ], 0x01 );
+    expected[ 2 ] = 0x04;
+
+    const auto data = advertising_data( advertisings().back() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( data.begin(), data.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( advertising_data_can_not_be_updated_before_the_link_layer_is_started, advertising_and_connect )
+{
+    BOOST_CHECK( !update_advertising_data( 0xff, manufacturer_data, sizeof( manufacturer_data ) ) );
+
+    run();
+
+    const auto expected = expected_advertising_data( {} );
+    const auto data     = advertising_data( advertisings().front() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( data.begin(), data.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( advertising_data_must_fit_into_the_pdu, advertising_and_connect )
+{
+    static const std::uint8_t large_data[ 30 ] = { 0 };
+
+    run();
+
+    // the server advertising data takes 21 octets
+    BOOST_CHECK( !update_advertising_data( 0xff, large_data, sizeof( large_data ) ) );
+    BOOST_CHECK( !update_advertising_data( 0xff, large_data, 9 ) );
+
+    end_of_simulation( bluetoe::link_layer::delta_time::seconds( 20 ) );
+    run();
+
+    const auto expected = expected_advertising_data( {} );
+    const auto data     = advertising_data( advertisings().back() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( data.begin(), data.end(), expected.begin(), expected.end() );
+
+    BOOST_CHECK( update_advertising_data( 0xff, large_data, 8 ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -639,3 +639,90 @@ BOOST_FIXTURE_TEST_CASE( connecting_client_is_not_in_white_list, server_with_whi
 
     BOOST_REQUIRE( connection_events().empty() );
 }
+
+static const std::initializer_list< std::uint8_t > connection_request_with_chsel_pdu =
+{
+    0xe5, 0x22,                         // header, ChSel set
+    0x3c, 0x1c, 0x62, 0x92, 0xf0, 0x48, // InitA: 48:f0:92:62:1c:3c (random)
+    0x47, 0x11, 0x08, 0x15, 0x0f, 0xc0, // AdvA:  c0:0f:15:08:11:47 (random)
+    0x5a, 0xb3, 0x9a, 0xaf,             // Access Address
+    0x08, 0x81, 0xf6,                   // CRC Init
+    0x03,                               // transmit window size
+    0x0b, 0x00,                         // window offset
+    0x18, 0x00,                         // interval (30ms)
+    0x00, 0x00,                         // slave latency
+    0x48, 0x00,                         // connection timeout (720ms)
+    0xff, 0xff, 0xff, 0xff, 0x1f,       // used channel map
+    0xaa                                // hop increment and sleep clock accuracy (10 and 50ppm)
+};
+
+struct unconnected_with_csa2 : unconnected_base< test::buffer_sizes, bluetoe::link_layer::channel_selection_algorithm_2 >
+{
+    std::vector< unsigned > channels() const
+    {
+        std::vector< unsigned > result;
+
+        for ( const auto& event : connection_events() )
+            result.push_back( event.channel );
+
+        result.resize( 5 );
+
+        return result;
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( chsel_is_not_announced_by_default, unconnected )
+{
+    run();
+
+    BOOST_REQUIRE( !advertisings().empty() );
+    BOOST_CHECK_EQUAL( advertisings().front().transmitted_data[ 0 ] & 0x20, 0 );
+}
+
+BOOST_FIXTURE_TEST_CASE( chsel_is_announced, unconnected_with_csa2 )
+{
+    run();
+
+    BOOST_REQUIRE( !advertisings().empty() );
+    BOOST_CHECK_EQUAL( advertisings().front().transmitted_data[ 0 ] & 0x20, 0x20 );
+}
+
+/*
+ * channel identifier = 0xaf9a ^ 0xb35a
+ */
+BOOST_FIXTURE_TEST_CASE( algorithm_2_is_used_if_selected_by_the_master, unconnected_with_csa2 )
+{
+    respond_to( 37, connection_request_with_chsel_pdu );
+    ll_empty_pdus( 5 );
+
+    run();
+
+    const std::vector< unsigned > expected = { 22, 2, 9, 13, 11 };
+    const std::vector< unsigned > channels = this->channels();
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( channels.begin(), channels.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( algorithm_1_is_used_if_not_selected_by_the_master, unconnected_with_csa2 )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_empty_pdus( 5 );
+
+    run();
+
+    const std::vector< unsigned > expected = { 10, 20, 30, 3, 13 };
+    const std::vector< unsigned > channels = this->channels();
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( channels.begin(), channels.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( algorithm_1_is_used_if_not_supported, unconnected )
+{
+    respond_to( 37, connection_request_with_chsel_pdu );
+    ll_empty_pdus( 5 );
+
+    run();
+
+    BOOST_REQUIRE( !connection_events().empty() );
+    BOOST_CHECK_EQUAL( connection_events().front().channel, 10u );
+}
@@ -0,0 +1,230 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "connected.hpp"
+
+namespace {
+    /*
+     * every call to cycles() advances the counter by `step`, so a connection event takes `step` cycles
+     */
+    struct cycle_counter
+    {
+        static std::uint32_t cycles()
+        {
+            return now += step;
+        }
+
+        static std::uint32_t now;
+        static std::uint32_t step;
+    };
+
+    std::uint32_t cycle_counter::now  = 0;
+    std::uint32_t cycle_counter::step = 0;
+
+    using statistics = bluetoe::link_layer::connection_statistics< cycle_counter, 100, 4 >;
+
+    struct connected : unconnected_base< statistics, bluetoe::link_layer::buffer_sizes< 200u, 200u > >
+    {
+        connected()
+        {
+            cycle_counter::step = 0;
+            respond_to( 37, valid_connection_request_pdu );
+        }
+    };
+
+    /*
+     * ll_data_pdu_buffer with the link layer statistics as callback, to simulate errors that the test radio can not simulate
+     */
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+    struct buffer_radio : bluetoe::link_layer::ll_data_pdu_buffer< TransmitSize, ReceiveSize, buffer_radio< TransmitSize, ReceiveSize, CallBack > >
+    {
+        using lock_guard = bluetoe::link_layer::details::no_lock_guard;
+        using layout     = bluetoe::link_layer::default_pdu_layout;
+
+        void increment_receive_packet_counter() {}
+        void increment_transmit_packet_counter() {}
+
+        buffer_radio()
+        {
+            this->reset();
+        }
+
+        void transmit_pdu()
+        {
+            auto pdu = this->allocate_transmit_buffer( layout::data_channel_pdu_memory_size( 1 ) );
+            layout::header( pdu, 0x0102 );
+            this->commit_transmit_buffer( pdu );
+        }
+
+        // simulates the reception of a PDU from the master and the transmission of the response
+        void receive_pdu( std::uint16_t header )
+        {
+            auto pdu = this->allocate_receive_buffer();
+            layout::header( pdu, header );
+            this->received( pdu );
+        }
+
+        void receive_with_crc_error()
+        {
+            this->crc_error();
+        }
+
+        void receive_with_mic_error()
+        {
+            this->mic_error();
+        }
+    };
+
+    struct buffer_statistics;
+}
+
+namespace bluetoe {
+namespace link_layer {
+namespace details {
+    template <>
+    struct callback_collects_connection_statistics< ::buffer_statistics >
+    {
+        static constexpr bool value = true;
+    };
+}
+}
+}
+
+namespace {
+    struct buffer_statistics : buffer_radio< 100, 100, buffer_statistics >, statistics::impl
+    {
+    };
+
+    static constexpr std::uint16_t sn   = 0x08;
+    static constexpr std::uint16_t nesn = 0x04;
+    static constexpr std::uint16_t empty_pdu = 0x0001;
+}
+
+BOOST_AUTO_TEST_CASE( no_statistics_by_default )
+{
+    using ll = unconnected_base< bluetoe::link_layer::buffer_sizes< 200u, 200u > >;
+
+    BOOST_CHECK( !ll::collects_connection_statistics );
+    BOOST_CHECK( statistics::impl::collects_connection_statistics );
+
+    // without statistics, the ll_data_pdu_buffer has no additional state
+    using buffer_without_statistics = buffer_radio< 100, 100, void >;
+    BOOST_CHECK( std::is_empty< bluetoe::link_layer::details::pdu_statistics< buffer_without_statistics > >::value );
+    using buffer_with_statistics = buffer_radio< 100, 100, buffer_statistics >;
+    BOOST_CHECK( !std::is_empty< bluetoe::link_layer::details::pdu_statistics< buffer_with_statistics > >::value );
+}
+
+BOOST_FIXTURE_TEST_CASE( statistics_are_zero_before_the_first_connection, connected )
+{
+    const auto& stats = connection_statistics();
+
+    BOOST_CHECK_EQUAL( stats.events, 0u );
+    BOOST_CHECK_EQUAL( stats.empty_events, 0u );
+    BOOST_CHECK_EQUAL( stats.timeouts, 0u );
+    BOOST_CHECK_EQUAL( stats.received_pdus, 0u );
+    BOOST_CHECK_EQUAL( stats.transmitted_pdus, 0u );
+
+    for ( const auto bucket : stats.processing_time )
+        BOOST_CHECK_EQUAL( bucket, 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( empty_connection_events_are_counted, connected )
+{
+    ll_empty_pdus( 5 );
+    run();
+
+    BOOST_CHECK_EQUAL( connection_statistics().events, 5u );
+    BOOST_CHECK_EQUAL( connection_statistics().empty_events, 5u );
+    BOOST_CHECK_EQUAL( connection_statistics().received_pdus, 0u );
+    BOOST_CHECK_EQUAL( connection_statistics().transmitted_pdus, 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( received_and_acknowledged_pdus_are_counted, connected )
+{
+    ll_control_pdu( {
+        0x12                // LL_PING_REQ
+    } );
+    ll_empty_pdus( 3 );
+    run();
+
+    // the ping request is received in the first event, the response is acknowledged in the third event
+    BOOST_CHECK_EQUAL( connection_statistics().events, 4u );
+    BOOST_CHECK_EQUAL( connection_statistics().received_pdus, 1u );
+    BOOST_CHECK_EQUAL( connection_statistics().transmitted_pdus, 1u );
+    BOOST_CHECK_EQUAL( connection_statistics().empty_events, 2u );
+    BOOST_CHECK_EQUAL( connection_statistics().retransmissions, 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( timeouts_are_counted, connected )
+{
+    ll_empty_pdus( 2 );
+    add_connection_event_respond_timeout();
+    add_connection_event_respond_timeout();
+    ll_empty_pdus( 1 );
+    run();
+
+    BOOST_CHECK_EQUAL( connection_statistics().events, 3u );
+    BOOST_CHECK_GE( connection_statistics().timeouts, 2u );
+}
+
+BOOST_FIXTURE_TEST_CASE( processing_time_histogram, connected )
+{
+    cycle_counter::step = 150;
+    ll_empty_pdus( 2 );
+    ll_function_call( [](){ cycle_counter::step = 20; } );
+    ll_function_call( [](){ cycle_counter::step = 1000; } );
+    ll_empty_pdus( 1 );
+    run();
+
+    const auto& histogram = connection_statistics().processing_time;
+
+    BOOST_CHECK_EQUAL( histogram[ 0 ], 1u );
+    BOOST_CHECK_EQUAL( histogram[ 1 ], 2u );
+    BOOST_CHECK_EQUAL( histogram[ 2 ], 0u );
+    BOOST_CHECK_EQUAL( histogram[ 3 ], 2u );
+}
+
+BOOST_FIXTURE_TEST_CASE( statistics_can_be_reset, connected )
+{
+    ll_empty_pdus( 3 );
+    run();
+    BOOST_CHECK_EQUAL( connection_statistics().events, 3u );
+
+    reset_connection_statistics();
+    BOOST_CHECK_EQUAL( connection_statistics().events, 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( retransmissions_are_counted, buffer_statistics )
+{
+    transmit_pdu();
+
+    // master acknowledges nothing, slave sends the data PDU with sn = 0
+    receive_pdu( empty_pdu );
+    // master did not receive the PDU and asks again for sn = 0
+    receive_pdu( empty_pdu | sn );
+    BOOST_CHECK_EQUAL( connection_statistics().retransmissions, 1u );
+    BOOST_CHECK_EQUAL( connection_statistics().transmitted_pdus, 0u );
+
+    // master acknowledges the PDU
+    receive_pdu( empty_pdu | nesn );
+    BOOST_CHECK_EQUAL( connection_statistics().retransmissions, 1u );
+    BOOST_CHECK_EQUAL( connection_statistics().transmitted_pdus, 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( not_acknowledged_empty_pdus_are_no_retransmissions, buffer_statistics )
+{
+    receive_pdu( empty_pdu );
+    receive_pdu( empty_pdu | sn );
+
+    BOOST_CHECK_EQUAL( connection_statistics().retransmissions, 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( receive_errors_are_counted, buffer_statistics )
+{
+    receive_with_crc_error();
+    receive_with_crc_error();
+    receive_with_mic_error();
+
+    BOOST_CHECK_EQUAL( connection_statistics().crc_errors, 2u );
+    BOOST_CHECK_EQUAL( connection_statistics().mic_failures, 1u );
+}
@@ -0,0 +1,177 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "connected.hpp"
+
+namespace {
+    using data_length_link_layer = unconnected_base<
+        bluetoe::link_layer::buffer_sizes< 512u, 512u >,
+        bluetoe::link_layer::data_length_extension<> >;
+
+    struct unconnected_with_data_length : data_length_link_layer
+    {
+        // all non-empty PDUs of the given connection event
+        std::vector< std::vector< std::uint8_t > > transmitted_pdus( std::size_t event ) const
+        {
+            std::vector< std::vector< std::uint8_t > > result;
+
+            for ( const auto& pdu : connection_events().at( event ).transmitted_data )
+            {
+                if ( pdu.data.size() > 2 && pdu.data[ 1 ] != 0 )
+                {
+                    result.push_back( pdu.data );
+                    result.back()[ 0 ] &= 0x03;
+                }
+            }
+
+            return result;
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( length_request_not_supported_by_default, unconnected )
+{
+    check_single_ll_control_pdu(
+        {
+            0x03, 0x09,
+            0x14,               // LL_LENGTH_REQ
+            0xfb, 0x00,         // MaxRxOctets
+            0x48, 0x08,         // MaxRxTime
+            0xfb, 0x00,         // MaxTxOctets
+            0x48, 0x08          // MaxTxTime
+        },
+        {
+            0x03, 0x02,
+            0x07, 0x14          // LL_UNKNOWN_RSP
+        },
+        "length_request_not_supported_by_default"
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( data_length_extension_is_announced_as_feature, unconnected_with_data_length )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_control_pdu( {
+        0x08,               // LL_FEATURE_REQ
+        0xff, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00
+    } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    static const std::uint8_t expected_response[] = {
+        0x03, 0x09,
+        0x09,               // LL_FEATURE_RSP
+        0x32, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00
+    };
+
+    // followed by the LL_LENGTH_REQ
+    const auto pdus = transmitted_pdus( 1 );
+    BOOST_REQUIRE_EQUAL( pdus.size(), 2u );
+    BOOST_CHECK_EQUAL_COLLECTIONS( pdus[ 0 ].begin(), pdus[ 0 ].end(), std::begin( expected_response ), std::end( expected_response ) );
+    BOOST_CHECK_EQUAL( pdus[ 1 ][ 2 ], 0x14 );
+}
+
+/*
+ * The largest size, the link layer buffer can handle is 251 including the LL header
+ */
+BOOST_FIXTURE_TEST_CASE( respond_to_length_request, unconnected_with_data_length )
+{
+    check_single_ll_control_pdu(
+        {
+            0x03, 0x09,
+            0x14,               // LL_LENGTH_REQ
+            0xfb, 0x00,         // MaxRxOctets
+            0x48, 0x08,         // MaxRxTime
+            0xfb, 0x00,         // MaxTxOctets
+            0x48, 0x08          // MaxTxTime
+        },
+        {
+            0x03, 0x09,
+            0x15,               // LL_LENGTH_RSP
+            0xf9, 0x00,         // MaxRxOctets
+            0x38, 0x08,         // MaxRxTime
+            0xf9, 0x00,         // MaxTxOctets
+            0x38, 0x08          // MaxTxTime
+        },
+        "respond_to_length_request"
+    );
+
+    BOOST_CHECK_EQUAL( max_rx_size(), 251u );
+    BOOST_CHECK_EQUAL( max_tx_size(), 251u );
+}
+
+BOOST_FIXTURE_TEST_CASE( negotiated_sizes_are_limited_by_the_master, unconnected_with_data_length )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_control_pdu( {
+        0x14,               // LL_LENGTH_REQ
+        0x50, 0x00,         // MaxRxOctets
+        0x48, 0x08,         // MaxRxTime
+        0x64, 0x00,         // MaxTxOctets
+        0x48, 0x08          // MaxTxTime
+    } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    BOOST_CHECK_EQUAL( max_tx_size(), 0x50u + 2 );
+    BOOST_CHECK_EQUAL( max_rx_size(), 0x64u + 2 );
+}
+
+BOOST_FIXTURE_TEST_CASE( initiates_data_length_update, unconnected_with_data_length )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_empty_pdus( 2 );
+    ll_control_pdu( {
+        0x15,               // LL_LENGTH_RSP
+        0x64, 0x00,         // MaxRxOctets
+        0x90, 0x03,         // MaxRxTime
+        0x64, 0x00,         // MaxTxOctets
+        0x90, 0x03          // MaxTxTime
+    } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    const auto pdus = transmitted_pdus( 1 );
+    BOOST_REQUIRE_EQUAL( pdus.size(), 1u );
+
+    static const std::uint8_t expected_request[] = {
+        0x03, 0x09,
+        0x14,               // LL_LENGTH_REQ
+        0xf9, 0x00,         // MaxRxOctets
+        0x38, 0x08,         // MaxRxTime
+        0xf9, 0x00,         // MaxTxOctets
+        0x38, 0x08          // MaxTxTime
+    };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( pdus[ 0 ].begin(), pdus[ 0 ].end(), std::begin( expected_request ), std::end( expected_request ) );
+
+    // the response must not be answered
+    BOOST_CHECK( transmitted_pdus( 3 ).empty() );
+
+    BOOST_CHECK_EQUAL( max_tx_size(), 100u + 2 );
+    BOOST_CHECK_EQUAL( max_rx_size(), 100u + 2 );
+}
+
+BOOST_FIXTURE_TEST_CASE( master_does_not_support_data_length_update, unconnected_with_data_length )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_empty_pdus( 2 );
+    ll_control_pdu( {
+        0x07,               // LL_UNKNOWN_RSP
+        0x14
+    } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    BOOST_CHECK( transmitted_pdus( 3 ).empty() );
+    BOOST_CHECK( transmitted_pdus( 4 ).empty() );
+
+    BOOST_CHECK_EQUAL( max_tx_size(), 29u );
+    BOOST_CHECK_EQUAL( max_rx_size(), 29u );
+}
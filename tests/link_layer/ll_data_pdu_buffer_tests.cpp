@@ -8,6 +8,7 @@
 
 #include <initializer_list>
 #include <random>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 
@@ -910,3 +911,202 @@ BOOST_AUTO_TEST_SUITE( packet_counter_tests )
     }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+namespace lock_free
+{
+    /*
+     * radio without lock_guard, that uses the lock free buffers
+     */
+    template < std::size_t TransmitSize, std::size_t ReceiveSize >
+    struct mock_radio : bluetoe::link_layer::ll_data_pdu_buffer< TransmitSize, ReceiveSize, mock_radio< TransmitSize, ReceiveSize > >
+    {
+        void increment_receive_packet_counter() {}
+
+        void increment_transmit_packet_counter() {}
+    };
+
+    /*
+     * generated content of the n-th PDU of a stream
+     */
+    std::vector< std::uint8_t > stream_pdu( std::size_t n, std::uint8_t seed )
+    {
+        std::vector< std::uint8_t > result( 1 + n % 27 );
+
+        for ( std::size_t i = 0; i != result.size(); ++i )
+            result[ i ] = static_cast< std::uint8_t >( seed + n * 7 + i );
+
+        return result;
+    }
+}
+
+namespace bluetoe
+{
+    namespace link_layer
+    {
+        template < std::size_t TransmitSize, std::size_t ReceiveSize >
+        struct pdu_buffer_synchronization_by_radio< lock_free::mock_radio< TransmitSize, ReceiveSize > > {
+            using synchronization = lock_free_pdu_buffers;
+        };
+    }
+}
+
+BOOST_AUTO_TEST_SUITE( lock_free_tests )
+
+    using buffer_under_test = running_mode_impl< 100, 100, lock_free::mock_radio >;
+
+    BOOST_FIXTURE_TEST_CASE( make_sure_the_synchronization_is_used, buffer_under_test )
+    {
+        BOOST_CHECK( ( std::is_same< synchronization, bluetoe::link_layer::lock_free_pdu_buffers >::value ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( sequence_numbers_are_assigned_when_transmitted, buffer_under_test )
+    {
+        transmit_pdu( { 0x01 } );
+        transmit_pdu( { 0x02 } );
+
+        auto transmit = next_transmit();
+        BOOST_CHECK_EQUAL( transmit.buffer[ 0 ] & 0x08, 0 );
+        BOOST_CHECK_EQUAL( transmit.buffer[ 2 ], 0x01 );
+
+        // not acknowledged: same sequence number
+        receive_pdu( {}, false, false );
+        transmit = next_transmit();
+        BOOST_CHECK_EQUAL( transmit.buffer[ 0 ] & 0x08, 0 );
+        BOOST_CHECK_EQUAL( transmit.buffer[ 2 ], 0x01 );
+
+        receive_pdu( {}, true, true );
+        transmit = next_transmit();
+        BOOST_CHECK_EQUAL( transmit.buffer[ 0 ] & 0x08, 0x08 );
+        BOOST_CHECK_EQUAL( transmit.buffer[ 2 ], 0x02 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( not_transmitted_pdus_are_not_acknowledged, buffer_under_test )
+    {
+        transmit_pdu( { 0x01 } );
+
+        // NESN would acknowledge a PDU with sequence number 0
+        receive_pdu( {}, false, true );
+
+        const auto transmit = next_transmit();
+        BOOST_CHECK_EQUAL( transmit.buffer[ 0 ] & 0x08, 0 );
+        BOOST_CHECK_EQUAL( transmit.buffer[ 2 ], 0x01 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( sequence_numbers_continue_after_empty_pdus, buffer_under_test )
+    {
+        // empty PDU with sequence number 0 is send and acknowledged
+        BOOST_CHECK_EQUAL( next_transmit().buffer[ 0 ] & 0x08, 0 );
+        receive_pdu( {}, false, true );
+
+        transmit_pdu( { 0x01 } );
+
+        const auto transmit = next_transmit();
+        BOOST_CHECK_EQUAL( transmit.buffer[ 0 ] & 0x08, 0x08 );
+        BOOST_CHECK_EQUAL( transmit.buffer[ 2 ], 0x01 );
+    }
+
+    /*
+     * The link layer is running in the test thread, while the radio ISR, together with a simulated master,
+     * is running in a second thread. Both sides are streaming PDUs to each other.
+     */
+    BOOST_FIXTURE_TEST_CASE( stress_link_layer_and_radio_in_two_threads, buffer_under_test )
+    {
+        static constexpr std::size_t   stream_size    = 20000;
+        static constexpr std::size_t   max_iterations = 100 * 1000 * 1000;
+        static constexpr std::uint8_t  slave_seed     = 0x00;
+        static constexpr std::uint8_t  master_seed    = 0x80;
+
+        std::vector< std::vector< std::uint8_t > > received_by_master;
+        std::vector< std::vector< std::uint8_t > > received_by_slave;
+
+        std::thread radio( [&]()
+        {
+            bool        sequence_number      = false;
+            bool        next_expected        = false;
+            std::size_t acknowledged         = 0;
+
+            for ( std::size_t iteration = 0; iteration != max_iterations && ( acknowledged != stream_size || received_by_master.size() != stream_size ); ++iteration )
+            {
+                auto pdu = allocate_receive_buffer();
+
+                // no room to receive, the master PDU is lost
+                if ( pdu.size == 0 )
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                const std::vector< std::uint8_t > payload = acknowledged == stream_size
+                    ? std::vector< std::uint8_t >()
+                    : lock_free::stream_pdu( acknowledged, master_seed );
+
+                pdu.buffer[ 0 ] = static_cast< std::uint8_t >( ( payload.empty() ? 1 : 2 ) | ( sequence_number ? 8 : 0 ) | ( next_expected ? 4 : 0 ) );
+                pdu.buffer[ 1 ] = static_cast< std::uint8_t >( payload.size() );
+                std::copy( payload.begin(), payload.end(), &pdu.buffer[ 2 ] );
+
+                const auto response = received( pdu );
+
+                // the slave acknowledged the master PDU
+                if ( static_cast< bool >( response.buffer[ 0 ] & 4 ) != sequence_number )
+                {
+                    sequence_number = !sequence_number;
+
+                    if ( !payload.empty() )
+                        ++acknowledged;
+                }
+
+                // new PDU from the slave
+                if ( static_cast< bool >( response.buffer[ 0 ] & 8 ) == next_expected )
+                {
+                    next_expected = !next_expected;
+
+                    if ( response.buffer[ 1 ] != 0 )
+                        received_by_master.push_back( std::vector< std::uint8_t >( &response.buffer[ 2 ], &response.buffer[ 2 + response.buffer[ 1 ] ] ) );
+                }
+            }
+        } );
+
+        std::size_t transmitted = 0;
+
+        for ( std::size_t iteration = 0; iteration != max_iterations && ( transmitted != stream_size || received_by_slave.size() != stream_size ); ++iteration )
+        {
+            bool idle = true;
+
+            if ( transmitted != stream_size )
+            {
+                const std::vector< std::uint8_t > payload = lock_free::stream_pdu( transmitted, slave_seed );
+
+                if ( allocate_transmit_buffer( layout::data_channel_pdu_memory_size( payload.size() ) ).size )
+                {
+                    transmit_pdu( payload.begin(), payload.end() );
+                    ++transmitted;
+                    idle = false;
+                }
+            }
+
+            const auto next = next_received();
+
+            if ( next.size )
+            {
+                received_by_slave.push_back( std::vector< std::uint8_t >( &next.buffer[ 2 ], &next.buffer[ 2 + next.buffer[ 1 ] ] ) );
+                free_received();
+                idle = false;
+            }
+
+            if ( idle )
+                std::this_thread::yield();
+        }
+
+        radio.join();
+
+        BOOST_REQUIRE_EQUAL( received_by_master.size(), stream_size );
+        BOOST_REQUIRE_EQUAL( received_by_slave.size(), stream_size );
+
+        for ( std::size_t n = 0; n != stream_size; ++n )
+        {
+            BOOST_REQUIRE( received_by_master[ n ] == lock_free::stream_pdu( n, slave_seed ) );
+            BOOST_REQUIRE( received_by_slave[ n ] == lock_free::stream_pdu( n, master_seed ) );
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -31,3 +31,70 @@ BOOST_FIXTURE_TEST_CASE( response_to_att_request, unconnected )
 
     BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( response ), std::end( response ), std::begin( expected_response ), std::end( expected_response ) );
 }
+
+namespace {
+    bool sensor_sampled = false;
+
+    std::uint8_t read_sensor( std::size_t, std::uint8_t* out_buffer, std::size_t& out_size )
+    {
+        if ( !sensor_sampled )
+            return bluetoe::error_codes::pending;
+
+        *out_buffer = 0x42;
+        out_size    = 1;
+
+        return bluetoe::error_codes::success;
+    }
+
+    using sensor_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::free_read_handler< &read_sensor >
+            >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers
+    >;
+
+    struct connected_sensor : unconnected_base_t< sensor_server, test::radio, bluetoe::link_layer::buffer_sizes< 61u, 61u > >
+    {
+        connected_sensor()
+        {
+            sensor_sampled = false;
+            respond_to( 37, valid_connection_request_pdu );
+        }
+
+        void run()
+        {
+            for ( int event = 0; event != 3; ++event )
+                base::run( server );
+        }
+
+        sensor_server server;
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( pending_att_response_is_send_after_completion, connected_sensor )
+{
+    ll_data_pdu(
+        {
+            0x03, 0x00,         // length
+            0x04, 0x00,         // Channel
+            0x0A, 0x03, 0x00    // Read Request
+        } );
+    ll_empty_pdus( 3 );
+    ll_function_call( [this]() {
+        sensor_sampled = true;
+        server.complete_pending_read();
+        this->wake_up();
+    } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    check_outgoing_l2cap_pdu( {
+        0x02, 0x00, 0x04, 0x00,     // l2cap header
+        0x0B, 0x42                  // Read Response
+    } );
+}
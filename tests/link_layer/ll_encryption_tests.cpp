@@ -54,14 +54,23 @@ namespace test {
                 return key_vault;
             }
 
-            void remote_connection_created( const bluetoe::link_layer::device_address& )
+            void remote_connection_created( const bluetoe::link_layer::device_address& remote )
             {
+                remote_addr_ = remote;
+            }
+
+            const bluetoe::link_layer::device_address& remote_address() const
+            {
+                return remote_addr_;
             }
 
             bluetoe::device_pairing_status local_device_pairing_status() const
             {
                 return bluetoe::device_pairing_status::no_key;
             }
+
+        private:
+            bluetoe::link_layer::device_address remote_addr_;
         };
 
         template < class OtherConnectionData, class SecurityFunctions >
@@ -69,6 +78,17 @@ namespace test {
         {
         }
 
+        template < class OtherConnectionData, class SecurityFunctions >
+        void l2cap_output( std::uint8_t*, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& )
+        {
+            out_size = 0;
+        }
+
+        template < class OtherConnectionData, class SecurityFunctions >
+        void idle_processing( connection_data< OtherConnectionData >&, SecurityFunctions& )
+        {
+        }
+
         struct meta_type :
             bluetoe::details::security_manager_meta_type,
             bluetoe::link_layer::details::valid_link_layer_option_meta_type {};
@@ -403,3 +423,233 @@ BOOST_FIXTURE_TEST_CASE( pause_encryption, link_layer_with_encryption )
     BOOST_CHECK( !connection_events().at( 7 ).receive_encryption_at_start_of_event );
     BOOST_CHECK( !connection_events().at( 7 ).transmit_encryption_at_start_of_event );
 }
+
+struct link_layer_with_bonding : unconnected_base_t<
+    test::secret_service, test::radio_with_encryption, test::security_manager, test::buffer_sizes,
+    bluetoe::bonding< bluetoe::ram_key_store< 1 > > >
+{
+    link_layer_with_bonding()
+    {
+        respond_to( 37, valid_connection_request_pdu );
+        test::key_vault = { false, { { 0x00 } } };
+
+        // bond with the initiator of the connection request
+        store_bond( bluetoe::bond_data{
+            bluetoe::link_layer::random_device_address( { 0x3c, 0x1c, 0x62, 0x92, 0xf0, 0x48 } ),
+            test::example_key,
+            0x7766554433221100,
+            0x1234,
+            bluetoe::device_pairing_status::unauthenticated_key,
+            {{ 0 }} } );
+    }
+
+    void encryption_request( std::uint16_t ediv )
+    {
+        ll_control_pdu({
+            0x03,                                   // LL_ENC_REQ
+            0x00, 0x11, 0x22, 0x33,                 // Rand
+            0x44, 0x55, 0x66, 0x77,
+            static_cast< std::uint8_t >( ediv ),    // EDIV
+            static_cast< std::uint8_t >( ediv >> 8 ),
+            0x00, 0x10, 0x20, 0x30,                 // SKDm
+            0x40, 0x50, 0x60, 0x70,
+            0xab, 0xbc, 0x12, 0x34,                 // IVm
+        });
+        ll_empty_pdu();
+    }
+
+    void expected_response( const std::initializer_list< std::uint8_t >& expected_response, std::size_t event = 1, std::size_t pdu = 0 )
+    {
+        auto response = connection_events().at( event ).transmitted_data.at( pdu );
+        response[ 0 ] &= 0x03;
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( response ), std::end( response ), std::begin( expected_response ), std::end( expected_response ) );
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( bonded_key_starts_encryption_in_the_same_connection_event, link_layer_with_bonding )
+{
+    encryption_request( 0x1234 );
+
+    run();
+
+    const auto used_key = encryption_key();
+    BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( used_key ), std::end( used_key ), std::begin( test::example_key ), std::end( test::example_key ) );
+
+    expected_response( {
+        0x03, 0x01,
+        0x05                                    // LL_START_ENC_REQ
+    }, 1, 1 );
+
+    BOOST_CHECK( connection_events().at( 1 ).receive_encryption_at_start_of_event );
+}
+
+BOOST_FIXTURE_TEST_CASE( bonded_key_with_different_ediv_is_not_used, link_layer_with_bonding )
+{
+    encryption_request( 0x1235 );
+
+    run();
+
+    expected_response( {
+        0x03, 0x02,
+        0x0D,                                   // LL_REJECT_IND
+        0x06                                    // ErrorCode
+    }, 1, 1 );
+}
+
+BOOST_FIXTURE_TEST_CASE( key_of_the_current_pairing_takes_precedence, link_layer_with_bonding )
+{
+    static const bluetoe::details::uint128_t pairing_key = { {
+        0x10, 0x20, 0x30, 0x40,
+        0x50, 0x60, 0x70, 0x80,
+        0x90, 0xa0, 0xb0, 0xc0,
+        0xd0, 0xe0, 0xf0, 0x00
+    } };
+
+    test::key_vault = std::make_pair( true, pairing_key );
+    encryption_request( 0x1234 );
+
+    run();
+
+    const auto used_key = encryption_key();
+    BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( used_key ), std::end( used_key ), std::begin( pairing_key ), std::end( pairing_key ) );
+}
+
+/*
+ * Encryption in software, with the sample data from the core spec (version 4.2); Vol. 6; Part C; 1
+ * (see start_encryption_example). The encrypted PDUs of the master and the expected, encrypted PDUs of
+ * the slave were calculated with an independent AES-CCM implementation; the LL_START_ENC_RSP PDUs match
+ * the sample data of the specification.
+ */
+struct link_layer_with_software_encryption : unconnected_base_t< test::secret_service, test::radio_with_software_encryption, test::security_manager, test::buffer_sizes >
+{
+    link_layer_with_software_encryption()
+    {
+        // LTK = 0x4C68384139F574D836BCF34E9DFB01BF
+        static const bluetoe::details::uint128_t sample_long_term_key = { {
+            0xBF, 0x01, 0xFB, 0x9D,
+            0x4E, 0xF3, 0xBC, 0x36,
+            0xD8, 0x74, 0xF5, 0x39,
+            0x41, 0x38, 0x68, 0x4C
+        } };
+
+        respond_to( 37, valid_connection_request_pdu );
+        test::key_vault = std::make_pair( true, sample_long_term_key );
+        test::secret_value = 0x1234;
+
+        // SKDs = 0x0213243546576879, IVs = 0xDEAFBABE
+        srand( { {
+            0x79, 0x68, 0x57, 0x46,
+            0x35, 0x24, 0x13, 0x02,
+            0xBE, 0xBA, 0xAF, 0xDE,
+            0x00, 0x00, 0x00, 0x00
+        } } );
+
+        ll_control_pdu({
+            0x03,                                   // LL_ENC_REQ
+            0x90, 0x78, 0x56, 0x34,                 // Rand
+            0x12, 0xef, 0xcd, 0xab,
+            0x74, 0x24,                             // EDIV
+            0x13, 0x02, 0xf1, 0xe0,                 // SKDm
+            0xdf, 0xce, 0xbd, 0xac,
+            0x24, 0xab, 0xdc, 0xba                  // IVm
+        });
+        ll_empty_pdu();
+
+        // LL_START_ENC_RSP, packet counter 0
+        add_connection_event_respond( {
+            0x03, 0x05,
+            0x9F, 0xCD, 0xA7, 0xF4, 0x48
+        } );
+        ll_empty_pdu();
+    }
+
+    // number of transmitted PDUs, that are equal to the expected PDU; SN, NESN and MD are ignored
+    std::size_t transmitted( const std::initializer_list< std::uint8_t >& expected ) const
+    {
+        std::size_t result = 0;
+
+        for ( const auto& event : connection_events() )
+        {
+            for ( auto pdu : event.transmitted_data )
+            {
+                pdu[ 0 ] &= 0x03;
+
+                if ( pdu.data == std::vector< std::uint8_t >( expected ) )
+                    ++result;
+            }
+        }
+
+        return result;
+    }
+
+    // number of transmitted PDUs with payload and the given LLID
+    std::size_t transmitted_with_payload( std::uint8_t llid ) const
+    {
+        std::size_t result = 0;
+
+        for ( const auto& event : connection_events() )
+        {
+            for ( const auto& pdu : event.transmitted_data )
+            {
+                if ( ( pdu[ 0 ] & 0x03 ) == llid && pdu[ 1 ] != 0 )
+                    ++result;
+            }
+        }
+
+        return result;
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( encryption_is_started_in_software, link_layer_with_software_encryption )
+{
+    run();
+
+    // LL_START_ENC_RSP, packet counter 0
+    BOOST_CHECK_EQUAL( transmitted( {
+        0x03, 0x05,
+        0xA3, 0x4C, 0x13, 0xA4, 0x15
+    } ), 1u );
+
+    check_connection_events(
+        []( const test::connection_event& evt ) -> bool {
+            return !evt.transmit_encryption_at_start_of_event
+                || std::all_of( evt.transmitted_data.begin(), evt.transmitted_data.end(), []( const test::pdu_t& pdu ) {
+                    return pdu.encrypted;
+                } );
+        },
+        "all PDUs have to be transmitted encrypted"
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( encrypted_request_gets_encrypted_response, link_layer_with_software_encryption )
+{
+    // Read Request, handle 3, packet counter 1
+    add_connection_event_respond( {
+        0x02, 0x0B,
+        0x6E, 0x70, 0xB1, 0x00, 0x7A, 0x47, 0x0A, 0x97, 0xB5, 0xCF, 0x93
+    } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    // Read Response, 0x1234, packet counter 1
+    BOOST_CHECK_EQUAL( transmitted( {
+        0x02, 0x0B,
+        0xE7, 0x88, 0xB2, 0xD1, 0x83, 0x94, 0xE8, 0x28, 0x84, 0xE9, 0x47
+    } ), 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( pdu_with_invalid_mic_is_not_received, link_layer_with_software_encryption )
+{
+    // Read Request, handle 3, packet counter 1, last octet of the MIC altered
+    add_connection_event_respond( {
+        0x02, 0x0B,
+        0x6E, 0x70, 0xB1, 0x00, 0x7A, 0x47, 0x0A, 0x97, 0xB5, 0xCF, 0x94
+    } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    BOOST_CHECK_EQUAL( transmitted_with_payload( 0x02 ), 0u );
+}
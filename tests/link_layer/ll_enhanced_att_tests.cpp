@@ -0,0 +1,303 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "connected.hpp"
+
+namespace {
+    std::uint8_t temperature = 0x11;
+    std::uint8_t humidity    = 0x22;
+    std::uint8_t history[ 100 ];
+
+    using eatt_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::bind_characteristic_value< std::uint8_t, &temperature >,
+                bluetoe::no_write_access,
+                bluetoe::indicate
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0002 >,
+                bluetoe::bind_characteristic_value< std::uint8_t, &humidity >,
+                bluetoe::no_write_access,
+                bluetoe::indicate
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0003 >,
+                bluetoe::bind_characteristic_value< decltype( history ), &history >,
+                bluetoe::no_write_access
+            >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers,
+        bluetoe::gatt_caching,
+        bluetoe::enhanced_att< 1, 100 >
+    >;
+
+    /*
+     * security manager, that knows the long term key of every remote device
+     */
+    struct known_key_security_manager
+    {
+        template < class OtherConnectionData >
+        class connection_data : public OtherConnectionData
+        {
+        public:
+            template < class ... Args >
+            connection_data( Args&&... args )
+                : OtherConnectionData( args... )
+            {}
+
+            std::pair< bool, bluetoe::details::uint128_t > find_key( std::uint16_t, std::uint64_t ) const
+            {
+                return { true, { { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10 } } };
+            }
+
+            void remote_connection_created( const bluetoe::link_layer::device_address& remote )
+            {
+                remote_addr_ = remote;
+            }
+
+            const bluetoe::link_layer::device_address& remote_address() const
+            {
+                return remote_addr_;
+            }
+
+            bluetoe::device_pairing_status local_device_pairing_status() const
+            {
+                return bluetoe::device_pairing_status::unauthenticated_key;
+            }
+
+        private:
+            bluetoe::link_layer::device_address remote_addr_;
+        };
+
+        template < class OtherConnectionData, class SecurityFunctions >
+        void l2cap_input( const std::uint8_t*, std::size_t, std::uint8_t*, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& )
+        {
+            out_size = 0;
+        }
+
+        template < class OtherConnectionData, class SecurityFunctions >
+        void l2cap_output( std::uint8_t*, std::size_t& out_size, connection_data< OtherConnectionData >&, SecurityFunctions& )
+        {
+            out_size = 0;
+        }
+
+        template < class OtherConnectionData, class SecurityFunctions >
+        void idle_processing( connection_data< OtherConnectionData >&, SecurityFunctions& )
+        {
+        }
+
+        struct meta_type :
+            bluetoe::details::security_manager_meta_type,
+            bluetoe::link_layer::details::valid_link_layer_option_meta_type {};
+    };
+
+    struct unencrypted_eatt : unconnected_base_t< eatt_server, test::radio_with_encryption,
+        known_key_security_manager, bluetoe::link_layer::max_mtu_size< 64 >, bluetoe::link_layer::buffer_sizes< 400u, 400u > >
+    {
+        unencrypted_eatt()
+        {
+            respond_to( 37, valid_connection_request_pdu );
+        }
+
+        void start_encryption()
+        {
+            ll_control_pdu({
+                0x03,                                   // LL_ENC_REQ
+                0x00, 0x00, 0x00, 0x00,                 // Rand
+                0x00, 0x00, 0x00, 0x00,
+                0x00, 0x00,                             // EDIV
+                0x00, 0x10, 0x20, 0x30,                 // SKDm
+                0x40, 0x50, 0x60, 0x70,
+                0xab, 0xbc, 0x12, 0x34,                 // IVm
+            });
+            ll_empty_pdu();
+            ll_control_pdu({
+                0x06                                    // LL_START_ENC_RSP
+            });
+            ll_empty_pdu();
+        }
+
+        // opens the enhanced bearer
+        void enhanced_credit_based_connection_request()
+        {
+            ll_data_pdu(
+                {
+                    0x0E, 0x00, 0x05, 0x00,
+                    0x17, 0x02, 0x0A, 0x00,
+                    0x27, 0x00,         // SPSM: EATT
+                    0x40, 0x00,         // MTU
+                    0x40, 0x00,         // MPS
+                    0x05, 0x00,         // credits
+                    0x41, 0x00          // source CID
+                } );
+        }
+
+        void run()
+        {
+            for ( int event = 0; event != 4; ++event )
+                base::run( server );
+        }
+
+        eatt_server server;
+    };
+
+    struct connected_eatt : unencrypted_eatt
+    {
+        connected_eatt()
+        {
+            start_encryption();
+            enhanced_credit_based_connection_request();
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( enhanced_bearer_is_accepted, connected_eatt )
+{
+    ll_empty_pdus( 3 );
+    run();
+
+    check_outgoing_l2cap_pdu( {
+        0x0E, 0x00, 0x05, 0x00,
+        0x18, 0x02, 0x0A, 0x00,
+        0x64, 0x00,             // MTU
+        0x40, 0x00,             // MPS
+        0x01, 0x00,             // credits
+        0x00, 0x00,             // result
+        0x40, 0x00              // destination CID
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( enhanced_bearer_requires_encryption, unencrypted_eatt )
+{
+    enhanced_credit_based_connection_request();
+    ll_empty_pdus( 3 );
+    run();
+
+    check_outgoing_l2cap_pdu( {
+        0x0E, 0x00, 0x05, 0x00,
+        0x18, 0x02, 0x0A, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x08, 0x00,             // result: insufficient encryption
+        0x00, 0x00
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( enhanced_bearer_can_not_be_opened_with_le_credit_based_flow_control, unencrypted_eatt )
+{
+    start_encryption();
+    ll_data_pdu(
+        {
+            0x0E, 0x00, 0x05, 0x00,
+            0x14, 0x02, 0x0A, 0x00,
+            0x27, 0x00, 0x41, 0x00, 0x40, 0x00, 0x40, 0x00, 0x05, 0x00
+        } );
+    ll_empty_pdus( 3 );
+    run();
+
+    check_outgoing_l2cap_pdu( {
+        0x0E, 0x00, 0x05, 0x00,
+        0x15, 0x02, 0x0A, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x02, 0x00              // result: SPSM not supported
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( response_is_limited_by_the_mtu_of_the_channel, connected_eatt )
+{
+    ll_data_pdu(
+        {
+            0x05, 0x00, 0x40, 0x00,
+            0x03, 0x00,         // SDU length
+            0x0A, 0x09, 0x00    // Read Request
+        } );
+    ll_empty_pdus( 8 );
+    run();
+
+    check_outgoing_l2cap_pdu( {
+        0x40, 0x00, 0x41, 0x00,
+        0x40, 0x00,             // SDU length: the MTU of the remote device
+        0x0B, test::and_so_on
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( reconfigured_mtu_is_used_by_the_bearer, connected_eatt )
+{
+    ll_data_pdu(
+        {
+            0x0A, 0x00, 0x05, 0x00,
+            0x19, 0x03, 0x06, 0x00,
+            0x50, 0x00,         // MTU
+            0x40, 0x00,         // MPS
+            0x41, 0x00          // destination CID
+        } );
+    ll_empty_pdus( 3 );
+    ll_data_pdu(
+        {
+            0x05, 0x00, 0x40, 0x00,
+            0x03, 0x00,
+            0x0A, 0x09, 0x00
+        } );
+    ll_empty_pdus( 8 );
+    run();
+
+    check_outgoing_l2cap_pdu( {
+        0x06, 0x00, 0x05, 0x00,
+        0x1A, 0x03, 0x02, 0x00,
+        0x00, 0x00              // result: successful
+    } );
+
+    // the first of two K-frames with a MPS of 64
+    check_outgoing_l2cap_pdu( {
+        0x40, 0x00, 0x41, 0x00,
+        0x50, 0x00,             // SDU length: the reconfigured MTU of the remote device
+        0x0B, test::and_so_on
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( request_is_answered_on_the_enhanced_bearer, connected_eatt )
+{
+    ll_data_pdu(
+        {
+            0x05, 0x00, 0x40, 0x00,
+            0x03, 0x00,         // SDU length
+            0x0A, 0x03, 0x00    // Read Request
+        } );
+    ll_empty_pdus( 5 );
+    run();
+
+    check_outgoing_l2cap_pdu( {
+        0x04, 0x00, 0x41, 0x00,
+        0x02, 0x00,
+        0x0B, 0x11              // Read Response
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( indications_are_sent_concurrently_on_all_bearers, connected_eatt )
+{
+    // subscribe to both indications
+    ll_data_pdu( { 0x05, 0x00, 0x04, 0x00, 0x12, 0x04, 0x00, 0x02, 0x00 } );
+    ll_data_pdu( { 0x05, 0x00, 0x04, 0x00, 0x12, 0x07, 0x00, 0x02, 0x00 } );
+    ll_empty_pdus( 3 );
+    ll_function_call( [this](){
+        server.indicate( temperature );
+        server.indicate( humidity );
+        this->wake_up();
+    } );
+    ll_empty_pdus( 5 );
+    run();
+
+    // no confirmation was received, but both indications are sent
+    check_outgoing_l2cap_pdu( {
+        0x04, 0x00, 0x04, 0x00,
+        0x1D, 0x03, 0x00, 0x11
+    } );
+
+    check_outgoing_l2cap_pdu( {
+        0x06, 0x00, 0x41, 0x00,
+        0x04, 0x00,
+        0x1D, 0x06, 0x00, 0x22
+    } );
+}
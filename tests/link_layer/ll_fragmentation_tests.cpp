@@ -0,0 +1,210 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/link_layer.hpp>
+#include <bluetoe/server.hpp>
+#include <test_radio.hpp>
+#include "connected.hpp"
+
+#include <numeric>
+
+namespace {
+    std::uint8_t large_value[ 300 ] = { 0 };
+
+    using large_value_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::bind_characteristic_value< decltype( large_value ), &large_value >,
+                bluetoe::no_write_access
+            >
+        >
+    >;
+
+    using zero_copy_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::bind_characteristic_value< decltype( large_value ), &large_value >,
+                bluetoe::no_write_access,
+                bluetoe::zero_copy_read
+            >
+        >
+    >;
+
+    template < class Server >
+    struct link_layer_with_large_mtu_t : unconnected_base_t<
+        Server,
+        test::radio,
+        bluetoe::link_layer::buffer_sizes< 100u, 100u >,
+        bluetoe::link_layer::max_mtu_size< 512u > >
+    {
+        link_layer_with_large_mtu_t()
+        {
+            std::iota( std::begin( large_value ), std::end( large_value ), 0 );
+
+            this->respond_to( 37, valid_connection_request_pdu );
+        }
+
+        void exchange_mtu()
+        {
+            this->ll_data_pdu( { 0x03, 0x00, 0x04, 0x00, 0x02, 0x00, 0x02 } );
+        }
+
+        // all non-empty PDUs, that where send by the link layer
+        std::vector< std::vector< std::uint8_t > > transmitted_pdus() const
+        {
+            std::vector< std::vector< std::uint8_t > > result;
+
+            for ( const auto& event : this->connection_events() )
+            {
+                for ( const auto& pdu : event.transmitted_data )
+                {
+                    if ( pdu.data.size() > 2 && pdu.data[ 1 ] != 0 )
+                        result.push_back( pdu.data );
+                }
+            }
+
+            return result;
+        }
+
+        // reassembles the transmitted L2CAP PDUs
+        std::vector< std::vector< std::uint8_t > > transmitted_l2cap_pdus() const
+        {
+            std::vector< std::vector< std::uint8_t > > result;
+
+            for ( const auto& pdu : transmitted_pdus() )
+            {
+                const std::uint8_t llid = pdu[ 0 ] & 0x03;
+
+                if ( llid == 0x02 )
+                {
+                    result.push_back( std::vector< std::uint8_t >( pdu.begin() + 2, pdu.end() ) );
+                }
+                else if ( llid == 0x01 )
+                {
+                    BOOST_REQUIRE( !result.empty() );
+                    result.back().insert( result.back().end(), pdu.begin() + 2, pdu.end() );
+                }
+            }
+
+            return result;
+        }
+    };
+
+    using link_layer_with_large_mtu = link_layer_with_large_mtu_t< large_value_server >;
+    using link_layer_with_zero_copy = link_layer_with_large_mtu_t< zero_copy_server >;
+}
+
+BOOST_FIXTURE_TEST_CASE( fragmented_request_is_reassembled, link_layer_with_large_mtu )
+{
+    ll_pdu( 0x02, { 0x03, 0x00, 0x04, 0x00, 0x02 } );
+    ll_pdu( 0x01, { 0x17, 0x00 } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    const auto l2cap = transmitted_l2cap_pdus();
+    BOOST_REQUIRE_EQUAL( l2cap.size(), 1u );
+
+    static const std::uint8_t expected_response[] = {
+        0x03, 0x00, 0x04, 0x00, // l2cap header
+        0x03, 0x00, 0x02        // Exchange MTU Response, server MTU 512
+    };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( l2cap[ 0 ].begin(), l2cap[ 0 ].end(), std::begin( expected_response ), std::end( expected_response ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( continuation_fragment_without_start_is_ignored, link_layer_with_large_mtu )
+{
+    ll_pdu( 0x01, { 0x17, 0x00 } );
+    ll_data_pdu( { 0x03, 0x00, 0x04, 0x00, 0x02, 0x17, 0x00 } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    const auto l2cap = transmitted_l2cap_pdus();
+    BOOST_CHECK_EQUAL( l2cap.size(), 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( l2cap_pdu_larger_than_mtu_disconnects, link_layer_with_large_mtu )
+{
+    ll_pdu( 0x02, { 0x05, 0x02, 0x04, 0x00, 0x02 } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    BOOST_CHECK( transmitted_pdus().empty() );
+    BOOST_CHECK_EQUAL( connection_events().size(), 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( large_response_is_segmented, link_layer_with_large_mtu )
+{
+    exchange_mtu();
+    ll_data_pdu( { 0x03, 0x00, 0x04, 0x00, 0x0A, 0x03, 0x00 } ); // Read Request handle 3
+    ll_empty_pdus( 20 );
+
+    run();
+
+    const auto pdus = transmitted_pdus();
+    BOOST_REQUIRE_GT( pdus.size(), 2u );
+
+    // start fragment followed by continuation fragments
+    BOOST_CHECK_EQUAL( pdus[ 1 ][ 0 ] & 0x03, 0x02 );
+
+    for ( auto pdu = pdus.begin() + 2; pdu != pdus.end(); ++pdu )
+        BOOST_CHECK_EQUAL( ( *pdu )[ 0 ] & 0x03, 0x01 );
+
+    const auto l2cap = transmitted_l2cap_pdus();
+    BOOST_REQUIRE_EQUAL( l2cap.size(), 2u );
+
+    std::vector< std::uint8_t > expected_response = {
+        0x2D, 0x01, 0x04, 0x00, // l2cap header
+        0x0B                    // Read Response
+    };
+    expected_response.insert( expected_response.end(), std::begin( large_value ), std::end( large_value ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( l2cap[ 1 ].begin(), l2cap[ 1 ].end(), expected_response.begin(), expected_response.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( zero_copy_response_is_segmented, link_layer_with_zero_copy )
+{
+    exchange_mtu();
+    ll_data_pdu( { 0x03, 0x00, 0x04, 0x00, 0x0A, 0x03, 0x00 } ); // Read Request handle 3
+    ll_empty_pdus( 20 );
+
+    run();
+
+    const auto l2cap = transmitted_l2cap_pdus();
+    BOOST_REQUIRE_EQUAL( l2cap.size(), 2u );
+
+    std::vector< std::uint8_t > expected_response = {
+        0x2D, 0x01, 0x04, 0x00, // l2cap header
+        0x0B                    // Read Response
+    };
+    expected_response.insert( expected_response.end(), std::begin( large_value ), std::end( large_value ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( l2cap[ 1 ].begin(), l2cap[ 1 ].end(), expected_response.begin(), expected_response.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( zero_copy_blob_response_is_segmented, link_layer_with_zero_copy )
+{
+    exchange_mtu();
+    ll_data_pdu( { 0x05, 0x00, 0x04, 0x00, 0x0C, 0x03, 0x00, 0x64, 0x00 } ); // Read Blob Request handle 3, offset 100
+    ll_empty_pdus( 20 );
+
+    run();
+
+    const auto l2cap = transmitted_l2cap_pdus();
+    BOOST_REQUIRE_EQUAL( l2cap.size(), 2u );
+
+    std::vector< std::uint8_t > expected_response = {
+        0xC9, 0x00, 0x04, 0x00, // l2cap header
+        0x0D                    // Read Blob Response
+    };
+    expected_response.insert( expected_response.end(), std::begin( large_value ) + 100, std::end( large_value ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( l2cap[ 1 ].begin(), l2cap[ 1 ].end(), expected_response.begin(), expected_response.end() );
+}
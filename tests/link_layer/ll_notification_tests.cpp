@@ -0,0 +1,236 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "connected.hpp"
+
+namespace {
+    std::uint8_t value_a = 0x0a;
+    std::uint8_t value_b = 0x0b;
+    std::uint8_t value_c = 0x0c;
+
+    template < typename ... ServerOptions >
+    using notifying_server_t = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::bind_characteristic_value< decltype( value_a ), &value_a >,
+                bluetoe::notify
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0002 >,
+                bluetoe::bind_characteristic_value< decltype( value_b ), &value_b >,
+                bluetoe::notify
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0003 >,
+                bluetoe::bind_characteristic_value< decltype( value_c ), &value_c >,
+                bluetoe::notify
+            >
+        >,
+        ServerOptions...
+    >;
+
+    using notifying_server = notifying_server_t<>;
+
+    template < typename Server, typename ... Options >
+    struct link_layer_with_notifications_t : unconnected_base_t<
+        Server,
+        test::radio,
+        bluetoe::link_layer::buffer_sizes< 200u, 200u >,
+        Options... >
+    {
+        // client_features are written to the Client Supported Features characteristic (handle 0x0D), if not 0
+        explicit link_layer_with_notifications_t( std::initializer_list< std::uint8_t > cccd_handles = { 0x04, 0x07, 0x0A }, std::uint8_t client_features = 0 )
+        {
+            this->respond_to( 37, valid_connection_request_pdu );
+
+            for ( const std::uint8_t cccd_handle : cccd_handles )
+                this->ll_data_pdu( { 0x05, 0x00, 0x04, 0x00, 0x12, cccd_handle, 0x00, 0x01, 0x00 } );
+
+            if ( client_features )
+                this->ll_data_pdu( { 0x04, 0x00, 0x04, 0x00, 0x12, 0x0D, 0x00, client_features } );
+
+            this->ll_function_call( [this]() {
+                server.notify( value_a );
+                server.notify( value_b );
+                server.notify( value_c );
+                this->wake_up();
+            } );
+
+            // let run() return after every connection event, like on real hardware
+            for ( int event = 0; event != event_count; ++event )
+                this->ll_function_call( [this]() { this->wake_up(); } );
+        }
+
+        void run()
+        {
+            for ( int event = 0; event != event_count + 1; ++event )
+                this->base::run( server );
+        }
+
+        static constexpr int event_count = 5;
+
+        // all transmitted, non empty PDUs, by connection event
+        std::vector< std::vector< std::vector< std::uint8_t > > > transmitted_pdus() const
+        {
+            static constexpr std::uint8_t sn_flag = 0x08;
+
+            std::vector< std::vector< std::vector< std::uint8_t > > > result;
+            int last_sequence_number = -1;
+
+            for ( const auto& event : this->connection_events() )
+            {
+                result.push_back( std::vector< std::vector< std::uint8_t > >() );
+
+                for ( const auto& pdu : event.transmitted_data )
+                {
+                    // retransmissions do not count
+                    const int  sequence_number = pdu.data[ 0 ] & sn_flag;
+                    const bool retransmission  = sequence_number == last_sequence_number;
+                    last_sequence_number = sequence_number;
+
+                    if ( !retransmission && pdu.data[ 1 ] != 0 )
+                        result.back().push_back( pdu.data );
+                }
+            }
+
+            return result;
+        }
+
+        // the ATT values of all notifications, by connection event; events without notifications are not listed
+        std::vector< std::vector< std::uint8_t > > notified_values() const
+        {
+            std::vector< std::vector< std::uint8_t > > result;
+
+            for ( const auto& event : transmitted_pdus() )
+            {
+                std::vector< std::uint8_t > values;
+
+                for ( const auto& pdu : event )
+                {
+                    if ( pdu.size() == 2 + 4 + 4 && pdu[ 6 ] == 0x1B )
+                        values.push_back( pdu.back() );
+                }
+
+                if ( !values.empty() )
+                    result.push_back( values );
+            }
+
+            return result;
+        }
+
+        // the ATT PDUs of all transmitted notifications
+        std::vector< std::vector< std::uint8_t > > notifications() const
+        {
+            std::vector< std::vector< std::uint8_t > > result;
+
+            for ( const auto& event : transmitted_pdus() )
+            {
+                for ( const auto& pdu : event )
+                {
+                    if ( pdu.size() > 6 && ( pdu[ 6 ] == 0x1B || pdu[ 6 ] == 0x23 ) )
+                        result.push_back( std::vector< std::uint8_t >( pdu.begin() + 6, pdu.end() ) );
+                }
+            }
+
+            return result;
+        }
+
+        Server server;
+    };
+
+    template < typename ... Options >
+    using link_layer_with_notifications = link_layer_with_notifications_t< notifying_server, Options... >;
+
+    using multiple_notifications_server = notifying_server_t<
+        bluetoe::multiple_handle_value_notifications,
+        bluetoe::gatt_caching,
+        bluetoe::no_gap_service_for_gatt_servers >;
+
+    static constexpr std::uint8_t multiple_notifications_feature = 0x04;
+
+    struct link_layer_with_multiple_notifications : link_layer_with_notifications_t< multiple_notifications_server >
+    {
+        link_layer_with_multiple_notifications()
+            : link_layer_with_notifications_t< multiple_notifications_server >( { 0x04, 0x07, 0x0A }, multiple_notifications_feature )
+        {
+        }
+    };
+
+    struct link_layer_without_client_support : link_layer_with_notifications_t< multiple_notifications_server >
+    {
+    };
+
+    struct link_layer_with_single_subscription : link_layer_with_notifications_t< multiple_notifications_server >
+    {
+        link_layer_with_single_subscription()
+            : link_layer_with_notifications_t< multiple_notifications_server >( { 0x04 }, multiple_notifications_feature )
+        {
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( one_notification_per_event_by_default, link_layer_with_notifications<> )
+{
+    run();
+
+    const std::vector< std::vector< std::uint8_t > > expected = { { 0x0a }, { 0x0b }, { 0x0c } };
+    BOOST_CHECK( notified_values() == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( all_notifications_in_one_event, link_layer_with_notifications< bluetoe::link_layer::multiple_notifications_per_event<> > )
+{
+    run();
+
+    const std::vector< std::vector< std::uint8_t > > expected = { { 0x0a, 0x0b, 0x0c } };
+    BOOST_CHECK( notified_values() == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( notifications_per_event_are_limited, link_layer_with_notifications< bluetoe::link_layer::multiple_notifications_per_event< 2 > > )
+{
+    run();
+
+    const std::vector< std::vector< std::uint8_t > > expected = { { 0x0a, 0x0b }, { 0x0c } };
+    BOOST_CHECK( notified_values() == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( notifications_are_combined, link_layer_with_multiple_notifications )
+{
+    run();
+
+    const std::vector< std::vector< std::uint8_t > > expected = {
+        {
+            0x23,                                       // Multiple Handle Value Notification
+            0x03, 0x00, 0x01, 0x00, 0x0a,               // handle, length, value
+            0x06, 0x00, 0x01, 0x00, 0x0b,
+            0x09, 0x00, 0x01, 0x00, 0x0c
+        }
+    };
+
+    BOOST_CHECK( notifications() == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( notifications_are_not_combined_without_client_support, link_layer_without_client_support )
+{
+    run();
+
+    const std::vector< std::vector< std::uint8_t > > expected = {
+        { 0x1B, 0x03, 0x00, 0x0a },
+        { 0x1B, 0x06, 0x00, 0x0b },
+        { 0x1B, 0x09, 0x00, 0x0c }
+    };
+
+    BOOST_CHECK( notifications() == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( single_notification_is_not_combined, link_layer_with_single_subscription )
+{
+    run();
+
+    const std::vector< std::vector< std::uint8_t > > expected = {
+        { 0x1B, 0x03, 0x00, 0x0a }
+    };
+
+    BOOST_CHECK( notifications() == expected );
+}
@@ -0,0 +1,201 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "connected.hpp"
+
+namespace {
+    struct unconnected_with_2mbit : unconnected_base_t< test::small_temperature_service, test::radio_with_2mbit, test::buffer_sizes >
+    {
+        // all non-empty PDUs of the given connection event
+        std::vector< std::vector< std::uint8_t > > transmitted_pdus( std::size_t event ) const
+        {
+            std::vector< std::vector< std::uint8_t > > result;
+
+            for ( const auto& pdu : connection_events().at( event ).transmitted_data )
+            {
+                if ( pdu.data.size() > 2 && pdu.data[ 1 ] != 0 )
+                {
+                    result.push_back( pdu.data );
+                    result.back()[ 0 ] &= 0x03;
+                }
+            }
+
+            return result;
+        }
+
+        void phy_update_indication( std::uint8_t m_to_s, std::uint8_t s_to_m, std::uint16_t instant )
+        {
+            ll_control_pdu( {
+                0x18,               // LL_PHY_UPDATE_IND
+                m_to_s, s_to_m,
+                static_cast< std::uint8_t >( instant ), static_cast< std::uint8_t >( instant >> 8 )
+            } );
+        }
+    };
+
+    using bluetoe::link_layer::details::phy_ll_encoding::le_1m_phy;
+    using bluetoe::link_layer::details::phy_ll_encoding::le_2m_phy;
+}
+
+BOOST_FIXTURE_TEST_CASE( phy_request_not_supported_by_default, unconnected )
+{
+    check_single_ll_control_pdu(
+        {
+            0x03, 0x03,
+            0x16,               // LL_PHY_REQ
+            0x02, 0x02
+        },
+        {
+            0x03, 0x02,
+            0x07, 0x16          // LL_UNKNOWN_RSP
+        },
+        "phy_request_not_supported_by_default"
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE( le_2m_phy_is_announced_as_feature, unconnected_with_2mbit )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_control_pdu( {
+        0x08,               // LL_FEATURE_REQ
+        0xff, 0xff, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00
+    } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    static const std::uint8_t expected_response[] = {
+        0x03, 0x09,
+        0x09,               // LL_FEATURE_RSP
+        0x12, 0x01, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00
+    };
+
+    const auto pdus = transmitted_pdus( 1 );
+    BOOST_REQUIRE( !pdus.empty() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( pdus[ 0 ].begin(), pdus[ 0 ].end(), std::begin( expected_response ), std::end( expected_response ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( initiates_phy_update, unconnected_with_2mbit )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    static const std::uint8_t expected_request[] = {
+        0x03, 0x03,
+        0x16,               // LL_PHY_REQ
+        0x02, 0x02          // prefer LE 2M in both directions
+    };
+
+    const auto pdus = transmitted_pdus( 1 );
+    BOOST_REQUIRE_EQUAL( pdus.size(), 1u );
+    BOOST_CHECK_EQUAL_COLLECTIONS( pdus[ 0 ].begin(), pdus[ 0 ].end(), std::begin( expected_request ), std::end( expected_request ) );
+    BOOST_CHECK( transmitted_pdus( 2 ).empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( respond_to_phy_request, unconnected_with_2mbit )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_control_pdu( {
+        0x16,               // LL_PHY_REQ
+        0x03, 0x02
+    } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    static const std::uint8_t expected_response[] = {
+        0x03, 0x03,
+        0x17,               // LL_PHY_RSP
+        0x03, 0x03          // 1M and 2M in both directions
+    };
+
+    // the response makes the link layer initiated procedure obsolete
+    const auto pdus = transmitted_pdus( 1 );
+    BOOST_REQUIRE_EQUAL( pdus.size(), 1u );
+    BOOST_CHECK_EQUAL_COLLECTIONS( pdus[ 0 ].begin(), pdus[ 0 ].end(), std::begin( expected_response ), std::end( expected_response ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( phy_is_changed_at_the_instant, unconnected_with_2mbit )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_empty_pdus( 2 );
+    phy_update_indication( 0x02, 0x02, 6 );
+    ll_empty_pdus( 10 );
+
+    run();
+
+    // the second change restores LE 1M, when the simulated connection times out
+    BOOST_REQUIRE_EQUAL( phy_changes().size(), 2u );
+    BOOST_CHECK_EQUAL( phy_changes()[ 0 ].connection_event, 6u );
+    BOOST_CHECK_EQUAL( phy_changes()[ 0 ].receiving_phy, le_2m_phy );
+    BOOST_CHECK_EQUAL( phy_changes()[ 0 ].transmitting_phy, le_2m_phy );
+
+    BOOST_CHECK_GT( connection_events().size(), 10u );
+}
+
+BOOST_FIXTURE_TEST_CASE( phy_can_be_changed_in_one_direction_only, unconnected_with_2mbit )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_empty_pdus( 2 );
+    phy_update_indication( 0x00, 0x02, 6 );
+    ll_empty_pdus( 10 );
+
+    run();
+
+    BOOST_REQUIRE_EQUAL( phy_changes().size(), 2u );
+    BOOST_CHECK_EQUAL( phy_changes()[ 0 ].receiving_phy, le_1m_phy );
+    BOOST_CHECK_EQUAL( phy_changes()[ 0 ].transmitting_phy, le_2m_phy );
+}
+
+BOOST_FIXTURE_TEST_CASE( update_without_change_is_ignored, unconnected_with_2mbit )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_empty_pdus( 2 );
+    phy_update_indication( 0x00, 0x00, 0 );
+    ll_empty_pdus( 10 );
+
+    run();
+
+    BOOST_CHECK( phy_changes().empty() );
+    BOOST_CHECK_GT( connection_events().size(), 10u );
+}
+
+BOOST_FIXTURE_TEST_CASE( instant_in_the_past_disconnects, unconnected_with_2mbit )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_empty_pdus( 2 );
+    phy_update_indication( 0x02, 0x02, 1 );
+    ll_empty_pdus( 10 );
+
+    run();
+
+    BOOST_CHECK( phy_changes().empty() );
+    BOOST_CHECK_EQUAL( connection_events().size(), 3u );
+}
+
+BOOST_FIXTURE_TEST_CASE( le_1m_phy_is_restored_after_disconnect, unconnected_with_2mbit )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_empty_pdus( 2 );
+    phy_update_indication( 0x02, 0x02, 6 );
+    ll_empty_pdus( 6 );
+    ll_control_pdu( {
+        0x02,               // LL_TERMINATE_IND
+        0x13
+    } );
+
+    run();
+
+    BOOST_REQUIRE_EQUAL( phy_changes().size(), 2u );
+    BOOST_CHECK_EQUAL( phy_changes()[ 0 ].receiving_phy, le_2m_phy );
+    BOOST_CHECK_EQUAL( phy_changes()[ 1 ].receiving_phy, le_1m_phy );
+    BOOST_CHECK_EQUAL( phy_changes()[ 1 ].transmitting_phy, le_1m_phy );
+    BOOST_CHECK_LE( phy_changes()[ 1 ].connection_event, 10u );
+
+    // advertising and the next connection start on LE 1M
+    BOOST_CHECK_GT( advertisings().size(), 1u );
+}
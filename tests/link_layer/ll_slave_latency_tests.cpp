@@ -0,0 +1,177 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include "connected.hpp"
+
+namespace {
+    std::uint8_t value = 0x42;
+
+    using notifying_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x1234 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x0001 >,
+                bluetoe::bind_characteristic_value< decltype( value ), &value >,
+                bluetoe::notify
+            >
+        >
+    >;
+
+    /*
+     * connection request with an interval of 30ms, a slave latency of 3 and a timeout of 720ms
+     */
+    const std::initializer_list< std::uint8_t > connection_request_with_latency =
+    {
+        0xc5, 0x22,                         // header
+        0x3c, 0x1c, 0x62, 0x92, 0xf0, 0x48, // InitA: 48:f0:92:62:1c:3c (random)
+        0x47, 0x11, 0x08, 0x15, 0x0f, 0xc0, // AdvA:  c0:0f:15:08:11:47 (random)
+        0x5a, 0xb3, 0x9a, 0xaf,             // Access Address
+        0x08, 0x81, 0xf6,                   // CRC Init
+        0x03,                               // transmit window size
+        0x0b, 0x00,                         // window offset
+        0x18, 0x00,                         // interval (30ms)
+        0x03, 0x00,                         // slave latency
+        0x48, 0x00,                         // connection timeout (720ms)
+        0xff, 0xff, 0xff, 0xff, 0x1f,       // used channel map
+        0xaa                                // hop increment and sleep clock accuracy (10 and 50ppm)
+    };
+
+    template < template < std::size_t, std::size_t, typename > class Radio >
+    struct connected_with_latency_t : unconnected_base_t<
+        notifying_server,
+        Radio,
+        bluetoe::link_layer::buffer_sizes< 200u, 200u > >
+    {
+        connected_with_latency_t()
+        {
+            this->respond_to( 37, connection_request_with_latency );
+        }
+
+        void run()
+        {
+            this->base::run( server );
+        }
+
+        // the distance of the expected connection event to the last anchor
+        bluetoe::link_layer::delta_time event_distance( std::size_t event ) const
+        {
+            const auto& scheduled = this->connection_events().at( event );
+
+            return bluetoe::link_layer::delta_time( ( scheduled.start_receive.usec() + scheduled.end_receive.usec() ) / 2 );
+        }
+
+        bluetoe::link_layer::delta_time window_size( std::size_t event ) const
+        {
+            const auto& scheduled = this->connection_events().at( event );
+
+            return scheduled.end_receive - scheduled.start_receive;
+        }
+
+        notifying_server server;
+    };
+
+    using connected_with_latency    = connected_with_latency_t< test::radio_with_slave_latency >;
+    using connected_without_latency = connected_with_latency_t< test::radio >;
+
+    const bluetoe::link_layer::delta_time interval = bluetoe::link_layer::delta_time::msec( 30 );
+
+    // master with 50ppm and link layer with the default of 500ppm
+    const unsigned cumulated_sleep_clock_accuracy = 550;
+}
+
+BOOST_FIXTURE_TEST_CASE( no_events_are_skipped_without_support_by_the_radio, connected_without_latency )
+{
+    ll_empty_pdus( 5 );
+    run();
+
+    BOOST_REQUIRE_GE( connection_events().size(), 5u );
+
+    for ( std::size_t event = 1; event != 5; ++event )
+        BOOST_CHECK_EQUAL( event_distance( event ), interval );
+}
+
+BOOST_FIXTURE_TEST_CASE( idle_connection_events_are_skipped, connected_with_latency )
+{
+    ll_empty_pdus( 5 );
+    run();
+
+    BOOST_REQUIRE_GE( connection_events().size(), 5u );
+
+    for ( std::size_t event = 1; event != 5; ++event )
+        BOOST_CHECK_EQUAL( event_distance( event ), interval * 4 );
+}
+
+BOOST_FIXTURE_TEST_CASE( window_widening_covers_the_skipped_events, connected_with_latency )
+{
+    ll_empty_pdus( 2 );
+    run();
+
+    BOOST_REQUIRE_GE( connection_events().size(), 2u );
+    BOOST_CHECK_EQUAL( window_size( 1 ), ( interval * 4 ).ppm( cumulated_sleep_clock_accuracy ) * 2 );
+}
+
+BOOST_AUTO_TEST_CASE( skipped_events_keep_the_channel_hopping )
+{
+    connected_without_latency without_latency;
+    without_latency.ll_empty_pdus( 9 );
+    without_latency.run();
+
+    connected_with_latency with_latency;
+    with_latency.ll_empty_pdus( 3 );
+    with_latency.run();
+
+    BOOST_REQUIRE_GE( without_latency.connection_events().size(), 9u );
+    BOOST_REQUIRE_GE( with_latency.connection_events().size(), 3u );
+
+    BOOST_CHECK_EQUAL( with_latency.connection_events()[ 1 ].channel, without_latency.connection_events()[ 4 ].channel );
+    BOOST_CHECK_EQUAL( with_latency.connection_events()[ 2 ].channel, without_latency.connection_events()[ 8 ].channel );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_events_are_skipped_while_data_is_pending, connected_with_latency )
+{
+    ll_empty_pdu();
+    ll_control_pdu( {
+        0x12                // LL_PING_REQ
+    } );
+    ll_empty_pdus( 3 );
+    run();
+
+    BOOST_REQUIRE_GE( connection_events().size(), 5u );
+
+    // the response to the ping is transmitted and acknowledged in the next two events
+    BOOST_CHECK_EQUAL( event_distance( 1 ), interval * 4 );
+    BOOST_CHECK_EQUAL( event_distance( 2 ), interval );
+    BOOST_CHECK_EQUAL( event_distance( 3 ), interval );
+    BOOST_CHECK_EQUAL( event_distance( 4 ), interval * 4 );
+}
+
+BOOST_FIXTURE_TEST_CASE( notification_ends_the_skipping_of_events, connected_with_latency )
+{
+    // subscribe and let run() return, after the write response was acknowledged
+    ll_data_pdu( { 0x05, 0x00, 0x04, 0x00, 0x12, 0x04, 0x00, 0x01, 0x00 } );
+    ll_empty_pdu();
+    ll_function_call( [this](){ this->wake_up(); } );
+    ll_empty_pdus( 3 );
+    run();
+
+    const std::size_t next_event = connection_events().size() - 1;
+    BOOST_CHECK_EQUAL( event_distance( next_event ), interval * 4 );
+
+    // the connection event is not moved from the context of notify()
+    server.notify( value );
+    BOOST_CHECK_EQUAL( event_distance( next_event ), interval * 4 );
+
+    // the first call to run() returns immediately, places the notification in the transmit buffer and moves the event
+    run();
+    BOOST_CHECK_EQUAL( connection_events().size(), next_event + 1 );
+    BOOST_CHECK_EQUAL( event_distance( next_event ), interval );
+
+    run();
+
+    BOOST_REQUIRE_GT( connection_events().size(), next_event + 1 );
+    const auto& transmitted = connection_events()[ next_event ].transmitted_data;
+
+    BOOST_REQUIRE( !transmitted.empty() );
+    BOOST_CHECK_EQUAL( transmitted.front().data.size(), 2u + 4u + 4u );
+    BOOST_CHECK_EQUAL( transmitted.front().data.back(), value );
+}
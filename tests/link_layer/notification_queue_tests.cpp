@@ -11,6 +11,7 @@ namespace {
 using queue17 = bluetoe::link_layer::notification_queue< std::tuple< std::integral_constant< int, 17u > >, empty_fixture >;
 using queue3 = bluetoe::link_layer::notification_queue< std::tuple< std::integral_constant< int, 3u > >, empty_fixture >;
 using queue8 = bluetoe::link_layer::notification_queue< std::tuple< std::integral_constant< int, 8u > >, empty_fixture >;
+using queue100 = bluetoe::link_layer::notification_queue< std::tuple< std::integral_constant< int, 100u > >, empty_fixture >;
 
 BOOST_AUTO_TEST_SUITE( single_prio_notifications )
 
@@ -72,6 +73,24 @@ BOOST_AUTO_TEST_SUITE( single_prio_notifications )
         BOOST_CHECK( dequeue_indication_or_confirmation().first == entry_type::empty );
     }
 
+    BOOST_FIXTURE_TEST_CASE( round_robin_over_multiple_words, queue100 )
+    {
+        BOOST_CHECK( queue_notification( 99u ) );
+        BOOST_CHECK( queue_notification( 64u ) );
+        BOOST_CHECK( queue_notification( 31u ) );
+        BOOST_CHECK( queue_notification( 32u ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 31u } ) );
+
+        BOOST_CHECK( queue_notification( 0u ) );
+        BOOST_CHECK( queue_notification( 31u ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 32u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 64u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 99u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 0u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 31u } ) );
+        BOOST_CHECK( dequeue_indication_or_confirmation().first == entry_type::empty );
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE( single_prio_indications )
@@ -118,6 +137,20 @@ BOOST_AUTO_TEST_SUITE( single_prio_indications )
         BOOST_CHECK( !queue_indication( 16u ) );
     }
 
+    BOOST_FIXTURE_TEST_CASE( outstanding_confirmation_skips_indications_in_other_words, queue100 )
+    {
+        BOOST_CHECK( queue_indication( 5u ) );
+        BOOST_CHECK( queue_indication( 40u ) );
+        BOOST_CHECK( queue_notification( 90u ) );
+
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::indication, 5u } ) );
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 90u } ) );
+        BOOST_CHECK( dequeue_indication_or_confirmation().first == entry_type::empty );
+
+        indication_confirmed();
+        BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::indication, 40u } ) );
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE( single_prio_clearing )
@@ -148,6 +181,20 @@ BOOST_AUTO_TEST_SUITE( single_prio_clearing )
         BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::indication, 2u } ) );
     }
 
+    BOOST_FIXTURE_TEST_CASE( pending_entries, queue100 )
+    {
+        BOOST_CHECK( !pending() );
+
+        queue_notification( 99u );
+        BOOST_CHECK( pending() );
+
+        dequeue_indication_or_confirmation();
+        BOOST_CHECK( !pending() );
+
+        queue_indication( 40u );
+        BOOST_CHECK( pending() );
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
 
 using queue1 = bluetoe::link_layer::notification_queue< std::tuple< std::integral_constant< int, 1u > >, empty_fixture >;
@@ -247,6 +294,22 @@ BOOST_AUTO_TEST_SUITE( mixed_priorities )
         BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 1 } ) );
         BOOST_CHECK( ( dequeue_indication_or_confirmation()  == std::pair< entry_type, std::size_t >{ entry_type::notification, 2 } ) );
         BOOST_CHECK( ( dequeue_indication_or_confirmation().first == entry_type::empty ) );
+        BOOST_CHECK( !pending() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( pending_in_any_priority, queue1_2 )
+    {
+        BOOST_CHECK( !pending() );
+
+        queue_notification( 2 );
+        BOOST_CHECK( pending() );
+
+        queue_indication( 0 );
+        dequeue_indication_or_confirmation();
+        BOOST_CHECK( pending() );
+
+        dequeue_indication_or_confirmation();
+        BOOST_CHECK( !pending() );
     }
 
     BOOST_FIXTURE_TEST_CASE( outstanding_indication_blocks_new_indiciation, queue1_2 )
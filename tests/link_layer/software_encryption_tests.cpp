@@ -0,0 +1,202 @@
+#include <bluetoe/software_encryption.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    // converts a value from the notation of the specification (most significant octet first) into little endian
+    bluetoe::details::uint128_t le( std::string hex )
+    {
+        hex.erase( std::remove( hex.begin(), hex.end(), ' ' ), hex.end() );
+
+        bluetoe::details::uint128_t result;
+        auto out = result.begin();
+
+        for ( std::size_t pos = hex.size(); pos != 0; pos -= 2 )
+            *out++ = static_cast< std::uint8_t >( std::strtoul( hex.substr( pos - 2, 2 ).c_str(), nullptr, 16 ) );
+
+        return result;
+    }
+
+    /*
+     * "start encryption" sample data from the Core Specification Vol 6, Part C, 1
+     */
+    struct radio : bluetoe::link_layer::software_encryption< radio >
+    {
+        bluetoe::details::uint128_t create_srand()
+        {
+            // SKDs = 0x0213243546576879, IVs = 0xDEAFBABE
+            return le( "00000000 DEAFBABE 02132435 46576879" );
+        }
+    };
+
+    struct encryption_setup : radio
+    {
+        encryption_setup()
+        {
+            const auto slaves_part = setup_encryption( le( "4C68384139F574D836BCF34E9DFB01BF" ), 0xACBDCEDFE0F10213, 0xBADCAB24 );
+
+            BOOST_CHECK_EQUAL( slaves_part.first, 0x0213243546576879u );
+            BOOST_CHECK_EQUAL( slaves_part.second, 0xDEAFBABEu );
+
+            start_receive_encrypted();
+            start_transmit_encrypted();
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE( legacy_confirm_value_sample_data )
+{
+    radio r;
+
+    // Core Specification Vol 3, Part H, 2.2.3
+    const auto confirm = r.c1(
+        le( "00000000000000000000000000000000" ),
+        le( "5783D52156AD6F0E6388274EC6702EE0" ),
+        le( "05000800000302070710000001010001" ),
+        le( "00000000A1A2A3A4A5A6B1B2B3B4B5B6" ) );
+
+    const auto expected = le( "1E1E3FEF878988EAD2A74DC5BEF13B86" );
+    BOOST_CHECK_EQUAL_COLLECTIONS( confirm.begin(), confirm.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( legacy_key_generation_sample_data )
+{
+    radio r;
+
+    // Core Specification Vol 3, Part H, 2.2.4
+    const auto key = r.s1(
+        le( "00000000000000000000000000000000" ),
+        le( "000F0E0D0C0B0A091122334455667788" ),
+        le( "010203040506070899AABBCCDDEEFF00" ) );
+
+    const auto expected = le( "9A1FE1F0E8B0F49B5B4216AE796DA062" );
+    BOOST_CHECK_EQUAL_COLLECTIONS( key.begin(), key.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( not_encrypted_by_default )
+{
+    radio r;
+
+    BOOST_CHECK( !r.receive_encrypted() );
+    BOOST_CHECK( !r.transmit_encrypted() );
+}
+
+BOOST_FIXTURE_TEST_CASE( start_and_stop_encryption, encryption_setup )
+{
+    BOOST_CHECK( receive_encrypted() );
+    BOOST_CHECK( transmit_encrypted() );
+
+    stop_receive_encrypted();
+    BOOST_CHECK( !receive_encrypted() );
+    BOOST_CHECK( transmit_encrypted() );
+
+    stop_transmit_encrypted();
+    BOOST_CHECK( !transmit_encrypted() );
+}
+
+BOOST_FIXTURE_TEST_CASE( decrypt_sample_data, encryption_setup )
+{
+    // LL_START_ENC_RSP1, packet counter 0, master to slave
+    std::uint8_t payload[] = { 0x9F, 0xCD, 0xA7, 0xF4, 0x48 };
+
+    BOOST_CHECK( decrypt_received_pdu( 0x0F, payload, sizeof( payload ) ) );
+    BOOST_CHECK_EQUAL( payload[ 0 ], 0x06 );
+}
+
+BOOST_FIXTURE_TEST_CASE( encrypt_sample_data, encryption_setup )
+{
+    // LL_START_ENC_RSP2, packet counter 0, slave to master
+    std::uint8_t payload[ 1 + mic_size ] = { 0x06 };
+    const std::uint8_t expected[] = { 0xA3, 0x4C, 0x13, 0xA4, 0x15 };
+
+    encrypt_transmitted_pdu( 0x07, payload, 1 );
+    BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( payload ), std::end( payload ), std::begin( expected ), std::end( expected ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( nesn_sn_and_md_are_not_authenticated, encryption_setup )
+{
+    std::uint8_t payload[] = { 0x9F, 0xCD, 0xA7, 0xF4, 0x48 };
+
+    BOOST_CHECK( decrypt_received_pdu( 0x03 | 0x1C, payload, sizeof( payload ) ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( invalid_mic_is_detected, encryption_setup )
+{
+    std::uint8_t payload[] = { 0x9F, 0xCD, 0xA7, 0xF4, 0x49 };
+    BOOST_CHECK( !decrypt_received_pdu( 0x0F, payload, sizeof( payload ) ) );
+
+    // the packet counter is not incremented by an invalid PDU
+    std::uint8_t valid[] = { 0x9F, 0xCD, 0xA7, 0xF4, 0x48 };
+    BOOST_CHECK( decrypt_received_pdu( 0x0F, valid, sizeof( valid ) ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( modified_llid_is_detected, encryption_setup )
+{
+    std::uint8_t payload[] = { 0x9F, 0xCD, 0xA7, 0xF4, 0x48 };
+
+    BOOST_CHECK( !decrypt_received_pdu( 0x0E, payload, sizeof( payload ) ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( empty_pdus_are_not_encrypted, encryption_setup )
+{
+    std::uint8_t payload[ mic_size ] = { 0 };
+
+    encrypt_transmitted_pdu( 0x01, payload, 0 );
+    BOOST_CHECK( decrypt_received_pdu( 0x01, payload, 0 ) );
+
+    // and do not count
+    std::uint8_t valid[] = { 0x9F, 0xCD, 0xA7, 0xF4, 0x48 };
+    BOOST_CHECK( decrypt_received_pdu( 0x0F, valid, sizeof( valid ) ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( packet_counter_is_incremented, encryption_setup )
+{
+    std::uint8_t first[ 1 + mic_size ] = { 0x06 };
+    std::uint8_t second[ 1 + mic_size ] = { 0x06 };
+
+    encrypt_transmitted_pdu( 0x07, first, 1 );
+    encrypt_transmitted_pdu( 0x07, second, 1 );
+
+    BOOST_CHECK( !std::equal( std::begin( first ), std::end( first ), std::begin( second ) ) );
+
+    // restarting the encryption resets the counter
+    start_transmit_encrypted();
+    encrypt_transmitted_pdu( 0x07, second, 0 );
+
+    std::uint8_t third[ 1 + mic_size ] = { 0x06 };
+    encrypt_transmitted_pdu( 0x07, third, 1 );
+    BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( first ), std::end( first ), std::begin( third ), std::end( third ) );
+}
+
+BOOST_AUTO_TEST_CASE( maximum_pdu_size_round_trip )
+{
+    const auto key = le( "99AD1B5226A37E3E058E3B8E27C2C666" );
+    const bluetoe::link_layer::details::ll_ccm ccm( key.data(), 0xDEAFBABEBADCAB24 );
+
+    std::vector< std::uint8_t > plain( 251 );
+    for ( std::size_t i = 0; i != plain.size(); ++i )
+        plain[ i ] = static_cast< std::uint8_t >( i * 7 );
+
+    std::vector< std::uint8_t > pdu( plain );
+    pdu.resize( plain.size() + bluetoe::link_layer::details::ll_ccm::mic_size );
+
+    ccm.encrypt( 0x7fffffffff, true, 0x02, pdu.data(), plain.size() );
+    BOOST_CHECK( !std::equal( plain.begin(), plain.end(), pdu.begin() ) );
+
+    // different counter, direction or header
+    std::vector< std::uint8_t > copy( pdu );
+    BOOST_CHECK( !ccm.decrypt( 0x7ffffffffe, true, 0x02, copy.data(), copy.size() ) );
+    copy = pdu;
+    BOOST_CHECK( !ccm.decrypt( 0x7fffffffff, false, 0x02, copy.data(), copy.size() ) );
+    copy = pdu;
+    BOOST_CHECK( !ccm.decrypt( 0x7fffffffff, true, 0x01, copy.data(), copy.size() ) );
+
+    BOOST_CHECK( ccm.decrypt( 0x7fffffffff, true, 0x02, pdu.data(), pdu.size() ) );
+    BOOST_CHECK_EQUAL_COLLECTIONS( plain.begin(), plain.end(), pdu.begin(), pdu.begin() + plain.size() );
+}
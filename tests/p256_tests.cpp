@@ -0,0 +1,110 @@
+#include <bluetoe/p256.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    using p256 = bluetoe::details::p256;
+
+    // converts a value from the notation of the specification (most significant octet first) into little endian
+    std::vector< std::uint8_t > le( std::string hex )
+    {
+        hex.erase( std::remove( hex.begin(), hex.end(), ' ' ), hex.end() );
+
+        std::vector< std::uint8_t > result;
+
+        for ( std::size_t pos = hex.size(); pos != 0; pos -= 2 )
+            result.push_back( static_cast< std::uint8_t >( std::strtoul( hex.substr( pos - 2, 2 ).c_str(), nullptr, 16 ) ) );
+
+        return result;
+    }
+
+    std::vector< std::uint8_t > public_key( const std::string& x, const std::string& y )
+    {
+        std::vector< std::uint8_t > result = le( x );
+        const std::vector< std::uint8_t > y_ = le( y );
+        result.insert( result.end(), y_.begin(), y_.end() );
+
+        return result;
+    }
+
+    // P-256 sample data from the Core Specification Vol 3, Part H, Appendix D.1
+    const auto private_a = le( "3f49f6d4 a3c55f38 74c9b3e3 d2103f50 4aff607b eb40b799 5899b8a6 cd3c1abd" );
+    const auto private_b = le( "55188b3d 32f6bb9a 900afcfb eed4e72a 59cb9ac2 f19d7cfb 6b4fdd49 f47fc5fd" );
+
+    const auto public_a = public_key(
+        "20b003d2 f297be2c 5e2c83a7 e9f9a5b9 eff49111 acf4fddb cc030148 0e359de6",
+        "dc809c49 652aeb6d 63329abf 5a52155c 766345c2 8fed3024 741c8ed0 1589d28b" );
+
+    const auto public_b = public_key(
+        "1ea1f0f0 1faf1d96 09592284 f19e4c00 47b58afd 8615a69f 559077b2 2faaa190",
+        "4c55f33e 429dad37 7356703a 9ab85160 472d1130 e28e3676 5f89aff9 15b1214a" );
+
+    const auto dh_key = le( "ec0234a3 57c8ad05 341010a6 0a397d9b 99796b13 b4f866f1 868d34f3 73bfa698" );
+
+    const auto order = le( "ffffffff 00000000 ffffffff ffffffff bce6faad a7179e84 f3b9cac2 fc632551" );
+}
+
+BOOST_AUTO_TEST_CASE( public_key_from_private_key )
+{
+    std::vector< std::uint8_t > key( p256::public_key_size );
+
+    BOOST_CHECK( p256::public_key( private_a.data(), key.data() ) );
+    BOOST_CHECK_EQUAL_COLLECTIONS( key.begin(), key.end(), public_a.begin(), public_a.end() );
+
+    BOOST_CHECK( p256::public_key( private_b.data(), key.data() ) );
+    BOOST_CHECK_EQUAL_COLLECTIONS( key.begin(), key.end(), public_b.begin(), public_b.end() );
+}
+
+BOOST_AUTO_TEST_CASE( dh_key_sample_data )
+{
+    std::vector< std::uint8_t > key( p256::dh_key_size );
+
+    BOOST_CHECK( p256::dh_key( private_a.data(), public_b.data(), key.data() ) );
+    BOOST_CHECK_EQUAL_COLLECTIONS( key.begin(), key.end(), dh_key.begin(), dh_key.end() );
+
+    BOOST_CHECK( p256::dh_key( private_b.data(), public_a.data(), key.data() ) );
+    BOOST_CHECK_EQUAL_COLLECTIONS( key.begin(), key.end(), dh_key.begin(), dh_key.end() );
+}
+
+BOOST_AUTO_TEST_CASE( private_key_must_be_in_range )
+{
+    std::vector< std::uint8_t > key( p256::public_key_size );
+    const std::vector< std::uint8_t > zero( p256::private_key_size, 0 );
+    const std::vector< std::uint8_t > all_ones( p256::private_key_size, 0xff );
+
+    BOOST_CHECK( !p256::public_key( zero.data(), key.data() ) );
+    BOOST_CHECK( !p256::public_key( order.data(), key.data() ) );
+    BOOST_CHECK( !p256::public_key( all_ones.data(), key.data() ) );
+}
+
+BOOST_AUTO_TEST_CASE( public_keys_are_validated )
+{
+    BOOST_CHECK( p256::is_valid_public_key( public_a.data() ) );
+    BOOST_CHECK( p256::is_valid_public_key( public_b.data() ) );
+
+    auto modified = public_a;
+    modified[ 7 ] ^= 0x01;
+    BOOST_CHECK( !p256::is_valid_public_key( modified.data() ) );
+
+    // x = p is not a valid coordinate
+    const auto outside_of_field = public_key(
+        "ffffffff 00000001 00000000 00000000 00000000 ffffffff ffffffff ffffffff",
+        "dc809c49 652aeb6d 63329abf 5a52155c 766345c2 8fed3024 741c8ed0 1589d28b" );
+    BOOST_CHECK( !p256::is_valid_public_key( outside_of_field.data() ) );
+}
+
+BOOST_AUTO_TEST_CASE( no_dh_key_from_an_invalid_public_key )
+{
+    std::vector< std::uint8_t > key( p256::dh_key_size );
+
+    auto invalid = public_b;
+    invalid[ 40 ] ^= 0x80;
+
+    BOOST_CHECK( !p256::dh_key( private_a.data(), invalid.data(), key.data() ) );
+}
@@ -0,0 +1,102 @@
+#include <bluetoe/crypto_toolbox.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+namespace {
+    /*
+     * converts a value in the notation of the specification sample data (most significant octet first)
+     * into the byte order of the Security Manager Protocol
+     */
+    std::vector< std::uint8_t > le( std::string hex )
+    {
+        hex.erase( std::remove( hex.begin(), hex.end(), ' ' ), hex.end() );
+
+        std::vector< std::uint8_t > result;
+
+        for ( std::size_t pos = hex.size(); pos != 0; pos -= 2 )
+            result.push_back( static_cast< std::uint8_t >( std::strtoul( hex.substr( pos - 2, 2 ).c_str(), nullptr, 16 ) ) );
+
+        return result;
+    }
+
+    const auto n1 = le( "d5cb8454 d177733e ffffb2ec 712baeab" );
+    const auto n2 = le( "a6e8e7cc 25a75f6e 216583f7 ff3dc4cf" );
+    const auto mac_key = le( "2965f176 a1084a02 fd3f6a20 ce636e20" );
+
+    const bluetoe::link_layer::public_device_address a1( { 0xce, 0xbf, 0x37, 0x37, 0x12, 0x56 } );
+    const bluetoe::link_layer::public_device_address a2( { 0xc1, 0xcf, 0x2d, 0x70, 0x13, 0xa7 } );
+}
+
+// Core Specification Vol 3, Part H, Appendix D.2
+BOOST_AUTO_TEST_CASE( f4_sample_data )
+{
+    const auto u = le( "20b003d2 f297be2c 5e2c83a7 e9f9a5b9 eff49111 acf4fddb cc030148 0e359de6" );
+    const auto v = le( "55188b3d 32f6bb9a 900afcfb eed4e72a 59cb9ac2 f19d7cfb 6b4fdd49 f47fc5fd" );
+    const auto expected = le( "f2c916f1 07a9bd1c f1eda1be a974872d" );
+
+    std::vector< std::uint8_t > result( 16 );
+    bluetoe::details::f4( u.data(), v.data(), n1.data(), 0, result.data() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( result.begin(), result.end(), expected.begin(), expected.end() );
+}
+
+// Core Specification Vol 3, Part H, Appendix D.3
+BOOST_AUTO_TEST_CASE( f5_sample_data )
+{
+    const auto w = le( "ec0234a3 57c8ad05 341010a6 0a397d9b 99796b13 b4f866f1 868d34f3 73bfa698" );
+    const auto expected_ltk = le( "69867911 69d7cd23 980522b5 94750a38" );
+
+    std::vector< std::uint8_t > mac( 16 );
+    std::vector< std::uint8_t > ltk( 16 );
+    bluetoe::details::f5( w.data(), n1.data(), n2.data(), a1, a2, mac.data(), ltk.data() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( mac.begin(), mac.end(), mac_key.begin(), mac_key.end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( ltk.begin(), ltk.end(), expected_ltk.begin(), expected_ltk.end() );
+}
+
+// Core Specification Vol 3, Part H, Appendix D.4
+BOOST_AUTO_TEST_CASE( f6_sample_data )
+{
+    const auto r = le( "12a3343b b453bb54 08da42d2 0c2d0fc8" );
+    const auto io_cap = le( "010102" );
+    const auto expected = le( "e3c47398 9cd0e8c5 d26c0b09 da958f61" );
+
+    std::vector< std::uint8_t > result( 16 );
+    bluetoe::details::f6( mac_key.data(), n1.data(), n2.data(), r.data(), io_cap.data(), a1, a2, result.data() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( result.begin(), result.end(), expected.begin(), expected.end() );
+}
+
+// Core Specification Vol 3, Part H, Appendix D.7
+BOOST_AUTO_TEST_CASE( ah_sample_data )
+{
+    const auto irk = le( "ec0234a3 57c8ad05 341010a6 0a397d9b" );
+    const auto prand = le( "708194" );
+    const auto expected = le( "0dfbaa" );
+
+    std::uint8_t result[ 3 ];
+    bluetoe::details::ah( irk.data(), prand.data(), result );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( result ), std::end( result ), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( resolvable_private_address )
+{
+    const auto irk = le( "ec0234a3 57c8ad05 341010a6 0a397d9b" );
+    const std::vector< std::uint8_t > zero_irk( 16, 0 );
+
+    // hash = 0dfbaa, prand = 708194
+    const bluetoe::link_layer::random_device_address rpa( { 0xaa, 0xfb, 0x0d, 0x94, 0x81, 0x70 } );
+    const bluetoe::link_layer::random_device_address other_rpa( { 0xab, 0xfb, 0x0d, 0x94, 0x81, 0x70 } );
+    const bluetoe::link_layer::public_device_address public_address( { 0xaa, 0xfb, 0x0d, 0x94, 0x81, 0x70 } );
+
+    BOOST_CHECK( bluetoe::details::resolvable_by( rpa, irk.data() ) );
+    BOOST_CHECK( !bluetoe::details::resolvable_by( other_rpa, irk.data() ) );
+    BOOST_CHECK( !bluetoe::details::resolvable_by( public_address, irk.data() ) );
+    BOOST_CHECK( !bluetoe::details::resolvable_by( rpa, zero_irk.data() ) );
+}
@@ -0,0 +1,369 @@
+#include <bluetoe/bonding.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <array>
+#include <algorithm>
+
+namespace {
+
+    /*
+     * two pages of simulated NOR flash: writes can only clear bits, erase sets all bits of a page.
+     * After writes_until_reset writes, all further writes are lost, to simulate a reset of the device.
+     */
+    template < std::size_t PageSize >
+    struct simulated_flash
+    {
+        static constexpr std::size_t page_size = PageSize;
+
+        simulated_flash()
+            : writes( 0 )
+            , erases( 0 )
+            , writes_until_reset( ~std::size_t( 0 ) )
+        {
+            for ( auto& page : pages )
+                page.fill( 0xff );
+        }
+
+        void read( std::size_t page, std::size_t offset, std::uint8_t* data, std::size_t size )
+        {
+            BOOST_REQUIRE_LT( page, pages.size() );
+            BOOST_REQUIRE_LE( offset + size, PageSize );
+
+            std::copy( &pages[ page ][ offset ], &pages[ page ][ offset + size ], data );
+        }
+
+        void write( std::size_t page, std::size_t offset, const std::uint8_t* data, std::size_t size )
+        {
+            BOOST_REQUIRE_LT( page, pages.size() );
+            BOOST_REQUIRE_LE( offset + size, PageSize );
+            BOOST_REQUIRE_EQUAL( offset % 4, 0u );
+            BOOST_REQUIRE_EQUAL( size % 4, 0u );
+
+            if ( writes_until_reset == 0 )
+                return;
+
+            --writes_until_reset;
+            ++writes;
+
+            for ( std::size_t i = 0; i != size; ++i )
+                pages[ page ][ offset + i ] &= data[ i ];
+        }
+
+        void erase( std::size_t page )
+        {
+            BOOST_REQUIRE_LT( page, pages.size() );
+
+            if ( writes_until_reset == 0 )
+                return;
+
+            ++erases;
+            pages[ page ].fill( 0xff );
+        }
+
+        std::array< std::array< std::uint8_t, PageSize >, 2 > pages;
+        std::size_t writes;
+        std::size_t erases;
+        std::size_t writes_until_reset;
+    };
+
+    // room for 3 bonds per page
+    using flash_t = simulated_flash< 4 + 3 * 56 >;
+    using flash_store_t = bluetoe::flash_key_store< flash_t >;
+
+    bluetoe::link_layer::device_address peer( std::uint8_t id, bool is_random = false )
+    {
+        return bluetoe::link_layer::device_address( { id, 0x11, 0x22, 0x33, 0x44, 0x55 }, is_random );
+    }
+
+    bluetoe::bond_data bond( std::uint8_t id, std::uint8_t key, bool is_random = false )
+    {
+        bluetoe::bond_data result{
+            peer( id, is_random ),
+            {{ 0 }},
+            static_cast< std::uint64_t >( 0x0102030405060708 + key ),
+            static_cast< std::uint16_t >( 0x1234 + key ),
+            bluetoe::device_pairing_status::unauthenticated_key,
+            {{ 0 }}
+        };
+
+        result.long_term_key.fill( key );
+
+        return result;
+    }
+
+    // bond with the identity resolving key from the sample data of the Core Specification (Vol 3, Part H, Appendix D.7)
+    bluetoe::bond_data bond_with_irk( std::uint8_t id, std::uint8_t key )
+    {
+        bluetoe::bond_data result = bond( id, key );
+        result.identity_resolving_key = {{
+            0x9b, 0x7d, 0x39, 0x0a, 0xa6, 0x10, 0x10, 0x34, 0x05, 0xad, 0xc8, 0x57, 0xa3, 0x34, 0x02, 0xec
+        }};
+
+        return result;
+    }
+
+    // resolvable private address, that resolves with the IRK of bond_with_irk()
+    const bluetoe::link_layer::random_device_address resolvable_address( { 0xaa, 0xfb, 0x0d, 0x94, 0x81, 0x70 } );
+
+    template < class Store >
+    bool contains( Store&& store, const bluetoe::bond_data& expected )
+    {
+        bluetoe::bond_data found;
+
+        return store.find_bond( expected.identity, found )
+            && found.identity == expected.identity
+            && found.long_term_key == expected.long_term_key
+            && found.rand == expected.rand
+            && found.ediv == expected.ediv
+            && found.status == expected.status
+            && found.identity_resolving_key == expected.identity_resolving_key;
+    }
+
+    template < class Store >
+    bool contains_no( Store&& store, const bluetoe::link_layer::device_address& identity )
+    {
+        bluetoe::bond_data found;
+
+        return !store.find_bond( identity, found );
+    }
+
+    // restarts the key store with the content of the flash
+    flash_store_t restart( flash_store_t& store )
+    {
+        flash_store_t result;
+        result.flash().pages = store.flash().pages;
+
+        return result;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE( ram_key_store )
+
+    BOOST_AUTO_TEST_CASE( empty_store_finds_nothing )
+    {
+        bluetoe::ram_key_store< 2 > store;
+
+        BOOST_CHECK( contains_no( store, peer( 1 ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( bonds_are_found_by_identity )
+    {
+        bluetoe::ram_key_store< 2 > store;
+
+        BOOST_CHECK( store.store_bond( bond( 1, 0x10 ) ) );
+        BOOST_CHECK( store.store_bond( bond( 2, 0x20 ) ) );
+
+        BOOST_CHECK( contains( store, bond( 1, 0x10 ) ) );
+        BOOST_CHECK( contains( store, bond( 2, 0x20 ) ) );
+        BOOST_CHECK( contains_no( store, peer( 3 ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( address_type_is_part_of_the_identity )
+    {
+        bluetoe::ram_key_store< 2 > store;
+        store.store_bond( bond( 1, 0x10 ) );
+
+        BOOST_CHECK( contains_no( store, peer( 1, true ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( new_bond_replaces_bond_to_the_same_identity )
+    {
+        bluetoe::ram_key_store< 2 > store;
+        store.store_bond( bond( 1, 0x10 ) );
+        store.store_bond( bond( 2, 0x20 ) );
+        store.store_bond( bond( 1, 0x11 ) );
+
+        BOOST_CHECK( contains( store, bond( 1, 0x11 ) ) );
+        BOOST_CHECK( contains( store, bond( 2, 0x20 ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( oldest_bond_is_replaced_when_full )
+    {
+        bluetoe::ram_key_store< 2 > store;
+        store.store_bond( bond( 1, 0x10 ) );
+        store.store_bond( bond( 2, 0x20 ) );
+        store.store_bond( bond( 3, 0x30 ) );
+
+        BOOST_CHECK( contains_no( store, peer( 1 ) ) );
+        BOOST_CHECK( contains( store, bond( 2, 0x20 ) ) );
+        BOOST_CHECK( contains( store, bond( 3, 0x30 ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( bonds_are_found_by_resolvable_private_address )
+    {
+        bluetoe::ram_key_store< 2 > store;
+        store.store_bond( bond( 1, 0x10 ) );
+        BOOST_CHECK( contains_no( store, resolvable_address ) );
+
+        store.store_bond( bond_with_irk( 2, 0x20 ) );
+
+        bluetoe::bond_data found;
+        BOOST_REQUIRE( store.find_bond( resolvable_address, found ) );
+        BOOST_CHECK( found.identity == peer( 2 ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( remove_bonds )
+    {
+        bluetoe::ram_key_store< 2 > store;
+        store.store_bond( bond( 1, 0x10 ) );
+        store.remove_bonds();
+
+        BOOST_CHECK( contains_no( store, peer( 1 ) ) );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( flash_key_store )
+
+    BOOST_AUTO_TEST_CASE( empty_flash_finds_nothing )
+    {
+        flash_store_t store;
+
+        BOOST_CHECK( contains_no( store, peer( 1 ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( bonds_survive_a_restart )
+    {
+        flash_store_t store;
+        store.store_bond( bond( 1, 0x10 ) );
+        store.store_bond( bond( 2, 0x20, true ) );
+
+        flash_store_t restarted = restart( store );
+
+        BOOST_CHECK( contains( restarted, bond( 1, 0x10 ) ) );
+        BOOST_CHECK( contains( restarted, bond( 2, 0x20, true ) ) );
+        BOOST_CHECK( contains_no( restarted, peer( 2 ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( identity_resolving_key_survives_a_restart )
+    {
+        flash_store_t store;
+        store.store_bond( bond( 1, 0x10 ) );
+        store.store_bond( bond_with_irk( 2, 0x20 ) );
+
+        flash_store_t restarted = restart( store );
+
+        BOOST_CHECK( contains( restarted, bond_with_irk( 2, 0x20 ) ) );
+
+        bluetoe::bond_data found;
+        BOOST_REQUIRE( restarted.find_bond( resolvable_address, found ) );
+        BOOST_CHECK( found.identity == peer( 2 ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( last_record_of_an_identity_wins )
+    {
+        flash_store_t store;
+        store.store_bond( bond( 1, 0x10 ) );
+        store.store_bond( bond( 1, 0x11 ) );
+
+        BOOST_CHECK( contains( store, bond( 1, 0x11 ) ) );
+        BOOST_CHECK( contains( restart( store ), bond( 1, 0x11 ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( unchanged_bond_is_not_written_again )
+    {
+        flash_store_t store;
+        store.store_bond( bond( 1, 0x10 ) );
+
+        const std::size_t writes = store.flash().writes;
+        store.store_bond( bond( 1, 0x10 ) );
+
+        BOOST_CHECK_EQUAL( store.flash().writes, writes );
+    }
+
+    BOOST_AUTO_TEST_CASE( full_page_is_compacted )
+    {
+        flash_store_t store;
+        store.store_bond( bond( 1, 0x10 ) );
+        store.store_bond( bond( 2, 0x20 ) );
+        store.store_bond( bond( 1, 0x11 ) );
+        store.store_bond( bond( 2, 0x21 ) );
+
+        BOOST_CHECK( contains( store, bond( 1, 0x11 ) ) );
+        BOOST_CHECK( contains( store, bond( 2, 0x21 ) ) );
+
+        flash_store_t restarted = restart( store );
+        BOOST_CHECK( contains( restarted, bond( 1, 0x11 ) ) );
+        BOOST_CHECK( contains( restarted, bond( 2, 0x21 ) ) );
+
+        // there is room for another bond, without compacting again
+        const std::size_t erases = restarted.flash().erases;
+        restarted.store_bond( bond( 3, 0x30 ) );
+        BOOST_CHECK_EQUAL( restarted.flash().erases, erases );
+        BOOST_CHECK( contains( restarted, bond( 3, 0x30 ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( oldest_bond_is_dropped_if_the_page_is_too_small )
+    {
+        flash_store_t store;
+        store.store_bond( bond( 1, 0x10 ) );
+        store.store_bond( bond( 2, 0x20 ) );
+        store.store_bond( bond( 3, 0x30 ) );
+        store.store_bond( bond( 4, 0x40 ) );
+
+        BOOST_CHECK( contains_no( store, peer( 1 ) ) );
+        BOOST_CHECK( contains( store, bond( 2, 0x20 ) ) );
+        BOOST_CHECK( contains( store, bond( 3, 0x30 ) ) );
+        BOOST_CHECK( contains( store, bond( 4, 0x40 ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( record_without_commit_is_ignored )
+    {
+        flash_store_t store;
+        store.store_bond( bond( 1, 0x10 ) );
+
+        // reset after the record data was written, but before the commit word
+        store.flash().writes_until_reset = 1;
+        store.store_bond( bond( 1, 0x11 ) );
+
+        flash_store_t restarted = restart( store );
+        BOOST_CHECK( contains( restarted, bond( 1, 0x10 ) ) );
+
+        // the slot of the incomplete record is not reused
+        restarted.store_bond( bond( 2, 0x20 ) );
+        BOOST_CHECK( contains( restart( restarted ), bond( 2, 0x20 ) ) );
+        BOOST_CHECK( contains( restart( restarted ), bond( 1, 0x10 ) ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( reset_during_compaction_keeps_the_old_bonds )
+    {
+        for ( std::size_t writes = 0; writes != 8; ++writes )
+        {
+            flash_store_t store;
+            store.store_bond( bond( 1, 0x10 ) );
+            store.store_bond( bond( 2, 0x20 ) );
+            store.store_bond( bond( 1, 0x11 ) );
+
+            store.flash().writes_until_reset = writes;
+            store.store_bond( bond( 3, 0x30 ) );
+
+            flash_store_t restarted = restart( store );
+            BOOST_CHECK( contains( restarted, bond( 1, 0x11 ) ) );
+            BOOST_CHECK( contains( restarted, bond( 2, 0x20 ) ) );
+
+            // the compaction is complete, after the header of the new page was written
+            if ( writes > 6 )
+                BOOST_CHECK( contains( restarted, bond( 3, 0x30 ) ) );
+
+            // the restarted store is fully functional
+            restarted.store_bond( bond( 4, 0x40 ) );
+            BOOST_CHECK( contains( restart( restarted ), bond( 4, 0x40 ) ) );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( remove_bonds )
+    {
+        flash_store_t store;
+        store.store_bond( bond( 1, 0x10 ) );
+        store.remove_bonds();
+
+        BOOST_CHECK( contains_no( store, peer( 1 ) ) );
+        BOOST_CHECK( contains_no( restart( store ), peer( 1 ) ) );
+
+        store.store_bond( bond( 2, 0x20 ) );
+        BOOST_CHECK( contains( restart( store ), bond( 2, 0x20 ) ) );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
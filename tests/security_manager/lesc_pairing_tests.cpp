@@ -0,0 +1,520 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/security_manager.hpp>
+
+#include "test_sm.hpp"
+
+#include <vector>
+
+namespace {
+    using manager_t = bluetoe::lesc_security_manager<>;
+    using p256      = bluetoe::details::p256;
+
+    // private key of the initiator, from the P-256 sample data of the Core Specification
+    const std::uint8_t initiator_private_key[ 32 ] = {
+        0xbd, 0x1a, 0x3c, 0xcd, 0xa6, 0xb8, 0x99, 0x58, 0x99, 0xb7, 0x40, 0xeb, 0x7b, 0x60, 0xff, 0x4a,
+        0x50, 0x3f, 0x10, 0xd2, 0xe3, 0xb3, 0xc9, 0x74, 0x38, 0x5f, 0xc5, 0xa3, 0xd4, 0xf6, 0x49, 0x3f
+    };
+
+    const std::vector< std::uint8_t > na = {
+        0xab, 0xae, 0x2b, 0x71, 0xec, 0xb2, 0xff, 0xff, 0x3e, 0x73, 0x77, 0xd1, 0x54, 0x84, 0xcb, 0xd5
+    };
+
+    const bluetoe::link_layer::public_device_address local_address( { 0xb6, 0xb5, 0xb4, 0xb3, 0xb2, 0xb1 } );
+    const bluetoe::link_layer::random_device_address remote_address( { 0xa6, 0xa5, 0xa4, 0xa3, 0xa2, 0xa1 } );
+
+    template < class Functions >
+    struct basic_lesc_pairing : manager_t
+    {
+        static constexpr std::size_t mtu = 65;
+
+        struct gatt_connection_details {};
+        using connection_data_t = bluetoe::details::link_state<
+            manager_t::connection_data< gatt_connection_details > >;
+
+        basic_lesc_pairing()
+            : connection_data_( mtu )
+            , initiator_auth_req_( 0x08 )
+            , initiator_max_key_size_( 0x10 )
+            , initiator_key_distribution_( 0x00 )
+        {
+            functions_.local_address( local_address );
+            connection_data_.remote_connection_created( remote_address );
+
+            p256::public_key( initiator_private_key, initiator_public_key_ );
+
+            // the test security functions always create the same random number
+            const auto srand = functions_.create_srand();
+            nb_.assign( srand.begin(), srand.end() );
+
+            std::uint8_t private_key[ 32 ];
+            std::copy( srand.begin(), srand.end(), &private_key[ 0 ] );
+            std::copy( srand.begin(), srand.end(), &private_key[ 16 ] );
+            p256::public_key( private_key, responder_public_key_ );
+            p256::dh_key( initiator_private_key, responder_public_key_, dh_key_ );
+
+            bluetoe::details::f5( dh_key_, na.data(), nb_.data(), remote_address, local_address, mac_key_, ltk_ );
+        }
+
+        std::vector< std::uint8_t > input( const std::vector< std::uint8_t >& pdu, std::size_t out_size = mtu )
+        {
+            std::vector< std::uint8_t > output( out_size );
+            this->l2cap_input( pdu.data(), pdu.size(), output.data(), out_size, connection_data_, functions_ );
+            output.resize( out_size );
+
+            return output;
+        }
+
+        std::vector< std::uint8_t > output()
+        {
+            std::vector< std::uint8_t > output( mtu );
+            std::size_t out_size = mtu;
+            this->l2cap_output( output.data(), out_size, connection_data_, functions_ );
+            output.resize( out_size );
+
+            return output;
+        }
+
+        void idle()
+        {
+            this->idle_processing( connection_data_, functions_ );
+        }
+
+        std::vector< std::uint8_t > pairing_request()
+        {
+            return input( { 0x01, 0x03, 0x00, initiator_auth_req_, initiator_max_key_size_, initiator_key_distribution_, 0x00 } );
+        }
+
+        std::vector< std::uint8_t > public_key( const std::uint8_t* key )
+        {
+            std::vector< std::uint8_t > pdu( 1, 0x0c );
+            pdu.insert( pdu.end(), key, key + p256::public_key_size );
+
+            return input( pdu );
+        }
+
+        std::vector< std::uint8_t > public_key()
+        {
+            return public_key( initiator_public_key_ );
+        }
+
+        std::vector< std::uint8_t > pairing_random()
+        {
+            std::vector< std::uint8_t > pdu( 1, 0x04 );
+            pdu.insert( pdu.end(), na.begin(), na.end() );
+
+            return input( pdu );
+        }
+
+        std::uint8_t responder_auth_req() const
+        {
+            return Functions::bonding_supported ? 0x09 : 0x08;
+        }
+
+        std::vector< std::uint8_t > initiator_check() const
+        {
+            const std::uint8_t io_cap[] = { 0x03, 0x00, initiator_auth_req_ };
+            const std::uint8_t r[ 16 ]  = { 0 };
+
+            std::vector< std::uint8_t > pdu( 17, 0x0d );
+            bluetoe::details::f6( mac_key_, na.data(), nb_.data(), r, io_cap, remote_address, local_address, &pdu[ 1 ] );
+
+            return pdu;
+        }
+
+        std::vector< std::uint8_t > responder_check() const
+        {
+            const std::uint8_t io_cap[] = { 0x03, 0x00, responder_auth_req() };
+            const std::uint8_t r[ 16 ]  = { 0 };
+
+            std::vector< std::uint8_t > pdu( 17, 0x0d );
+            bluetoe::details::f6( mac_key_, nb_.data(), na.data(), r, io_cap, local_address, remote_address, &pdu[ 1 ] );
+
+            return pdu;
+        }
+
+        Functions                   functions_;
+        connection_data_t           connection_data_;
+        std::uint8_t                initiator_auth_req_;
+        std::uint8_t                initiator_max_key_size_;
+        std::uint8_t                initiator_key_distribution_;
+
+        std::uint8_t                initiator_public_key_[ 64 ];
+        std::uint8_t                responder_public_key_[ 64 ];
+        std::uint8_t                dh_key_[ 32 ];
+        std::uint8_t                mac_key_[ 16 ];
+        std::uint8_t                ltk_[ 16 ];
+        std::vector< std::uint8_t > nb_;
+    };
+
+    using lesc_pairing = basic_lesc_pairing< test::security_functions >;
+
+    struct public_keys_exchanged : lesc_pairing
+    {
+        public_keys_exchanged()
+        {
+            pairing_request();
+            public_key();
+            output();
+        }
+    };
+
+    struct random_exchanged : public_keys_exchanged
+    {
+        random_exchanged()
+        {
+            pairing_random();
+        }
+    };
+
+    std::vector< std::uint8_t > pairing_failed( std::uint8_t reason )
+    {
+        return { 0x05, reason };
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( pairing_without_secure_connections_is_rejected, lesc_pairing )
+{
+    BOOST_CHECK( input( { 0x01, 0x03, 0x00, 0x01, 0x10, 0x00, 0x00 } ) == pairing_failed( 0x03 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( invalid_pairing_request, lesc_pairing )
+{
+    BOOST_CHECK( input( { 0x01, 0x03, 0x00, 0x48, 0x10, 0x00, 0x00 } ) == pairing_failed( 0x0a ) );
+    BOOST_CHECK( input( { 0x01, 0x03, 0x00, 0x08, 0x10, 0x00 } ) == pairing_failed( 0x0a ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( pairing_response_announces_secure_connections, lesc_pairing )
+{
+    const std::vector< std::uint8_t > expected = { 0x02, 0x03, 0x00, 0x08, 0x10, 0x00, 0x00 };
+
+    BOOST_CHECK( pairing_request() == expected );
+    BOOST_CHECK( connection_data_.state() == bluetoe::details::lesc_pairing_state::pairing_requested );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_keys_are_requested_without_bonding, lesc_pairing )
+{
+    initiator_key_distribution_ = 0x03;
+    const std::vector< std::uint8_t > expected = { 0x02, 0x03, 0x00, 0x08, 0x10, 0x00, 0x00 };
+
+    BOOST_CHECK( pairing_request() == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( pairing_is_not_supported_with_too_small_pdus, lesc_pairing )
+{
+    BOOST_CHECK( input( { 0x01, 0x03, 0x00, 0x08, 0x10, 0x00, 0x00 }, 27 ) == pairing_failed( 0x05 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( public_key_is_answered_with_the_local_public_key, lesc_pairing )
+{
+    pairing_request();
+
+    std::vector< std::uint8_t > expected( 1, 0x0c );
+    expected.insert( expected.end(), std::begin( responder_public_key_ ), std::end( responder_public_key_ ) );
+
+    BOOST_CHECK( public_key() == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( public_key_not_on_the_curve_is_rejected, lesc_pairing )
+{
+    pairing_request();
+    initiator_public_key_[ 40 ] ^= 0x01;
+
+    BOOST_CHECK( public_key() == pairing_failed( 0x0b ) );
+    BOOST_CHECK( connection_data_.state() == bluetoe::details::lesc_pairing_state::idle );
+}
+
+BOOST_FIXTURE_TEST_CASE( reflected_public_key_is_rejected, lesc_pairing )
+{
+    pairing_request();
+
+    BOOST_CHECK( public_key( responder_public_key_ ) == pairing_failed( 0x0b ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( public_key_without_pairing_request, lesc_pairing )
+{
+    BOOST_CHECK( public_key() == pairing_failed( 0x08 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( confirm_follows_the_public_key, lesc_pairing )
+{
+    BOOST_CHECK( output().empty() );
+
+    pairing_request();
+    public_key();
+
+    std::vector< std::uint8_t > expected( 17, 0x03 );
+    bluetoe::details::f4( responder_public_key_, initiator_public_key_, nb_.data(), 0, &expected[ 1 ] );
+
+    BOOST_CHECK( output() == expected );
+    BOOST_CHECK( output().empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( random_is_not_accepted_before_the_confirm_was_sent, lesc_pairing )
+{
+    pairing_request();
+    public_key();
+
+    BOOST_CHECK( pairing_random() == pairing_failed( 0x08 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( random_is_answered_with_nb, public_keys_exchanged )
+{
+    std::vector< std::uint8_t > expected( 1, 0x04 );
+    expected.insert( expected.end(), nb_.begin(), nb_.end() );
+
+    BOOST_CHECK( pairing_random() == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( dhkey_check_completes_pairing, random_exchanged )
+{
+    BOOST_CHECK( connection_data_.local_device_pairing_status() == bluetoe::device_pairing_status::no_key );
+    BOOST_CHECK( !connection_data_.find_key( 0, 0 ).first );
+
+    BOOST_CHECK( input( initiator_check() ) == responder_check() );
+
+    BOOST_CHECK( connection_data_.local_device_pairing_status() == bluetoe::device_pairing_status::unauthenticated_key );
+
+    const auto key = connection_data_.find_key( 0, 0 );
+    BOOST_CHECK( key.first );
+    BOOST_CHECK_EQUAL_COLLECTIONS( key.second.begin(), key.second.end(), std::begin( ltk_ ), std::end( ltk_ ) );
+
+    BOOST_CHECK( !connection_data_.find_key( 1, 0 ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( long_term_key_is_shortened_to_the_negotiated_key_size, lesc_pairing )
+{
+    initiator_max_key_size_ = 7;
+
+    BOOST_CHECK( pairing_request() == std::vector< std::uint8_t >( { 0x02, 0x03, 0x00, 0x08, 0x10, 0x00, 0x00 } ) );
+    public_key();
+    output();
+    pairing_random();
+    BOOST_CHECK( input( initiator_check() ) == responder_check() );
+
+    std::fill( std::begin( ltk_ ) + 7, std::end( ltk_ ), 0 );
+
+    const auto key = connection_data_.find_key( 0, 0 );
+    BOOST_REQUIRE( key.first );
+    BOOST_CHECK_EQUAL_COLLECTIONS( key.second.begin(), key.second.end(), std::begin( ltk_ ), std::end( ltk_ ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( dh_key_is_calculated_in_idle_time, public_keys_exchanged )
+{
+    BOOST_CHECK( connection_data_.dh_key_pending() );
+    idle();
+    BOOST_CHECK( !connection_data_.dh_key_pending() );
+    BOOST_CHECK( connection_data_.dh_key_valid() );
+
+    pairing_random();
+    BOOST_CHECK( input( initiator_check() ) == responder_check() );
+}
+
+BOOST_FIXTURE_TEST_CASE( dh_key_is_not_calculated_before_the_confirm_was_sent, lesc_pairing )
+{
+    pairing_request();
+    public_key();
+
+    idle();
+    BOOST_CHECK( connection_data_.dh_key_pending() );
+}
+
+BOOST_FIXTURE_TEST_CASE( wrong_dhkey_check_fails_pairing, random_exchanged )
+{
+    auto check = initiator_check();
+    check[ 5 ] ^= 0x01;
+
+    BOOST_CHECK( input( check ) == pairing_failed( 0x0b ) );
+    BOOST_CHECK( connection_data_.local_device_pairing_status() == bluetoe::device_pairing_status::no_key );
+    BOOST_CHECK( !connection_data_.find_key( 0, 0 ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( unsupported_commands, lesc_pairing )
+{
+    BOOST_CHECK( input( { 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } ) == pairing_failed( 0x07 ) );
+}
+
+namespace {
+    using bonding_functions = test::basic_security_functions< bluetoe::bonding< bluetoe::ram_key_store< 2 > > >;
+
+    struct lesc_bonding : basic_lesc_pairing< bonding_functions >
+    {
+        lesc_bonding()
+        {
+            initiator_auth_req_ = 0x09;
+        }
+
+        void pair()
+        {
+            pairing_request();
+            public_key();
+            output();
+            pairing_random();
+            BOOST_CHECK( input( initiator_check() ) == responder_check() );
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( pairing_response_announces_bonding, lesc_bonding )
+{
+    const std::vector< std::uint8_t > expected = { 0x02, 0x03, 0x00, 0x09, 0x10, 0x00, 0x00 };
+
+    BOOST_CHECK( pairing_request() == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( long_term_key_is_stored_when_both_devices_request_bonding, lesc_bonding )
+{
+    bluetoe::bond_data bond;
+    BOOST_CHECK( !functions_.find_bond( remote_address, bond ) );
+
+    pair();
+
+    BOOST_REQUIRE( functions_.find_bond( remote_address, bond ) );
+    BOOST_CHECK_EQUAL_COLLECTIONS( bond.long_term_key.begin(), bond.long_term_key.end(), std::begin( ltk_ ), std::end( ltk_ ) );
+    BOOST_CHECK_EQUAL( bond.ediv, 0u );
+    BOOST_CHECK_EQUAL( bond.rand, 0u );
+    BOOST_CHECK( bond.status == bluetoe::device_pairing_status::unauthenticated_key );
+}
+
+BOOST_FIXTURE_TEST_CASE( stored_long_term_key_is_shortened_to_the_negotiated_key_size, lesc_bonding )
+{
+    initiator_max_key_size_ = 12;
+    pair();
+
+    std::fill( std::begin( ltk_ ) + 12, std::end( ltk_ ), 0 );
+
+    bluetoe::bond_data bond;
+    BOOST_REQUIRE( functions_.find_bond( remote_address, bond ) );
+    BOOST_CHECK_EQUAL_COLLECTIONS( bond.long_term_key.begin(), bond.long_term_key.end(), std::begin( ltk_ ), std::end( ltk_ ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_bonding_if_the_initiator_does_not_request_bonding, lesc_bonding )
+{
+    initiator_auth_req_ = 0x08;
+    pair();
+
+    bluetoe::bond_data bond;
+    BOOST_CHECK( !functions_.find_bond( remote_address, bond ) );
+    BOOST_CHECK( connection_data_.find_key( 0, 0 ).first );
+}
+
+namespace {
+    // identity resolving key from the sample data of the Core Specification (Vol 3, Part H, Appendix D.7)
+    const std::vector< std::uint8_t > peer_irk = {
+        0x9b, 0x7d, 0x39, 0x0a, 0xa6, 0x10, 0x10, 0x34, 0x05, 0xad, 0xc8, 0x57, 0xa3, 0x34, 0x02, 0xec
+    };
+
+    // resolvable private address, generated from peer_irk
+    const bluetoe::link_layer::random_device_address peer_rpa( { 0xaa, 0xfb, 0x0d, 0x94, 0x81, 0x70 } );
+
+    const bluetoe::link_layer::public_device_address peer_identity( { 0x16, 0x15, 0x14, 0x13, 0x12, 0x11 } );
+
+    struct lesc_bonding_with_identity : lesc_bonding
+    {
+        lesc_bonding_with_identity()
+        {
+            initiator_key_distribution_ = 0x03;
+        }
+
+        std::vector< std::uint8_t > identity_information()
+        {
+            std::vector< std::uint8_t > pdu( 1, 0x08 );
+            pdu.insert( pdu.end(), peer_irk.begin(), peer_irk.end() );
+
+            return input( pdu );
+        }
+
+        std::vector< std::uint8_t > identity_address_information()
+        {
+            std::vector< std::uint8_t > pdu = { 0x09, 0x00 };
+            pdu.insert( pdu.end(), peer_identity.begin(), peer_identity.end() );
+
+            return input( pdu );
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( pairing_response_requests_the_identity_key, lesc_bonding_with_identity )
+{
+    const std::vector< std::uint8_t > expected = { 0x02, 0x03, 0x00, 0x09, 0x10, 0x02, 0x00 };
+
+    BOOST_CHECK( pairing_request() == expected );
+}
+
+BOOST_FIXTURE_TEST_CASE( bond_is_stored_with_the_distributed_identity, lesc_bonding_with_identity )
+{
+    pair();
+
+    bluetoe::bond_data bond;
+    BOOST_CHECK( !functions_.find_bond( remote_address, bond ) );
+
+    BOOST_CHECK( identity_information().empty() );
+    BOOST_CHECK( !functions_.find_bond( remote_address, bond ) );
+
+    BOOST_CHECK( identity_address_information().empty() );
+
+    BOOST_REQUIRE( functions_.find_bond( peer_identity, bond ) );
+    BOOST_CHECK( bond.identity == peer_identity );
+    BOOST_CHECK_EQUAL_COLLECTIONS( bond.long_term_key.begin(), bond.long_term_key.end(), std::begin( ltk_ ), std::end( ltk_ ) );
+    BOOST_CHECK_EQUAL_COLLECTIONS( bond.identity_resolving_key.begin(), bond.identity_resolving_key.end(), peer_irk.begin(), peer_irk.end() );
+
+    // the key is still available for the current connection
+    BOOST_CHECK( connection_data_.find_key( 0, 0 ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( bond_is_found_by_a_resolvable_private_address_of_the_peer, lesc_bonding_with_identity )
+{
+    pair();
+    identity_information();
+    identity_address_information();
+
+    bluetoe::bond_data bond;
+    BOOST_REQUIRE( functions_.find_bond( peer_rpa, bond ) );
+    BOOST_CHECK( bond.identity == peer_identity );
+
+    const bluetoe::link_layer::random_device_address other_rpa( { 0xab, 0xfb, 0x0d, 0x94, 0x81, 0x70 } );
+    BOOST_CHECK( !functions_.find_bond( other_rpa, bond ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( identity_address_without_identity_information, lesc_bonding_with_identity )
+{
+    pair();
+
+    BOOST_CHECK( identity_address_information() == pairing_failed( 0x08 ) );
+
+    bluetoe::bond_data bond;
+    BOOST_CHECK( !functions_.find_bond( peer_identity, bond ) );
+
+    // the key is still available for the current connection
+    BOOST_CHECK( connection_data_.find_key( 0, 0 ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( malformed_identity_information_keeps_the_encryption, lesc_bonding_with_identity )
+{
+    pair();
+
+    BOOST_CHECK( input( { 0x08, 0x01, 0x02 } ) == pairing_failed( 0x0a ) );
+
+    const auto key = connection_data_.find_key( 0, 0 );
+    BOOST_REQUIRE( key.first );
+    BOOST_CHECK_EQUAL_COLLECTIONS( key.second.begin(), key.second.end(), std::begin( ltk_ ), std::end( ltk_ ) );
+    BOOST_CHECK( connection_data_.local_device_pairing_status() == bluetoe::device_pairing_status::unauthenticated_key );
+
+    // the identity resolving key was dropped, so the identity address is not expected anymore
+    BOOST_CHECK( identity_address_information() == pairing_failed( 0x08 ) );
+
+    bluetoe::bond_data bond;
+    BOOST_CHECK( !functions_.find_bond( peer_identity, bond ) );
+    BOOST_CHECK( connection_data_.find_key( 0, 0 ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( identity_information_is_not_expected_without_requesting_it, lesc_bonding )
+{
+    pair();
+
+    std::vector< std::uint8_t > pdu( 1, 0x08 );
+    pdu.insert( pdu.end(), peer_irk.begin(), peer_irk.end() );
+
+    BOOST_CHECK( input( pdu ) == pairing_failed( 0x08 ) );
+}
@@ -8,7 +8,8 @@
 
 namespace test {
 
-    struct security_functions {
+    template < class Bonding >
+    struct basic_security_functions : Bonding {
         bluetoe::link_layer::device_address local_address() const
         {
             return local_addr_;
@@ -116,6 +117,8 @@ namespace test {
         bluetoe::link_layer::device_address local_addr_;
     };
 
+    using security_functions = basic_security_functions< bluetoe::no_bonding >;
+
     template < class Manager, std::size_t MTU = 27 >
     struct security_manager : Manager, private security_functions
     {
@@ -5,6 +5,7 @@
 #include <bluetoe/delta_time.hpp>
 #include <bluetoe/ll_data_pdu_buffer.hpp>
 #include <bluetoe/link_layer.hpp>
+#include <bluetoe/software_encryption.hpp>
 
 #include <vector>
 #include <functional>
@@ -370,6 +371,12 @@ namespace test {
             bluetoe::link_layer::delta_time             end_receive,
             bluetoe::link_layer::delta_time             connection_interval );
 
+        bool reschedule_connection_event(
+            unsigned                                    channel,
+            bluetoe::link_layer::delta_time             start_receive,
+            bluetoe::link_layer::delta_time             end_receive,
+            bluetoe::link_layer::delta_time             connection_interval );
+
         void wake_up();
 
         /**
@@ -402,6 +409,16 @@ namespace test {
     protected:
         bool reception_encrypted_;
         bool transmition_encrypted_;
+
+        // hooks for radios, that encrypt in software; the PDUs are in over the air layout
+        virtual bool decrypt_received_pdu( std::vector< std::uint8_t >& )
+        {
+            return true;
+        }
+
+        virtual void encrypt_transmitted_pdu( std::vector< std::uint8_t >& )
+        {
+        }
     };
 }
 
@@ -518,6 +535,135 @@ namespace test {
         std::uint32_t               ivs_;
     };
 
+    /**
+     * @brief test radio, that encrypts and decrypts PDUs with bluetoe::link_layer::software_encryption
+     *
+     * PDUs received while receive encryption is active are expected to be encrypted by the simulated master
+     * and are decrypted before they are passed to the link layer. A PDU that fails the message integrity check
+     * is reported as MIC error and ends the connection event. Transmitted PDUs are recorded encrypted. As the
+     * simulated master acknowledges every PDU, there are no retransmissions.
+     */
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+    class radio_with_software_encryption :
+        public radio< TransmitSize, ReceiveSize, CallBack >,
+        public bluetoe::link_layer::software_encryption< radio_with_software_encryption< TransmitSize, ReceiveSize, CallBack > >
+    {
+    public:
+        static constexpr bool hardware_supports_encryption = true;
+
+        radio_with_software_encryption()
+            : srand_( { { 0x00 } } )
+        {
+        }
+
+        bluetoe::details::uint128_t create_srand()
+        {
+            return srand_;
+        }
+
+        // the random number, that is used for SKDs and IVs
+        void srand( const bluetoe::details::uint128_t& r )
+        {
+            srand_ = r;
+        }
+
+        void start_receive_encrypted()
+        {
+            encryption::start_receive_encrypted();
+            this->reception_encrypted_ = true;
+        }
+
+        void start_transmit_encrypted()
+        {
+            encryption::start_transmit_encrypted();
+            this->transmition_encrypted_ = true;
+        }
+
+        void stop_receive_encrypted()
+        {
+            encryption::stop_receive_encrypted();
+            this->reception_encrypted_ = false;
+        }
+
+        void stop_transmit_encrypted()
+        {
+            encryption::stop_transmit_encrypted();
+            this->transmition_encrypted_ = false;
+        }
+
+    private:
+        using encryption = bluetoe::link_layer::software_encryption< radio_with_software_encryption< TransmitSize, ReceiveSize, CallBack > >;
+
+        static constexpr std::size_t ll_header_size = 2;
+
+        bool decrypt_received_pdu( std::vector< std::uint8_t >& pdu ) override
+        {
+            const std::size_t size = pdu[ 1 ];
+
+            if ( size == 0 )
+                return true;
+
+            if ( size < encryption::mic_size || !encryption::decrypt_received_pdu( pdu[ 0 ], &pdu[ ll_header_size ], size ) )
+                return false;
+
+            pdu[ 1 ] = static_cast< std::uint8_t >( size - encryption::mic_size );
+            pdu.resize( ll_header_size + pdu[ 1 ] );
+
+            return true;
+        }
+
+        void encrypt_transmitted_pdu( std::vector< std::uint8_t >& pdu ) override
+        {
+            const std::size_t size = pdu[ 1 ];
+
+            if ( size == 0 )
+                return;
+
+            pdu.resize( ll_header_size + size + encryption::mic_size );
+            encryption::encrypt_transmitted_pdu( pdu[ 0 ], &pdu[ ll_header_size ], size );
+            pdu[ 1 ] = static_cast< std::uint8_t >( size + encryption::mic_size );
+        }
+
+        bluetoe::details::uint128_t srand_;
+    };
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+    class radio_with_slave_latency : public radio< TransmitSize, ReceiveSize, CallBack >
+    {
+    public:
+        static constexpr bool hardware_supports_slave_latency = true;
+    };
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+    class radio_with_2mbit : public radio< TransmitSize, ReceiveSize, CallBack >
+    {
+    public:
+        static constexpr bool hardware_supports_2mbit = true;
+
+        struct phy_change {
+            // number of connection events, that took place before the change
+            std::size_t                                                         connection_event;
+            bluetoe::link_layer::details::phy_ll_encoding::phy_ll_encoding_t   receiving_phy;
+            bluetoe::link_layer::details::phy_ll_encoding::phy_ll_encoding_t   transmitting_phy;
+        };
+
+        void radio_set_phy(
+            bluetoe::link_layer::details::phy_ll_encoding::phy_ll_encoding_t receiving_phy,
+            bluetoe::link_layer::details::phy_ll_encoding::phy_ll_encoding_t transmitting_phy )
+        {
+            phy_changes_.push_back( phy_change{ this->connection_events().size(), receiving_phy, transmitting_phy } );
+        }
+
+        // access to data provided for testing
+        const std::vector< phy_change >& phy_changes() const
+        {
+            return phy_changes_;
+        }
+
+    private:
+        std::vector< phy_change > phy_changes_;
+    };
+
     // implementation
     template < class Accu >
     Accu radio_base::sum_data( std::function< Accu ( const advertising_data&, Accu start_value ) > f, Accu start_value ) const
@@ -556,6 +702,10 @@ namespace test {
         advertising_response_ = true;
         connection_event_response_ = false;
 
+        // a new connection starts with new sequence numbers
+        master_sequence_number_    = 0;
+        master_ne_sequence_number_ = 0;
+
         const advertising_data data{
             now_,
             now_ + when,
@@ -599,6 +749,26 @@ namespace test {
         return bluetoe::link_layer::delta_time();
     }
 
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+    bool radio< TransmitSize, ReceiveSize, CallBack >::reschedule_connection_event(
+        unsigned                                    channel,
+        bluetoe::link_layer::delta_time             start_receive,
+        bluetoe::link_layer::delta_time             end_receive,
+        bluetoe::link_layer::delta_time             connection_interval )
+    {
+        // the simulation of the last scheduled event did not start jet
+        if ( !connection_event_response_ )
+            return false;
+
+        auto& event = connection_events_.back();
+        event.channel             = channel;
+        event.start_receive       = start_receive;
+        event.end_receive         = end_receive;
+        event.connection_interval = connection_interval;
+
+        return true;
+    }
+
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
     void radio< TransmitSize, ReceiveSize, CallBack >::wake_up()
     {
@@ -608,9 +778,14 @@ namespace test {
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
     void radio< TransmitSize, ReceiveSize, CallBack >::run()
     {
+        // like on real hardware, a wake up that happend outside of run() lets run() return immediately
+        if ( wake_ups_ )
+        {
+            --wake_ups_;
+            return;
+        }
+
         bool new_scheduling_added = false;
-        master_sequence_number_    = 0;
-        master_ne_sequence_number_ = 0;
 
         do
         {
@@ -723,9 +898,17 @@ namespace test {
                     }
                     else
                     {
-                        const auto pdu = pdus.front();
+                        auto pdu = pdus.front();
                         pdus.erase( pdus.begin() );
 
+                        if ( reception_encrypted_ && !decrypt_received_pdu( pdu.data ) )
+                        {
+                            event.received_data.push_back( pdu );
+                            this->mic_error();
+
+                            break;
+                        }
+
                         copy_air_to_memory( pdu.data, receive_buffer );
 
                         more_data = !pdus.empty();
@@ -753,8 +936,12 @@ namespace test {
                 event.received_data.push_back(
                     memory_to_air( bluetoe::link_layer::write_buffer( receive_buffer ) ) );
 
-                event.transmitted_data.push_back(
-                    pdu_t( memory_to_air( response ), transmition_encrypted_ ) );
+                std::vector< std::uint8_t > transmitted = memory_to_air( response );
+
+                if ( transmition_encrypted_ )
+                    encrypt_transmitted_pdu( transmitted );
+
+                event.transmitted_data.push_back( pdu_t( transmitted, transmition_encrypted_ ) );
 
             } while ( more_data );
 
@@ -883,6 +1070,24 @@ namespace bluetoe {
         {
             using pdu_layout = test::pdu_layout;
         };
+
+        template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+        struct pdu_layout_by_radio< test::radio_with_software_encryption< TransmitSize, ReceiveSize, CallBack > >
+        {
+            using pdu_layout = test::pdu_layout;
+        };
+
+        template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+        struct pdu_layout_by_radio< test::radio_with_slave_latency< TransmitSize, ReceiveSize, CallBack > >
+        {
+            using pdu_layout = test::pdu_layout;
+        };
+
+        template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+        struct pdu_layout_by_radio< test::radio_with_2mbit< TransmitSize, ReceiveSize, CallBack > >
+        {
+            using pdu_layout = test::pdu_layout;
+        };
    }
 }
 
@@ -222,9 +222,12 @@ namespace test {
 
         static bool l2cap_layer_notify_cb( const bluetoe::details::notification_data& item, void*, typename Server::notification_type type )
         {
-            notification = item;
             notification_type = type;
 
+            if ( type == Server::pending_response )
+                return true;
+
+            notification = item;
             open_notifications_.insert( item.client_characteristic_configuration_index() );
 
             return true;